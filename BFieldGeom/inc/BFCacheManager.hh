@@ -7,6 +7,7 @@
 #ifndef BFCacheManager_hh
 #define BFCacheManager_hh
 
+#include <atomic>
 #include <cassert>
 #include <map>
 #include <memory>
@@ -54,9 +55,11 @@ namespace mu2e {
                 : myMap(my), inner(in) {}
         };
 
-        // Inner map lists optimized for the last used map
-        mutable const CacheElement* innerForLastInner;
-        mutable const CacheElement* innerForLastOuter;  // never null
+        // Inner map lists optimized for the last used map.  These are only hints:
+        // the map found does not depend on them, so threads sharing one instance
+        // may overwrite each other's hints; they are atomic to make that safe.
+        mutable std::atomic<const CacheElement*> innerForLastInner;
+        mutable std::atomic<const CacheElement*> innerForLastOuter;  // never null
 
         // Outer maps in the user-specified order
         MapList outer;
@@ -68,6 +71,8 @@ namespace mu2e {
 
        public:
         BFCacheManager();
+        BFCacheManager(const BFCacheManager& other);
+        BFCacheManager& operator=(const BFCacheManager& other);
 
         void setMaps(const MapContainerType& innerMaps, const MapContainerType& outerMaps);
 
@@ -75,44 +80,46 @@ namespace mu2e {
         std::shared_ptr<const BFMap> findMap(const CLHEP::Hep3Vector& x) const {
             // First try to find if the point belong to any of the inner maps
 
-            if (innerForLastInner) {  // we were in an inner map last time
+            const CacheElement* lastInner = innerForLastInner.load(std::memory_order_relaxed);
+            if (lastInner) {  // we were in an inner map last time
 
-                if (innerForLastInner->myMap->isValid(x)) {
+                if (lastInner->myMap->isValid(x)) {
                     // Cache update not needed, we are still in the same inner map
-                    return innerForLastInner->myMap;
+                    return lastInner->myMap;
                 }
 
                 // The lookup order here is optimized
-                std::shared_ptr<const BFMap> newinner = innerForLastInner->inner.findMap(x);
+                std::shared_ptr<const BFMap> newinner = lastInner->inner.findMap(x);
                 if (newinner) {  // Update cache
                     CacheType::const_iterator p = innerCache.find(newinner);
                     assert(p != innerCache.end());
-                    innerForLastInner = &p->second;
+                    innerForLastInner.store(&p->second, std::memory_order_relaxed);
                     return newinner;
                 }
             } else {  // We were not in an inner map last time
 
                 // innerForLastOuter is never null
-                std::shared_ptr<const BFMap> newinner = innerForLastOuter->inner.findMap(x);
+                std::shared_ptr<const BFMap> newinner =
+                    innerForLastOuter.load(std::memory_order_relaxed)->inner.findMap(x);
                 if (newinner) {  // Update cache
                     CacheType::const_iterator p = innerCache.find(newinner);
                     assert(p != innerCache.end());
-                    innerForLastInner = &p->second;
+                    innerForLastInner.store(&p->second, std::memory_order_relaxed);
                     return newinner;
                 }
             }
 
             // The current point is not in any of the inner maps
-            innerForLastInner = 0;
+            innerForLastInner.store(nullptr, std::memory_order_relaxed);
 
             // The lookup order of the outer maps is always the same
             std::shared_ptr<const BFMap> newouter = outer.findMap(x);
 
             // Keep the inner map lookup optimized
-            if (innerForLastOuter->myMap != newouter) {
+            if (innerForLastOuter.load(std::memory_order_relaxed)->myMap != newouter) {
                 CacheType::const_iterator p = outerCache.find(newouter);
                 assert(p != outerCache.end());
-                innerForLastOuter = &p->second;
+                innerForLastOuter.store(&p->second, std::memory_order_relaxed);
             }
 
             return newouter;
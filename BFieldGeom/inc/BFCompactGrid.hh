@@ -0,0 +1,132 @@
+#ifndef BFieldGeom_BFCompactGrid_hh
+#define BFieldGeom_BFCompactGrid_hh
+//
+// Compact storage for the field values of one grid map, used by the
+// "compact" interpolation style of BFGridMap.
+//
+// The field is stored in single precision as a structure of arrays.  The grid
+// is cut into blocks of 2x2x4 points (x,y,z); each block holds 16 values of
+// each field component, so one component of one block fills exactly one
+// 64 byte cache line.  The 8 corners of most grid cells are found in a single
+// block and the others span at most 4 blocks.
+//
+// The interpolation is trilinear, the same algorithm as
+// BFGridMap::interpolateTriLinear, written without data dependent branches so
+// that the batch version can be vectorized by the compiler.  The position
+// arithmetic is done in double precision; only the stored field values are
+// rounded to float, which bounds the difference to the double precision path
+// at about 1e-7 relative to the largest field value of the cell.
+//
+// Units are: space point in mm, field values in tesla.  The overall scale
+// factor of the map is not applied here.
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+namespace mu2e {
+
+    class BFCompactGrid {
+       public:
+        // Block dimensions, in grid points.
+        static constexpr unsigned blockX = 2;
+        static constexpr unsigned blockY = 2;
+        static constexpr unsigned blockZ = 4;
+        static constexpr unsigned blockPoints = blockX * blockY * blockZ;
+
+        // One block of the grid: one cache line per field component.
+        struct alignas(64) Block {
+            float bx[blockPoints];
+            float by[blockPoints];
+            float bz[blockPoints];
+        };
+
+        BFCompactGrid() = default;
+
+        BFCompactGrid(unsigned nx,
+                      double xmin,
+                      double dx,
+                      unsigned ny,
+                      double ymin,
+                      double dy,
+                      unsigned nz,
+                      double zmin,
+                      double dz,
+                      bool flipy);
+
+        // Set the field at one grid point; no range check.
+        void set(unsigned ix, unsigned iy, unsigned iz, CLHEP::Hep3Vector const& b);
+
+        // Field at one grid point; no range check.
+        CLHEP::Hep3Vector get(unsigned ix, unsigned iy, unsigned iz) const;
+
+        // Interpolate at one point.  Returns false, and a zero field, if the
+        // point is outside of the grid.
+        bool interpolate(CLHEP::Hep3Vector const& point, CLHEP::Hep3Vector& result) const;
+
+        // Interpolate at one point and differentiate the interpolation:
+        // gradient[j] = dB/dx_j, in tesla/mm.  Zero outside of the grid.
+        bool interpolate(CLHEP::Hep3Vector const& point,
+                         CLHEP::Hep3Vector& result,
+                         CLHEP::Hep3Vector gradient[3]) const;
+
+        // Interpolate at n points given as separate coordinate arrays.
+        // Points outside of the grid get a zero field and status false.
+        void interpolate(std::size_t n,
+                         double const* x,
+                         double const* y,
+                         double const* z,
+                         double* bx,
+                         double* by,
+                         double* bz,
+                         bool* status) const;
+
+        bool empty() const { return _blocks.empty(); }
+
+        unsigned nx() const { return _nx; }
+        unsigned ny() const { return _ny; }
+        unsigned nz() const { return _nz; }
+
+        // Memory used by the field values, in bytes.
+        std::size_t memorySize() const { return _blocks.size() * sizeof(Block); }
+
+       private:
+        // Grid dimensions, in points and in blocks.
+        unsigned _nx = 0, _ny = 0, _nz = 0;
+        unsigned _nbx = 0, _nby = 0, _nbz = 0;
+
+        // Grid origin and inverse spacing.
+        double _xmin = 0., _ymin = 0., _zmin = 0.;
+        double _rdx = 0., _rdy = 0., _rdz = 0.;
+
+        // The grid covers y>=0 only; use the symmetry B_y(x,-y,z) = -B_y(x,y,z).
+        bool _flipy = false;
+
+        std::vector<Block> _blocks;
+
+        // Location of a grid point: block number and index within the block.
+        std::size_t block(unsigned ix, unsigned iy, unsigned iz) const {
+            return (std::size_t(ix / blockX) * _nby + iy / blockY) * _nbz + iz / blockZ;
+        }
+        static unsigned offset(unsigned ix, unsigned iy, unsigned iz) {
+            return ((ix % blockX) * blockY + iy % blockY) * blockZ + iz % blockZ;
+        }
+
+        // The cell holding a point, the fractional position inside it and
+        // whether the point is inside the grid.
+        struct Cell {
+            unsigned i, j, k;
+            double tx, ty, tz;
+            bool inside;
+        };
+        Cell locate(double x, double y, double z) const;
+
+        // The kernel shared by the single point and batch interfaces.
+        bool interpolate(double x, double y, double z, double b[3]) const;
+    };
+
+}  // end namespace mu2e
+
+#endif /* BFieldGeom_BFCompactGrid_hh */
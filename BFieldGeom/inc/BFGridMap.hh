@@ -12,10 +12,13 @@
 //
 
 //#include <iosfwd>
+#include <memory>
 #include <ostream>
 #include <string>
+#include "Offline/BFieldGeom/inc/BFCompactGrid.hh"
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
 #include "Offline/BFieldGeom/inc/BFMap.hh"
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
 #include "Offline/BFieldGeom/inc/Container3D.hh"
 #include "CLHEP/Vector/ThreeVector.h"
@@ -67,10 +70,30 @@ namespace mu2e {
               _allDefined(false),
               _interpStyle(style){};
 
+        // A map that uses the field values of a mapped file in place; the grid
+        // is described by the header of the file.
+        BFGridMap(std::string filename,
+                  std::shared_ptr<const BFMapFile> mapping,
+                  BFMapType::enum_type atype,
+                  double scale,
+                  BFInterpolationStyle style,
+                  bool warnIfOutside = false);
+
         ~BFGridMap(){};
 
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
 
+        // Differentiates the trilinear interpolation in the cell of the point.
+        virtual bool getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector& point,
+                                                    CLHEP::Hep3Vector& field,
+                                                    CLHEP::Hep3Vector gradient[3]) const;
+
+        // The compact style hands the points to the batch kernel of BFCompactGrid.
+        virtual std::size_t getBFieldsWithStatus(std::size_t n,
+                                                 const CLHEP::Hep3Vector* points,
+                                                 CLHEP::Hep3Vector* fields,
+                                                 bool* status) const;
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const;
         bool isValid(const GridPoint& ipoint) const {
@@ -101,6 +124,18 @@ namespace mu2e {
 
         virtual void print(std::ostream& os) const;
 
+        BFInterpolationStyle interpolationStyle() const { return _interpStyle; }
+
+        // True if the grid covers y>=0 only and is extended by reflection.
+        bool flipy() const { return _flipy; }
+
+        // True if the field values are used in place from a mapped file.
+        bool isMapped() const { return _mapping != nullptr; }
+
+        // Copy of the field values in the single precision, blocked layout used
+        // by the compact interpolation style.
+        BFCompactGrid makeCompactGrid() const;
+
        private:
         // Grid dimensions
         unsigned int _nx, _ny, _nz;
@@ -121,6 +156,12 @@ namespace mu2e {
         // method for interpolation between field grid points
         BFInterpolationStyle _interpStyle;
 
+        // Field values used by the compact interpolation style; empty otherwise.
+        BFCompactGrid _compact;
+
+        // The file that holds the field values of a mapped map; keeps the mapping alive.
+        std::shared_ptr<const BFMapFile> _mapping;
+
         // Functions used internally and by the code that populates the maps.
 
         // method to store the neighbors
@@ -141,6 +182,9 @@ namespace mu2e {
         std::size_t iZ(double z) const { return static_cast<int>((z - _zmin) / _dz + 0.5); }
 
         bool interpolateTriLinear(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+        bool interpolateTriLinear(const CLHEP::Hep3Vector&,
+                                  CLHEP::Hep3Vector&,
+                                  CLHEP::Hep3Vector gradient[3]) const;
 
     };
 
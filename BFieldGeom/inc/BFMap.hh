@@ -11,6 +11,7 @@
 // Rewritten again by Brian Pollack to become pure-virtual base class for all types of BFMaps
 //
 
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
@@ -49,6 +50,39 @@ namespace mu2e {
         // Accessors
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const = 0;
 
+        // Field at n points in one call; the default loops over getBFieldWithStatus.
+        // Returns the number of points inside the map.
+        virtual std::size_t getBFieldsWithStatus(std::size_t n,
+                                                 const CLHEP::Hep3Vector* points,
+                                                 CLHEP::Hep3Vector* fields,
+                                                 bool* status) const {
+            std::size_t nvalid(0);
+            for (std::size_t i = 0; i != n; ++i) {
+                status[i] = getBFieldWithStatus(points[i], fields[i]);
+                nvalid += status[i];
+            }
+            return nvalid;
+        }
+
+        // Field and its derivatives at a point: gradient[j] = dB/dx_j, in tesla/mm.
+        // The default uses central differences of getBFieldWithStatus; maps that
+        // can differentiate their own interpolation override it.
+        virtual bool getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector& point,
+                                                    CLHEP::Hep3Vector& field,
+                                                    CLHEP::Hep3Vector gradient[3]) const {
+            static const double h(1.0);  // mm
+            bool retval = getBFieldWithStatus(point, field);
+            for (int j = 0; j != 3; ++j) {
+                CLHEP::Hep3Vector step;
+                step[j] = h;
+                CLHEP::Hep3Vector bm, bp;
+                retval &= getBFieldWithStatus(point - step, bm);
+                retval &= getBFieldWithStatus(point + step, bp);
+                gradient[j] = (bp - bm) / (2. * h);
+            }
+            return retval;
+        }
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const = 0;
 
@@ -61,6 +95,8 @@ namespace mu2e {
 
         BFMapType type() const { return _type; }
 
+        double scaleFactor() const { return _scaleFactor; }
+
         const std::string& getKey() const { return _key; };
 
         virtual void print(std::ostream& os) const = 0;
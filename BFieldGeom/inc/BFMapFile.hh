@@ -0,0 +1,89 @@
+#ifndef BFieldGeom_BFMapFile_hh
+#define BFieldGeom_BFMapFile_hh
+//
+// Versioned, checksummed binary file format for one grid field map, read by
+// mapping the file into memory.
+//
+// The file is a fixed size header followed, at a page aligned offset, by the
+// field values at the grid points in the memory layout of the field array of
+// BFGridMap (CLHEP::Hep3Vector, x slowest and z fastest).  The values are used
+// in place from a read-only, shared mapping of the file instead of being read
+// into a heap array.  The effect on job startup time and RSS has not been
+// measured.
+//
+// The header holds the grid description, so no separate header file is
+// needed.  Two checksums protect the file: one over the header and one over
+// the field values; checking the second one touches every page of the file.
+//
+// Files are written by BFieldManagerMaker when bfield.writeMappedMaps is set;
+// see BFieldGeom/test/makeMappedMaps.fcl.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+namespace mu2e {
+
+    struct BFMapFileHeader {
+        char magic[8];            // "MU2EBFM" followed by a zero byte
+        std::uint32_t version;    // BFMapFile::currentVersion when written
+        std::uint32_t endian;     // 0xDEADBEEF in the byte order of the writer
+        std::uint32_t headerSize; // sizeof(BFMapFileHeader)
+        std::uint32_t flags;      // see BFMapFile::flipyFlag
+        std::uint32_t nx, ny, nz; // grid dimensions
+        std::uint32_t valueSize;  // bytes per grid point
+        double xmin, ymin, zmin;  // first grid point, mm
+        double dx, dy, dz;        // grid spacing, mm
+        std::uint64_t dataOffset; // start of the field values, bytes from the start of the file
+        std::uint64_t dataSize;   // size of the field values, bytes
+        std::uint64_t dataChecksum;
+        std::uint64_t headerChecksum; // of the bytes of the header before this word
+    };
+
+    class BFMapFile {
+       public:
+        static constexpr std::uint32_t currentVersion = 1;
+
+        // The map covers y>=0 only and is extended by reflection.
+        static constexpr std::uint32_t flipyFlag = 0x1;
+
+        // Map the file and check its header.  If verify is true, also check the
+        // checksum of the field values.  Throws on any error.
+        BFMapFile(std::string const& filename, bool verify);
+        ~BFMapFile();
+
+        BFMapFile(BFMapFile const&) = delete;
+        BFMapFile& operator=(BFMapFile const&) = delete;
+
+        BFMapFileHeader const& header() const { return *_header; }
+
+        // Field values at the grid points, in the layout of Container3D.
+        CLHEP::Hep3Vector const* field() const { return _field; }
+
+        std::string const& filename() const { return _filename; }
+
+        // Write a file; fills in the sizes, offsets and checksums of the header.
+        static void write(std::string const& filename,
+                          BFMapFileHeader header,
+                          CLHEP::Hep3Vector const* field);
+
+        // A header with the magic number, version and sizes filled in.
+        static BFMapFileHeader makeHeader();
+
+        // 64 bit FNV-1a, applied to 8 byte words, then to the remaining bytes.
+        static std::uint64_t checksum(void const* data, std::size_t nbytes);
+
+       private:
+        std::string _filename;
+        void* _address = nullptr;
+        std::size_t _size = 0;
+        BFMapFileHeader const* _header = nullptr;
+        CLHEP::Hep3Vector const* _field = nullptr;
+    };
+
+}  // end namespace mu2e
+
+#endif /* BFieldGeom_BFMapFile_hh */
@@ -60,13 +60,24 @@ namespace mu2e {
         // to trigger the map-writing hack inside the BFieldManagerMaker code.
         bool writeBinaries() const { return writeBinaries_; }
 
+        // to write the maps in the mapped binary format (see BFMapFile).
+        bool writeMappedMaps() const { return writeMappedMaps_; }
+
+        // check the checksum of the field values of mapped binary maps when loading them.
+        bool verifyMapChecksums() const { return verifyMapChecksums_; }
+
         int verbosityLevel() const { return verbosityLevel_; }
 
         bool flipBFieldMaps() const { return flipBFieldMaps_; }
 
        private:
         BFieldConfig()
-            : scaleFactor_(1.), writeBinaries_(false), verbosityLevel_(1), flipBFieldMaps_(false) {}
+            : scaleFactor_(1.),
+              writeBinaries_(false),
+              writeMappedMaps_(false),
+              verifyMapChecksums_(true),
+              verbosityLevel_(1),
+              flipBFieldMaps_(false) {}
 
         // G4BL, PARAM or possible future types.
         BFMapType mapType_;
@@ -89,6 +100,8 @@ namespace mu2e {
         CLHEP::Hep3Vector dsGradientValue_;
 
         bool writeBinaries_;
+        bool writeMappedMaps_;
+        bool verifyMapChecksums_;
         int verbosityLevel_;
         bool flipBFieldMaps_;
     };
@@ -44,6 +44,30 @@ namespace mu2e {
                                  BFCacheManager const&,
                                  CLHEP::Hep3Vector&) const;
 
+        // Get the field and its derivatives, gradient[j] = dB/dx_j in tesla/mm,
+        // from a single lookup of the map.  Zero for out of range.
+        bool getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector&,
+                                            CLHEP::Hep3Vector& field,
+                                            CLHEP::Hep3Vector gradient[3]) const;
+        bool getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector&,
+                                            BFCacheManager const&,
+                                            CLHEP::Hep3Vector& field,
+                                            CLHEP::Hep3Vector gradient[3]) const;
+
+        // Get the field at n points in one call.  The map is looked up once for
+        // each contiguous run of points inside the same inner map and the whole
+        // run is handed to that map.  The status of each point has the same meaning
+        // as for getBFieldWithStatus.  Returns the number of points inside a map.
+        std::size_t getBFieldsWithStatus(std::size_t n,
+                                         const CLHEP::Hep3Vector* points,
+                                         CLHEP::Hep3Vector* fields,
+                                         bool* status) const;
+        std::size_t getBFieldsWithStatus(std::size_t n,
+                                         const CLHEP::Hep3Vector* points,
+                                         BFCacheManager const&,
+                                         CLHEP::Hep3Vector* fields,
+                                         bool* status) const;
+
         // Just return zero for out of range.
         CLHEP::Hep3Vector getBField(const CLHEP::Hep3Vector& pos) const {
             // Default c'tor sets all components to zero - which is what we need here.
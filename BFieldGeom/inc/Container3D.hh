@@ -24,7 +24,9 @@ namespace mu2e {
       _nx(0u),
       _ny(0u),
       _nz(0u),
-      _vec(){
+      _vec(),
+      _data(nullptr),
+      _external(false){
     }
 
     // Normal constructor.
@@ -32,10 +34,47 @@ namespace mu2e {
       _nx(nx),
       _ny(ny),
       _nz(nz),
-      _vec(_nx*_ny*_nz,OBJ()){
+      _vec(_nx*_ny*_nz,OBJ()),
+      _data(_vec.data()),
+      _external(false){
     }
 
-    // Use compiler-generated copy c'tor, copy assignment, and d'tor
+    // Read-only view of nx*ny*nz objects owned elsewhere, for example in a
+    // memory mapped file.  The caller keeps that memory alive for the lifetime
+    // of the container.  Only the const accessors may be used on a view.
+    Container3D( unsigned int nx, unsigned int ny, unsigned int nz, OBJ const* data):
+      _nx(nx),
+      _ny(ny),
+      _nz(nz),
+      _vec(),
+      _data(data),
+      _external(true){
+    }
+
+    // Copies of an owning container point to their own copy of the data.
+    Container3D( Container3D const& other ):
+      _nx(other._nx),
+      _ny(other._ny),
+      _nz(other._nz),
+      _vec(other._vec),
+      _data(other._external ? other._data : _vec.data()),
+      _external(other._external){
+    }
+
+    Container3D& operator=( Container3D const& other ){
+      if ( this != &other ){
+        _nx = other._nx;
+        _ny = other._ny;
+        _nz = other._nz;
+        _vec = other._vec;
+        _data = other._external ? other._data : _vec.data();
+        _external = other._external;
+      }
+      return *this;
+    }
+
+    // True if the container does not own its data.
+    bool isView() const { return _external; }
 
     // Set element, without safety features.  Use if the caller has
     // already ensured the validity of the arguments.
@@ -46,7 +85,7 @@ namespace mu2e {
     // Get element, without safety features. Use if the caller has
     // already ensured the validity of the arguments.
     OBJ const& get( unsigned int ix, unsigned int iy, unsigned int iz) const {
-      return _vec[index(ix,iy,iz)];
+      return _data[index(ix,iy,iz)];
     }
 
     // Get element, without safety features. Use if the caller has
@@ -57,7 +96,7 @@ namespace mu2e {
 
     // Synonym for get, without safety features.
     OBJ const& operator()( unsigned int ix, unsigned int iy, unsigned int iz) const {
-      return _vec[index(ix,iy,iz)];
+      return _data[index(ix,iy,iz)];
     }
 
     // Set, with safety features.
@@ -69,7 +108,7 @@ namespace mu2e {
     // Get, with safety features.
     OBJ const& getSafe( unsigned int ix, unsigned int iy, unsigned int iz) const {
       isValidOrThrow(ix,iy,iz);
-      return _vec.at(index(ix,iy,iz));
+      return _data[index(ix,iy,iz)];
     }
 
     // Check for a valid index
@@ -98,6 +137,8 @@ namespace mu2e {
       _ny = 0;
       _nz = 0;
       std::vector<OBJ>().swap(_vec);
+      _data = nullptr;
+      _external = false;
     }
 
 
@@ -109,6 +150,10 @@ namespace mu2e {
     // Container to hold everything.
     std::vector<OBJ> _vec;
 
+    // The data: either _vec.data() or memory owned elsewhere.
+    OBJ const* _data;
+    bool _external;
+
     // Compute the index into the array.
     typename std::vector<OBJ>::size_type index(unsigned int ix, unsigned int iy, unsigned int iz) const {
       return ix*_ny*_nz + iy*_nz + iz;
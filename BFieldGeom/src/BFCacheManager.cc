@@ -15,6 +15,28 @@ namespace mu2e {
         innerForLastOuter = &p->second;
     }
 
+    // A copy starts with the hints of the original, which point into the cache
+    // of the original: the original must outlive the copy.
+    BFCacheManager::BFCacheManager(const BFCacheManager& other)
+        : innerForLastInner(other.innerForLastInner.load(std::memory_order_relaxed)),
+          innerForLastOuter(other.innerForLastOuter.load(std::memory_order_relaxed)),
+          outer(other.outer),
+          innerCache(other.innerCache),
+          outerCache(other.outerCache),
+          counter(other.counter) {}
+
+    BFCacheManager& BFCacheManager::operator=(const BFCacheManager& other) {
+        innerForLastInner.store(other.innerForLastInner.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+        innerForLastOuter.store(other.innerForLastOuter.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+        outer = other.outer;
+        innerCache = other.innerCache;
+        outerCache = other.outerCache;
+        counter = other.counter;
+        return *this;
+    }
+
     void BFCacheManager::setMaps(const MapContainerType& innerMaps,
                                  const MapContainerType& outerMaps) {
         typedef MapContainerType::const_iterator Iter;
@@ -0,0 +1,192 @@
+//
+// Compact storage for the field values of one grid map, used by the
+// "compact" interpolation style of BFGridMap.
+//
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFCompactGrid.hh"
+
+// Other includes
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+    BFCompactGrid::BFCompactGrid(unsigned nx,
+                                 double xmin,
+                                 double dx,
+                                 unsigned ny,
+                                 double ymin,
+                                 double dy,
+                                 unsigned nz,
+                                 double zmin,
+                                 double dz,
+                                 bool flipy)
+        : _nx(nx),
+          _ny(ny),
+          _nz(nz),
+          _nbx((nx + blockX - 1) / blockX),
+          _nby((ny + blockY - 1) / blockY),
+          _nbz((nz + blockZ - 1) / blockZ),
+          _xmin(xmin),
+          _ymin(ymin),
+          _zmin(zmin),
+          _rdx(1. / dx),
+          _rdy(1. / dy),
+          _rdz(1. / dz),
+          _flipy(flipy),
+          _blocks(std::size_t(_nbx) * _nby * _nbz) {
+        // The interpolation needs at least one cell in each dimension.
+        if (nx < 2 || ny < 2 || nz < 2) {
+            throw cet::exception("GEOM")
+                << "BFCompactGrid: a grid needs at least 2 points in each dimension. Found: "
+                << nx << " " << ny << " " << nz << "\n";
+        }
+        for (auto& b : _blocks) {
+            std::fill(std::begin(b.bx), std::end(b.bx), 0.f);
+            std::fill(std::begin(b.by), std::end(b.by), 0.f);
+            std::fill(std::begin(b.bz), std::end(b.bz), 0.f);
+        }
+    }
+
+    void BFCompactGrid::set(unsigned ix, unsigned iy, unsigned iz, CLHEP::Hep3Vector const& b) {
+        Block& blk = _blocks[block(ix, iy, iz)];
+        unsigned const i = offset(ix, iy, iz);
+        blk.bx[i] = b.x();
+        blk.by[i] = b.y();
+        blk.bz[i] = b.z();
+    }
+
+    CLHEP::Hep3Vector BFCompactGrid::get(unsigned ix, unsigned iy, unsigned iz) const {
+        Block const& blk = _blocks[block(ix, iy, iz)];
+        unsigned const i = offset(ix, iy, iz);
+        return CLHEP::Hep3Vector(blk.bx[i], blk.by[i], blk.bz[i]);
+    }
+
+    // Points outside of the grid are clamped onto it so that the memory access is
+    // always legal; their result is then masked to zero.  Points on the upper edge
+    // of the grid use the last cell with a fractional distance of 1.
+    BFCompactGrid::Cell BFCompactGrid::locate(double x, double y, double z) const {
+        double const ay = _flipy ? std::abs(y) : y;
+
+        // Position in units of the grid spacing.
+        double const ux = (x - _xmin) * _rdx;
+        double const uy = (ay - _ymin) * _rdy;
+        double const uz = (z - _zmin) * _rdz;
+
+        // fmin/fmax also map a NaN onto the grid.
+        double const cx = std::fmin(std::fmax(ux, 0.), _nx - 1.);
+        double const cy = std::fmin(std::fmax(uy, 0.), _ny - 1.);
+        double const cz = std::fmin(std::fmax(uz, 0.), _nz - 1.);
+
+        Cell c;
+        c.i = std::min(unsigned(cx), _nx - 2);
+        c.j = std::min(unsigned(cy), _ny - 2);
+        c.k = std::min(unsigned(cz), _nz - 2);
+        c.tx = cx - c.i;
+        c.ty = cy - c.j;
+        c.tz = cz - c.k;
+        c.inside = (ux >= 0.) & (ux <= _nx - 1.) & (uy >= 0.) & (uy <= _ny - 1.) & (uz >= 0.) &
+                   (uz <= _nz - 1.);
+        return c;
+    }
+
+    bool BFCompactGrid::interpolate(double x, double y, double z, double b[3]) const {
+        Cell const cell = locate(x, y, z);
+
+        // Weighted sum over the 8 corners of the cell; bits of c are the x,y,z steps.
+        double sx(0.), sy(0.), sz(0.);
+        for (unsigned c = 0; c != 8; ++c) {
+            unsigned const di = c >> 2;
+            unsigned const dj = (c >> 1) & 1u;
+            unsigned const dk = c & 1u;
+            double const w = (di ? cell.tx : 1. - cell.tx) * (dj ? cell.ty : 1. - cell.ty) *
+                             (dk ? cell.tz : 1. - cell.tz);
+            Block const& blk = _blocks[block(cell.i + di, cell.j + dj, cell.k + dk)];
+            unsigned const o = offset(cell.i + di, cell.j + dj, cell.k + dk);
+            sx += w * blk.bx[o];
+            sy += w * blk.by[o];
+            sz += w * blk.bz[o];
+        }
+
+        // Need the signed value of y here to restore the sign of B_y.
+        double const mask = cell.inside ? 1. : 0.;
+        double const ysign = (_flipy && y < 0.) ? -1. : 1.;
+        b[0] = mask * sx;
+        b[1] = mask * ysign * sy;
+        b[2] = mask * sz;
+        return cell.inside;
+    }
+
+    bool BFCompactGrid::interpolate(CLHEP::Hep3Vector const& point,
+                                    CLHEP::Hep3Vector& result,
+                                    CLHEP::Hep3Vector gradient[3]) const {
+        Cell const cell = locate(point.x(), point.y(), point.z());
+
+        double b[3] = {0., 0., 0.};
+        double g[3][3] = {{0., 0., 0.}, {0., 0., 0.}, {0., 0., 0.}};
+        for (unsigned c = 0; c != 8; ++c) {
+            unsigned const di = c >> 2;
+            unsigned const dj = (c >> 1) & 1u;
+            unsigned const dk = c & 1u;
+            double const wx = di ? cell.tx : 1. - cell.tx;
+            double const wy = dj ? cell.ty : 1. - cell.ty;
+            double const wz = dk ? cell.tz : 1. - cell.tz;
+            // Weight of the corner and its derivatives with respect to tx, ty and tz.
+            double const w[4] = {wx * wy * wz, (di ? 1. : -1.) * wy * wz,
+                                 wx * (dj ? 1. : -1.) * wz, wx * wy * (dk ? 1. : -1.)};
+            Block const& blk = _blocks[block(cell.i + di, cell.j + dj, cell.k + dk)];
+            unsigned const o = offset(cell.i + di, cell.j + dj, cell.k + dk);
+            double const bc[3] = {blk.bx[o], blk.by[o], blk.bz[o]};
+            for (int i = 0; i != 3; ++i) {
+                b[i] += w[0] * bc[i];
+                for (int j = 0; j != 3; ++j) {
+                    g[j][i] += w[j + 1] * bc[i];
+                }
+            }
+        }
+
+        // Convert to derivatives per mm.  For a reflected point the terms that involve
+        // exactly one y (a y component or a y derivative) change sign.
+        double const mask = cell.inside ? 1. : 0.;
+        bool const reflected = _flipy && point.y() < 0.;
+        double const scale[3] = {mask * _rdx, mask * _rdy, mask * _rdz};
+        for (int j = 0; j != 3; ++j) {
+            for (int i = 0; i != 3; ++i) {
+                double const sign = (reflected && ((i == 1) != (j == 1))) ? -1. : 1.;
+                gradient[j][i] = sign * scale[j] * g[j][i];
+            }
+        }
+        result.set(mask * b[0], mask * (reflected ? -b[1] : b[1]), mask * b[2]);
+        return cell.inside;
+    }
+
+    bool BFCompactGrid::interpolate(CLHEP::Hep3Vector const& point,
+                                    CLHEP::Hep3Vector& result) const {
+        double b[3];
+        bool const retval = interpolate(point.x(), point.y(), point.z(), b);
+        result.set(b[0], b[1], b[2]);
+        return retval;
+    }
+
+    void BFCompactGrid::interpolate(std::size_t n,
+                                    double const* x,
+                                    double const* y,
+                                    double const* z,
+                                    double* bx,
+                                    double* by,
+                                    double* bz,
+                                    bool* status) const {
+        for (std::size_t i = 0; i != n; ++i) {
+            double b[3];
+            status[i] = interpolate(x[i], y[i], z[i], b);
+            bx[i] = b[0];
+            by[i] = b[1];
+            bz[i] = b[2];
+        }
+    }
+
+}  // end namespace mu2e
@@ -9,6 +9,7 @@
 // methods.
 
 // C++ includes
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -28,6 +29,35 @@ using namespace std;
 
 namespace mu2e {
 
+    BFGridMap::BFGridMap(std::string filename,
+                         std::shared_ptr<const BFMapFile> mapping,
+                         BFMapType::enum_type atype,
+                         double scale,
+                         BFInterpolationStyle style,
+                         bool warnIfOutside)
+        : BFMap(filename,
+                mapping->header().xmin,
+                mapping->header().xmin + (mapping->header().nx - 1) * mapping->header().dx,
+                mapping->header().ymin,
+                mapping->header().ymin + (mapping->header().ny - 1) * mapping->header().dy,
+                mapping->header().zmin,
+                mapping->header().zmin + (mapping->header().nz - 1) * mapping->header().dz,
+                atype,
+                scale,
+                warnIfOutside),
+          _nx(mapping->header().nx),
+          _ny(mapping->header().ny),
+          _nz(mapping->header().nz),
+          _dx(mapping->header().dx),
+          _dy(mapping->header().dy),
+          _dz(mapping->header().dz),
+          _field(_nx, _ny, _nz, mapping->field()),
+          _isDefined(_nx, _ny, _nz, true),
+          _allDefined(true),
+          _flipy((mapping->header().flags & BFMapFile::flipyFlag) != 0),
+          _interpStyle(style),
+          _mapping(std::move(mapping)) {}
+
     // function to determine if the point is in the map; take into account Y-symmetry
     bool BFGridMap::isValid(CLHEP::Hep3Vector const& point) const {
         if (point.x() < _xmin || point.x() > _xmax) {
@@ -153,15 +183,85 @@ namespace mu2e {
         if (_interpStyle == BFInterpolationStyle::trilinear) {
             retval = interpolateTriLinear(testpoint, result);
 
+        } else if (_interpStyle == BFInterpolationStyle::compact) {
+            retval = _compact.interpolate(testpoint, result);
+            if (!retval && _warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << testpoint << "\n";
+            }
+
+        } else {
+            throw cet::exception("GEOM")
+                << "Unrecognized option for interpolation into the BField: " << _interpStyle
+                << "\n";
+        }
+        result *= _scaleFactor;
+        return retval;
+    }
+
+    bool BFGridMap::getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector& testpoint,
+                                                   CLHEP::Hep3Vector& result,
+                                                   CLHEP::Hep3Vector gradient[3]) const {
+        bool retval(false);
+
+        if (_interpStyle == BFInterpolationStyle::trilinear) {
+            retval = interpolateTriLinear(testpoint, result, gradient);
+
+        } else if (_interpStyle == BFInterpolationStyle::compact) {
+            retval = _compact.interpolate(testpoint, result, gradient);
+
         } else {
             throw cet::exception("GEOM")
                 << "Unrecognized option for interpolation into the BField: " << _interpStyle
                 << "\n";
         }
+        if (!retval && _warnIfOutside) {
+            mf::LogWarning("GEOM")
+                << "Point is outside of the valid region of the map: " << _key << "\n"
+                << "Point in input coordinates: " << testpoint << "\n";
+        }
         result *= _scaleFactor;
+        for (int j = 0; j != 3; ++j) {
+            gradient[j] *= _scaleFactor;
+        }
         return retval;
     }
 
+    std::size_t BFGridMap::getBFieldsWithStatus(std::size_t n,
+                                                const CLHEP::Hep3Vector* points,
+                                                CLHEP::Hep3Vector* fields,
+                                                bool* status) const {
+        if (_interpStyle != BFInterpolationStyle::compact) {
+            return BFMap::getBFieldsWithStatus(n, points, fields, status);
+        }
+
+        // Transpose to coordinate arrays in chunks that fit on the stack.
+        static constexpr std::size_t chunk = 64;
+        double x[chunk], y[chunk], z[chunk], bx[chunk], by[chunk], bz[chunk];
+        std::size_t nvalid(0);
+        for (std::size_t i0 = 0; i0 < n; i0 += chunk) {
+            std::size_t const m = std::min(chunk, n - i0);
+            for (std::size_t i = 0; i != m; ++i) {
+                x[i] = points[i0 + i].x();
+                y[i] = points[i0 + i].y();
+                z[i] = points[i0 + i].z();
+            }
+            _compact.interpolate(m, x, y, z, bx, by, bz, status + i0);
+            for (std::size_t i = 0; i != m; ++i) {
+                fields[i0 + i].set(bx[i] * _scaleFactor, by[i] * _scaleFactor,
+                                   bz[i] * _scaleFactor);
+                nvalid += status[i0 + i];
+            }
+        }
+        if (_warnIfOutside && nvalid != n) {
+            mf::LogWarning("GEOM") << n - nvalid
+                                   << " points are outside of the valid region of the map: "
+                                   << _key << "\n";
+        }
+        return nvalid;
+    }
+
     // The algorithm is:
     // Find the grid cube in which the point lives - this defines eight corner points.
     // Assign a weight to each corner that is the "distance" to each corner - see below for
@@ -232,6 +332,87 @@ namespace mu2e {
     }
 
 
+    // The same interpolation as above, differentiated within the cell:
+    // gradient[j] = dB/dx_j.  The derivatives are those of the trilinear form,
+    // so they are constant along each axis inside a cell and change at its faces.
+    bool BFGridMap::interpolateTriLinear(const CLHEP::Hep3Vector& p,
+                                         CLHEP::Hep3Vector& result,
+                                         CLHEP::Hep3Vector gradient[3]) const {
+        double px = p.x();
+        double py = p.y();
+        if (_flipy)
+            py = std::abs(p.y());
+        double pz = p.z();
+
+        // Indicies into each dimension;
+        int i = floor((px - _xmin) / _dx);
+        int j = floor((py - _ymin) / _dy);
+        int k = floor((pz - _zmin) / _dz);
+
+        // Check that we are inside the map.
+        if (i < 0 || i >= int(_nx) || j < 0 || j >= int(_ny) || k < 0 || k >= int(_nz)) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            for (int n = 0; n != 3; ++n) {
+                gradient[n] = CLHEP::Hep3Vector(0., 0., 0.);
+            }
+            return false;
+        }
+
+        // Points on the upper edge use the last cell.
+        i = std::min(i, int(_nx) - 2);
+        j = std::min(j, int(_ny) - 2);
+        k = std::min(k, int(_nz) - 2);
+
+        // Fractional position inside the cell.
+        double tx = (px - _xmin - i * _dx) / _dx;
+        double ty = (py - _ymin - j * _dy) / _dy;
+        double tz = (pz - _zmin - k * _dz) / _dz;
+
+        CLHEP::Hep3Vector b;
+        CLHEP::Hep3Vector g[3];
+        for (int c = 0; c != 8; ++c) {
+            int di = c >> 2;
+            int dj = (c >> 1) & 1;
+            int dk = c & 1;
+            double wx = di ? tx : 1.0 - tx;
+            double wy = dj ? ty : 1.0 - ty;
+            double wz = dk ? tz : 1.0 - tz;
+            CLHEP::Hep3Vector const& corner = _field(i + di, j + dj, k + dk);
+            b += wx * wy * wz * corner;
+            g[0] += (di ? 1.0 : -1.0) * wy * wz / _dx * corner;
+            g[1] += wx * (dj ? 1.0 : -1.0) * wz / _dy * corner;
+            g[2] += wx * wy * (dk ? 1.0 : -1.0) / _dz * corner;
+        }
+
+        // Reflected point: the terms with exactly one y (a y component or
+        // a y derivative) change sign.
+        if (_flipy && p.y() < 0) {
+            b.setY(-b.y());
+            g[0].setY(-g[0].y());
+            g[2].setY(-g[2].y());
+            g[1].setX(-g[1].x());
+            g[1].setZ(-g[1].z());
+        }
+
+        result = b;
+        for (int n = 0; n != 3; ++n) {
+            gradient[n] = g[n];
+        }
+        return true;
+    }
+
+    BFCompactGrid BFGridMap::makeCompactGrid() const {
+        BFCompactGrid grid(_nx, _xmin, _dx, _ny, _ymin, _dy, _nz, _zmin, _dz, _flipy);
+        for (unsigned ix = 0; ix != _nx; ++ix) {
+            for (unsigned iy = 0; iy != _ny; ++iy) {
+                for (unsigned iz = 0; iz != _nz; ++iz) {
+                    grid.set(ix, iy, iz, _field(ix, iy, iz));
+                }
+            }
+        }
+        return grid;
+    }
+
     bool BFGridMap::getNeighborPointBF(const CLHEP::Hep3Vector& testpoint,
                                        CLHEP::Hep3Vector neighborPoints[3],
                                        CLHEP::Hep3Vector neighborBF[3][3][3]) const {
@@ -340,12 +521,20 @@ namespace mu2e {
              << endl;
         cout << "Distance:       " << _dx << " " << _dy << " " << _dz << endl;
 
+        if (_mapping) {
+            cout << "Field values mapped from: " << _mapping->filename() << endl;
+        }
+
         cout << "Field at the edges: " << _field(0, 0, 0) << ", " << _field(_nx - 1, 0, 0) << ", "
              << _field(0, _ny - 1, 0) << ", " << _field(0, 0, _nz - 1) << ", "
              << _field(_nx - 1, _ny - 1, 0) << ", " << _field(_nx - 1, _ny - 1, _nz - 1) << endl;
 
         cout << "Field in the middle: " << _field(_nx / 2, _ny / 2, _nz / 2) << endl;
 
+        if (_interpStyle == BFInterpolationStyle::compact) {
+            cout << "Compact grid size: " << _compact.memorySize() << " bytes" << endl;
+        }
+
         if (_warnIfOutside) {
             cout << "Will warn if outside of the valid region." << endl;
         } else {
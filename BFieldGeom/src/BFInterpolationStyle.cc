@@ -24,6 +24,7 @@ namespace mu2e {
             nam[unused] = "unused";
             nam[trilinear] = "trilinear";
             nam[fit] = "fit";
+            nam[compact] = "compact";
         }
 
         return nam;
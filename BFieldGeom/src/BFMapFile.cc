@@ -0,0 +1,217 @@
+//
+// Versioned, checksummed binary file format for one grid field map, read by
+// mapping the file into memory.
+//
+
+// C++ includes
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+// Includes from C ( needed for block IO and mmap ).
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
+
+// Other includes
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+    namespace {
+
+        static_assert(std::is_standard_layout<BFMapFileHeader>::value,
+                      "BFMapFileHeader is written to disk as is");
+        static_assert(sizeof(CLHEP::Hep3Vector) == 3 * sizeof(double),
+                      "the field values are written to disk as is");
+
+        const char magicNumber[8] = {'M', 'U', '2', 'E', 'B', 'F', 'M', '\0'};
+        const std::uint32_t endianMarker = 0XDEADBEEF;
+
+        // The field values start on a page boundary of the file.
+        const std::uint64_t dataAlignment = 4096;
+
+        std::size_t checkedBytes() { return offsetof(BFMapFileHeader, headerChecksum); }
+
+        // Write all of the buffer, or throw.
+        void writeAll(int fd, void const* buf, std::size_t nbytes, std::string const& filename) {
+            char const* p = static_cast<char const*>(buf);
+            while (nbytes > 0) {
+                ssize_t s = ::write(fd, p, nbytes);
+                if (s < 0) {
+                    if (errno == EINTR) continue;
+                    int errsave = errno;
+                    throw cet::exception("GEOM") << "BFMapFile: Error writing to " << filename
+                                                 << "  errno: " << errsave << " "
+                                                 << strerror(errsave) << "\n";
+                }
+                p += s;
+                nbytes -= s;
+            }
+        }
+
+    }  // end anonymous namespace
+
+    std::uint64_t BFMapFile::checksum(void const* data, std::size_t nbytes) {
+        const std::uint64_t prime = 0x100000001b3ULL;
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        unsigned char const* p = static_cast<unsigned char const*>(data);
+        std::size_t const nwords = nbytes / sizeof(std::uint64_t);
+        for (std::size_t i = 0; i != nwords; ++i) {
+            std::uint64_t w;
+            std::memcpy(&w, p + i * sizeof(w), sizeof(w));
+            h = (h ^ w) * prime;
+        }
+        for (std::size_t i = nwords * sizeof(std::uint64_t); i != nbytes; ++i) {
+            h = (h ^ p[i]) * prime;
+        }
+        return h;
+    }
+
+    BFMapFileHeader BFMapFile::makeHeader() {
+        BFMapFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, magicNumber, sizeof(header.magic));
+        header.version = currentVersion;
+        header.endian = endianMarker;
+        header.headerSize = sizeof(BFMapFileHeader);
+        header.valueSize = sizeof(CLHEP::Hep3Vector);
+        return header;
+    }
+
+    BFMapFile::BFMapFile(std::string const& filename, bool verify) : _filename(filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            int errsave = errno;
+            throw cet::exception("GEOM") << "BFMapFile: Error opening " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        struct stat info;
+        if (fstat(fd, &info)) {
+            int errsave = errno;
+            close(fd);
+            throw cet::exception("GEOM") << "BFMapFile: Error doing fstat() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+        _size = info.st_size;
+        if (_size < sizeof(BFMapFileHeader)) {
+            close(fd);
+            throw cet::exception("GEOM") << "BFMapFile: the file " << filename
+                                         << " is too short to hold a header: " << _size
+                                         << " bytes\n";
+        }
+
+        // Read-only and shared: the pages come straight from the page cache.
+        _address = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        int errsave = errno;
+        close(fd);
+        if (_address == MAP_FAILED) {
+            _address = nullptr;
+            throw cet::exception("GEOM") << "BFMapFile: Error doing mmap() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+        _header = static_cast<BFMapFileHeader const*>(_address);
+
+        // Check the header before trusting any of its contents.  On error the
+        // destructor is not called, so release the mapping here; the messages
+        // use a copy of the header.
+        BFMapFileHeader const h = *_header;
+        auto fail = [this]() -> cet::exception {
+            munmap(_address, _size);
+            _address = nullptr;
+            return cet::exception("GEOM");
+        };
+        if (std::memcmp(h.magic, magicNumber, sizeof(magicNumber)) != 0) {
+            throw fail() << "BFMapFile: the file " << filename
+                         << " is not a Mu2e mapped field map file\n";
+        }
+        if (h.endian != endianMarker) {
+            throw fail() << "BFMapFile: endian mismatch in " << filename
+                         << "  returned value: " << std::hex << h.endian
+                         << "  expected value: " << endianMarker << std::dec << "\n";
+        }
+        if (h.version != currentVersion) {
+            throw fail() << "BFMapFile: the file " << filename << " has format version "
+                         << h.version << "; this release reads version "
+                         << currentVersion << "\n";
+        }
+        if (h.headerSize != sizeof(BFMapFileHeader) ||
+            h.headerChecksum != checksum(&h, checkedBytes())) {
+            throw fail() << "BFMapFile: corrupt header in " << filename << "\n";
+        }
+        std::uint64_t const npoints = std::uint64_t(h.nx) * h.ny * h.nz;
+        if (h.valueSize != sizeof(CLHEP::Hep3Vector) ||
+            h.dataSize != npoints * sizeof(CLHEP::Hep3Vector) ||
+            h.dataOffset % dataAlignment != 0 ||
+            h.dataOffset + h.dataSize != _size) {
+            throw fail() << "BFMapFile: the size = " << _size << " of the file " << filename
+                         << " does not match its header: " << h.nx << " x "
+                         << h.ny << " x " << h.nz << " points at offset "
+                         << h.dataOffset << "\n";
+        }
+
+        char const* base = static_cast<char const*>(_address);
+        _field = reinterpret_cast<CLHEP::Hep3Vector const*>(base + h.dataOffset);
+
+        if (verify && checksum(_field, h.dataSize) != h.dataChecksum) {
+            throw fail() << "BFMapFile: checksum mismatch for the field values in " << filename
+                         << "\n";
+        }
+    }
+
+    BFMapFile::~BFMapFile() {
+        if (_address != nullptr) {
+            munmap(_address, _size);
+        }
+    }
+
+    void BFMapFile::write(std::string const& filename,
+                          BFMapFileHeader header,
+                          CLHEP::Hep3Vector const* field) {
+        std::uint64_t const npoints = std::uint64_t(header.nx) * header.ny * header.nz;
+        header.dataSize = npoints * sizeof(CLHEP::Hep3Vector);
+        header.dataOffset =
+            (sizeof(BFMapFileHeader) + dataAlignment - 1) / dataAlignment * dataAlignment;
+        header.dataChecksum = checksum(field, header.dataSize);
+        header.headerChecksum = checksum(&header, checkedBytes());
+
+        std::cout << "Writing magnetic field map in mapped binary format to file: " << filename
+                  << std::endl;
+
+        // Never overwrite a map in place: processes may have it mapped.
+        mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+        int flags = O_CREAT | O_WRONLY | O_TRUNC | O_EXCL;
+        int fd = open(filename.c_str(), flags, mode);
+        if (fd < 0) {
+            int errsave = errno;
+            if (errsave == EEXIST) {
+                throw cet::exception("GEOM") << "BFMapFile: Error opening " << filename
+                                             << "  File already exists.\n";
+            }
+            throw cet::exception("GEOM") << "BFMapFile: Error opening " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        std::vector<char> padding(header.dataOffset - sizeof(BFMapFileHeader), 0);
+        writeAll(fd, &header, sizeof(header), filename);
+        writeAll(fd, padding.data(), padding.size(), filename);
+        writeAll(fd, field, header.dataSize, filename);
+        close(fd);
+
+        std::cout << "Writing complete for file: " << filename << std::endl;
+    }
+
+}  // end namespace mu2e
@@ -5,6 +5,7 @@
 // Modified by Brian Pollack to allow for polymorphic BField class.
 
 // Includes from C++
+#include <algorithm>
 #include <iostream>
 
 // Framework includes
@@ -42,6 +43,74 @@ namespace mu2e {
     }
 
 
+    bool BFieldManager::getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector& point,
+                                                       CLHEP::Hep3Vector& result,
+                                                       CLHEP::Hep3Vector gradient[3]) const {
+        return getBFieldAndGradientWithStatus(point, cm_, result, gradient);
+    }
+
+
+    bool BFieldManager::getBFieldAndGradientWithStatus(const CLHEP::Hep3Vector& point,
+                                                       BFCacheManager const& cmgr,
+                                                       CLHEP::Hep3Vector& result,
+                                                       CLHEP::Hep3Vector gradient[3]) const {
+        auto m = cmgr.findMap(point);
+
+        if (m) {
+            m->getBFieldAndGradientWithStatus(point, result, gradient);
+        } else {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            for (int j = 0; j != 3; ++j) {
+                gradient[j] = CLHEP::Hep3Vector(0., 0., 0.);
+            }
+        }
+
+        return (m != 0);
+    }
+
+
+    std::size_t BFieldManager::getBFieldsWithStatus(std::size_t n,
+                                                    const CLHEP::Hep3Vector* points,
+                                                    CLHEP::Hep3Vector* fields,
+                                                    bool* status) const {
+        return getBFieldsWithStatus(n, points, cm_, fields, status);
+    }
+
+
+    std::size_t BFieldManager::getBFieldsWithStatus(std::size_t n,
+                                                    const CLHEP::Hep3Vector* points,
+                                                    BFCacheManager const& cmgr,
+                                                    CLHEP::Hep3Vector* fields,
+                                                    bool* status) const {
+        std::size_t nvalid(0);
+        std::size_t i(0);
+        while (i < n) {
+            auto m = cmgr.findMap(points[i]);
+            if (!m) {
+                fields[i] = CLHEP::Hep3Vector(0., 0., 0.);
+                status[i] = false;
+                ++i;
+                continue;
+            }
+
+            // Inner maps do not overlap and take precedence over the outer maps, so
+            // the following points inside the same inner map would resolve to it too.
+            // Outer maps may be shadowed by an inner map: look those up point by point.
+            std::size_t j(i + 1);
+            if (std::find(innerMaps_.begin(), innerMaps_.end(), m) != innerMaps_.end()) {
+                while (j < n && m->isValid(points[j])) {
+                    ++j;
+                }
+            }
+            m->getBFieldsWithStatus(j - i, points + i, fields + i, status + i);
+            std::fill(status + i, status + j, true);
+            nvalid += j - i;
+            i = j;
+        }
+        return nvalid;
+    }
+
+
   BFieldManager::BFieldManager(MapContainerType const& innerMaps,
                                MapContainerType const& outerMaps):
     innerMaps_(innerMaps),outerMaps_(outerMaps) {
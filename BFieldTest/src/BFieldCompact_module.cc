@@ -0,0 +1,173 @@
+//
+// Regression test for the compact interpolation style of BFGridMap.
+//
+// For each named grid map, draw random points uniformly over the volume of the
+// map and compare the field from the double precision trilinear interpolation
+// with the field from the single precision, blocked copy of the same map
+// (BFCompactGrid).  The job fails if any component differs by more than
+// the tolerance (tesla).  The float rounding of the stored field values bounds
+// the difference at about 1e-7 relative to the field in the cell, so the
+// default tolerance of 1e-6 T leaves a wide margin for fields up to 5 T.
+//
+// The time spent in each of the two interpolations is also printed.
+//
+// The work is done in the beginRun member function.
+// The magnetic field map may depend on run number so it is
+// not available at c'to time or beginJob time.
+//
+
+#include "Offline/BFieldGeom/inc/BFCompactGrid.hh"
+#include "Offline/BFieldGeom/inc/BFGridMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+#include "Offline/GeometryService/inc/GeomHandle.hh"
+#include "Offline/SeedService/inc/SeedService.hh"
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Find the named map; it must be a grid map.
+    mu2e::BFGridMap const& getGridMap(std::string const& mapName) {
+        mu2e::GeomHandle<mu2e::BFieldManager> bfmgr;
+
+        for (auto const* maps : {&bfmgr->getInnerMaps(), &bfmgr->getOuterMaps()}) {
+            for (auto const& map : *maps) {
+                if (map->getKey() == mapName) {
+                    auto const* gmap = dynamic_cast<mu2e::BFGridMap const*>(map.get());
+                    if (gmap == nullptr) {
+                        throw cet::exception("GEOM")
+                            << "BFieldCompact: the map named: " << mapName
+                            << " is not a grid map.\n";
+                    }
+                    return *gmap;
+                }
+            }
+        }
+
+        throw cet::exception("GEOM")
+            << "BFieldCompact: cannot find the map named: " << mapName << "\n";
+    }
+
+}  // end anonymous namespace
+
+namespace mu2e {
+
+    class BFieldCompact : public art::EDAnalyzer {
+       public:
+        explicit BFieldCompact(const fhicl::ParameterSet& pset);
+
+        void beginRun(const art::Run& run) override;
+        void analyze(const art::Event&) override {}
+
+       private:
+        // Names of maps to check
+        std::vector<std::string> mapNames_;
+
+        // Number of test points to draw.
+        int nPoints_;
+
+        // Maximum allowed difference for each field component, in tesla.
+        double tolerance_;
+
+        // Uniform flat random distribution.
+        CLHEP::RandFlat flat_;
+
+        void check(BFGridMap const& map);
+    };
+
+}  // namespace mu2e
+
+mu2e::BFieldCompact::BFieldCompact(const fhicl::ParameterSet& pset)
+    : art::EDAnalyzer(pset),
+      mapNames_(pset.get<std::vector<std::string>>("mapNames")),
+      nPoints_(pset.get<int>("nPoints")),
+      tolerance_(pset.get<double>("tolerance", 1.e-6)),
+      flat_(createEngine(art::ServiceHandle<mu2e::SeedService>()->getSeed())) {}
+
+void mu2e::BFieldCompact::beginRun(const art::Run& run) {
+    for (auto const& name : mapNames_) {
+        check(getGridMap(name));
+    }
+}
+
+void mu2e::BFieldCompact::check(BFGridMap const& map) {
+    if (map.interpolationStyle() != BFInterpolationStyle::trilinear) {
+        throw cet::exception("GEOM")
+            << "BFieldCompact: the map " << map.getKey()
+            << " must use the trilinear interpolation style as the reference. Found: "
+            << map.interpolationStyle() << "\n";
+    }
+
+    BFCompactGrid const grid = map.makeCompactGrid();
+
+    // Random points, uniformly distributed over the volume of the map.
+    std::vector<double> x(nPoints_), y(nPoints_), z(nPoints_);
+    for (int i = 0; i < nPoints_; ++i) {
+        x[i] = flat_.fire(map.xmin(), map.xmax());
+        y[i] = flat_.fire(map.ymin(), map.ymax());
+        z[i] = flat_.fire(map.zmin(), map.zmax());
+    }
+
+    // Reference: double precision trilinear interpolation, one point per call.
+    std::vector<CLHEP::Hep3Vector> bref(nPoints_);
+    std::vector<char> sref(nPoints_);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < nPoints_; ++i) {
+        sref[i] = map.getBFieldWithStatus(CLHEP::Hep3Vector(x[i], y[i], z[i]), bref[i]);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // Compact grid, all points in one call.
+    std::vector<double> bx(nPoints_), by(nPoints_), bz(nPoints_);
+    std::unique_ptr<bool[]> status(new bool[nPoints_]);
+    grid.interpolate(nPoints_, x.data(), y.data(), z.data(), bx.data(), by.data(), bz.data(),
+                     status.get());
+    auto t2 = std::chrono::steady_clock::now();
+
+    double maxDiff(0.);
+    int nBad(0);
+    for (int i = 0; i < nPoints_; ++i) {
+        CLHEP::Hep3Vector b(bx[i], by[i], bz[i]);
+        b *= map.scaleFactor();
+        CLHEP::Hep3Vector const d = b - bref[i];
+        double const diff = std::max({std::abs(d.x()), std::abs(d.y()), std::abs(d.z())});
+        maxDiff = std::max(maxDiff, diff);
+        if (bool(sref[i]) != status[i] || diff > tolerance_) {
+            if (nBad++ < 10) {
+                std::cout << "BFieldCompact: mismatch in map " << map.getKey() << " at point ("
+                          << x[i] << ", " << y[i] << ", " << z[i] << "): trilinear " << bref[i]
+                          << " status " << bool(sref[i]) << "  compact " << b << " status "
+                          << status[i] << std::endl;
+            }
+        }
+    }
+
+    std::chrono::duration<double, std::nano> dtRef = t1 - t0;
+    std::chrono::duration<double, std::nano> dtCompact = t2 - t1;
+    std::cout << "BFieldCompact: map " << map.getKey() << " points: " << nPoints_
+              << " max |delta B|: " << maxDiff << " T"
+              << "  ns/point trilinear: " << dtRef.count() / nPoints_
+              << " compact: " << dtCompact.count() / nPoints_
+              << "  compact size: " << grid.memorySize() << " bytes" << std::endl;
+
+    if (nBad > 0) {
+        throw cet::exception("GEOM")
+            << "BFieldCompact: " << nBad << " points of map " << map.getKey()
+            << " differ by more than the tolerance of " << tolerance_ << " T\n";
+    }
+}
+
+DEFINE_ART_MODULE(mu2e::BFieldCompact)
@@ -37,6 +37,7 @@
 
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "Offline/GeneralUtilities/inc/CsvReader.hh"
@@ -120,15 +121,21 @@ namespace {
 
         mu2e::CsvReader cr(c.csv_name);
         mu2e::StringVec row;
-        double x, y, z;
+        std::vector<CLHEP::Hep3Vector> points;
         while (cr.getRow(row)) {
-            x = stod(row[0]);
-            y = stod(row[1]);
-            z = stod(row[2]);
-            CLHEP::Hep3Vector field = bfmgr.getBField(CLHEP::Hep3Vector(x, y, z));
+            points.emplace_back(stod(row[0]), stod(row[1]), stod(row[2]));
+        }
+
+        // Look up all points in one call.
+        std::vector<CLHEP::Hep3Vector> fields(points.size());
+        std::unique_ptr<bool[]> status(new bool[points.size()]);
+        bfmgr.getBFieldsWithStatus(points.size(), points.data(), fields.data(), status.get());
 
-            std::fprintf(file, "%15.10f %15.10f %15.10f %15.10f %15.10f %15.10f\n", x, y, z,
-                         field[0], field[1], field[2]);
+        for (std::size_t i = 0; i != points.size(); ++i) {
+            CLHEP::Hep3Vector const& p = points[i];
+            CLHEP::Hep3Vector const& field = fields[i];
+            std::fprintf(file, "%15.10f %15.10f %15.10f %15.10f %15.10f %15.10f\n", p.x(), p.y(),
+                         p.z(), field[0], field[1], field[2]);
         }
     }
 
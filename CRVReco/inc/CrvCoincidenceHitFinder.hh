@@ -0,0 +1,110 @@
+#ifndef CrvCoincidenceHitFinder_h
+#define CrvCoincidenceHitFinder_h
+//
+// The hit filtering, clustering, and coincidence search of the CrvCoincidenceFinder.
+//
+// The hits are kept in vectors. For the filtering, the hits are sorted by layer, counter, and time,
+// so that only the hits of the same and the adjacent counters within the time window get compared.
+// For the clustering, the hits are sorted by time, and the neighbors of each hit added to a cluster
+// are found within the time window. The clusters (and the order of the hits within the clusters)
+// are the same as with the repeated scans of the list of unused hits done before.
+//
+// Original Author: Ralf Ehrlich
+
+#include "Offline/RecoDataProducts/inc/CrvRecoPulse.hh"
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <vector>
+
+namespace mu2e
+{
+  class CrvCoincidenceHitFinder
+  {
+    public:
+
+    struct CrvHit
+    {
+      art::Ptr<CrvRecoPulse> _crvRecoPulse;
+      CLHEP::Hep3Vector      _pos;
+      double _x, _y;
+      double _time, _timePulseStart, _timePulseEnd;
+      double _PEs;
+      int    _crvSector;
+      int    _layer;
+      int    _counter;
+      int    _SiPM;
+      int    _PEthreshold;
+      double _maxTimeDifferenceAdjacentPulses;
+      double _maxTimeDifference;
+      double _minOverlapTimeAdjacentPulses;
+      double _minOverlapTime;
+      double _minSlope, _maxSlope, _maxSlopeDifference;
+      int    _coincidenceLayers;
+      double _minClusterPEs;
+      mutable double _maxDistance; //initially set to initialClusterMaxDistance, which is just an estimate
+                                   //used for the initial clustering process (to keep the number of
+                                   //hit combinations down that need to be checked for coincidendes).
+                                   //_maxDistance is updated when the coindidences are checked
+                                   //(used for the final clustering process)
+
+      CrvHit(const art::Ptr<CrvRecoPulse> crvRecoPulse, const CLHEP::Hep3Vector &pos,
+             double x, double y, double time, double timePulseStart, double timePulseEnd,
+             double PEs, int crvSector, int layer, int counter, int SiPM, int PEthreshold,
+             double maxTimeDifferenceAdjacentPulses, double maxTimeDifference,
+             double minOverlapTimeAdjacentPulses, double minOverlapTime,
+             double minSlope, double maxSlope, double maxSlopeDifference, int coincidenceLayers, double minClusterPEs, double maxDistance) :
+               _crvRecoPulse(crvRecoPulse), _pos(pos),
+               _x(x), _y(y), _time(time), _timePulseStart(timePulseStart), _timePulseEnd(timePulseEnd),
+               _PEs(PEs), _crvSector(crvSector), _layer(layer), _counter(counter), _SiPM(SiPM), _PEthreshold(PEthreshold),
+               _maxTimeDifferenceAdjacentPulses(maxTimeDifferenceAdjacentPulses), _maxTimeDifference(maxTimeDifference),
+               _minOverlapTimeAdjacentPulses(minOverlapTimeAdjacentPulses), _minOverlapTime(minOverlapTime),
+               _minSlope(minSlope), _maxSlope(maxSlope), _maxSlopeDifference(maxSlopeDifference), _coincidenceLayers(coincidenceLayers),
+               _minClusterPEs(minClusterPEs), _maxDistance(maxDistance) {}
+    };
+
+    CrvCoincidenceHitFinder(bool usePulseOverlaps, size_t bigClusterThreshold);
+
+    //remove hits below the PE threshold (the hits keep their order)
+    void filterHits(const std::vector<CrvHit> &hits, std::vector<CrvHit> &hitsFiltered);
+    //distribute the hits into clusters of hits close in space and time
+    void findClusters(const std::vector<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
+                      double clusterMaxTimeDifference, double clusterMinOverlapTime);
+    //add the hits of a cluster (of one readout side) belonging to coincidences to coincidenceHits
+    void checkCoincidence(const std::vector<CrvHit> &hits, std::vector<CrvHit> &coincidenceHits);
+
+    private:
+    CrvCoincidenceHitFinder();
+    bool checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n);
+    //true, if no coincidence can contain both hits, because they are too far apart in time
+    bool outOfTime(const CrvHit &a, const CrvHit &b) const;
+    //time used to sort the hits: the pulse start with the overlap option, the pulse time otherwise
+    double sortTime(const CrvHit &hit) const {return _usePulseOverlaps ? hit._timePulseStart : hit._time;}
+    //fill _maxPulseEnd[begin,end) for the hits in _sorted[begin,end)
+    void   fillMaxPulseEnd(const std::vector<CrvHit> &hits, size_t begin, size_t end);
+
+    bool   _usePulseOverlaps;
+    size_t _bigClusterThreshold;
+
+    //largest time difference and smallest overlap time of all hits in the current coincidence check
+    double _coincidenceMaxTimeDifference;
+    double _coincidenceMinOverlapTime;
+
+    //hit indices sorted by time (sorted by layer and counter first for the filter),
+    //and the largest pulse end of the hits sorted up to each entry (within a counter for the filter).
+    //the hits of a counter are _sorted[_counterBegin[i]] ... _sorted[_counterBegin[i+1]-1]
+    std::vector<size_t> _sorted;
+    std::vector<double> _maxPulseEnd;
+    std::vector<size_t> _counterBegin;
+    std::vector<bool>   _passed;
+    //for the clustering: hits already in a cluster, hits which will be added to the current cluster
+    //(in this scan and in the next scan of the unused hits)
+    std::vector<bool>     _used;
+    std::vector<unsigned> _touched;
+    std::vector<size_t>   _thisScan, _nextScan;
+    std::vector<size_t>   _adjacent;
+  };
+}
+
+#endif
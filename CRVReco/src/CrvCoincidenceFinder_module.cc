@@ -5,6 +5,7 @@
 
 #include "Offline/CRVConditions/inc/CRVStatus.hh"
 #include "Offline/CosmicRayShieldGeom/inc/CosmicRayShield.hh"
+#include "Offline/CRVReco/inc/CrvCoincidenceHitFinder.hh"
 #include "Offline/CRVReco/inc/CrvHelper.hh"
 #include "Offline/DataProducts/inc/CRSScintillatorBarIndex.hh"
 #include "Offline/DataProducts/inc/CRVId.hh"
@@ -123,54 +124,12 @@ namespace mu2e
     };
     std::map<int,sectorCoincidenceProperties> _sectorMap;
 
-    struct CrvHit
-    {
-      art::Ptr<CrvRecoPulse> _crvRecoPulse;
-      CLHEP::Hep3Vector      _pos;
-      double _x, _y;
-      double _time, _timePulseStart, _timePulseEnd;
-      double _PEs;
-      int    _crvSector;
-      int    _layer;
-      int    _counter;
-      int    _SiPM;
-      int    _PEthreshold;
-      double _maxTimeDifferenceAdjacentPulses;
-      double _maxTimeDifference;
-      double _minOverlapTimeAdjacentPulses;
-      double _minOverlapTime;
-      double _minSlope, _maxSlope, _maxSlopeDifference;
-      int    _coincidenceLayers;
-      double _minClusterPEs;
-      mutable double _maxDistance; //initially set to initialClusterMaxDistance, which is just an estimate
-                                   //used for the initial clustering process (to keep the number of
-                                   //hit combinations down that need to be checked for coincidendes).
-                                   //_maxDistance is updated when the coindidences are checked
-                                   //(used for the final clustering process)
-
-      CrvHit(const art::Ptr<CrvRecoPulse> crvRecoPulse, const CLHEP::Hep3Vector &pos,
-             double x, double y, double time, double timePulseStart, double timePulseEnd,
-             double PEs, int crvSector, int layer, int counter, int SiPM, int PEthreshold,
-             double maxTimeDifferenceAdjacentPulses, double maxTimeDifference,
-             double minOverlapTimeAdjacentPulses, double minOverlapTime,
-             double minSlope, double maxSlope, double maxSlopeDifference, int coincidenceLayers, double minClusterPEs, double maxDistance) :
-               _crvRecoPulse(crvRecoPulse), _pos(pos),
-               _x(x), _y(y), _time(time), _timePulseStart(timePulseStart), _timePulseEnd(timePulseEnd),
-               _PEs(PEs), _crvSector(crvSector), _layer(layer), _counter(counter), _SiPM(SiPM), _PEthreshold(PEthreshold),
-               _maxTimeDifferenceAdjacentPulses(maxTimeDifferenceAdjacentPulses), _maxTimeDifference(maxTimeDifference),
-               _minOverlapTimeAdjacentPulses(minOverlapTimeAdjacentPulses), _minOverlapTime(minOverlapTime),
-               _minSlope(minSlope), _maxSlope(maxSlope), _maxSlopeDifference(maxSlopeDifference), _coincidenceLayers(coincidenceLayers),
-               _minClusterPEs(minClusterPEs), _maxDistance(maxDistance) {}
-    };
+    typedef CrvCoincidenceHitFinder::CrvHit CrvHit;
+    CrvCoincidenceHitFinder                 _hitFinder;
 
     void clusterProperties(int crvSectorType, const std::vector<std::vector<CrvHit> > &clusters,
                            std::unique_ptr<CrvCoincidenceClusterCollection> &crvCoincidenceClusterCollection,
                            const art::Handle<CrvRecoPulseCollection> &crvRecoPulseCollection);
-    void filterHits(const std::vector<CrvHit> &hits, std::list<CrvHit> &hitsFiltered);
-    void findClusters(std::list<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
-                      double clusterMaxTimeDifference, double clusterMinOverlapTime);
-    void checkCoincidence(const std::vector<CrvHit> &hits, std::list<CrvHit> &coincidenceHits);
-    bool checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n);
 
   };
 
@@ -190,7 +149,8 @@ namespace mu2e
     _timeOffset(conf().timeOffset()),
     _compensateChannelStatus(conf().compensateChannelStatus()),
     _totalEvents(0),
-    _totalEventsCoincidence(0)
+    _totalEventsCoincidence(0),
+    _hitFinder(_usePulseOverlaps, _bigClusterThreshold)
   {
     produces<CrvCoincidenceClusterCollection>();
     //get initial cluster time parameters from coincidence parameters
@@ -348,16 +308,16 @@ namespace mu2e
       const std::vector<CrvHit> &hitsUnfiltered = sectorTypeMapIter->second;
 
       //filter hits, i.e. remove all hits below PE threshold
-      std::list<CrvHit> hitsFiltered;
-      filterHits(hitsUnfiltered, hitsFiltered);
+      std::vector<CrvHit> hitsFiltered;
+      _hitFinder.filterHits(hitsUnfiltered, hitsFiltered);
 
       //distribute the hits into clusters
       //initial clustering is done to keep the number of hit combinations down that need to be checked for coincidences
       std::vector<std::vector<CrvHit> > clusters;
-      findClusters(hitsFiltered, clusters, _initialClusterMaxTimeDifference, _initialClusterMinOverlapTime);
+      _hitFinder.findClusters(hitsFiltered, clusters, _initialClusterMaxTimeDifference, _initialClusterMinOverlapTime);
 
-      //all hits belonging to a coincidence group are collected in a new list
-      std::list<CrvHit> coincidenceHits;
+      //all hits belonging to a coincidence group are collected in a new vector
+      std::vector<CrvHit> coincidenceHits;
 
       //loop through all clusters
       for(size_t iCluster=0; iCluster<clusters.size(); ++iCluster)
@@ -372,13 +332,13 @@ namespace mu2e
 
         //check whether this hit cluster has coincidences
         //(separately for both readout sides)
-        checkCoincidence(cluster0,coincidenceHits);
-        checkCoincidence(cluster1,coincidenceHits);
+        _hitFinder.checkCoincidence(cluster0,coincidenceHits);
+        _hitFinder.checkCoincidence(cluster1,coincidenceHits);
       }//loop over all cluster in sector type
 
       //create new clusters based only on coincidence hits
       std::vector<std::vector<CrvHit> > coincidenceClusters;
-      findClusters(coincidenceHits, coincidenceClusters, _clusterMaxTimeDifference, _clusterMinOverlapTime);
+      _hitFinder.findClusters(coincidenceHits, coincidenceClusters, _clusterMaxTimeDifference, _clusterMinOverlapTime);
 
       clusterProperties(crvSectorType, coincidenceClusters, crvCoincidenceClusterCollection, crvRecoPulseCollection);
     }//loop over all sector types
@@ -585,358 +545,6 @@ namespace mu2e
     } //loop through all clusters
   } //end cluster properies
 
-
-  //remove hits below the threshold
-  void CrvCoincidenceFinder::filterHits(const std::vector<CrvHit> &hits, std::list<CrvHit> &hitsFiltered)
-  {
-    std::vector<CrvHit>::const_iterator iterHit;
-    for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
-    {
-      int    layer=iterHit->_layer;
-      int    counter=iterHit->_counter;  //counter number in one layer counted from the beginning of the counter type
-      double time=iterHit->_time;
-      double timePulseStart=iterHit->_timePulseStart;
-      double timePulseEnd=iterHit->_timePulseEnd;
-
-      int    PEthreshold=iterHit->_PEthreshold;
-      double maxTimeDifferenceAdjacentPulses=iterHit->_maxTimeDifferenceAdjacentPulses;
-      double minOverlapTimeAdjacentPulses=iterHit->_minOverlapTimeAdjacentPulses;
-
-      //check other SiPM and the SiPMs at the adjacent counters
-      double PEs_thisCounter=0;
-      double PEs_adjacentCounter1=0;
-      double PEs_adjacentCounter2=0;
-      std::vector<CrvHit>::const_iterator iterHitAdjacent;
-      for(iterHitAdjacent=hits.begin(); iterHitAdjacent!=hits.end(); ++iterHitAdjacent)
-      {
-        //use hits of the same layer only
-        if(iterHitAdjacent->_layer!=layer) continue;
-
-        //use hits within a certain time window only
-        if(!_usePulseOverlaps)
-        {
-          if(fabs(iterHitAdjacent->_time-time)>maxTimeDifferenceAdjacentPulses) continue;
-        }
-        else
-        {
-          double overlapTime=std::min(iterHitAdjacent->_timePulseEnd,timePulseEnd)-std::max(iterHitAdjacent->_timePulseStart,timePulseStart);
-          if(overlapTime<minOverlapTimeAdjacentPulses) continue; //no overlap or overlap time too short
-        }
-
-        //collect all PEs of this and the adjacent counters
-        int counterDiff=iterHitAdjacent->_counter-counter;
-        if(counterDiff==0) PEs_thisCounter+=iterHitAdjacent->_PEs;   //add PEs from the same counter (i.e. the "other" SiPM),
-                                                                     //if the "other" hit is within a certain time window (5ns)
-                                                                     //this will include PEs from the current pulse
-        if(counterDiff==-1) PEs_adjacentCounter1+=iterHitAdjacent->_PEs;  //add PEs from an adjacent counter,
-                                                                          //if these hits are within a certain time window (5ns)
-        if(counterDiff==1) PEs_adjacentCounter2+=iterHitAdjacent->_PEs;   //add PEs from an adjacent counter,
-                                                                          //if these hits are within a certain time window (5ns)
-      }
-
-      //if the number of PEs of this hit (plus the number of PEs of the same or one of the adjacent counter, if their time
-      //difference is small enough) is above the PE threshold, add this hit to vector of filtered hits
-      if(PEs_thisCounter+PEs_adjacentCounter1>=PEthreshold || PEs_thisCounter+PEs_adjacentCounter2>=PEthreshold)
-         hitsFiltered.push_back(*iterHit);
-    }
-  } //end filter hits
-
-
-  void CrvCoincidenceFinder::findClusters(std::list<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
-                                          double clusterMaxTimeDifference, double clusterMinOverlapTime)
-  {
-    while(!hits.empty()) //run through clustering processes until all hits are distributed into clusters
-    {
-      clusters.resize(clusters.size()+1); //add a new cluster
-      std::vector<CrvHit> &cluster = clusters.back();
-
-      //need to loop several times to check the unused hits until the cluster size remains stable
-      size_t lastClusterSize=0;
-      do
-      {
-        lastClusterSize=cluster.size();
-
-        for(auto hitsIter=hits.begin(); hitsIter!=hits.end(); )
-        {
-          if(cluster.empty())
-          {
-            //first element of current cluster
-            //gets moved from list of hits to the current cluster
-            cluster.push_back(*hitsIter);
-            hitsIter=hits.erase(hitsIter);
-          }
-          else
-          {
-            //check whether current hit satisfies time and distance condition w.r.t. to any hit of current cluster
-            bool erasedHit=false;
-            for(auto clusterIter=cluster.begin(); clusterIter!=cluster.end(); ++clusterIter)
-            {
-              double maxDistance = std::max(hitsIter->_maxDistance,clusterIter->_maxDistance);
-              if(_usePulseOverlaps)
-              {
-                if((std::fabs(hitsIter->_x-clusterIter->_x)<=maxDistance) &&
-                   (hitsIter->_timePulseEnd-clusterIter->_timePulseStart>clusterMinOverlapTime) &&
-                   (clusterIter->_timePulseEnd-hitsIter->_timePulseStart>clusterMinOverlapTime))
-                {
-                  //this hit satisfied the conditions
-                  //move it from list of hits to the current cluster
-                  cluster.push_back(*hitsIter);
-                  hitsIter=hits.erase(hitsIter);
-                  erasedHit=true;
-                  break;  //no need for more comparisons with other hits in current cluster, go to the next hit in list of hits
-                }
-              }
-              else
-              {
-                if((std::fabs(hitsIter->_x-clusterIter->_x)<=maxDistance) &&
-                   (std::fabs(hitsIter->_time-clusterIter->_time)<clusterMaxTimeDifference))
-                {
-                  //this hit satisfied the conditions
-                  //move it from list of hits to the current cluster
-                  cluster.push_back(*hitsIter);
-                  hitsIter=hits.erase(hitsIter);
-                  erasedHit=true;
-                  break;  //no need for more comparisons with other hits in current cluster, go to the next hit in list of hits
-                }
-              }
-            } //loop over all hits in the cluster (for comparison with current hit)
-
-            if(!erasedHit) ++hitsIter;
-
-          } //cluster not empty
-        } //loop over all undistributed hits
-
-      } while(lastClusterSize!=cluster.size()); //loop until cluster does not change anymore
-
-    } //loop until all hits in list of hits are distributed into clusters
-  } //end finder clusters
-
-
-  void CrvCoincidenceFinder::checkCoincidence(const std::vector<CrvHit> &hits, std::list<CrvHit> &coincidenceHits)
-  {
-    if(hits.empty()) return;
-
-    std::vector<CrvHit> hitsLayers[CRVId::nLayers];  //separated by layers
-    std::vector<CrvHit>::const_iterator iterHit;
-    for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
-    {
-      int    layer=iterHit->_layer;
-      hitsLayers[layer].push_back(*iterHit);
-    }
-
-    //we want to collect all hits belonging to coincidence groups,
-    //but avoid collecting hits multiple times, if they belong to different coincidence groups.
-    //can be done by placing the hit interator into a set.
-    auto setComp = [](const std::vector<CrvHit>::const_iterator &a, const std::vector<CrvHit>::const_iterator &b) {return a->_crvRecoPulse < b->_crvRecoPulse;};
-    std::set<std::vector<CrvHit>::const_iterator,decltype(setComp)> coincidenceHitSet(setComp);
-
-    int minCoincidenceLayers = std::min_element(hits.begin(),hits.end(),
-                               [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
-    int maxCoincidenceLayers = std::max_element(hits.begin(),hits.end(),
-                               [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
-
-    if(hits.size()>_bigClusterThreshold)
-    {
-      //this cluster has so many hits that it makes no sense anymore to search for individual coincidences.
-      //we still need to check that the minimum number of layers were hit to skip the coincidence check.
-      int nonEmptyLayers=0;
-      for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
-      {
-        if(!hitsLayers[iLayer].empty()) ++nonEmptyLayers;
-      }
-      if(nonEmptyLayers>=minCoincidenceLayers)
-      {
-        for(auto iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit) coincidenceHits.push_back(*iterHit);
-        return;
-      }
-    }
-
-    //***************************************************
-    //find coincidences using 2/4 coincidence requirement
-    if(minCoincidenceLayers==2)
-    {
-      std::vector<CrvHit>::const_iterator layerIterators[2];
-
-      for(int layer1=0; layer1<4; ++layer1)
-      for(int layer2=layer1+1; layer2<4; ++layer2)
-      {
-        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
-        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
-        std::vector<CrvHit>::const_iterator layer1Iter;
-        std::vector<CrvHit>::const_iterator layer2Iter;
-
-        //it will loop only, if both layers have hits
-        //loops will exit, if all three hits require a 3/4 or 4/4 coincidence
-        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
-        {
-          if(layer1Iter->_coincidenceLayers>2 && layer2Iter->_coincidenceLayers>2) continue; //all hits require at least a 3/4 coincidence
-
-          //add all both hits into one array
-          layerIterators[0]=layer1Iter;
-          layerIterators[1]=layer2Iter;
-          if(checkCombination(layerIterators,2))
-          {
-            coincidenceHitSet.insert(layer1Iter);
-            coincidenceHitSet.insert(layer2Iter);
-          }
-        }
-      }
-    }  //two layer coincidences
-
-    //***************************************************
-    //find coincidences using 3/4 coincidence requirement
-    if(minCoincidenceLayers<=3 && maxCoincidenceLayers>=3)
-    {
-      std::vector<CrvHit>::const_iterator layerIterators[3];
-
-      for(int layer1=0; layer1<4; ++layer1)
-      for(int layer2=layer1+1; layer2<4; ++layer2)
-      for(int layer3=layer2+1; layer3<4; ++layer3)
-      {
-        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
-        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
-        const std::vector<CrvHit> &layer3Hits=hitsLayers[layer3];
-        std::vector<CrvHit>::const_iterator layer1Iter;
-        std::vector<CrvHit>::const_iterator layer2Iter;
-        std::vector<CrvHit>::const_iterator layer3Iter;
-
-        //it will loop only, if all 3 layers have hits
-        //loops will exit, if all three hits require a 4/4 coincidence
-        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
-        for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
-        {
-          if(layer1Iter->_coincidenceLayers>3 && layer2Iter->_coincidenceLayers>3 && layer3Iter->_coincidenceLayers>3) continue; //all hits require at 4/4 coincidence
-
-          //add all 3 hits into one array
-          layerIterators[0]=layer1Iter;
-          layerIterators[1]=layer2Iter;
-          layerIterators[2]=layer3Iter;
-          if(checkCombination(layerIterators,3))
-          {
-            coincidenceHitSet.insert(layer1Iter);
-            coincidenceHitSet.insert(layer2Iter);
-            coincidenceHitSet.insert(layer3Iter);
-          }
-        }
-      }
-    }  //three layer coincidences
-
-    //***************************************************
-    //find coincidences using 4/4 coincidence requirement
-    if(maxCoincidenceLayers==4)
-    {
-      std::vector<CrvHit>::const_iterator layerIterators[4];
-
-      const std::vector<CrvHit> &layer0Hits=hitsLayers[0];
-      const std::vector<CrvHit> &layer1Hits=hitsLayers[1];
-      const std::vector<CrvHit> &layer2Hits=hitsLayers[2];
-      const std::vector<CrvHit> &layer3Hits=hitsLayers[3];
-      std::vector<CrvHit>::const_iterator layer0Iter;
-      std::vector<CrvHit>::const_iterator layer1Iter;
-      std::vector<CrvHit>::const_iterator layer2Iter;
-      std::vector<CrvHit>::const_iterator layer3Iter;
-
-      //it will loop only, if all 4 layers have hits
-      for(layer0Iter=layer0Hits.begin(); layer0Iter!=layer0Hits.end(); ++layer0Iter)
-      for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
-      for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
-      for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
-      {
-        //add all 4 hits into one array
-        layerIterators[0]=layer0Iter;
-        layerIterators[1]=layer1Iter;
-        layerIterators[2]=layer2Iter;
-        layerIterators[3]=layer3Iter;
-        if(checkCombination(layerIterators,4))
-        {
-          coincidenceHitSet.insert(layer0Iter);
-          coincidenceHitSet.insert(layer1Iter);
-          coincidenceHitSet.insert(layer2Iter);
-          coincidenceHitSet.insert(layer3Iter);
-        }
-      }
-    } // four layer coincidences
-
-    //move the set of coincidence hit iterators to a list of hits
-    for(auto iterHit=coincidenceHitSet.begin(); iterHit!=coincidenceHitSet.end(); ++iterHit) coincidenceHits.push_back(**iterHit);
-
-  } //end check coincidence
-
-  bool CrvCoincidenceFinder::checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n)
-  {
-    typedef const std::vector<CrvHit>::const_iterator L;
-
-    if(!_usePulseOverlaps)
-    {
-      double maxTimeDifference = (*std::max_element(layerIterators,layerIterators+n,
-                                 [](L &a, L &b){return a->_maxTimeDifference < b->_maxTimeDifference;}))->_maxTimeDifference;
-      double timeMax = (*std::max_element(layerIterators,layerIterators+n,
-                       [](L &a, L &b){return a->_time < b->_time;}))->_time;
-      double timeMin = (*std::min_element(layerIterators,layerIterators+n,
-                       [](L &a, L &b){return a->_time < b->_time;}))->_time;
-      if(timeMax-timeMin>maxTimeDifference) return false;  //hits don't fall within the time window
-    }
-    else
-    {
-      double minOverlapTime = (*std::min_element(layerIterators,layerIterators+n,
-                                 [](L &a, L &b){return a->_minOverlapTime < b->_minOverlapTime;}))->_minOverlapTime;
-      double timeMaxPulseStart = (*std::max_element(layerIterators,layerIterators+n,
-                                 [](L &a, L &b){return a->_timePulseStart < b->_timePulseStart;}))->_timePulseStart;
-      double timeMinPulseEnd   = (*std::min_element(layerIterators,layerIterators+n,
-                                 [](L &a, L &b){return a->_timePulseEnd < b->_timePulseEnd;}))->_timePulseEnd;
-      if(timeMinPulseEnd-timeMaxPulseStart<minOverlapTime) return false;  //pulses don't overlap, or overlap time too short
-    }
-
-    double minSlope = (*std::min_element(layerIterators,layerIterators+n,
-                      [](L &a, L &b){return a->_minSlope < b->_minSlope;}))->_minSlope;
-    double maxSlope = (*std::max_element(layerIterators,layerIterators+n,
-                      [](L &a, L &b){return a->_maxSlope < b->_maxSlope;}))->_maxSlope;
-    double maxSlopeDifference = (*std::max_element(layerIterators,layerIterators+n,
-                                [](L &a, L &b){return a->_maxSlopeDifference < b->_maxSlopeDifference;}))->_maxSlopeDifference;
-    std::array<double,CRVId::nLayers-1> slopes;
-    for(int d=0; d<n-1; ++d)
-    {
-      //slope = width direction / thickness direction
-      slopes[d]=(layerIterators[d+1]->_x-layerIterators[d]->_x)/(layerIterators[d+1]->_y-layerIterators[d]->_y);
-      if(slopes[d]<minSlope || slopes[d]>maxSlope) return false; //slopes need to be within minSlope and maxSlope
-    }
-
-    if(n>2)
-    {
-      if(fabs(slopes[0]-slopes[1])>maxSlopeDifference) return false;
-      if(n>3)
-      {
-        if(fabs(slopes[0]-slopes[2])>maxSlopeDifference) return false;
-        if(fabs(slopes[1]-slopes[2])>maxSlopeDifference) return false;
-      }
-    }
-
-    //need distances between subsequent positions, when ordered by position
-    std::sort(layerIterators,layerIterators+n,[](L &a, L &b){return a->_x < b->_x;});
-    for(int i=0; i<n; ++i)
-    {
-      //find the max distances between hits belonging to a coincidence group.
-      //these max distances are used later when new clusters based on coincidence hits are created,
-      //because the distance between hits belonging to a coincidence group
-      //may be greater than the original clusterMaxDistance (if it was chosen very small).
-      //this is done to avoid breaking coincidence groups apart during the next clustering process
-      if(i>0)
-      {
-        double distance=layerIterators[i]->_x-layerIterators[i-1]->_x;
-        if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
-      }
-      if(i+1<n)
-      {
-        double distance=layerIterators[i+1]->_x-layerIterators[i]->_x;
-        if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
-      }
-    }
-
-    return true; //all coincidence criteria for this combination satisfied
-  } // end checkCombination
-
 } // end namespace mu2e
 
 using mu2e::CrvCoincidenceFinder;
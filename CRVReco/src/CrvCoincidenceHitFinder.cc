@@ -0,0 +1,498 @@
+//
+// The hit filtering, clustering, and coincidence search of the CrvCoincidenceFinder.
+//
+// Original Author: Ralf Ehrlich
+
+#include "Offline/CRVReco/inc/CrvCoincidenceHitFinder.hh"
+#include "Offline/DataProducts/inc/CRVId.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <set>
+
+namespace mu2e
+{
+  CrvCoincidenceHitFinder::CrvCoincidenceHitFinder(bool usePulseOverlaps, size_t bigClusterThreshold) :
+    _usePulseOverlaps(usePulseOverlaps),
+    _bigClusterThreshold(bigClusterThreshold),
+    _coincidenceMaxTimeDifference(0),
+    _coincidenceMinOverlapTime(0)
+  {
+  }
+
+  void CrvCoincidenceHitFinder::fillMaxPulseEnd(const std::vector<CrvHit> &hits, size_t begin, size_t end)
+  {
+    for(size_t k=begin; k<end; ++k)
+    {
+      double pulseEnd=hits[_sorted[k]]._timePulseEnd;
+      _maxPulseEnd[k]=(k>begin && _maxPulseEnd[k-1]>pulseEnd ? _maxPulseEnd[k-1] : pulseEnd);
+    }
+  }
+
+  //remove hits below the threshold
+  void CrvCoincidenceHitFinder::filterHits(const std::vector<CrvHit> &hits, std::vector<CrvHit> &hitsFiltered)
+  {
+    //sort the hits by layer, counter, and time, and find where the hits of each counter start
+    _sorted.resize(hits.size());
+    std::iota(_sorted.begin(), _sorted.end(), 0);
+    std::sort(_sorted.begin(), _sorted.end(), [&](size_t a, size_t b)
+              {
+                const CrvHit &hitA=hits[a];
+                const CrvHit &hitB=hits[b];
+                if(hitA._layer!=hitB._layer) return hitA._layer<hitB._layer;
+                if(hitA._counter!=hitB._counter) return hitA._counter<hitB._counter;
+                if(sortTime(hitA)!=sortTime(hitB)) return sortTime(hitA)<sortTime(hitB);
+                return a<b;
+              });
+    _counterBegin.clear();
+    for(size_t k=0; k<_sorted.size(); ++k)
+    {
+      if(k==0 || hits[_sorted[k]]._layer!=hits[_sorted[k-1]]._layer || hits[_sorted[k]]._counter!=hits[_sorted[k-1]]._counter)
+        _counterBegin.push_back(k);
+    }
+    _counterBegin.push_back(_sorted.size());
+
+    _maxPulseEnd.resize(_sorted.size());
+    if(_usePulseOverlaps)
+    {
+      for(size_t iCounter=0; iCounter+1<_counterBegin.size(); ++iCounter) fillMaxPulseEnd(hits, _counterBegin[iCounter], _counterBegin[iCounter+1]);
+    }
+
+    //sum of the PEs of the hits of one counter within the time window of a hit.
+    //the PEs are added in the order of the hits, as when all hits were compared with each other
+    auto sumPEs = [&](const CrvHit &hit, size_t iCounter) -> double
+    {
+      size_t begin=_counterBegin[iCounter];
+      size_t end=_counterBegin[iCounter+1];
+
+      //skip the hits which are too early to be within the time window
+      size_t first=begin;
+      if(!_usePulseOverlaps)
+      {
+        first=std::partition_point(_sorted.begin()+begin, _sorted.begin()+end, [&](size_t i)
+              {return hits[i]._time<hit._time && fabs(hits[i]._time-hit._time)>hit._maxTimeDifferenceAdjacentPulses;})-_sorted.begin();
+      }
+      else
+      {
+        first=std::partition_point(_maxPulseEnd.begin()+begin, _maxPulseEnd.begin()+end, [&](double maxPulseEnd)
+              {return maxPulseEnd-hit._timePulseStart<hit._minOverlapTimeAdjacentPulses;})-_maxPulseEnd.begin();
+      }
+
+      _adjacent.clear();
+      for(size_t k=first; k<end; ++k)
+      {
+        const CrvHit &hitAdjacent=hits[_sorted[k]];
+        if(!_usePulseOverlaps)
+        {
+          if(fabs(hitAdjacent._time-hit._time)>hit._maxTimeDifferenceAdjacentPulses)
+          {
+            if(hitAdjacent._time>hit._time) break;  //this and all following hits are too late
+            continue;
+          }
+        }
+        else
+        {
+          if(hitAdjacent._timePulseStart>=hit._timePulseStart && hit._timePulseEnd-hitAdjacent._timePulseStart<hit._minOverlapTimeAdjacentPulses) break;
+          double overlapTime=std::min(hitAdjacent._timePulseEnd,hit._timePulseEnd)-std::max(hitAdjacent._timePulseStart,hit._timePulseStart);
+          if(overlapTime<hit._minOverlapTimeAdjacentPulses) continue; //no overlap or overlap time too short
+        }
+        _adjacent.push_back(_sorted[k]);
+      }
+      std::sort(_adjacent.begin(), _adjacent.end());
+
+      double PEs=0;
+      for(size_t i : _adjacent) PEs+=hits[i]._PEs;
+      return PEs;
+    };
+
+    _passed.assign(hits.size(), false);
+    for(size_t iCounter=0; iCounter+1<_counterBegin.size(); ++iCounter)
+    {
+      const CrvHit &first=hits[_sorted[_counterBegin[iCounter]]];
+      //the adjacent counters of the same layer are the neighbors in the sorted hits, if they have hits
+      bool hasCounter1=(iCounter>0 && hits[_sorted[_counterBegin[iCounter-1]]]._layer==first._layer &&
+                        hits[_sorted[_counterBegin[iCounter-1]]]._counter==first._counter-1);
+      bool hasCounter2=(iCounter+2<_counterBegin.size() && hits[_sorted[_counterBegin[iCounter+1]]]._layer==first._layer &&
+                        hits[_sorted[_counterBegin[iCounter+1]]]._counter==first._counter+1);
+
+      for(size_t k=_counterBegin[iCounter]; k<_counterBegin[iCounter+1]; ++k)
+      {
+        const CrvHit &hit=hits[_sorted[k]];
+
+        //PEs of this counter (this pulse and the pulses of the "other" SiPMs) and of the adjacent counters
+        //within a certain time window (5ns)
+        double PEs_thisCounter=sumPEs(hit, iCounter);
+        double PEs_adjacentCounter1=(hasCounter1 ? sumPEs(hit, iCounter-1) : 0);
+        double PEs_adjacentCounter2=(hasCounter2 ? sumPEs(hit, iCounter+1) : 0);
+
+        //if the number of PEs of this hit (plus the number of PEs of the same or one of the adjacent counter, if their time
+        //difference is small enough) is above the PE threshold, add this hit to vector of filtered hits
+        if(PEs_thisCounter+PEs_adjacentCounter1>=hit._PEthreshold || PEs_thisCounter+PEs_adjacentCounter2>=hit._PEthreshold)
+          _passed[_sorted[k]]=true;
+      }
+    }
+
+    for(size_t i=0; i<hits.size(); ++i)
+    {
+      if(_passed[i]) hitsFiltered.push_back(hits[i]);
+    }
+  } //end filter hits
+
+
+  void CrvCoincidenceHitFinder::findClusters(const std::vector<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
+                                             double clusterMaxTimeDifference, double clusterMinOverlapTime)
+  {
+    //sort the hits by time
+    _sorted.resize(hits.size());
+    std::iota(_sorted.begin(), _sorted.end(), 0);
+    std::sort(_sorted.begin(), _sorted.end(), [&](size_t a, size_t b)
+              {
+                if(sortTime(hits[a])!=sortTime(hits[b])) return sortTime(hits[a])<sortTime(hits[b]);
+                return a<b;
+              });
+    _maxPulseEnd.resize(_sorted.size());
+    if(_usePulseOverlaps) fillMaxPulseEnd(hits, 0, _sorted.size());
+
+    _used.assign(hits.size(), false);
+    _touched.assign(hits.size(), 0);
+    unsigned nCluster=0;
+
+    //move a hit to the current cluster, and mark the unused hits which satisfy the time and distance condition w.r.t. this hit.
+    //the list of unused hits used to be scanned until the cluster didn't change anymore, and hits were added in the order
+    //of this list. a marked hit which comes after this hit in the list is added in the same scan, otherwise in the next scan.
+    auto addHit = [&](size_t iHit, std::vector<CrvHit> &cluster)
+    {
+      _used[iHit]=true;
+      cluster.push_back(hits[iHit]);
+      const CrvHit &clusterHit=hits[iHit];
+
+      //skip the hits which are too early to be within the time window
+      size_t first=0;
+      if(!_usePulseOverlaps)
+      {
+        first=std::partition_point(_sorted.begin(), _sorted.end(), [&](size_t i)
+              {return hits[i]._time<clusterHit._time && !(std::fabs(hits[i]._time-clusterHit._time)<clusterMaxTimeDifference);})-_sorted.begin();
+      }
+      else
+      {
+        first=std::partition_point(_maxPulseEnd.begin(), _maxPulseEnd.end(), [&](double maxPulseEnd)
+              {return !(maxPulseEnd-clusterHit._timePulseStart>clusterMinOverlapTime);})-_maxPulseEnd.begin();
+      }
+
+      for(size_t k=first; k<_sorted.size(); ++k)
+      {
+        size_t i=_sorted[k];
+        const CrvHit &hit=hits[i];
+        if(!_usePulseOverlaps)
+        {
+          if(!(std::fabs(hit._time-clusterHit._time)<clusterMaxTimeDifference))
+          {
+            if(hit._time>clusterHit._time) break;  //this and all following hits are too late
+            continue;
+          }
+        }
+        else
+        {
+          if(!(clusterHit._timePulseEnd-hit._timePulseStart>clusterMinOverlapTime)) break;  //this and all following hits are too late
+          if(!(hit._timePulseEnd-clusterHit._timePulseStart>clusterMinOverlapTime)) continue;
+        }
+        if(_used[i] || _touched[i]==nCluster) continue;
+
+        double maxDistance = std::max(hit._maxDistance,clusterHit._maxDistance);
+        if(!(std::fabs(hit._x-clusterHit._x)<=maxDistance)) continue;
+
+        _touched[i]=nCluster;
+        if(i>iHit)
+        {
+          _thisScan.push_back(i);
+          std::push_heap(_thisScan.begin(), _thisScan.end(), std::greater<size_t>());
+        }
+        else _nextScan.push_back(i);
+      }
+    };
+
+    for(size_t iSeed=0; iSeed<hits.size(); ++iSeed) //run through clustering processes until all hits are distributed into clusters
+    {
+      if(_used[iSeed]) continue;
+
+      ++nCluster;
+      clusters.resize(clusters.size()+1); //add a new cluster
+      std::vector<CrvHit> &cluster = clusters.back();
+
+      //first element of current cluster is the first unused hit
+      _thisScan.clear();
+      _nextScan.clear();
+      addHit(iSeed, cluster);
+
+      //scan the unused hits until the cluster size remains stable
+      while(true)
+      {
+        while(!_thisScan.empty())
+        {
+          std::pop_heap(_thisScan.begin(), _thisScan.end(), std::greater<size_t>());
+          size_t iHit=_thisScan.back();
+          _thisScan.pop_back();
+          addHit(iHit, cluster);
+        }
+        if(_nextScan.empty()) break;
+        _thisScan.swap(_nextScan);
+        std::make_heap(_thisScan.begin(), _thisScan.end(), std::greater<size_t>());
+      }
+    } //loop until all hits are distributed into clusters
+  } //end finder clusters
+
+
+  bool CrvCoincidenceHitFinder::outOfTime(const CrvHit &a, const CrvHit &b) const
+  {
+    //the time window of a combination can only be larger, and its overlap time only shorter, than those of two of its hits
+    if(!_usePulseOverlaps) return fabs(a._time-b._time)>_coincidenceMaxTimeDifference;
+    return std::min(a._timePulseEnd,b._timePulseEnd)-std::max(a._timePulseStart,b._timePulseStart)<_coincidenceMinOverlapTime;
+  }
+
+  void CrvCoincidenceHitFinder::checkCoincidence(const std::vector<CrvHit> &hits, std::vector<CrvHit> &coincidenceHits)
+  {
+    if(hits.empty()) return;
+
+    std::vector<CrvHit> hitsLayers[CRVId::nLayers];  //separated by layers
+    std::vector<CrvHit>::const_iterator iterHit;
+    for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
+    {
+      int    layer=iterHit->_layer;
+      hitsLayers[layer].push_back(*iterHit);
+    }
+
+    //we want to collect all hits belonging to coincidence groups,
+    //but avoid collecting hits multiple times, if they belong to different coincidence groups.
+    //can be done by placing the hit interator into a set.
+    auto setComp = [](const std::vector<CrvHit>::const_iterator &a, const std::vector<CrvHit>::const_iterator &b) {return a->_crvRecoPulse < b->_crvRecoPulse;};
+    std::set<std::vector<CrvHit>::const_iterator,decltype(setComp)> coincidenceHitSet(setComp);
+
+    int minCoincidenceLayers = std::min_element(hits.begin(),hits.end(),
+                               [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
+    int maxCoincidenceLayers = std::max_element(hits.begin(),hits.end(),
+                               [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
+
+    //loosest time conditions of all hits. combinations with two hits outside these conditions get skipped.
+    _coincidenceMaxTimeDifference = std::max_element(hits.begin(),hits.end(),
+                                    [](const CrvHit &a, const CrvHit &b){return a._maxTimeDifference < b._maxTimeDifference;})->_maxTimeDifference;
+    _coincidenceMinOverlapTime    = std::min_element(hits.begin(),hits.end(),
+                                    [](const CrvHit &a, const CrvHit &b){return a._minOverlapTime < b._minOverlapTime;})->_minOverlapTime;
+
+    if(hits.size()>_bigClusterThreshold)
+    {
+      //this cluster has so many hits that it makes no sense anymore to search for individual coincidences.
+      //we still need to check that the minimum number of layers were hit to skip the coincidence check.
+      int nonEmptyLayers=0;
+      for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer)
+      {
+        if(!hitsLayers[iLayer].empty()) ++nonEmptyLayers;
+      }
+      if(nonEmptyLayers>=minCoincidenceLayers)
+      {
+        coincidenceHits.insert(coincidenceHits.end(), hits.begin(), hits.end());
+        return;
+      }
+    }
+
+    //***************************************************
+    //find coincidences using 2/4 coincidence requirement
+    if(minCoincidenceLayers==2)
+    {
+      std::vector<CrvHit>::const_iterator layerIterators[2];
+
+      for(int layer1=0; layer1<4; ++layer1)
+      for(int layer2=layer1+1; layer2<4; ++layer2)
+      {
+        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
+        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
+        std::vector<CrvHit>::const_iterator layer1Iter;
+        std::vector<CrvHit>::const_iterator layer2Iter;
+
+        //it will loop only, if both layers have hits
+        //loops will exit, if all three hits require a 3/4 or 4/4 coincidence
+        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
+        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
+        {
+          if(layer1Iter->_coincidenceLayers>2 && layer2Iter->_coincidenceLayers>2) continue; //all hits require at least a 3/4 coincidence
+
+          //add all both hits into one array
+          layerIterators[0]=layer1Iter;
+          layerIterators[1]=layer2Iter;
+          if(checkCombination(layerIterators,2))
+          {
+            coincidenceHitSet.insert(layer1Iter);
+            coincidenceHitSet.insert(layer2Iter);
+          }
+        }
+      }
+    }  //two layer coincidences
+
+    //***************************************************
+    //find coincidences using 3/4 coincidence requirement
+    if(minCoincidenceLayers<=3 && maxCoincidenceLayers>=3)
+    {
+      std::vector<CrvHit>::const_iterator layerIterators[3];
+
+      for(int layer1=0; layer1<4; ++layer1)
+      for(int layer2=layer1+1; layer2<4; ++layer2)
+      for(int layer3=layer2+1; layer3<4; ++layer3)
+      {
+        const std::vector<CrvHit> &layer1Hits=hitsLayers[layer1];
+        const std::vector<CrvHit> &layer2Hits=hitsLayers[layer2];
+        const std::vector<CrvHit> &layer3Hits=hitsLayers[layer3];
+        std::vector<CrvHit>::const_iterator layer1Iter;
+        std::vector<CrvHit>::const_iterator layer2Iter;
+        std::vector<CrvHit>::const_iterator layer3Iter;
+
+        //it will loop only, if all 3 layers have hits
+        //loops will exit, if all three hits require a 4/4 coincidence
+        for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
+        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
+        {
+          if(outOfTime(*layer1Iter,*layer2Iter)) continue;
+
+          for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
+          {
+            if(layer1Iter->_coincidenceLayers>3 && layer2Iter->_coincidenceLayers>3 && layer3Iter->_coincidenceLayers>3) continue; //all hits require at 4/4 coincidence
+
+            //add all 3 hits into one array
+            layerIterators[0]=layer1Iter;
+            layerIterators[1]=layer2Iter;
+            layerIterators[2]=layer3Iter;
+            if(checkCombination(layerIterators,3))
+            {
+              coincidenceHitSet.insert(layer1Iter);
+              coincidenceHitSet.insert(layer2Iter);
+              coincidenceHitSet.insert(layer3Iter);
+            }
+          }
+        }
+      }
+    }  //three layer coincidences
+
+    //***************************************************
+    //find coincidences using 4/4 coincidence requirement
+    if(maxCoincidenceLayers==4)
+    {
+      std::vector<CrvHit>::const_iterator layerIterators[4];
+
+      const std::vector<CrvHit> &layer0Hits=hitsLayers[0];
+      const std::vector<CrvHit> &layer1Hits=hitsLayers[1];
+      const std::vector<CrvHit> &layer2Hits=hitsLayers[2];
+      const std::vector<CrvHit> &layer3Hits=hitsLayers[3];
+      std::vector<CrvHit>::const_iterator layer0Iter;
+      std::vector<CrvHit>::const_iterator layer1Iter;
+      std::vector<CrvHit>::const_iterator layer2Iter;
+      std::vector<CrvHit>::const_iterator layer3Iter;
+
+      //it will loop only, if all 4 layers have hits
+      for(layer0Iter=layer0Hits.begin(); layer0Iter!=layer0Hits.end(); ++layer0Iter)
+      for(layer1Iter=layer1Hits.begin(); layer1Iter!=layer1Hits.end(); ++layer1Iter)
+      {
+        if(outOfTime(*layer0Iter,*layer1Iter)) continue;
+
+        for(layer2Iter=layer2Hits.begin(); layer2Iter!=layer2Hits.end(); ++layer2Iter)
+        {
+          if(outOfTime(*layer0Iter,*layer2Iter) || outOfTime(*layer1Iter,*layer2Iter)) continue;
+
+          for(layer3Iter=layer3Hits.begin(); layer3Iter!=layer3Hits.end(); ++layer3Iter)
+          {
+            //add all 4 hits into one array
+            layerIterators[0]=layer0Iter;
+            layerIterators[1]=layer1Iter;
+            layerIterators[2]=layer2Iter;
+            layerIterators[3]=layer3Iter;
+            if(checkCombination(layerIterators,4))
+            {
+              coincidenceHitSet.insert(layer0Iter);
+              coincidenceHitSet.insert(layer1Iter);
+              coincidenceHitSet.insert(layer2Iter);
+              coincidenceHitSet.insert(layer3Iter);
+            }
+          }
+        }
+      }
+    } // four layer coincidences
+
+    //move the set of coincidence hit iterators to the vector of hits
+    for(auto iterHit=coincidenceHitSet.begin(); iterHit!=coincidenceHitSet.end(); ++iterHit) coincidenceHits.push_back(**iterHit);
+
+  } //end check coincidence
+
+  bool CrvCoincidenceHitFinder::checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n)
+  {
+    typedef const std::vector<CrvHit>::const_iterator L;
+
+    if(!_usePulseOverlaps)
+    {
+      double maxTimeDifference = (*std::max_element(layerIterators,layerIterators+n,
+                                 [](L &a, L &b){return a->_maxTimeDifference < b->_maxTimeDifference;}))->_maxTimeDifference;
+      double timeMax = (*std::max_element(layerIterators,layerIterators+n,
+                       [](L &a, L &b){return a->_time < b->_time;}))->_time;
+      double timeMin = (*std::min_element(layerIterators,layerIterators+n,
+                       [](L &a, L &b){return a->_time < b->_time;}))->_time;
+      if(timeMax-timeMin>maxTimeDifference) return false;  //hits don't fall within the time window
+    }
+    else
+    {
+      double minOverlapTime = (*std::min_element(layerIterators,layerIterators+n,
+                                 [](L &a, L &b){return a->_minOverlapTime < b->_minOverlapTime;}))->_minOverlapTime;
+      double timeMaxPulseStart = (*std::max_element(layerIterators,layerIterators+n,
+                                 [](L &a, L &b){return a->_timePulseStart < b->_timePulseStart;}))->_timePulseStart;
+      double timeMinPulseEnd   = (*std::min_element(layerIterators,layerIterators+n,
+                                 [](L &a, L &b){return a->_timePulseEnd < b->_timePulseEnd;}))->_timePulseEnd;
+      if(timeMinPulseEnd-timeMaxPulseStart<minOverlapTime) return false;  //pulses don't overlap, or overlap time too short
+    }
+
+    double minSlope = (*std::min_element(layerIterators,layerIterators+n,
+                      [](L &a, L &b){return a->_minSlope < b->_minSlope;}))->_minSlope;
+    double maxSlope = (*std::max_element(layerIterators,layerIterators+n,
+                      [](L &a, L &b){return a->_maxSlope < b->_maxSlope;}))->_maxSlope;
+    double maxSlopeDifference = (*std::max_element(layerIterators,layerIterators+n,
+                                [](L &a, L &b){return a->_maxSlopeDifference < b->_maxSlopeDifference;}))->_maxSlopeDifference;
+    std::array<double,CRVId::nLayers-1> slopes;
+    for(int d=0; d<n-1; ++d)
+    {
+      //slope = width direction / thickness direction
+      slopes[d]=(layerIterators[d+1]->_x-layerIterators[d]->_x)/(layerIterators[d+1]->_y-layerIterators[d]->_y);
+      if(slopes[d]<minSlope || slopes[d]>maxSlope) return false; //slopes need to be within minSlope and maxSlope
+    }
+
+    if(n>2)
+    {
+      if(fabs(slopes[0]-slopes[1])>maxSlopeDifference) return false;
+      if(n>3)
+      {
+        if(fabs(slopes[0]-slopes[2])>maxSlopeDifference) return false;
+        if(fabs(slopes[1]-slopes[2])>maxSlopeDifference) return false;
+      }
+    }
+
+    //need distances between subsequent positions, when ordered by position
+    std::sort(layerIterators,layerIterators+n,[](L &a, L &b){return a->_x < b->_x;});
+    for(int i=0; i<n; ++i)
+    {
+      //find the max distances between hits belonging to a coincidence group.
+      //these max distances are used later when new clusters based on coincidence hits are created,
+      //because the distance between hits belonging to a coincidence group
+      //may be greater than the original clusterMaxDistance (if it was chosen very small).
+      //this is done to avoid breaking coincidence groups apart during the next clustering process
+      if(i>0)
+      {
+        double distance=layerIterators[i]->_x-layerIterators[i-1]->_x;
+        if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
+      }
+      if(i+1<n)
+      {
+        double distance=layerIterators[i+1]->_x-layerIterators[i]->_x;
+        if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
+      }
+    }
+
+    return true; //all coincidence criteria for this combination satisfied
+  } // end checkCombination
+
+} // end namespace mu2e
@@ -0,0 +1,432 @@
+//
+// Benchmark of the hit filtering, clustering, and coincidence search of the CrvCoincidenceFinder
+// on made up events (a few cosmic muons crossing all four layers on top of many noise pulses spread in time)
+// for several numbers of pulses per event, with and without the pulse overlap option.
+// The coincidence clusters are found with the CrvCoincidenceHitFinder and with the list based
+// functions used before, and checked to be identical (same hits in the same order, same max distances).
+//
+// arguments are
+// NEVENT: optional, number of events per pulse multiplicity (default 100)
+//
+// example:
+// CrvCoincidenceBench 500
+//
+// Original Author: Ralf Ehrlich
+
+#include "Offline/CRVReco/inc/CrvCoincidenceHitFinder.hh"
+#include "Offline/DataProducts/inc/CRVId.hh"
+#include "Offline/RecoDataProducts/inc/CrvRecoPulse.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace
+{
+  typedef CrvCoincidenceHitFinder::CrvHit CrvHit;
+
+  //settings of the CrvCoincidenceFinder in CRVReco/fcl/prolog_v11.fcl
+  const int    nCounters(256);
+  const double counterWidth(51.3), layerOffset(42.0), layerThickness(21.0);
+  const double initialClusterMaxDistance(250);
+  const double clusterMaxTimeDifference(60), clusterMinOverlapTime(10);
+  const double maxTimeDifferenceAdjacentPulses(10), maxTimeDifference(10);
+  const double minOverlapTimeAdjacentPulses(30), minOverlapTime(30);
+  const size_t bigClusterThreshold(800);
+  const int    PEthreshold(8);
+
+  CrvHit makeHit(const std::vector<CrvRecoPulse> &pulses, size_t index, int layer, int counter, int SiPM,
+                 double time, double timePulseStart, double timePulseEnd, float PEs)
+  {
+    //the counters are split into sections with 2/4, 3/4, and 4/4 coincidence requirements
+    int coincidenceLayers=2+(3*counter)/nCounters;
+    double x=counter*counterWidth+layer*layerOffset;
+    double y=layer*layerThickness;
+    art::Ptr<CrvRecoPulse> crvRecoPulse(art::ProductID(), &pulses.at(index), index);
+    return CrvHit(crvRecoPulse, CLHEP::Hep3Vector(x,y,0), x, y, time, timePulseStart, timePulseEnd, PEs, 0,
+                  layer, counter, SiPM, PEthreshold, maxTimeDifferenceAdjacentPulses, maxTimeDifference,
+                  minOverlapTimeAdjacentPulses, minOverlapTime, -11, 11, 4, coincidenceLayers, 0, initialClusterMaxDistance);
+  }
+
+  std::vector<CrvHit> makeEvent(std::mt19937 &gen, const std::vector<CrvRecoPulse> &pulses, int nPulses)
+  {
+    std::uniform_int_distribution<int>     counter(0,nCounters-1), layer(0,CRVId::nLayers-1), SiPM(0,3);
+    std::uniform_real_distribution<double> time(400,1700), rise(5,15), fall(20,60), flat(0,1);
+    std::exponential_distribution<float>   noisePEs(1.0/4.0);
+    std::normal_distribution<double>       jitter(0,1.5);
+
+    std::vector<CrvHit> hits;
+    //cosmic muons, with pulses at all SiPMs of the crossed counters (and sometimes at their neighbors)
+    for(int iMuon=0; iMuon<5 && (int)hits.size()<nPulses; ++iMuon)
+    {
+      int    counter0=counter(gen);
+      double slope=2.0*flat(gen)-1.0;
+      double t0=time(gen);
+      for(int iLayer=0; iLayer<static_cast<int>(CRVId::nLayers); ++iLayer)
+      {
+        int c=counter0+std::lround(slope*iLayer);
+        for(int dc=0; dc<=(flat(gen)<0.3 ? 1 : 0); ++dc)
+        {
+          if(c+dc<0 || c+dc>=nCounters) continue;
+          for(int iSiPM=0; iSiPM<4 && (int)hits.size()<nPulses; ++iSiPM)
+          {
+            double t=t0+jitter(gen);
+            hits.push_back(makeHit(pulses, hits.size(), iLayer, c+dc, iSiPM, t, t-rise(gen), t+fall(gen), (dc==0 ? 15 : 3)+30*flat(gen)));
+          }
+        }
+      }
+    }
+    //noise pulses
+    while((int)hits.size()<nPulses)
+    {
+      double t=time(gen);
+      hits.push_back(makeHit(pulses, hits.size(), layer(gen), counter(gen), SiPM(gen), t, t-rise(gen), t+fall(gen), noisePEs(gen)));
+    }
+    std::shuffle(hits.begin(), hits.end(), gen);
+    return hits;
+  }
+
+
+  //the functions of the CrvCoincidenceFinder before the CrvCoincidenceHitFinder
+  class ListFinder
+  {
+    public:
+    ListFinder(bool usePulseOverlaps) : _usePulseOverlaps(usePulseOverlaps) {}
+
+    void filterHits(const std::vector<CrvHit> &hits, std::list<CrvHit> &hitsFiltered)
+    {
+      std::vector<CrvHit>::const_iterator iterHit;
+      for(iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit)
+      {
+        double PEs_thisCounter=0;
+        double PEs_adjacentCounter1=0;
+        double PEs_adjacentCounter2=0;
+        std::vector<CrvHit>::const_iterator iterHitAdjacent;
+        for(iterHitAdjacent=hits.begin(); iterHitAdjacent!=hits.end(); ++iterHitAdjacent)
+        {
+          if(iterHitAdjacent->_layer!=iterHit->_layer) continue;
+          if(!_usePulseOverlaps)
+          {
+            if(fabs(iterHitAdjacent->_time-iterHit->_time)>iterHit->_maxTimeDifferenceAdjacentPulses) continue;
+          }
+          else
+          {
+            double overlapTime=std::min(iterHitAdjacent->_timePulseEnd,iterHit->_timePulseEnd)-std::max(iterHitAdjacent->_timePulseStart,iterHit->_timePulseStart);
+            if(overlapTime<iterHit->_minOverlapTimeAdjacentPulses) continue;
+          }
+          int counterDiff=iterHitAdjacent->_counter-iterHit->_counter;
+          if(counterDiff==0) PEs_thisCounter+=iterHitAdjacent->_PEs;
+          if(counterDiff==-1) PEs_adjacentCounter1+=iterHitAdjacent->_PEs;
+          if(counterDiff==1) PEs_adjacentCounter2+=iterHitAdjacent->_PEs;
+        }
+        if(PEs_thisCounter+PEs_adjacentCounter1>=iterHit->_PEthreshold || PEs_thisCounter+PEs_adjacentCounter2>=iterHit->_PEthreshold)
+           hitsFiltered.push_back(*iterHit);
+      }
+    }
+
+    void findClusters(std::list<CrvHit> &hits, std::vector<std::vector<CrvHit> > &clusters,
+                      double clusterMaxTimeDifference, double clusterMinOverlapTime)
+    {
+      while(!hits.empty())
+      {
+        clusters.resize(clusters.size()+1);
+        std::vector<CrvHit> &cluster = clusters.back();
+        size_t lastClusterSize=0;
+        do
+        {
+          lastClusterSize=cluster.size();
+          for(auto hitsIter=hits.begin(); hitsIter!=hits.end(); )
+          {
+            if(cluster.empty())
+            {
+              cluster.push_back(*hitsIter);
+              hitsIter=hits.erase(hitsIter);
+              continue;
+            }
+            bool erasedHit=false;
+            for(auto clusterIter=cluster.begin(); clusterIter!=cluster.end(); ++clusterIter)
+            {
+              double maxDistance = std::max(hitsIter->_maxDistance,clusterIter->_maxDistance);
+              bool inTime;
+              if(_usePulseOverlaps)
+                inTime=(hitsIter->_timePulseEnd-clusterIter->_timePulseStart>clusterMinOverlapTime) &&
+                       (clusterIter->_timePulseEnd-hitsIter->_timePulseStart>clusterMinOverlapTime);
+              else
+                inTime=(std::fabs(hitsIter->_time-clusterIter->_time)<clusterMaxTimeDifference);
+              if((std::fabs(hitsIter->_x-clusterIter->_x)<=maxDistance) && inTime)
+              {
+                cluster.push_back(*hitsIter);
+                hitsIter=hits.erase(hitsIter);
+                erasedHit=true;
+                break;
+              }
+            }
+            if(!erasedHit) ++hitsIter;
+          }
+        } while(lastClusterSize!=cluster.size());
+      }
+    }
+
+    void checkCoincidence(const std::vector<CrvHit> &hits, std::list<CrvHit> &coincidenceHits)
+    {
+      if(hits.empty()) return;
+
+      std::vector<CrvHit> hitsLayers[CRVId::nLayers];
+      for(auto iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit) hitsLayers[iterHit->_layer].push_back(*iterHit);
+
+      auto setComp = [](const std::vector<CrvHit>::const_iterator &a, const std::vector<CrvHit>::const_iterator &b) {return a->_crvRecoPulse < b->_crvRecoPulse;};
+      std::set<std::vector<CrvHit>::const_iterator,decltype(setComp)> coincidenceHitSet(setComp);
+
+      int minCoincidenceLayers = std::min_element(hits.begin(),hits.end(),
+                                 [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
+      int maxCoincidenceLayers = std::max_element(hits.begin(),hits.end(),
+                                 [](const CrvHit &a, const CrvHit &b){return a._coincidenceLayers < b._coincidenceLayers;})->_coincidenceLayers;
+
+      if(hits.size()>bigClusterThreshold)
+      {
+        int nonEmptyLayers=0;
+        for(size_t iLayer=0; iLayer<CRVId::nLayers; ++iLayer) if(!hitsLayers[iLayer].empty()) ++nonEmptyLayers;
+        if(nonEmptyLayers>=minCoincidenceLayers)
+        {
+          for(auto iterHit=hits.begin(); iterHit!=hits.end(); ++iterHit) coincidenceHits.push_back(*iterHit);
+          return;
+        }
+      }
+
+      if(minCoincidenceLayers==2)
+      {
+        std::vector<CrvHit>::const_iterator layerIterators[2];
+        for(int layer1=0; layer1<4; ++layer1)
+        for(int layer2=layer1+1; layer2<4; ++layer2)
+        for(auto layer1Iter=hitsLayers[layer1].cbegin(); layer1Iter!=hitsLayers[layer1].cend(); ++layer1Iter)
+        for(auto layer2Iter=hitsLayers[layer2].cbegin(); layer2Iter!=hitsLayers[layer2].cend(); ++layer2Iter)
+        {
+          if(layer1Iter->_coincidenceLayers>2 && layer2Iter->_coincidenceLayers>2) continue;
+          layerIterators[0]=layer1Iter;
+          layerIterators[1]=layer2Iter;
+          if(checkCombination(layerIterators,2))
+          {
+            coincidenceHitSet.insert(layer1Iter);
+            coincidenceHitSet.insert(layer2Iter);
+          }
+        }
+      }
+
+      if(minCoincidenceLayers<=3 && maxCoincidenceLayers>=3)
+      {
+        std::vector<CrvHit>::const_iterator layerIterators[3];
+        for(int layer1=0; layer1<4; ++layer1)
+        for(int layer2=layer1+1; layer2<4; ++layer2)
+        for(int layer3=layer2+1; layer3<4; ++layer3)
+        for(auto layer1Iter=hitsLayers[layer1].cbegin(); layer1Iter!=hitsLayers[layer1].cend(); ++layer1Iter)
+        for(auto layer2Iter=hitsLayers[layer2].cbegin(); layer2Iter!=hitsLayers[layer2].cend(); ++layer2Iter)
+        for(auto layer3Iter=hitsLayers[layer3].cbegin(); layer3Iter!=hitsLayers[layer3].cend(); ++layer3Iter)
+        {
+          if(layer1Iter->_coincidenceLayers>3 && layer2Iter->_coincidenceLayers>3 && layer3Iter->_coincidenceLayers>3) continue;
+          layerIterators[0]=layer1Iter;
+          layerIterators[1]=layer2Iter;
+          layerIterators[2]=layer3Iter;
+          if(checkCombination(layerIterators,3))
+          {
+            coincidenceHitSet.insert(layer1Iter);
+            coincidenceHitSet.insert(layer2Iter);
+            coincidenceHitSet.insert(layer3Iter);
+          }
+        }
+      }
+
+      if(maxCoincidenceLayers==4)
+      {
+        std::vector<CrvHit>::const_iterator layerIterators[4];
+        for(auto layer0Iter=hitsLayers[0].cbegin(); layer0Iter!=hitsLayers[0].cend(); ++layer0Iter)
+        for(auto layer1Iter=hitsLayers[1].cbegin(); layer1Iter!=hitsLayers[1].cend(); ++layer1Iter)
+        for(auto layer2Iter=hitsLayers[2].cbegin(); layer2Iter!=hitsLayers[2].cend(); ++layer2Iter)
+        for(auto layer3Iter=hitsLayers[3].cbegin(); layer3Iter!=hitsLayers[3].cend(); ++layer3Iter)
+        {
+          layerIterators[0]=layer0Iter;
+          layerIterators[1]=layer1Iter;
+          layerIterators[2]=layer2Iter;
+          layerIterators[3]=layer3Iter;
+          if(checkCombination(layerIterators,4))
+          {
+            coincidenceHitSet.insert(layer0Iter);
+            coincidenceHitSet.insert(layer1Iter);
+            coincidenceHitSet.insert(layer2Iter);
+            coincidenceHitSet.insert(layer3Iter);
+          }
+        }
+      }
+
+      for(auto iterHit=coincidenceHitSet.begin(); iterHit!=coincidenceHitSet.end(); ++iterHit) coincidenceHits.push_back(**iterHit);
+    }
+
+    private:
+    bool checkCombination(std::vector<CrvHit>::const_iterator layerIterators[], int n)
+    {
+      typedef const std::vector<CrvHit>::const_iterator L;
+      if(!_usePulseOverlaps)
+      {
+        double maxTimeDifference = (*std::max_element(layerIterators,layerIterators+n,
+                                   [](L &a, L &b){return a->_maxTimeDifference < b->_maxTimeDifference;}))->_maxTimeDifference;
+        double timeMax = (*std::max_element(layerIterators,layerIterators+n, [](L &a, L &b){return a->_time < b->_time;}))->_time;
+        double timeMin = (*std::min_element(layerIterators,layerIterators+n, [](L &a, L &b){return a->_time < b->_time;}))->_time;
+        if(timeMax-timeMin>maxTimeDifference) return false;
+      }
+      else
+      {
+        double minOverlapTime = (*std::min_element(layerIterators,layerIterators+n,
+                                [](L &a, L &b){return a->_minOverlapTime < b->_minOverlapTime;}))->_minOverlapTime;
+        double timeMaxPulseStart = (*std::max_element(layerIterators,layerIterators+n,
+                                   [](L &a, L &b){return a->_timePulseStart < b->_timePulseStart;}))->_timePulseStart;
+        double timeMinPulseEnd   = (*std::min_element(layerIterators,layerIterators+n,
+                                   [](L &a, L &b){return a->_timePulseEnd < b->_timePulseEnd;}))->_timePulseEnd;
+        if(timeMinPulseEnd-timeMaxPulseStart<minOverlapTime) return false;
+      }
+
+      double minSlope = (*std::min_element(layerIterators,layerIterators+n, [](L &a, L &b){return a->_minSlope < b->_minSlope;}))->_minSlope;
+      double maxSlope = (*std::max_element(layerIterators,layerIterators+n, [](L &a, L &b){return a->_maxSlope < b->_maxSlope;}))->_maxSlope;
+      double maxSlopeDifference = (*std::max_element(layerIterators,layerIterators+n,
+                                  [](L &a, L &b){return a->_maxSlopeDifference < b->_maxSlopeDifference;}))->_maxSlopeDifference;
+      std::array<double,CRVId::nLayers-1> slopes;
+      for(int d=0; d<n-1; ++d)
+      {
+        slopes[d]=(layerIterators[d+1]->_x-layerIterators[d]->_x)/(layerIterators[d+1]->_y-layerIterators[d]->_y);
+        if(slopes[d]<minSlope || slopes[d]>maxSlope) return false;
+      }
+      if(n>2)
+      {
+        if(fabs(slopes[0]-slopes[1])>maxSlopeDifference) return false;
+        if(n>3)
+        {
+          if(fabs(slopes[0]-slopes[2])>maxSlopeDifference) return false;
+          if(fabs(slopes[1]-slopes[2])>maxSlopeDifference) return false;
+        }
+      }
+
+      std::sort(layerIterators,layerIterators+n,[](L &a, L &b){return a->_x < b->_x;});
+      for(int i=0; i<n; ++i)
+      {
+        if(i>0)
+        {
+          double distance=layerIterators[i]->_x-layerIterators[i-1]->_x;
+          if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
+        }
+        if(i+1<n)
+        {
+          double distance=layerIterators[i+1]->_x-layerIterators[i]->_x;
+          if(distance>layerIterators[i]->_maxDistance) layerIterators[i]->_maxDistance=distance;
+        }
+      }
+      return true;
+    }
+
+    bool _usePulseOverlaps;
+  };
+
+
+  //the steps of the CrvCoincidenceFinder::produce for one sector type
+  template<class Finder, class HitContainer>
+  std::vector<std::vector<CrvHit> > coincidenceClusters(Finder &finder, const std::vector<CrvHit> &hits,
+                                                        double initialClusterMaxTimeDifference, double initialClusterMinOverlapTime)
+  {
+    HitContainer hitsFiltered;
+    finder.filterHits(hits, hitsFiltered);
+
+    std::vector<std::vector<CrvHit> > clusters;
+    finder.findClusters(hitsFiltered, clusters, initialClusterMaxTimeDifference, initialClusterMinOverlapTime);
+
+    HitContainer coincidenceHits;
+    for(size_t iCluster=0; iCluster<clusters.size(); ++iCluster)
+    {
+      std::vector<CrvHit> cluster0, cluster1;
+      for(const CrvHit &hit : clusters[iCluster])
+      {
+        if(hit._SiPM%CRVId::nSidesPerBar==0) cluster0.push_back(hit); else cluster1.push_back(hit);
+      }
+      finder.checkCoincidence(cluster0,coincidenceHits);
+      finder.checkCoincidence(cluster1,coincidenceHits);
+    }
+
+    std::vector<std::vector<CrvHit> > coincidenceClusters;
+    finder.findClusters(coincidenceHits, coincidenceClusters, clusterMaxTimeDifference, clusterMinOverlapTime);
+    return coincidenceClusters;
+  }
+
+  bool sameClusters(const std::vector<std::vector<CrvHit> > &a, const std::vector<std::vector<CrvHit> > &b)
+  {
+    if(a.size()!=b.size()) return false;
+    for(size_t iCluster=0; iCluster<a.size(); ++iCluster)
+    {
+      if(a[iCluster].size()!=b[iCluster].size()) return false;
+      for(size_t iHit=0; iHit<a[iCluster].size(); ++iHit)
+      {
+        const CrvHit &hitA=a[iCluster][iHit];
+        const CrvHit &hitB=b[iCluster][iHit];
+        if(hitA._crvRecoPulse.key()!=hitB._crvRecoPulse.key() || hitA._maxDistance!=hitB._maxDistance) return false;
+      }
+    }
+    return true;
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  int nEvent = argc > 1 ? std::stoi(argv[1]) : 100;
+
+  std::mt19937 gen(1357);
+
+  std::cout<<"CrvCoincidenceBench mean time per event in ms, "<<nEvent<<" events per pulse multiplicity"<<std::endl;
+  std::cout<<std::setw(10)<<"overlaps"<<std::setw(10)<<"pulses"<<std::setw(10)<<"clusters"<<std::setw(12)<<"lists"<<std::setw(12)<<"sorted"<<std::endl;
+
+  int nBad(0);
+  for(bool usePulseOverlaps : {false, true})
+  {
+    ListFinder              listFinder(usePulseOverlaps);
+    CrvCoincidenceHitFinder hitFinder(usePulseOverlaps, bigClusterThreshold);
+
+    for(int nPulses : {100, 300, 1000, 3000})
+    {
+      std::vector<CrvRecoPulse> pulses(nPulses);
+      double tLists(0), tSorted(0);
+      long   nCluster(0);
+      for(int iEvent=0; iEvent<nEvent; ++iEvent)
+      {
+        std::vector<CrvHit> hits = makeEvent(gen, pulses, nPulses);
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        auto clustersOld = coincidenceClusters<ListFinder,std::list<CrvHit> >(listFinder, hits, maxTimeDifference, minOverlapTime);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto clustersNew = coincidenceClusters<CrvCoincidenceHitFinder,std::vector<CrvHit> >(hitFinder, hits, maxTimeDifference, minOverlapTime);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        tLists  += std::chrono::duration<double>(t1-t0).count();
+        tSorted += std::chrono::duration<double>(t2-t1).count();
+        nCluster += clustersNew.size();
+        if(!sameClusters(clustersOld, clustersNew)) ++nBad;
+      }
+
+      std::cout<<std::setw(10)<<usePulseOverlaps<<std::setw(10)<<nPulses<<std::setw(10)<<std::setprecision(4)<<double(nCluster)/std::max(nEvent,1)
+               <<std::fixed<<std::setprecision(3)<<std::setw(12)<<1e3*tLists/std::max(nEvent,1)<<std::setw(12)<<1e3*tSorted/std::max(nEvent,1)
+               <<std::defaultfloat<<std::endl;
+    }
+  }
+
+  if(nBad>0)
+  {
+    std::cout<<"CrvCoincidenceBench FAILED "<<nBad<<" events with different coincidence clusters"<<std::endl;
+    return 1;
+  }
+  std::cout<<"CrvCoincidenceBench passed"<<std::endl;
+  return 0;
+}
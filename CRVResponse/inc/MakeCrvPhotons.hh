@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <map>
+#include <memory>
+#include <cstdint>
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Random/Randomize.h"
 
@@ -11,6 +13,13 @@
 #include <ostream>
 #include <sstream>
 
+//The lookup tables are written by the lookup table generator as a stream of the structs below (version 6.x).
+//For use, they are held in a flat format (LookupTable), which is a fixed size header followed by arrays,
+//with no pointers, so that it can be memory-mapped read-only from a file and used in place.
+//All users of the same table in a process share one copy, and all processes on a node that map the same
+//flat file share one copy in the page cache. Tables in the stream format are converted to the flat format
+//in memory when they are loaded; CrvFlattenLookupTable writes the flat file.
+
 namespace mu2eCrv
 {
 
@@ -37,34 +46,54 @@ struct LookupCerenkov
   void Read(std::ifstream &lookupfile);
 };
 
-struct LookupBinDefinitions
+//read-only view of an array of doubles of a flat lookup table
+struct LookupArray
+{
+  const double *values;
+  size_t       n;
+  LookupArray(const double *v=NULL, size_t size=0) : values(v), n(size) {}
+  size_t        size() const {return n;}
+  const double *data() const {return values;}
+  const double &operator[](size_t i) const {return values[i];}
+};
+
+//bin numbering of the lookup tables, for bin edges held in vectors (LookupBinDefinitions)
+//or in a flat lookup table (LookupBinDefinitionsView)
+template<class Edges>
+struct LookupBinIndexing
+{
+  Edges xBins;
+  Edges yBins;
+  Edges zBins;
+  Edges betaBins;
+  Edges thetaBins;
+  Edges phiBins;
+  Edges rBins;
+
+  unsigned int getNScintillatorScintillationBins() const;
+  unsigned int getNScintillatorCerenkovBins() const;
+  unsigned int getNFiberCerenkovBins() const;
+
+  static unsigned int findBin(const Edges &v, const double &x, bool &notFound);
+  int findScintillatorScintillationBin(double x, double y, double z) const;
+  int findScintillatorCerenkovBin(double x, double y, double z, double beta) const;
+  int findFiberCerenkovBin(double beta, double theta, double phi, double r, double z) const;
+
+  bool findScintillatorScintillationBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin) const;
+  bool findScintillatorCerenkovBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin, double &betabin) const;
+  bool findFiberCerenkovBinReverse(unsigned int bin, double &betabin, double &thetabin, double &phibin, double &rbin, double &zbin) const;
+};
+
+struct LookupBinDefinitions : public LookupBinIndexing<std::vector<double> >
 {
-  std::vector<double> xBins;
-  std::vector<double> yBins;
-  std::vector<double> zBins;
-  std::vector<double> betaBins;
-  std::vector<double> thetaBins;
-  std::vector<double> phiBins;
-  std::vector<double> rBins;
   void WriteVector(std::vector<double> &v, std::ofstream &o);
   void ReadVector(std::vector<double> &v, std::ifstream &i);
   void Write(const std::string &filename);
   void Read(std::ifstream &lookupfile);
-
-  unsigned int getNScintillatorScintillationBins();
-  unsigned int getNScintillatorCerenkovBins();
-  unsigned int getNFiberCerenkovBins();
-
-  unsigned int findBin(const std::vector<double> &v, const double &x, bool &notFound);
-  int findScintillatorScintillationBin(double x, double y, double z);
-  int findScintillatorCerenkovBin(double x, double y, double z, double beta);
-  int findFiberCerenkovBin(double beta, double theta, double phi, double r, double z);
-
-  bool findScintillatorScintillationBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin);
-  bool findScintillatorCerenkovBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin, double &betabin);
-  bool findFiberCerenkovBinReverse(unsigned int bin, double &betabin, double &thetabin, double &phibin, double &rbin, double &zbin);
 };
 
+typedef LookupBinIndexing<LookupArray> LookupBinDefinitionsView;
+
 struct LookupBin
 {
   static const int maxTimeDelays=150;
@@ -87,6 +116,90 @@ struct LookupBin
   void Read(std::ifstream &lookupfile, const unsigned int &i);
 };
 
+//a bin of a flat lookup table
+//the probabilities of the time delays and fiber emissions are in the probability array of the table
+struct LookupFlatBin
+{
+  unsigned int binNumber;
+  float        arrivalProbability;
+  uint64_t     timeDelays;      //index of the first time delay probability
+  uint64_t     fiberEmissions;  //index of the first fiber emission probability
+  unsigned int nTimeDelays;
+  unsigned int nFiberEmissions;
+  unsigned int probabilityScaleTimeDelays;
+  unsigned int probabilityScaleFiberEmissions;
+};
+
+struct LookupFlatHeader
+{
+  char            magic[8];           //"MU2ECRVL" followed by a zero byte
+  uint32_t        version;            //LookupTable::currentFlatVersion when written
+  uint32_t        endian;             //0xDEADBEEF in the byte order of the writer
+  uint32_t        headerSize;         //sizeof(LookupFlatHeader)
+  uint32_t        binSize;            //sizeof(LookupFlatBin)
+  uint64_t        fileSize;
+  LookupConstants constants;
+  uint64_t        cerenkovOffset[2];  //(beta, photons per mm) pairs for the scintillator (0) and fiber (1)
+  uint64_t        nCerenkov[2];       //number of pairs
+  uint64_t        edgesOffset[7];     //bin edges x, y, z, beta, theta, phi, r
+  uint64_t        nEdges[7];
+  uint64_t        binsOffset[3];      //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+  uint64_t        nBins[3];
+  uint64_t        probabilitiesOffset;
+  uint64_t        nProbabilities;
+  uint64_t        dataChecksum;       //of the bytes after the header
+  uint64_t        headerChecksum;     //of the bytes of the header before this word
+};
+
+//a lookup table in the flat format, either mapped from a flat file or converted from a stream file
+class LookupTable
+{
+  public:
+    static const uint32_t currentFlatVersion=1;
+
+    //returns the table of this file, loading it if no one holds it yet
+    static std::shared_ptr<const LookupTable> Load(const std::string &filename, int debug);
+
+    ~LookupTable();
+    LookupTable(const LookupTable&) = delete;
+    LookupTable& operator=(const LookupTable&) = delete;
+
+    const std::string              &GetFileName() const {return _fileName;}
+    bool                           IsMapped() const {return _address!=NULL;}
+    const LookupFlatHeader         &GetHeader() const {return *_header;}
+    const LookupConstants          &GetConstants() const {return _header->constants;}
+    const LookupBinDefinitionsView &GetBinDefinitions() const {return _LBD;}
+    LookupArray                    GetCerenkov(int i) const {return _cerenkov[i];}
+    const LookupFlatBin            *GetBins(int table) const {return _bins[table];}
+    const unsigned char            *GetProbabilities() const {return _probabilities;}
+
+    //compares the bytes after the header with its data checksum
+    //this reads every page of a mapped table, so it is not done when mapping (see CrvFlattenLookupTable)
+    bool CheckData() const;
+
+    //writes the table as a flat file, which must not exist yet
+    void WriteFlat(const std::string &filename) const;
+
+    static uint64_t Checksum(const void *data, size_t nbytes);
+
+  private:
+    LookupTable(const std::string &filename, int debug);
+    void MapFlat(int debug);
+    void ConvertStream(std::ifstream &lookupfile, int debug);
+    void SetPointers();
+
+    std::string                _fileName;
+    void                       *_address;   //of the mapped file
+    size_t                     _size;
+    std::vector<uint64_t>      _buffer;     //of the table converted from a stream file
+    const char                 *_base;
+    const LookupFlatHeader     *_header;
+    LookupArray                _cerenkov[2];
+    LookupBinDefinitionsView   _LBD;
+    const LookupFlatBin        *_bins[3];
+    const unsigned char        *_probabilities;
+};
+
 
 
 class MakeCrvPhotons
@@ -99,6 +212,8 @@ class MakeCrvPhotons
     {
       _scintillationYield=39400;
       for(int i=0; i<_nSiPMs; ++i) _photonYieldDeviation[i]=1.0;
+      for(int i=0; i<3; ++i) _bins[i]=NULL;
+      _probabilities=NULL;
     }
 
     ~MakeCrvPhotons();
@@ -127,10 +242,12 @@ class MakeCrvPhotons
     double                    _scintillationYield;
     double                    _photonYieldDeviation[_nSiPMs];
 
+    std::shared_ptr<const LookupTable> _table;   //shared by all users of the same file
     LookupConstants           _LC;
-    LookupCerenkov            _LCerenkov;
-    LookupBinDefinitions      _LBD;
-    std::vector<LookupBin>    _bins[3];   //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+    LookupArray               _LCerenkov[2];      //scintillator (0), fiber (1)
+    LookupBinDefinitionsView  _LBD;
+    const LookupFlatBin       *_bins[3];   //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+    const unsigned char       *_probabilities;
 
     CLHEP::RandFlat           &_randFlat;
     CLHEP::RandGaussQ         &_randGaussQ;
@@ -138,9 +255,9 @@ class MakeCrvPhotons
 
     bool   IsInsideScintillator(const CLHEP::Hep3Vector &p);
     bool   IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3Vector &dir, double &r, double &phi);
-    double GetRandomTime(const LookupBin *theBin);
-    int    GetRandomFiberEmissions(const LookupBin *theBin);
-    double GetAverageNumberOfCerenkovPhotons(double beta, double charge, std::map<double,double> &photons);
+    double GetRandomTime(const LookupFlatBin *theBin);
+    int    GetRandomFiberEmissions(const LookupFlatBin *theBin);
+    double GetAverageNumberOfCerenkovPhotons(double beta, double charge, const LookupArray &photons);
     int    GetNumberOfPhotonsFromAverage(double average, int nSteps);
 
     public:
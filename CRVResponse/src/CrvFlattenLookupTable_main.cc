@@ -0,0 +1,78 @@
+//
+// Writes a CRV lookup table in the flat format, which CrvPhotonGenerator maps into memory
+// instead of reading it, and which is shared by all jobs on a node that use it.
+//
+// arguments are
+// INPUT:  lookup table in the stream format written by the lookup table generator
+// OUTPUT: flat lookup table to write, must not exist yet
+// or
+// --verify FLAT: check the data checksum of an existing flat lookup table, which
+//                jobs mapping the table do not do, as it reads the whole file
+//
+// examples:
+// CrvFlattenLookupTable LookupTable_6000_0 LookupTable_6000_0.flat
+// CrvFlattenLookupTable --verify LookupTable_6000_0.flat
+//
+#include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char **argv)
+{
+  if(argc!=3)
+  {
+    std::cout<<"usage: CrvFlattenLookupTable INPUT OUTPUT"<<std::endl;
+    std::cout<<"       CrvFlattenLookupTable --verify FLAT"<<std::endl;
+    return 1;
+  }
+
+  try
+  {
+    if(std::string(argv[1])=="--verify")
+    {
+      std::shared_ptr<const mu2eCrv::LookupTable> flat = mu2eCrv::LookupTable::Load(argv[2],1);
+      if(!flat->IsMapped())
+      {
+        std::cout<<"CrvFlattenLookupTable: "<<argv[2]<<" is not a flat lookup table"<<std::endl;
+        return 1;
+      }
+      auto t0 = std::chrono::steady_clock::now();
+      bool good = flat->CheckData();
+      auto t1 = std::chrono::steady_clock::now();
+      std::cout<<argv[2]<<": data checksum "<<(good ? "good" : "BAD")<<", "<<flat->GetHeader().fileSize<<" bytes checked in "
+               <<std::chrono::duration<double>(t1-t0).count()<<" s"<<std::endl;
+      return good ? 0 : 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::shared_ptr<const mu2eCrv::LookupTable> table = mu2eCrv::LookupTable::Load(argv[1],1);
+    auto t1 = std::chrono::steady_clock::now();
+    if(table->IsMapped()) std::cout<<argv[1]<<" is already a flat lookup table"<<std::endl;
+    table->WriteFlat(argv[2]);
+
+    //map the new file and check that it holds the same table
+    auto t2 = std::chrono::steady_clock::now();
+    std::shared_ptr<const mu2eCrv::LookupTable> flat = mu2eCrv::LookupTable::Load(argv[2],1);
+    auto t3 = std::chrono::steady_clock::now();
+    const mu2eCrv::LookupFlatHeader &h = flat->GetHeader();
+    if(h.dataChecksum!=table->GetHeader().dataChecksum || !flat->CheckData())
+    {
+      std::cout<<"CrvFlattenLookupTable: the flat table "<<argv[2]<<" does not match "<<argv[1]<<std::endl;
+      return 1;
+    }
+
+    std::cout<<"Wrote "<<argv[2]<<": "<<h.fileSize<<" bytes, "
+             <<h.nBins[0]<<"+"<<h.nBins[1]<<"+"<<h.nBins[2]<<" bins"<<std::endl;
+    std::cout<<"load time "<<std::chrono::duration<double>(t1-t0).count()<<" s, "
+             <<"map time "<<std::chrono::duration<double>(t3-t2).count()<<" s"<<std::endl;
+  }
+  catch(std::exception &e)
+  {
+    std::cout<<"CrvFlattenLookupTable: "<<e.what()<<std::endl;
+    return 1;
+  }
+  return 0;
+}
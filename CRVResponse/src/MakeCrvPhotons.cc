@@ -1,12 +1,43 @@
 #include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
 
+#include <cstring>
+#include <mutex>
 #include <sstream>
+#include <type_traits>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
 
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
 #include "CLHEP/Vector/TwoVector.h"
 
 namespace mu2eCrv
 {
+namespace
+{
+  static_assert(std::is_trivially_copyable<LookupFlatHeader>::value, "LookupFlatHeader is written to disk as is");
+  static_assert(std::is_trivially_copyable<LookupFlatBin>::value, "LookupFlatBin is written to disk as is");
+
+  const char     magicNumber[8] = {'M','U','2','E','C','R','V','L'};
+  const uint32_t endianMarker   = 0xDEADBEEF;
+
+  //all arrays of a flat table start at a multiple of 8 bytes
+  uint64_t aligned(uint64_t offset) {return (offset+7)/8*8;}
+
+  size_t checkedBytes() {return offsetof(LookupFlatHeader, headerChecksum);}
+
+  std::string errnoMessage(int errsave)
+  {
+    std::stringstream s;
+    s<<"  errno: "<<errsave<<" "<<strerror(errsave);
+    return s.str();
+  }
+}
+
 void LookupConstants::Write(const std::string &filename)
 {
   std::ofstream lookupfile(filename,std::ios::binary|std::ios::app);
@@ -91,14 +122,16 @@ void LookupBinDefinitions::Read(std::ifstream &lookupfile)
   ReadVector(rBins,lookupfile);
 }
 
-unsigned int LookupBinDefinitions::getNScintillatorScintillationBins()
+template<class Edges>
+unsigned int LookupBinIndexing<Edges>::getNScintillatorScintillationBins() const
 {
   unsigned int nXBins = xBins.size()-1;
   unsigned int nYBins = yBins.size()-1;
   unsigned int nZBins = zBins.size()-1;
   return nXBins*nYBins*nZBins;
 }
-unsigned int LookupBinDefinitions::getNScintillatorCerenkovBins()
+template<class Edges>
+unsigned int LookupBinIndexing<Edges>::getNScintillatorCerenkovBins() const
 {
   unsigned int nXBins = xBins.size()-1;
   unsigned int nYBins = yBins.size()-1;
@@ -106,7 +139,8 @@ unsigned int LookupBinDefinitions::getNScintillatorCerenkovBins()
   unsigned int nBetaBins = betaBins.size()-1;
   return nXBins*nYBins*nZBins*nBetaBins;
 }
-unsigned int LookupBinDefinitions::getNFiberCerenkovBins()
+template<class Edges>
+unsigned int LookupBinIndexing<Edges>::getNFiberCerenkovBins() const
 {
   unsigned int nBetaBins = betaBins.size()-1;
   unsigned int nThetaBins = thetaBins.size()-1;
@@ -116,7 +150,8 @@ unsigned int LookupBinDefinitions::getNFiberCerenkovBins()
   return nBetaBins*nThetaBins*nPhiBins*nRBins*nZBins;
 }
 
-unsigned int LookupBinDefinitions::findBin(const std::vector<double> &v, const double &x, bool &notFound)
+template<class Edges>
+unsigned int LookupBinIndexing<Edges>::findBin(const Edges &v, const double &x, bool &notFound)
 {
   for(size_t i=1; i<v.size(); i++)
   {
@@ -125,7 +160,8 @@ unsigned int LookupBinDefinitions::findBin(const std::vector<double> &v, const d
   notFound=true;
   return(-1);
 }
-int LookupBinDefinitions::findScintillatorScintillationBin(double x, double y, double z)
+template<class Edges>
+int LookupBinIndexing<Edges>::findScintillatorScintillationBin(double x, double y, double z) const
 {
   bool notFound=false;
   unsigned int xBin=findBin(xBins,x,notFound);
@@ -137,7 +173,8 @@ int LookupBinDefinitions::findScintillatorScintillationBin(double x, double y, d
   unsigned int nZBins = zBins.size()-1;
   return(zBin + yBin*nZBins + xBin*nYBins*nZBins);
 }
-int LookupBinDefinitions::findScintillatorCerenkovBin(double x, double y, double z, double beta)
+template<class Edges>
+int LookupBinIndexing<Edges>::findScintillatorCerenkovBin(double x, double y, double z, double beta) const
 {
   bool notFound=false;
   unsigned int xBin=findBin(xBins,x,notFound);
@@ -151,7 +188,8 @@ int LookupBinDefinitions::findScintillatorCerenkovBin(double x, double y, double
   unsigned int nBetaBins = betaBins.size()-1;
   return(betaBin + zBin*nBetaBins + yBin*nZBins*nBetaBins + xBin*nYBins*nZBins*nBetaBins);
 }
-int LookupBinDefinitions::findFiberCerenkovBin(double beta, double theta, double phi, double r, double z)
+template<class Edges>
+int LookupBinIndexing<Edges>::findFiberCerenkovBin(double beta, double theta, double phi, double r, double z) const
 {
   bool notFound=false;
   unsigned int betaBin=findBin(betaBins,beta,notFound);
@@ -167,7 +205,8 @@ int LookupBinDefinitions::findFiberCerenkovBin(double beta, double theta, double
   unsigned int nZBins = zBins.size()-1;
   return(zBin + rBin*nZBins + phiBin*nRBins*nZBins + thetaBin*nPhiBins*nRBins*nZBins + betaBin*nThetaBins*nPhiBins*nRBins*nZBins);
 }
-bool LookupBinDefinitions::findScintillatorScintillationBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin)
+template<class Edges>
+bool LookupBinIndexing<Edges>::findScintillatorScintillationBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin) const
 {
   if(bin>=getNScintillatorScintillationBins()) return false;
 
@@ -179,7 +218,8 @@ bool LookupBinDefinitions::findScintillatorScintillationBinReverse(unsigned int
   zbin = bin % nZBins;
   return true;
 }
-bool LookupBinDefinitions::findScintillatorCerenkovBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin, double &betabin)
+template<class Edges>
+bool LookupBinIndexing<Edges>::findScintillatorCerenkovBinReverse(unsigned int bin, double &xbin, double &ybin, double &zbin, double &betabin) const
 {
   if(bin>=getNScintillatorCerenkovBins()) return false;
 
@@ -193,7 +233,8 @@ bool LookupBinDefinitions::findScintillatorCerenkovBinReverse(unsigned int bin,
   betabin = bin % nBetaBins;
   return true;
 }
-bool LookupBinDefinitions::findFiberCerenkovBinReverse(unsigned int bin, double &betabin, double &thetabin, double &phibin, double &rbin, double &zbin)
+template<class Edges>
+bool LookupBinIndexing<Edges>::findFiberCerenkovBinReverse(unsigned int bin, double &betabin, double &thetabin, double &phibin, double &rbin, double &zbin) const
 {
   if(bin>=getNFiberCerenkovBins()) return false;
 
@@ -210,6 +251,9 @@ bool LookupBinDefinitions::findFiberCerenkovBinReverse(unsigned int bin, double
   return true;
 }
 
+template struct LookupBinIndexing<std::vector<double> >;
+template struct LookupBinIndexing<LookupArray>;
+
 void LookupBin::WriteVector(std::vector<unsigned char> &v, std::ofstream &o)
 {
   size_t n=v.size();
@@ -249,35 +293,281 @@ void LookupBin::Read(std::ifstream &lookupfile, const unsigned int &i)
   if(i!=binNumber) throw std::logic_error("Corrupt lookup table.");
 }
 
-  void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
+uint64_t LookupTable::Checksum(const void *data, size_t nbytes)  //64 bit FNV-1a, as for the mapped field maps
+{
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t h = 0xcbf29ce484222325ULL;
+  const unsigned char *p = static_cast<const unsigned char*>(data);
+  const size_t nwords = nbytes/sizeof(uint64_t);
+  for(size_t i=0; i<nwords; ++i)
+  {
+    uint64_t w;
+    std::memcpy(&w, p+i*sizeof(w), sizeof(w));
+    h = (h^w)*prime;
+  }
+  for(size_t i=nwords*sizeof(uint64_t); i<nbytes; ++i) h = (h^p[i])*prime;
+  return h;
+}
+
+std::shared_ptr<const LookupTable> LookupTable::Load(const std::string &filename, int debug)
+{
+  //the tables are only held by their users, a table no one uses anymore is released
+  static std::mutex tablesMutex;
+  static std::map<std::string,std::weak_ptr<const LookupTable> > tables;
+
+  std::lock_guard<std::mutex> lock(tablesMutex);
+  std::shared_ptr<const LookupTable> table = tables[filename].lock();
+  if(!table)
+  {
+    table.reset(new LookupTable(filename,debug));
+    tables[filename] = table;
+  }
+  else if(debug>0) std::cout<<"Using the CRV lookup table "<<filename<<" already loaded"<<std::endl;
+  return table;
+}
+
+LookupTable::LookupTable(const std::string &filename, int debug) :
+  _fileName(filename), _address(NULL), _size(0), _base(NULL), _header(NULL), _probabilities(NULL)
 {
-  _fileName = filename;
   std::ifstream lookupfile(filename,std::ios::binary);
   if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
 
-  _LC.Read(lookupfile);
-  if(_LC.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
-  if(_LC.reflector!=0 && _LC.reflector!=1 && _LC.reflector!=2) throw std::logic_error("Lookup tables can have either no reflector/absorber, or a reflector/absorber on the +z side.");
+  char magic[sizeof(magicNumber)]={0};
+  lookupfile.read(magic,sizeof(magic));
+  if(lookupfile.good() && std::memcmp(magic,magicNumber,sizeof(magicNumber))==0)
+  {
+    lookupfile.close();
+    MapFlat(debug);
+  }
+  else
+  {
+    lookupfile.clear();
+    lookupfile.seekg(0);
+    ConvertStream(lookupfile,debug);
+  }
+
+  try
+  {
+    SetPointers();
+  }
+  catch(...)
+  {
+    if(_address!=NULL) munmap(_address,_size);
+    throw;
+  }
+}
+
+LookupTable::~LookupTable()
+{
+  if(_address!=NULL) munmap(_address,_size);
+}
+
+void LookupTable::MapFlat(int debug)
+{
+  if(debug>0) std::cout<<"Mapping CRV lookup table "<<_fileName<<std::endl;
+
+  int fd = open(_fileName.c_str(), O_RDONLY);
+  if(fd<0) throw std::logic_error("Could not open lookup table file "+_fileName+errnoMessage(errno));
+
+  struct stat info;
+  if(fstat(fd,&info))
+  {
+    int errsave = errno;
+    close(fd);
+    throw std::logic_error("Could not fstat lookup table file "+_fileName+errnoMessage(errsave));
+  }
+  _size = info.st_size;
+  if(_size<sizeof(LookupFlatHeader))
+  {
+    close(fd);
+    throw std::logic_error("Lookup table file "+_fileName+" is too short for a flat lookup table header.");
+  }
 
-  _LCerenkov.Read(lookupfile);
-  _LBD.Read(lookupfile);
+  //read-only and shared: the pages come straight from the page cache
+  void *address = mmap(NULL, _size, PROT_READ, MAP_SHARED, fd, 0);
+  int errsave = errno;
+  close(fd);
+  if(address==MAP_FAILED) throw std::logic_error("Could not mmap lookup table file "+_fileName+errnoMessage(errsave));
+  _address = address;
+  _base = static_cast<const char*>(_address);
+
+  //check the header before trusting any of its contents
+  //on error the destructor is not called, so the mapping is released here
+  const LookupFlatHeader h = *reinterpret_cast<const LookupFlatHeader*>(_base);
+  std::string error;
+  if(h.endian!=endianMarker) error="endian mismatch";
+  else if(h.version!=currentFlatVersion) error="unknown flat format version "+std::to_string(h.version);
+  else if(h.headerSize!=sizeof(LookupFlatHeader) || h.binSize!=sizeof(LookupFlatBin) ||
+          h.headerChecksum!=Checksum(&h,checkedBytes())) error="corrupt header";
+  else if(h.fileSize!=_size) error="file size does not match its header";
+  else
+  {
+    bool outside = h.probabilitiesOffset+h.nProbabilities>_size;
+    for(int i=0; i<2; ++i) outside |= h.cerenkovOffset[i]+2*h.nCerenkov[i]*sizeof(double)>_size;
+    for(int i=0; i<7; ++i) outside |= h.edgesOffset[i]+h.nEdges[i]*sizeof(double)>_size;
+    for(int i=0; i<3; ++i) outside |= h.binsOffset[i]+h.nBins[i]*sizeof(LookupFlatBin)>_size;
+    if(outside) error="arrays outside of the file";
+  }
+  if(!error.empty())
+  {
+    munmap(_address,_size);
+    _address=NULL;
+    throw std::logic_error("Flat lookup table file "+_fileName+": "+error);
+  }
+}
+
+void LookupTable::ConvertStream(std::ifstream &lookupfile, int debug)
+{
+  LookupConstants LC;
+  LookupCerenkov LCerenkov;
+  LookupBinDefinitions LBD;
 
-  unsigned int nScintillatorScintillationBins = _LBD.getNScintillatorScintillationBins();
-  unsigned int nScintillatorCerenkovBins      = _LBD.getNScintillatorCerenkovBins();
-  unsigned int nFiberCerenkovBins             = _LBD.getNFiberCerenkovBins();
+  LC.Read(lookupfile);
+  if(LC.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
+  LCerenkov.Read(lookupfile);
+  LBD.Read(lookupfile);
 
   //0...scintillationInScintillator, 1...cerenkovInScintillator 2...cerenkovInFiber
-  _bins[0].resize(nScintillatorScintillationBins);
-  _bins[1].resize(nScintillatorCerenkovBins);
-  _bins[2].resize(nFiberCerenkovBins);
-
-  if(debug>0) std::cout<<"Reading CRV lookup tables "<<filename<<" ... "<<std::flush;
-  for(unsigned int i=0; i<nScintillatorScintillationBins; i++) _bins[0][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nScintillatorCerenkovBins; i++)      _bins[1][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nFiberCerenkovBins; i++)             _bins[2][i].Read(lookupfile,i);
+  unsigned int nBins[3] = {LBD.getNScintillatorScintillationBins(), LBD.getNScintillatorCerenkovBins(), LBD.getNFiberCerenkovBins()};
+
+  if(debug>0) std::cout<<"Reading CRV lookup tables "<<_fileName<<" ... "<<std::flush;
+  std::vector<LookupFlatBin> bins[3];
+  std::vector<unsigned char> probabilities;
+  LookupBin bin;
+  for(int table=0; table<3; ++table)
+  {
+    bins[table].resize(nBins[table]);
+    for(unsigned int i=0; i<nBins[table]; i++)
+    {
+      bin.Read(lookupfile,i);
+      LookupFlatBin &flatBin = bins[table][i];
+      flatBin.binNumber = bin.binNumber;
+      flatBin.arrivalProbability = bin.arrivalProbability;
+      flatBin.timeDelays = probabilities.size();
+      flatBin.nTimeDelays = bin.timeDelays.size();
+      probabilities.insert(probabilities.end(),bin.timeDelays.begin(),bin.timeDelays.end());
+      flatBin.fiberEmissions = probabilities.size();
+      flatBin.nFiberEmissions = bin.fiberEmissions.size();
+      probabilities.insert(probabilities.end(),bin.fiberEmissions.begin(),bin.fiberEmissions.end());
+      flatBin.probabilityScaleTimeDelays = bin.probabilityScaleTimeDelays;
+      flatBin.probabilityScaleFiberEmissions = bin.probabilityScaleFiberEmissions;
+    }
+  }
+  if(lookupfile.fail()) throw std::logic_error("Corrupt lookup table.");
   if(debug>0) std::cout<<"Done."<<std::endl;
 
-  lookupfile.close();
+  std::vector<double> cerenkov[2];
+  std::map<double,double> *photons[2] = {&LCerenkov.photonsScintillator, &LCerenkov.photonsFiber};
+  for(int i=0; i<2; ++i)
+  {
+    for(std::map<double,double>::const_iterator iter=photons[i]->begin(); iter!=photons[i]->end(); ++iter)
+    {
+      cerenkov[i].push_back(iter->first);
+      cerenkov[i].push_back(iter->second);
+    }
+  }
+  const std::vector<double> *edges[7] = {&LBD.xBins, &LBD.yBins, &LBD.zBins, &LBD.betaBins, &LBD.thetaBins, &LBD.phiBins, &LBD.rBins};
+
+  //lay out the arrays after the header
+  LookupFlatHeader h;
+  std::memset(&h,0,sizeof(h));
+  std::memcpy(h.magic,magicNumber,sizeof(h.magic));
+  h.version = currentFlatVersion;
+  h.endian = endianMarker;
+  h.headerSize = sizeof(LookupFlatHeader);
+  h.binSize = sizeof(LookupFlatBin);
+  h.constants = LC;
+  uint64_t offset = aligned(sizeof(LookupFlatHeader));
+  for(int i=0; i<2; ++i) {h.cerenkovOffset[i]=offset; h.nCerenkov[i]=cerenkov[i].size()/2; offset=aligned(offset+cerenkov[i].size()*sizeof(double));}
+  for(int i=0; i<7; ++i) {h.edgesOffset[i]=offset; h.nEdges[i]=edges[i]->size(); offset=aligned(offset+edges[i]->size()*sizeof(double));}
+  for(int i=0; i<3; ++i) {h.binsOffset[i]=offset; h.nBins[i]=bins[i].size(); offset=aligned(offset+bins[i].size()*sizeof(LookupFlatBin));}
+  h.probabilitiesOffset = offset;
+  h.nProbabilities = probabilities.size();
+  h.fileSize = aligned(offset+probabilities.size());
+
+  _buffer.assign(h.fileSize/sizeof(uint64_t),0);
+  char *base = reinterpret_cast<char*>(_buffer.data());
+  for(int i=0; i<2; ++i) std::memcpy(base+h.cerenkovOffset[i], cerenkov[i].data(), cerenkov[i].size()*sizeof(double));
+  for(int i=0; i<7; ++i) std::memcpy(base+h.edgesOffset[i], edges[i]->data(), edges[i]->size()*sizeof(double));
+  for(int i=0; i<3; ++i) std::memcpy(base+h.binsOffset[i], bins[i].data(), bins[i].size()*sizeof(LookupFlatBin));
+  std::memcpy(base+h.probabilitiesOffset, probabilities.data(), probabilities.size());
+  h.dataChecksum = Checksum(base+sizeof(LookupFlatHeader), h.fileSize-sizeof(LookupFlatHeader));
+  h.headerChecksum = Checksum(&h,checkedBytes());
+  std::memcpy(base, &h, sizeof(h));
+
+  _base = base;
+  _size = h.fileSize;
+}
+
+void LookupTable::SetPointers()
+{
+  _header = reinterpret_cast<const LookupFlatHeader*>(_base);
+  const LookupFlatHeader &h = *_header;
+  for(int i=0; i<2; ++i) _cerenkov[i] = LookupArray(reinterpret_cast<const double*>(_base+h.cerenkovOffset[i]), 2*h.nCerenkov[i]);
+  LookupArray *edges[7] = {&_LBD.xBins, &_LBD.yBins, &_LBD.zBins, &_LBD.betaBins, &_LBD.thetaBins, &_LBD.phiBins, &_LBD.rBins};
+  for(int i=0; i<7; ++i) *edges[i] = LookupArray(reinterpret_cast<const double*>(_base+h.edgesOffset[i]), h.nEdges[i]);
+  for(int i=0; i<3; ++i) _bins[i] = reinterpret_cast<const LookupFlatBin*>(_base+h.binsOffset[i]);
+  _probabilities = reinterpret_cast<const unsigned char*>(_base+h.probabilitiesOffset);
+
+  if(h.nBins[0]!=_LBD.getNScintillatorScintillationBins() ||
+     h.nBins[1]!=_LBD.getNScintillatorCerenkovBins() ||
+     h.nBins[2]!=_LBD.getNFiberCerenkovBins()) throw std::logic_error("Corrupt lookup table.");
+  for(int table=0; table<3; ++table)
+  {
+    for(unsigned int i=0; i<h.nBins[table]; ++i)
+    {
+      const LookupFlatBin &bin = _bins[table][i];
+      if(bin.binNumber!=i ||
+         bin.timeDelays+bin.nTimeDelays>h.nProbabilities ||
+         bin.fiberEmissions+bin.nFiberEmissions>h.nProbabilities) throw std::logic_error("Corrupt lookup table.");
+    }
+  }
+}
+
+bool LookupTable::CheckData() const
+{
+  return _header->dataChecksum==Checksum(_base+sizeof(LookupFlatHeader),_size-sizeof(LookupFlatHeader));
+}
+
+void LookupTable::WriteFlat(const std::string &filename) const
+{
+  //never overwrite a table in place: processes may have it mapped
+  mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+  int fd = open(filename.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_EXCL, mode);
+  if(fd<0) throw std::logic_error("Could not create flat lookup table file "+filename+errnoMessage(errno));
+
+  const char *p = _base;
+  size_t nbytes = _size;
+  while(nbytes>0)
+  {
+    ssize_t n = write(fd, p, nbytes);
+    if(n<0)
+    {
+      if(errno==EINTR) continue;
+      int errsave = errno;
+      close(fd);
+      throw std::logic_error("Could not write flat lookup table file "+filename+errnoMessage(errsave));
+    }
+    p+=n;
+    nbytes-=n;
+  }
+  close(fd);
+}
+
+void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
+{
+  _fileName = filename;
+  _table = LookupTable::Load(filename,debug);
+
+  _LC = _table->GetConstants();
+  if(_LC.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
+  if(_LC.reflector!=0 && _LC.reflector!=1 && _LC.reflector!=2) throw std::logic_error("Lookup tables can have either no reflector/absorber, or a reflector/absorber on the +z side.");
+
+  _LCerenkov[0] = _table->GetCerenkov(0);
+  _LCerenkov[1] = _table->GetCerenkov(1);
+  _LBD = _table->GetBinDefinitions();
+  for(int i=0; i<3; ++i) _bins[i] = _table->GetBins(i);
+  _probabilities = _table->GetProbabilities();
 }
 
 MakeCrvPhotons::~MakeCrvPhotons()
@@ -338,9 +628,9 @@ static int nPCerenkov=0;
 
     double avgNPhotonsScintillation = _scintillationYield*visibleEnergyDeposited;
     double avgNPhotonsCerenkovInScintillator
-           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov.photonsScintillator)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
+           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov[0])*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
     double avgNPhotonsCerenkovInFiber
-           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov.photonsFiber)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
+           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov[1])*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
 
     int nPhotonsScintillationPerStep          = GetNumberOfPhotonsFromAverage(avgNPhotonsScintillation,nSteps);
     int nPhotonsCerenkovInScintillatorPerStep = GetNumberOfPhotonsFromAverage(avgNPhotonsCerenkovInScintillator,nSteps);
@@ -358,8 +648,8 @@ static int nPCerenkov=0;
                      //0...+pi due to symmetry
       bool isInFiber = IsInsideFiber(p,distanceVector, r,phi);
 
-      const LookupBin *scintillationBin=NULL;
-      const LookupBin *cerenkovBin=NULL;
+      const LookupFlatBin *scintillationBin=NULL;
+      const LookupFlatBin *cerenkovBin=NULL;
       int nPhotonsScintillation=0;
       int nPhotonsCerenkov=0;
       if(isInScintillator)
@@ -395,7 +685,7 @@ nPCerenkov+=nPhotonsCerenkov;
       for(int i=0; i<nPhotons; i++)
       {
         //get the right bin
-        const LookupBin *theBin=cerenkovBin;
+        const LookupFlatBin *theBin=cerenkovBin;
         if(i<nPhotonsScintillation) theBin=scintillationBin;
         if(theBin==NULL) continue;  //this can't actually happen
 
@@ -476,7 +766,7 @@ bool MakeCrvPhotons::IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3
   return true;
 }
 
-double MakeCrvPhotons::GetRandomTime(const LookupBin *theBin)
+double MakeCrvPhotons::GetRandomTime(const LookupFlatBin *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
@@ -486,17 +776,18 @@ double MakeCrvPhotons::GetRandomTime(const LookupBin *theBin)
   size_t timeDelay=0;
   double rand=_randFlat.fire()*theBin->probabilityScaleTimeDelays;
   double sumProb=0;
-  size_t maxTimeDelay=theBin->timeDelays.size();
+  const unsigned char *timeDelays=_probabilities+theBin->timeDelays;
+  size_t maxTimeDelay=theBin->nTimeDelays;
   for(timeDelay=0; timeDelay<maxTimeDelay; ++timeDelay)
   {
-    sumProb+=theBin->timeDelays[timeDelay];
+    sumProb+=timeDelays[timeDelay];
     if(rand<=sumProb) break;
   }
 
   return static_cast<double>(timeDelay);
 }
 
-int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBin *theBin)
+int MakeCrvPhotons::GetRandomFiberEmissions(const LookupFlatBin *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
@@ -506,10 +797,11 @@ int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBin *theBin)
   size_t emissions=0;
   double rand=_randFlat.fire()*theBin->probabilityScaleFiberEmissions;
   double sumProb=0;
-  size_t maxEmissions=theBin->fiberEmissions.size();
+  const unsigned char *fiberEmissions=_probabilities+theBin->fiberEmissions;
+  size_t maxEmissions=theBin->nFiberEmissions;
   for(emissions=0; emissions<maxEmissions; ++emissions)
   {
-    sumProb+=theBin->fiberEmissions[emissions];
+    sumProb+=fiberEmissions[emissions];
     if(rand<=sumProb) break;
   }
 
@@ -542,31 +834,31 @@ const std::vector<double> &MakeCrvPhotons::GetArrivalTimes(int SiPM)
 }
 
 //average number of cerenkov photons per millimeter
-double MakeCrvPhotons::GetAverageNumberOfCerenkovPhotons(double beta, double charge, std::map<double,double> &photons)
+//photons holds (beta, number of photons) pairs ordered by beta
+double MakeCrvPhotons::GetAverageNumberOfCerenkovPhotons(double beta, double charge, const LookupArray &photons)
 {
   if(charge==0) return 0;
 
   bool first=true;
   double prevBeta=0;
   double prevNumberPhotons=0;
-  std::map<double,double>::const_iterator i;
-  for(i=photons.begin(); i!=photons.end(); i++)
+  for(size_t i=0; i+1<photons.size(); i+=2)
   {
-    if(beta<=i->first)
+    if(beta<=photons[i])
     {
       if(first) return 0; //this shouldn't happen
-      double numberPhotons=prevNumberPhotons+(i->second-prevNumberPhotons)/(i->first-prevBeta)*(beta-prevBeta);
+      double numberPhotons=prevNumberPhotons+(photons[i+1]-prevNumberPhotons)/(photons[i]-prevBeta)*(beta-prevBeta);
       numberPhotons*=fabs(charge/eplus);
       return numberPhotons;
     }
     if(first)
     {
-      prevBeta=i->first;
-      prevNumberPhotons=i->second;
+      prevBeta=photons[i];
+      prevNumberPhotons=photons[i+1];
       first=false;
     }
   }
-  return photons.rbegin()->second*fabs(charge/eplus); //this shouldn't happen
+  return photons[photons.size()-1]*fabs(charge/eplus); //this shouldn't happen
 }
 
 } //namespace mu2e
@@ -52,6 +52,7 @@
 #include "TMultiGraph.h"
 #include <TROOT.h>
 
+#include <algorithm>
 #include <chrono>
 
 namespace mu2e {
@@ -104,6 +105,7 @@ namespace mu2e {
       fhicl::Atom<float>         minHelixMomentum       {Name("minHelixMomentum"     ), Comment("min momentum of helix"       )  };
       fhicl::Atom<float>         maxHelixMomentum       {Name("maxHelixMomentum"     ), Comment("max momentum of helix"       )  };
       fhicl::Atom<float>         chi2LineSaveThresh     {Name("chi2LineSaveThresh"   ), Comment("max chi2Dof for line"        )  };
+      fhicl::Atom<bool>          indexedSearch          {Name("indexedSearch"        ), Comment("prune triplets and re-checks")  };
       fhicl::Atom<int>           debugPdgID             {Name("debugPdgID"           ), Comment("pdgID of interest in display")  };
       fhicl::Atom<float>         debugMomentum          {Name("debugMomentum"        ), Comment("lower momentum of interest"  )  };
       fhicl::Atom<std::string>   debugDirection         {Name("debugDirection"       ), Comment("down or up"                  )  };
@@ -246,6 +248,7 @@ namespace mu2e {
     float    _minHelixMomentum;
     float    _maxHelixMomentum;
     float    _chi2LineSaveThresh;
+    bool     _indexedSearch;
 
     //-----------------------------------------------------------------------------
     // fcl params to choose what particle to plot when doing debugging
@@ -272,6 +275,9 @@ namespace mu2e {
     // stuff for doing helix search
     //-----------------------------------------------------------------------------
     std::vector<cHit>             _tcHits;
+    std::vector<XYZVectorF>       _tcHitsPos;       // positions of _tcHits, filled with them
+    std::vector<float>            _tcHitsMaxError2; // largest circleError2 each hit can have
+    size_t                        _firstStrawHit;   // index in _tcHits of the first (highest z) combo hit
     XYZVectorF                    _stopTargPos;
     XYZVectorF                    _caloPos;
     ::LsqSums4                    _circleFitter;
@@ -344,6 +350,7 @@ namespace mu2e {
     void         resetFlags                ();
     void         findHelix                 (size_t tc, HelixSeedCollection& HSColl, bool& findAnotherHelix);
     bool         passesFlags               (size_t& tcHitsIndex);
+    size_t       firstTripletCandidate     (size_t tcHitsIndex, size_t end);
     void         setTripletI               (size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome);
     void         setTripletJ               (size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome);
     void         setTripletK               (size_t& tcHitsIndex, triplet& trip, LoopCondition& outcome);
@@ -415,6 +422,7 @@ namespace mu2e {
     _minHelixMomentum              (config().minHelixMomentum()                      ),
     _maxHelixMomentum              (config().maxHelixMomentum()                      ),
     _chi2LineSaveThresh            (config().chi2LineSaveThresh()                    ),
+    _indexedSearch                 (config().indexedSearch()                         ),
     _debugPdgID                    (config().debugPdgID()                            ),
     _debugMomentum                 (config().debugMomentum()                         ),
     _debugDirection                (config().debugDirection()                        ),
@@ -780,6 +788,20 @@ namespace mu2e {
     std::sort(_tcHits.begin() + sortStartIndex, _tcHits.end(), [&](const cHit& a, const cHit& b) {
         return _chColl->at(a.hitIndice).pos().z() > _chColl->at(b.hitIndice).pos().z();
       });
+    _firstStrawHit = sortStartIndex;
+
+    // cache the positions, and an upper bound on the circle error of each hit: circleError2 is a
+    // weighted mean of wireVar and transVar, the margin covers rounding
+    _tcHitsPos.clear();
+    _tcHitsMaxError2.clear();
+    for (size_t i = 0; i < _tcHits.size(); i++) {
+      _tcHitsPos.push_back(getPos(i));
+      float maxError2 = _caloClusterSigma * _caloClusterSigma;
+      if (_tcHits[i].hitIndice >= 0) {
+        maxError2 = std::max(_chColl->at(_tcHits[i].hitIndice).wireVar(), _chColl->at(_tcHits[i].hitIndice).transVar());
+      }
+      _tcHitsMaxError2.push_back(1.01 * maxError2);
+    }
 
   }
 
@@ -886,7 +908,11 @@ namespace mu2e {
       if (loopCondition == BREAK) {
         break;
       }
-      for (size_t j = i + 1; j < _tcHits.size() - 1; j++) {
+      size_t jStart = i + 1;
+      if (_indexedSearch == true) {
+        jStart = firstTripletCandidate(i, _tcHits.size() - 1);
+      }
+      for (size_t j = jStart; j < _tcHits.size() - 1; j++) {
         setTripletJ(j, tripletInfo, loopCondition);
         if (loopCondition == CONTINUE) {
           continue;
@@ -894,7 +920,11 @@ namespace mu2e {
         if (loopCondition == BREAK) {
           break;
         }
-        for (size_t k = j + 1; k < _tcHits.size(); k++) {
+        size_t kStart = j + 1;
+        if (_indexedSearch == true) {
+          kStart = firstTripletCandidate(j, _tcHits.size());
+        }
+        for (size_t k = kStart; k < _tcHits.size(); k++) {
           setTripletK(k, tripletInfo, loopCondition);
           if (loopCondition == CONTINUE) {
             continue;
@@ -1102,6 +1132,25 @@ namespace mu2e {
     return true;
   }
 
+  //-----------------------------------------------------------------------------
+  // first index after tcHitsIndex, and before end, of a hit that passes the minimum dz cut of
+  // setTripletJ / setTripletK with it. The combo hits are ordered by decreasing z, so the ones that
+  // fail it come first and are skipped with a binary search
+  //-----------------------------------------------------------------------------
+  size_t AgnosticHelixFinder::firstTripletCandidate(size_t tcHitsIndex, size_t end) {
+
+    size_t begin = tcHitsIndex + 1;
+    if (begin < _firstStrawHit || begin >= end || _minTripletDz > _maxTripletDz) {
+      return begin;
+    }
+
+    float z = _tcHitsPos[tcHitsIndex].z();
+    auto first = std::partition_point(_tcHitsPos.begin() + begin, _tcHitsPos.begin() + end,
+                                      [&](const XYZVectorF& pos) { return z - pos.z() < _minTripletDz; });
+
+    return first - _tcHitsPos.begin();
+  }
+
   //-----------------------------------------------------------------------------
   // set ith point of triplet, return outcome value which can be used to direct for loops
   //-----------------------------------------------------------------------------
@@ -1223,6 +1272,7 @@ namespace mu2e {
 
     // project error bars onto the triplet circle found and add to fitter those within defined max
     // residual
+    float maxResidual2 = _maxSeedCircleResidual * _maxSeedCircleResidual;
     for (size_t i = 0; i < _tcHits.size(); i++) {
       if (_tcHits[i].inHelix == true) {
         continue;
@@ -1231,6 +1281,16 @@ namespace mu2e {
         _tcHits[i].used = false;
         continue;
       }
+      // hits too far from the circle for any error they can have are rejected without computing it
+      if (_indexedSearch == true) {
+        float dx = _tcHitsPos[i].x() - xC;
+        float dy = _tcHitsPos[i].y() - yC;
+        float deltaDistance = std::abs(rC - std::sqrt(dx * dx + dy * dy));
+        if (!(deltaDistance * deltaDistance < maxResidual2 * _tcHitsMaxError2[i])) {
+          _tcHits[i].used = false;
+          continue;
+        }
+      }
       computeCircleError2(i, xC, yC);
       if (computeCircleResidual2(i, xC, yC, rC) < _maxSeedCircleResidual * _maxSeedCircleResidual) {
         float wP = 1.0 / (_tcHits[i].circleError2);
@@ -1244,8 +1304,18 @@ namespace mu2e {
     // check if there are enough hits to continue with search
     if (_circleFitter.qn() < _minSeedCircleHits) {
       outcome = CONTINUE;
-    } else {
-      outcome = GOOD;
+      return;
+    }
+    outcome = GOOD;
+
+    // the recovery stage uses the circle errors of the hits not added, so fill those skipped above
+    if (_indexedSearch == true) {
+      for (size_t i = 0; i < _tcHits.size(); i++) {
+        if (_tcHits[i].inHelix == true || _tcHits[i].hitIndice == HitType::STOPPINGTARGET || _tcHits[i].used == true) {
+          continue;
+        }
+        computeCircleError2(i, xC, yC);
+      }
     }
   }
 
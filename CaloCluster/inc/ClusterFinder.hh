@@ -3,38 +3,64 @@
 //
 // Class to find cluster of simply connected crystals
 //
+// The hits of an event are indexed by crystal in one flat array (crystal -> range of hits), and the hits
+// already put in a cluster are marked in a bitmap instead of being removed from per-crystal lists.
+// The neighbors of each crystal are copied from the calorimeter into flat arrays once per geometry.
+//
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
-#include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 
 #include <vector>
-#include <queue>
-#include <list>
 
 namespace mu2e {
 
+    class Calorimeter;
 
     class ClusterFinder
     {
          public:
-             using CaloCrystalList = std::list<const CaloHit*>;
-             using CaloCrystalVec  = std::vector<const CaloHit*>;
+             using CaloCrystalVec = std::vector<const CaloHit*>;
+
+             ClusterFinder(double deltaTime, double ExpandCut, bool addSecondRing);
+
+             // neighbors (and next neighbors if addSecondRing) of each crystal, in the order they are visited
+             void                   setCalorimeter(const Calorimeter&);
+             void                   setNeighbors(const std::vector<std::vector<int>>& neighbors,
+                                                 const std::vector<std::vector<int>>& nextNeighbors);
 
-             ClusterFinder(const Calorimeter&, const CaloHit*, double, double, bool addSecondRing);
+             // index the hits of the event with an energy above the noise cut
+             void                   setHits(const CaloHitCollection&, double EnoiseCut);
+             // remove the hits not compatible in time with any of these clusters
+             void                   filterByTime(const std::vector<double>& clusterTime);
+             // hit passing the noise cut, not yet in a cluster and not filtered out
+             bool                   isAvailable(size_t ihit) const {return available_[ihit];}
+             // the available hits of a crystal
+             CaloCrystalVec         crystalHits(int crystalId) const;
 
-             void                   formCluster(std::vector<CaloCrystalList>&);
-             const CaloCrystalList& clusterList() const {return clusterList_;}
+             // form the cluster around this available hit, sorted by energy
+             void                   formCluster(size_t iseed);
+             const CaloCrystalVec&  clusterList() const {return clusterList_;}
 
 
          private:
-             const Calorimeter*   cal_;
-             const CaloHit*       crystalSeed_;
-             double               seedTime_;
-             CaloCrystalList      clusterList_;
-             std::queue<int>      crystalToVisit_;
-             std::vector<bool>    isVisited_;
-             double               deltaTime_;
-             double               ExpandCut_;
-             bool                 addSecondRing_;
+             double                 deltaTime_;
+             double                 ExpandCut_;
+             bool                   addSecondRing_;
+
+             // crystal i has neighbors neighborIds_[neighborOffsets_[i]] ... neighborIds_[neighborOffsets_[i+1]-1]
+             std::vector<unsigned>  neighborOffsets_;
+             std::vector<int>       neighborIds_;
+
+             // crystal i has hits hitsBegin_[i] ... hitsBegin_[i+1]-1 in crystalHits_, in collection order
+             const CaloHitCollection* hits_;
+             std::vector<unsigned>  hitsBegin_;
+             std::vector<unsigned>  crystalHits_;
+             std::vector<bool>      available_;
+
+             // a crystal is visited in this cluster if its stamp is the cluster number
+             std::vector<unsigned>  visitStamp_;
+             unsigned               nCluster_;
+             std::vector<int>       crystalToVisit_;
+             CaloCrystalVec         clusterList_;
     };
 
 
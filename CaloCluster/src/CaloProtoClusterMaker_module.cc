@@ -13,10 +13,13 @@
 // Note 1: Seed do not need to be ordered by energy
 // Note 2: The cluster time is taken as that of the most energetic hit -> potential for improvement (have fun)
 // Note 3: Several optimization obscured the code for little gain, so I sticked to simplicity
+// Note 4: The hits are indexed by crystal in flat arrays and marked when used (see ClusterFinder), the seeds
+//         are taken in the order of the hit collection, as the pointer-ordered sets did before
 //
 
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
 #include "cetlib_except/exception.h"
 #include "fhiclcpp/types/Atom.h"
 
@@ -29,8 +32,6 @@
 
 #include <iostream>
 #include <string>
-#include <list>
-#include <set>
 #include <vector>
 
 
@@ -40,7 +41,6 @@ namespace mu2e {
   {
      public:
         typedef std::vector<const CaloHit*>  CaloCrystalVec;
-        typedef std::list<const CaloHit*>    CaloCrystalList;
 
         struct Config
         {
@@ -63,12 +63,14 @@ namespace mu2e {
           ExpandCut_       (config().ExpandCut()),
           addSecondRing_   (config().addSecondRing()),
           deltaTime_       (config().deltaTime()),
-          diagLevel_       (config().diagLevel())
+          diagLevel_       (config().diagLevel()),
+          finder_          (deltaTime_, ExpandCut_, addSecondRing_)
         {
            produces<CaloProtoClusterCollection>("main");
            produces<CaloProtoClusterCollection>("split");
         }
 
+        void beginRun(art::Run& run) override;
         void produce(art::Event& e) override;
 
      private:
@@ -79,14 +81,20 @@ namespace mu2e {
         bool                                 addSecondRing_;
         double                               deltaTime_;
         int                                  diagLevel_;
+        ClusterFinder                        finder_;
 
         void makeProtoClusters (CaloProtoClusterCollection&,CaloProtoClusterCollection&, const art::Handle<CaloHitCollection>&);
-        void filterByTime      (CaloCrystalList&, const std::vector<double>&);
-        void fillCluster       (CaloProtoClusterCollection&, const CaloCrystalList&,const art::Handle<CaloHitCollection>&);
-        void dump              (const std::string&, const std::vector<CaloCrystalList>&, std::set<const CaloHit*>);
+        void fillCluster       (CaloProtoClusterCollection&, const CaloCrystalVec&,const art::Handle<CaloHitCollection>&);
+        void dump              (const std::string&, const CaloHitCollection&, bool mainSeeds);
   };
 
 
+  void CaloProtoClusterMaker::beginRun(art::Run&)
+  {
+      finder_.setCalorimeter(*(GeomHandle<Calorimeter>()));
+  }
+
+
   void CaloProtoClusterMaker::produce(art::Event& event)
   {
       art::Handle<CaloHitCollection> CaloHitsHandle = event.getHandle<CaloHitCollection>(caloCrystalToken_);
@@ -105,60 +113,44 @@ namespace mu2e {
                                                 CaloProtoClusterCollection& caloProtoClustersSplit,
                                                 const art::Handle<CaloHitCollection> & CaloHitsHandle)
   {
-      const Calorimeter& cal = *(GeomHandle<Calorimeter>());
       const CaloHitCollection& CaloHits(*CaloHitsHandle);
       if (CaloHits.empty()) return;
 
 
-      //declare and fill the hash map crystal_id -> list of CaloHits
-      std::vector<CaloCrystalList> mainClusterList, splitClusterList, caloIdHitMap(cal.nCrystal());
-      std::set<const CaloHit*> seedList;
-      std::vector<double>      clusterTime;
+      //index the hits by crystal, a hit is a seed if its energy is above EminSeed
+      std::vector<CaloCrystalVec> mainClusterList, splitClusterList;
+      std::vector<double>         clusterTime;
 
-      //fill data structures
-      for (const auto& hit : CaloHits)
-      {
-          if (hit.energyDep() < EnoiseCut_) continue;
-          caloIdHitMap[hit.crystalID()].push_back(&hit);
-          if (hit.energyDep() > EminSeed_ ) seedList.insert(&hit);
-      }
+      finder_.setHits(CaloHits, EnoiseCut_);
 
-      if (diagLevel_ > 2) dump("Init", caloIdHitMap,seedList);
+      if (diagLevel_ > 2) dump("Init", CaloHits, true);
 
 
 
       //produce main clusters
-      while( !seedList.empty() )
+      for (size_t i=0; i<CaloHits.size(); ++i)
       {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal, crystalSeed, deltaTime_, ExpandCut_, addSecondRing_);
-          finder.formCluster(caloIdHitMap);
+          if (!finder_.isAvailable(i) || !(CaloHits[i].energyDep() > EminSeed_)) continue;
+          finder_.formCluster(i);
 
-          mainClusterList.push_back(finder.clusterList());
-          clusterTime.push_back(crystalSeed->time());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
+          mainClusterList.push_back(finder_.clusterList());
+          clusterTime.push_back(CaloHits[i].time());
       }
 
 
-      //filter unneeded hits and fill new seeds
-      for (unsigned i=0; i < caloIdHitMap.size(); ++i ) filterByTime(caloIdHitMap[i], clusterTime);
-      for (const auto& liste: caloIdHitMap) {for (const auto& ptr : liste) seedList.insert(ptr);}
-      if (diagLevel_ > 2) dump("Post filtering", caloIdHitMap,seedList);
+      //filter unneeded hits, all remaining hits are seeds
+      finder_.filterByTime(clusterTime);
+      if (diagLevel_ > 2) dump("Post filtering", CaloHits, false);
 
 
 
 
       //produce split-offs clusters
-      while (!seedList.empty())
+      for (size_t i=0; i<CaloHits.size(); ++i)
       {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal,crystalSeed,deltaTime_, ExpandCut_, addSecondRing_);
-
-          finder.formCluster(caloIdHitMap);
-          splitClusterList.push_back(finder.clusterList());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
+          if (!finder_.isAvailable(i)) continue;
+          finder_.formCluster(i);
+          splitClusterList.push_back(finder_.clusterList());
       }
 
       //save the main and split clusters
@@ -181,7 +173,7 @@ namespace mu2e {
 
   //----------------------------------------------------------------------------------------------------------
   void CaloProtoClusterMaker::fillCluster(CaloProtoClusterCollection& caloProtoClustersColl,
-                                          const CaloCrystalList& clusterPtrList,
+                                          const CaloCrystalVec& clusterPtrList,
                                           const art::Handle<CaloHitCollection>& CaloHitsHandle)
   {
       const CaloHitCollection& CaloHits(*CaloHitsHandle);
@@ -224,38 +216,25 @@ namespace mu2e {
 
 
   //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::filterByTime(CaloCrystalList& liste, const std::vector<double>& clusterTime)
-  {
-      auto it = liste.begin();
-      while (it != liste.end())
-      {
-          const CaloHit* hit = *it;
-
-          auto itTime = clusterTime.begin();
-          while (itTime != clusterTime.end()){if ( (*itTime - hit->time()) < deltaTime_) break; ++itTime;}
-
-          if (itTime == clusterTime.end() ) it = liste.erase(it);
-          else ++it;
-      }
-  }
-
-
-
-  //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::dump(const std::string& title, const std::vector<CaloCrystalList>& caloIdHitMap,
-                                            std::set<const CaloHit*> seedList)
+  void CaloProtoClusterMaker::dump(const std::string& title, const CaloHitCollection& CaloHits, bool mainSeeds)
   {
       std::cout<<title<<std::endl;
       std::cout<<"Cache content"<<std::endl;
-      for (unsigned i=0;i<caloIdHitMap.size();++i)
+      int nCrystal = GeomHandle<Calorimeter>()->nCrystal();
+      for (int i=0;i<nCrystal;++i)
       {
-         if (caloIdHitMap[i].empty()) continue;
+         auto hits = finder_.crystalHits(i);
+         if (hits.empty()) continue;
          std::cout<<"Crystal idx "<<i<<std::endl;
-         for (auto& ptr : caloIdHitMap[i]) std::cout<<ptr<<" "<<ptr->energyDep()<<"  ";
+         for (auto& ptr : hits) std::cout<<ptr<<" "<<ptr->energyDep()<<"  ";
          std::cout<<std::endl;
       }
       std::cout<<"Seeds  "<<std::endl;
-      for (auto& ptr :seedList) std::cout<<ptr<<" ";
+      for (size_t i=0;i<CaloHits.size();++i)
+      {
+         if (!finder_.isAvailable(i) || (mainSeeds && !(CaloHits[i].energyDep() > EminSeed_))) continue;
+         std::cout<<&CaloHits[i]<<" ";
+      }
       std::cout<<std::endl;
   }
 
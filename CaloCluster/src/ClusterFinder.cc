@@ -1,73 +1,152 @@
 #include "Offline/CaloCluster/inc/ClusterFinder.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
-#include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 
-#include <iostream>
-#include <vector>
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 
 namespace mu2e {
 
-        ClusterFinder::ClusterFinder(const Calorimeter& cal, const CaloHit* crystalSeed, double deltaTime, double ExpandCut, bool addSecondRing) :
-          cal_(&cal), crystalSeed_(crystalSeed), seedTime_(crystalSeed->time()), clusterList_(), crystalToVisit_(), isVisited_(cal.nCrystal()),
-          deltaTime_(deltaTime), ExpandCut_(ExpandCut), addSecondRing_(addSecondRing)
+        ClusterFinder::ClusterFinder(double deltaTime, double ExpandCut, bool addSecondRing) :
+          deltaTime_(deltaTime), ExpandCut_(ExpandCut), addSecondRing_(addSecondRing),
+          neighborOffsets_(1,0), neighborIds_(), hits_(nullptr), hitsBegin_(), crystalHits_(), available_(),
+          visitStamp_(), nCluster_(0), crystalToVisit_(), clusterList_()
         {}
 
 
-        void ClusterFinder::formCluster(std::vector<CaloCrystalList>& idHitVec)
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::setCalorimeter(const Calorimeter& cal)
         {
-            std::fill(isVisited_.begin(), isVisited_.end(), false);
+            std::vector<std::vector<int>> neighbors(cal.nCrystal()), nextNeighbors(cal.nCrystal());
+            for (int i=0; i<cal.nCrystal(); ++i)
+            {
+                neighbors[i]     = cal.crystal(i).neighbors();
+                nextNeighbors[i] = cal.nextNeighbors(i);
+            }
+            setNeighbors(neighbors, nextNeighbors);
+        }
 
-            clusterList_.clear();
-            clusterList_.push_front(crystalSeed_);
-            crystalToVisit_.push(crystalSeed_->crystalID());
+        void ClusterFinder::setNeighbors(const std::vector<std::vector<int>>& neighbors,
+                                         const std::vector<std::vector<int>>& nextNeighbors)
+        {
+            neighborOffsets_.assign(1,0);
+            neighborIds_.clear();
+            for (size_t i=0; i<neighbors.size(); ++i)
+            {
+                neighborIds_.insert(neighborIds_.end(), neighbors[i].begin(), neighbors[i].end());
+                if (addSecondRing_) neighborIds_.insert(neighborIds_.end(), nextNeighbors[i].begin(), nextNeighbors[i].end());
+                neighborOffsets_.push_back(neighborIds_.size());
+            }
+            visitStamp_.assign(neighbors.size(),0);
+            nCluster_ = 0;
+        }
 
-            CaloCrystalList& liste = idHitVec[crystalSeed_->crystalID()];
-            liste.erase(std::find(liste.begin(), liste.end(), crystalSeed_));
 
-            while (!crystalToVisit_.empty())
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::setHits(const CaloHitCollection& hits, double EnoiseCut)
+        {
+            size_t nCrystal = neighborOffsets_.size()-1;
+            hits_ = &hits;
+            available_.assign(hits.size(),false);
+            hitsBegin_.assign(nCrystal+1,0);
+
+            // count the hits of each crystal, then place them after those of the previous crystals
+            for (size_t i=0; i<hits.size(); ++i)
             {
-                 int visitId         = crystalToVisit_.front();
-                 isVisited_[visitId] = true;
+                if (hits[i].energyDep() < EnoiseCut) continue;
+                available_[i] = true;
+                ++hitsBegin_[hits[i].crystalID()+1];
+            }
+            for (size_t i=0; i<nCrystal; ++i) hitsBegin_[i+1] += hitsBegin_[i];
 
-                 std::vector<int>  neighborsId = cal_->crystal(visitId).neighbors();
-                 if (addSecondRing_) neighborsId.insert(neighborsId.end(), cal_->nextNeighbors(visitId).begin(), cal_->nextNeighbors(visitId).end());
+            crystalHits_.resize(hitsBegin_[nCrystal]);
+            std::vector<unsigned> next(hitsBegin_.begin(), hitsBegin_.end()-1);
+            for (size_t i=0; i<hits.size(); ++i)
+            {
+                if (available_[i]) crystalHits_[next[hits[i].crystalID()]++] = i;
+            }
 
-                 for (auto& iId : neighborsId)
-                 {
-                     if (isVisited_[iId]) continue;
-                     isVisited_[iId] = true;
-                     CaloCrystalList& list = idHitVec[iId];
+            std::fill(visitStamp_.begin(), visitStamp_.end(), 0);
+            nCluster_ = 0;
+        }
 
-                     auto it=list.begin();
-                     while(it != list.end())
-                     {
-                         CaloHit const* hit = *it;
-                         if (std::abs(hit->time() - seedTime_) < deltaTime_)
-                         {
-                             if (hit->energyDep() > ExpandCut_) crystalToVisit_.push(iId);
-                             clusterList_.push_front(hit);
-                             it = list.erase(it);
-                         }
-                         else ++it;
-                     }
-                 }
 
-                 crystalToVisit_.pop();
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::filterByTime(const std::vector<double>& clusterTime)
+        {
+            // the earliest cluster is compatible with a hit if any is
+            double tmin(0);
+            if (!clusterTime.empty()) tmin = *std::min_element(clusterTime.begin(), clusterTime.end());
+
+            for (size_t i=0; i<available_.size(); ++i)
+            {
+                if (!available_[i]) continue;
+                if (clusterTime.empty() || !((tmin - (*hits_)[i].time()) < deltaTime_)) available_[i] = false;
             }
+        }
 
-            // make sure to sort proto0cluster by energy
-            clusterList_.sort([](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
-       }
 
-}
+        //----------------------------------------------------------------------------------------------------------
+        ClusterFinder::CaloCrystalVec ClusterFinder::crystalHits(int crystalId) const
+        {
+            CaloCrystalVec list;
+            for (unsigned ih=hitsBegin_[crystalId]; ih<hitsBegin_[crystalId+1]; ++ih)
+            {
+                if (available_[crystalHits_[ih]]) list.push_back(&(*hits_)[crystalHits_[ih]]);
+            }
+            return list;
+        }
+
 
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::formCluster(size_t iseed)
+        {
+            ++nCluster_;
+            const CaloHit* crystalSeed = &(*hits_)[iseed];
+            double seedTime            = crystalSeed->time();
+
+            clusterList_.clear();
+            clusterList_.push_back(crystalSeed);
+            available_[iseed] = false;
 
+            crystalToVisit_.clear();
+            crystalToVisit_.push_back(crystalSeed->crystalID());
 
+            for (size_t ivisit=0; ivisit<crystalToVisit_.size(); ++ivisit)
+            {
+                 int visitId = crystalToVisit_[ivisit];
+                 visitStamp_[visitId] = nCluster_;
 
+                 for (unsigned in=neighborOffsets_[visitId]; in<neighborOffsets_[visitId+1]; ++in)
+                 {
+                     int iId = neighborIds_[in];
+                     if (visitStamp_[iId] == nCluster_) continue;
+                     visitStamp_[iId] = nCluster_;
 
+                     bool expand(false);
+                     for (unsigned ih=hitsBegin_[iId]; ih<hitsBegin_[iId+1]; ++ih)
+                     {
+                         unsigned ihit = crystalHits_[ih];
+                         if (!available_[ihit]) continue;
 
+                         CaloHit const* hit = &(*hits_)[ihit];
+                         if (std::abs(hit->time() - seedTime) < deltaTime_)
+                         {
+                             if (hit->energyDep() > ExpandCut_) expand = true;
+                             clusterList_.push_back(hit);
+                             available_[ihit] = false;
+                         }
+                     }
+                     if (expand) crystalToVisit_.push_back(iId);
+                 }
+            }
 
+            // make sure to sort proto-cluster by energy, the latest hit added first among equal energies
+            std::reverse(clusterList_.begin(), clusterList_.end());
+            std::stable_sort(clusterList_.begin(), clusterList_.end(),
+                             [](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
+       }
 
+}
@@ -0,0 +1,254 @@
+//
+// Benchmark of the proto-cluster finding of CaloProtoClusterMaker on made up events, a few showers on top
+// of many pile-up hits spread in time, on two disks of square crystals. The clusters are formed with
+// ClusterFinder and with the per-crystal lists and seed set used before, and checked to be identical.
+//
+// arguments are
+// NEVENT:  optional, number of events (default 200)
+// NPILEUP: optional, number of pile-up hits per event (default 3000)
+//
+// example:
+// ProtoClusterBench 500 6000
+//
+#include "Offline/CaloCluster/inc/ClusterFinder.hh"
+#include "Offline/RecoDataProducts/inc/CaloHit.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace {
+
+  // the CaloProtoClusterMaker defaults
+  const double EminSeed(10), EnoiseCut(1), ExpandCut(1), deltaTime(2);
+  const int    nSide(26), nDisk(2), nCrystal(nDisk*nSide*nSide);
+
+  using CaloCrystalList = std::list<const CaloHit*>;
+  using CaloCrystalVec  = std::vector<const CaloHit*>;
+  using Neighbors       = std::vector<std::vector<int>>;
+
+  // crystals at a distance of ring rows or columns on the same disk
+  Neighbors makeNeighbors(int ring)
+  {
+      Neighbors neighbors(nCrystal);
+      for (int id=0; id<nCrystal; ++id)
+      {
+          int disk = id/(nSide*nSide), ix = (id/nSide)%nSide, iy = id%nSide;
+          for (int dx=-ring; dx<=ring; ++dx)
+          {
+              for (int dy=-ring; dy<=ring; ++dy)
+              {
+                  if (std::max(std::abs(dx),std::abs(dy)) != ring) continue;
+                  if (ix+dx<0 || ix+dx>=nSide || iy+dy<0 || iy+dy>=nSide) continue;
+                  neighbors[id].push_back(disk*nSide*nSide + (ix+dx)*nSide + iy+dy);
+              }
+          }
+      }
+      return neighbors;
+  }
+
+  CaloHitCollection makeEvent(std::mt19937& gen, int nPileup)
+  {
+      std::uniform_int_distribution<int>     crystal(0,nCrystal-1);
+      std::uniform_real_distribution<float>  time(500,1700), flat(0,1);
+      std::exponential_distribution<float>   pileupEnergy(1.0/3.0);
+      std::normal_distribution<float>        jitter(0,0.5);
+
+      CaloHitCollection hits;
+      for (int i=0; i<nPileup; ++i) hits.emplace_back(crystal(gen), 2, time(gen), pileupEnergy(gen));
+
+      // showers, sharing energy with the crystals around the seed
+      for (int i=0; i<10; ++i)
+      {
+          int   id = crystal(gen), ix = (id/nSide)%nSide, iy = id%nSide;
+          float t0 = time(gen), e0 = 30 + 70*flat(gen);
+          for (int dx=-2; dx<=2; ++dx)
+          {
+              for (int dy=-2; dy<=2; ++dy)
+              {
+                  if (ix+dx<0 || ix+dx>=nSide || iy+dy<0 || iy+dy>=nSide) continue;
+                  float e = e0*std::exp(-1.5f*(std::abs(dx)+std::abs(dy)))*(0.5f+flat(gen));
+                  hits.emplace_back(id + dx*nSide + dy, 2, t0+jitter(gen), e);
+              }
+          }
+      }
+      std::shuffle(hits.begin(), hits.end(), gen);
+      return hits;
+  }
+
+
+  // the cluster finding before ClusterFinder, with the lists and seed sets of CaloProtoClusterMaker
+  void formClusterLists(const Neighbors& neighbors, const CaloHit* crystalSeed,
+                        std::vector<CaloCrystalList>& idHitVec, CaloCrystalList& clusterList)
+  {
+      std::vector<bool> isVisited(nCrystal,false);
+      std::queue<int>   crystalToVisit;
+      double            seedTime = crystalSeed->time();
+
+      clusterList.clear();
+      clusterList.push_front(crystalSeed);
+      crystalToVisit.push(crystalSeed->crystalID());
+
+      CaloCrystalList& liste = idHitVec[crystalSeed->crystalID()];
+      liste.erase(std::find(liste.begin(), liste.end(), crystalSeed));
+
+      while (!crystalToVisit.empty())
+      {
+          int visitId = crystalToVisit.front();
+          isVisited[visitId] = true;
+          for (auto& iId : neighbors[visitId])
+          {
+              if (isVisited[iId]) continue;
+              isVisited[iId] = true;
+              CaloCrystalList& list = idHitVec[iId];
+              auto it=list.begin();
+              while (it != list.end())
+              {
+                  CaloHit const* hit = *it;
+                  if (std::abs(hit->time() - seedTime) < deltaTime)
+                  {
+                      if (hit->energyDep() > ExpandCut) crystalToVisit.push(iId);
+                      clusterList.push_front(hit);
+                      it = list.erase(it);
+                  }
+                  else ++it;
+              }
+          }
+          crystalToVisit.pop();
+      }
+      clusterList.sort([](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
+  }
+
+  std::vector<CaloCrystalVec> clustersLists(const Neighbors& neighbors, const CaloHitCollection& hits)
+  {
+      std::vector<CaloCrystalVec>  clusters;
+      std::vector<CaloCrystalList> caloIdHitMap(nCrystal);
+      std::set<const CaloHit*>     seedList;
+      std::vector<double>          clusterTime;
+      CaloCrystalList              clusterList;
+
+      for (const auto& hit : hits)
+      {
+          if (hit.energyDep() < EnoiseCut) continue;
+          caloIdHitMap[hit.crystalID()].push_back(&hit);
+          if (hit.energyDep() > EminSeed) seedList.insert(&hit);
+      }
+      while (!seedList.empty())
+      {
+          const CaloHit* crystalSeed = *seedList.begin();
+          formClusterLists(neighbors, crystalSeed, caloIdHitMap, clusterList);
+          clusters.emplace_back(clusterList.begin(), clusterList.end());
+          clusterTime.push_back(crystalSeed->time());
+          for (const auto& hit : clusterList) seedList.erase(hit);
+      }
+
+      for (auto& liste : caloIdHitMap)
+      {
+          auto it = liste.begin();
+          while (it != liste.end())
+          {
+              auto itTime = clusterTime.begin();
+              while (itTime != clusterTime.end()) {if ((*itTime - (*it)->time()) < deltaTime) break; ++itTime;}
+              if (itTime == clusterTime.end()) it = liste.erase(it);
+              else ++it;
+          }
+      }
+      for (const auto& liste : caloIdHitMap) {for (const auto& ptr : liste) seedList.insert(ptr);}
+
+      while (!seedList.empty())
+      {
+          formClusterLists(neighbors, *seedList.begin(), caloIdHitMap, clusterList);
+          clusters.emplace_back(clusterList.begin(), clusterList.end());
+          for (const auto& hit : clusterList) seedList.erase(hit);
+      }
+      return clusters;
+  }
+
+
+  // the cluster finding of CaloProtoClusterMaker
+  std::vector<CaloCrystalVec> clustersFinder(ClusterFinder& finder, const CaloHitCollection& hits)
+  {
+      std::vector<CaloCrystalVec> clusters;
+      std::vector<double>         clusterTime;
+
+      finder.setHits(hits, EnoiseCut);
+      for (size_t i=0; i<hits.size(); ++i)
+      {
+          if (!finder.isAvailable(i) || !(hits[i].energyDep() > EminSeed)) continue;
+          finder.formCluster(i);
+          clusters.push_back(finder.clusterList());
+          clusterTime.push_back(hits[i].time());
+      }
+      finder.filterByTime(clusterTime);
+      for (size_t i=0; i<hits.size(); ++i)
+      {
+          if (!finder.isAvailable(i)) continue;
+          finder.formCluster(i);
+          clusters.push_back(finder.clusterList());
+      }
+      return clusters;
+  }
+
+}
+
+
+int main(int argc, char** argv)
+{
+    int nEvent  = argc > 1 ? std::stoi(argv[1]) : 200;
+    int nPileup = argc > 2 ? std::stoi(argv[2]) : 3000;
+
+    Neighbors neighbors = makeNeighbors(1), nextNeighbors = makeNeighbors(2);
+    std::mt19937 gen(2468);
+
+    std::cout<<"ProtoClusterBench mean time per event in ms, "<<nEvent<<" events with "<<nPileup<<" pile-up hits"<<std::endl;
+    std::cout<<std::setw(12)<<"second ring"<<std::setw(12)<<"clusters"<<std::setw(12)<<"lists"<<std::setw(12)<<"finder"<<std::endl;
+
+    int nBad(0);
+    for (bool addSecondRing : {false, true})
+    {
+        ClusterFinder finder(deltaTime, ExpandCut, addSecondRing);
+        finder.setNeighbors(neighbors, nextNeighbors);
+
+        Neighbors visited(neighbors);
+        if (addSecondRing) for (int i=0; i<nCrystal; ++i) visited[i].insert(visited[i].end(), nextNeighbors[i].begin(), nextNeighbors[i].end());
+
+        double tLists(0), tFinder(0);
+        long nCluster(0);
+        for (int ievt=0; ievt<nEvent; ++ievt)
+        {
+            CaloHitCollection hits = makeEvent(gen, nPileup);
+
+            auto t0 = std::chrono::high_resolution_clock::now();
+            auto clustersOld = clustersLists(visited, hits);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            auto clustersNew = clustersFinder(finder, hits);
+            auto t2 = std::chrono::high_resolution_clock::now();
+
+            tLists  += std::chrono::duration<double>(t1-t0).count();
+            tFinder += std::chrono::duration<double>(t2-t1).count();
+            nCluster += clustersNew.size();
+            if (clustersOld != clustersNew) ++nBad;
+        }
+
+        std::cout<<std::setw(12)<<addSecondRing<<std::setw(12)<<nCluster/std::max(nEvent,1)<<std::fixed<<std::setprecision(3)
+                 <<std::setw(12)<<1e3*tLists/std::max(nEvent,1)<<std::setw(12)<<1e3*tFinder/std::max(nEvent,1)<<std::endl;
+    }
+
+    if (nBad > 0)
+    {
+        std::cout<<"ProtoClusterBench FAILED "<<nBad<<" events with different clusters"<<std::endl;
+        return 1;
+    }
+    std::cout<<"ProtoClusterBench passed"<<std::endl;
+    return 0;
+}
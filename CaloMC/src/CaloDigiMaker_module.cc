@@ -3,6 +3,10 @@
 // Individual photo-electrons are generated for each readout, including photo-statistic fluctuations
 // Simulate digitization procedure and produce CaloDigis.
 //
+// Note: with nPEBinsPerSample > 0, the PE times of a readout are histogrammed in that many bins per sample and the
+//       histogram is convolved with the digitized pulse averaged over each bin, instead of adding the pulse of every
+//       PE. The cost no longer scales with the number of PEs. With as many bins as CaloPulseShape phases, the
+//       waveform is the same as adding the pulses one by one, with fewer bins it is the same on average.
 //
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
@@ -69,6 +73,7 @@ namespace mu2e {
              fhicl::Atom<unsigned>      nBinsPeak            { Name("nBinsPeak"),              Comment("Window size for finding local maximum to digitize wf") };
              fhicl::Atom<int>           minPeakADC           { Name("minPeakADC"),             Comment("Minimum ADC hits of local peak to digitize") };
              fhicl::Atom<unsigned>      bufferDigi           { Name("bufferDigi"),             Comment("Number of timeStamps for the buffer digi") };
+             fhicl::Atom<unsigned>      nPEBinsPerSample     { Name("nPEBinsPerSample"),       Comment("PE time bins per sample to convolve with pulse, 0 to add each PE"),0 };
              fhicl::Atom<int>           diagLevel            { Name("diagLevel"),              Comment("Diag Level"),0 };
          };
 
@@ -84,6 +89,10 @@ namespace mu2e {
             startTimeBuffer_   (config().digiSampling()*config().bufferDigi()),
             maxADCCounts_      (1 << config().nBits()),
             pulseShape_        (CaloPulseShape(config().digiSampling())),
+            nPEBins_           (config().nPEBinsPerSample()),
+            pulseKernels_      (),
+            peHist_            (),
+            peHistBins_        (),
             wfExtractor_       (config().bufferDigi(),config().nBinsPeak(),config().minPeakADC(),config().bufferDigi()),
             engine_            (createEngine(art::ServiceHandle<SeedService>()->getSeed())),
             addNoise_          (config().addNoise()),
@@ -109,6 +118,8 @@ namespace mu2e {
        void makeDigitization  (const CaloShowerROCollection&, CaloDigiCollection&, const EventWindowMarker&, const ProtonBunchTimeMC&);
        bool fillROHits        (unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection&,
                                const ConditionsHandle<CalorimeterCalibrations>&, const ProtonBunchTimeMC&);
+       void buildPulseKernels ();
+       void convolvePEHist    (std::vector<double>& waveform, float scaleFactor);
        void generateSpotNoise (std::vector<double>& waveform, unsigned iRO, const ConditionsHandle<CalorimeterCalibrations>&);
        void buildOutputDigi   (unsigned iRO, std::vector<double>& waveform, int pedestal, CaloDigiCollection&);
        void diag0             (unsigned, const std::vector<int>&);
@@ -127,6 +138,10 @@ namespace mu2e {
        double                  startTimeBuffer_;
        int                     maxADCCounts_;
        CaloPulseShape          pulseShape_;
+       unsigned                nPEBins_;
+       std::vector<std::vector<double>> pulseKernels_;
+       std::vector<double>     peHist_;
+       std::vector<unsigned>   peHistBins_;
        CaloWFExtractor         wfExtractor_;
        CLHEP::HepRandomEngine& engine_;
        bool                    addNoise_;
@@ -141,6 +156,7 @@ namespace mu2e {
   void CaloDigiMaker::beginRun(art::Run& aRun)
   {
       pulseShape_.buildShapes();
+      if (nPEBins_ > 0) buildPulseKernels();
       if (addNoise_) noiseGenerator_.initialize(wfExtractor_);
   }
 
@@ -197,6 +213,7 @@ namespace mu2e {
       if (waveformSize<1) throw cet::exception("Rethrow")<< "[CaloMC/CaloDigiMaker] digitization size too short " << std::endl;
       bool resetWaveform(false);
       std::vector<double> waveform(waveformSize,0.0);
+      if (nPEBins_ > 0) peHist_.assign(waveformSize*nPEBins_,0.0);
 
       for (int iRO=0;iRO<nWaveforms;++iRO)
       {
@@ -237,6 +254,15 @@ namespace mu2e {
           {
               //PE time is given in DR frame, we need to subtract the event window start and the digi Start time
               float       time           = PEtime + pbtmc.pbtime_- digitizationStart_ + timeFromProtonsToDRMarker_ + startTimeBuffer_;
+              if (nPEBins_ > 0)
+              {
+                  if (time < 0 || time/digiSampling_ >= waveform.size()) continue;
+                  unsigned ibin = unsigned(time/digiSampling_)*nPEBins_ + pulseShape_.phase(time)*nPEBins_/pulseShape_.nPhase();
+                  if (peHist_[ibin] < 1) peHistBins_.push_back(ibin);
+                  peHist_[ibin] += 1;
+                  continue;
+              }
+
               unsigned    startSample    = std::max(0u,unsigned(time/digiSampling_));
               const auto& pulse          = pulseShape_.digitizedPulse(time);
               unsigned    stopSample     = std::min(startSample+pulse.size(), waveform.size());
@@ -245,10 +271,52 @@ namespace mu2e {
                  waveform.at(timeSample) += pulse.at(timeSample - startSample)*scaleFactor;
           }
       }
+      if (nPEBins_ > 0) convolvePEHist(waveform, scaleFactor);
       return isEmpty;
   }
 
 
+  //--------------------------------------------------------------------------
+  // the kernel of a PE time bin is the digitized pulse averaged over the pulse shape phases in that bin
+  void CaloDigiMaker::buildPulseKernels()
+  {
+      unsigned nPhase = pulseShape_.nPhase();
+      if (nPEBins_ > nPhase) throw cet::exception("CATEGORY")<< "CaloDigiMaker: nPEBinsPerSample larger than the "<<nPhase<<" pulse shape phases";
+
+      pulseKernels_.assign(nPEBins_, std::vector<double>());
+      std::vector<unsigned> nPhaseInBin(nPEBins_,0);
+      for (unsigned iphase=0;iphase<nPhase;++iphase)
+      {
+          unsigned    ibin  = iphase*nPEBins_/nPhase;
+          const auto& pulse = pulseShape_.digitizedPulse((iphase+0.5)*digiSampling_/nPhase);
+          if (pulseKernels_[ibin].empty()) pulseKernels_[ibin].assign(pulse.size(),0.0);
+          for (size_t i=0;i<pulse.size();++i) pulseKernels_[ibin][i] += pulse[i];
+          ++nPhaseInBin[ibin];
+      }
+      for (unsigned ibin=0;ibin<nPEBins_;++ibin) {for (auto& val : pulseKernels_[ibin]) val /= nPhaseInBin[ibin];}
+  }
+
+
+  //--------------------------------------------------------------------------
+  // add the pulse of each filled PE time bin weighted by its content, and clear the histogram for the next readout
+  void CaloDigiMaker::convolvePEHist(std::vector<double>& waveform, float scaleFactor)
+  {
+      for (const auto ibin : peHistBins_)
+      {
+          const auto& kernel      = pulseKernels_[ibin%nPEBins_];
+          unsigned    startSample = ibin/nPEBins_;
+          unsigned    stopSample  = std::min(startSample+kernel.size(), waveform.size());
+          double      weight      = peHist_[ibin]*scaleFactor;
+
+          for (size_t timeSample = startSample; timeSample < stopSample; ++timeSample)
+             waveform[timeSample] += kernel[timeSample - startSample]*weight;
+
+          peHist_[ibin] = 0;
+      }
+      peHistBins_.clear();
+  }
+
+
   //----------------------------------------------------------------------------------------------------------
   void CaloDigiMaker::generateSpotNoise(std::vector<double>& waveform, unsigned iRO,
                                         const ConditionsHandle<CalorimeterCalibrations>& calorimeterCalibrations)
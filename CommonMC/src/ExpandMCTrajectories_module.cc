@@ -0,0 +1,66 @@
+// Restore MCTrajectoryCollections from MCTrajectoryCompactCollections,
+// for the modules reading MCTrajectories (the compression modules, the
+// event display, Mu2eG4 inputMCTrajectories, ...) from files written with
+// Mu2eG4 TrajectoryControl.compact.  Each output has the instance name of
+// its input.
+//
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Sequence.h"
+
+#include "Offline/MCDataProducts/inc/MCTrajectoryCollection.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
+
+namespace mu2e {
+
+  class ExpandMCTrajectories : public art::EDProducer {
+  public:
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+      fhicl::Sequence<art::InputTag> inputs { Name("inputs"), Comment("MCTrajectoryCompactCollections to expand") };
+    };
+
+    using Parameters = art::EDProducer::Table<Config>;
+    explicit ExpandMCTrajectories(const Parameters& conf);
+
+    void produce(art::Event& event) override;
+
+  private:
+    std::vector<art::InputTag> inputs_;
+  };
+
+  ExpandMCTrajectories::ExpandMCTrajectories(const Parameters& conf)
+    : art::EDProducer{conf}
+    , inputs_(conf().inputs())
+  {
+    std::set<std::string> instances;
+    for(const auto& tag : inputs_) {
+      if(!instances.insert(tag.instance()).second) {
+        throw cet::exception("CONFIG")<<"ExpandMCTrajectories: duplicate instance name in inputs: "<<tag<<"\n";
+      }
+      consumes<MCTrajectoryCompactCollection>(tag);
+      produces<MCTrajectoryCollection>(tag.instance());
+    }
+  }
+
+  void ExpandMCTrajectories::produce(art::Event& event) {
+    for(const auto& tag : inputs_) {
+      auto const& compact = *event.getValidHandle<MCTrajectoryCompactCollection>(tag);
+      auto trajectories = std::make_unique<MCTrajectoryCollection>();
+      compact.expand(*trajectories);
+      event.put(std::move(trajectories), tag.instance());
+    }
+  }
+
+} // namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::ExpandMCTrajectories)
@@ -0,0 +1,65 @@
+// Restore StepPointMCCollections from StepPointMCCompactCollections,
+// for the modules reading StepPointMCs (FromStepPointMCs, the compression
+// modules, ...) from files written with Mu2eG4 SDConfig.compactSteps.
+// Each output has the instance name of its input.
+//
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Sequence.h"
+
+#include "Offline/MCDataProducts/inc/StepPointMC.hh"
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
+
+namespace mu2e {
+
+  class ExpandStepPointMCs : public art::EDProducer {
+  public:
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+      fhicl::Sequence<art::InputTag> inputs { Name("inputs"), Comment("StepPointMCCompactCollections to expand") };
+    };
+
+    using Parameters = art::EDProducer::Table<Config>;
+    explicit ExpandStepPointMCs(const Parameters& conf);
+
+    void produce(art::Event& event) override;
+
+  private:
+    std::vector<art::InputTag> inputs_;
+  };
+
+  ExpandStepPointMCs::ExpandStepPointMCs(const Parameters& conf)
+    : art::EDProducer{conf}
+    , inputs_(conf().inputs())
+  {
+    std::set<std::string> instances;
+    for(const auto& tag : inputs_) {
+      if(!instances.insert(tag.instance()).second) {
+        throw cet::exception("CONFIG")<<"ExpandStepPointMCs: duplicate instance name in inputs: "<<tag<<"\n";
+      }
+      consumes<StepPointMCCompactCollection>(tag);
+      produces<StepPointMCCollection>(tag.instance());
+    }
+  }
+
+  void ExpandStepPointMCs::produce(art::Event& event) {
+    for(const auto& tag : inputs_) {
+      auto const& compact = *event.getValidHandle<StepPointMCCompactCollection>(tag);
+      auto steps = std::make_unique<StepPointMCCollection>();
+      compact.expand(*steps);
+      event.put(std::move(steps), tag.instance());
+    }
+  }
+
+} // namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::ExpandStepPointMCs)
@@ -188,6 +188,11 @@ void art::StrawHitRecoFromFragments::produce(art::Event& event) {
     analyze_tracker_(frag, shCol, chCol, pbtOffset, trackerStatus, srep, caloClusters, tt);
   }
 
+  // flag straw and electronic cross-talk, once all hits are known
+  if (_flagXT) {
+    _shrUtils.flagCrossTalk(*chCol);
+  }
+
   if (_writesh)
     event.put(std::move(shCol));
   event.put(std::move(chCol));
@@ -266,11 +271,6 @@ void art::StrawHitRecoFromFragments::analyze_tracker_(
         ewm._eventLength = 1695.0;
         _shrUtils.createComboHit(ewm,-1,chCol, shCol, caloClusters, pbtOffset, sid, tdc, tot, pmp, trackerStatus,  srep, tt);
       }
-
-      // flag straw and electronic cross-talk
-      if (_flagXT) {
-        _shrUtils.flagCrossTalk(shCol, chCol);
-      }
     }
   }
   // cc.ClearUpgradedPackets();
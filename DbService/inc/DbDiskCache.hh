@@ -0,0 +1,58 @@
+#ifndef DbService_DbDiskCache_hh
+#define DbService_DbDiskCache_hh
+
+// A cache of calibration table contents in a local directory, shared by all
+// the jobs on a node.  The contents of a cid never change once committed to
+// the database, so a table read once can be reused by any later job, instead
+// of being read again over the network.  DbReader::fillTableByCid looks here
+// before the query, and writes tables it had to read.
+//
+// Each table is a file <dir>/<dbname>/<cid>.dbt, with a binary header
+// (magic, cid, table name, content size and a 64 bit FNV-1a checksum)
+// followed by the content, the table columns in the DbColumns binary form.
+// Files are written to a unique temporary name and renamed into place, so
+// concurrent writers, in any process, never expose a partial file.  A file
+// which does not pass the checks is treated as a miss, and replaced when the
+// table is read again.  Failures to write are counted but otherwise ignored,
+// the cache is only an optimization.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace mu2e {
+
+class DbDiskCache {
+ public:
+  explicit DbDiskCache(std::string const& dir);
+
+  std::string const& dir() const { return _dir; }
+
+  // get the content of the table, return true if found and valid
+  bool read(std::string const& dbname, std::string const& tableName, int cid,
+            std::string& content);
+  // save the content of the table
+  void write(std::string const& dbname, std::string const& tableName, int cid,
+             std::string const& content);
+
+  void printStats() const;
+
+  static uint64_t checksum(std::string const& name,
+                           std::string const& content);
+
+ private:
+  std::string fileName(std::string const& dbname, int cid) const;
+
+  std::string _dir;
+
+  std::atomic<int> _nHit;
+  std::atomic<int> _nMiss;
+  std::atomic<int> _nBad;    // files found but failing the checks
+  std::atomic<int> _nWrite;
+  std::atomic<int> _nWriteFail;
+  std::atomic<int64_t> _bytesRead;
+};
+
+}  // namespace mu2e
+
+#endif
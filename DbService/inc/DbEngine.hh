@@ -7,9 +7,19 @@
 // and extract a set of IoVs and calibration pointerss.  The DbHandle contacts
 // this class through the service, and asks the update method
 // for appropriate tables.  Database tables can be overridden by a text file.
+// A table missing from the cache is read outside of the engine lock, so
+// threads asking for cached tables do not wait on the http read, and threads
+// asking for the same table wait on the one read in flight for that cid.
+// The tables needed for given run ranges can be read ahead, in parallel
+// (prefetch), so the first events of a run do not wait on the reads.
 
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <map>
+#include <memory>
 #include <shared_mutex>
+#include <vector>
 
 #include "Offline/DbService/inc/DbReader.hh"
 #include "Offline/DbTables/inc/DbCache.hh"
@@ -26,7 +36,8 @@ class DbEngine {
  public:
   DbEngine() :
       _verbose(0), _saveCsv(true), _nearestMatch(false), _initialized(false),
-      _lockWaitTime(0), _lockTime(0) {}
+      _lockWaitTime(0), _lockTime(0), _fetchWaitTime(0), _nFetch(0),
+      _nFetchWait(0) {}
   // the big read of the IOV structure is done in beginJob
   int beginJob();
   int endJob();
@@ -42,6 +53,8 @@ class DbEngine {
   void setSaveCsv(bool saveCsv) { _saveCsv = saveCsv; }
   // whether, if no perfect match, accept neaby data
   void setNearestMatch(bool nearestMatch) { _nearestMatch = nearestMatch; }
+  // directory of the local table cache shared between jobs, empty for none
+  void setDiskCache(std::string const& dir);
   // these should only be called in after startup
   std::shared_ptr<DbValCache>& valCache() { return _vcache; }
   DbReader& reader() { return _reader; }
@@ -51,6 +64,10 @@ class DbEngine {
   DbLiveTable update(int tid, uint32_t run, uint32_t subrun);
   // ruten tid for table name and reverce, for connecting handles
   int tidByName(std::string const& name);
+  // read into the cache all the tables of the calibration set valid for
+  // any part of these run ranges, in parallel as TBB tasks.  The cache
+  // limit should allow them all to be held.  Returns the number of tables
+  int prefetch(std::vector<DbIoV> const& ranges);
 
  private:
   // call beginRun on first use, if needed
@@ -58,6 +75,8 @@ class DbEngine {
   // set cid and tid for override text tables - called during intialization
   int setOverrideId();
   int updateOverrideTid();
+  // read a table from the database, without holding the engine lock
+  DbTable::cptr_t fetch(int tid, int cid, uint32_t run, uint32_t subrun);
 
   DbId _id;
   DbReader _reader;
@@ -67,16 +86,26 @@ class DbEngine {
   bool _nearestMatch;           // match to nearby data, without proper IOV
   DbTableCollection _override;  // the text tables
   DbCache _cache;               // cache of table contents
+  std::shared_ptr<DbDiskCache> _diskCache;  // local files of table contents
   std::shared_ptr<DbValCache> _vcache;  // full db iov heirarchy
-  bool _initialized;
+  // set with release ordering once _dbset is filled, which is read unlocked
+  std::atomic<bool> _initialized;
   DbSet _dbset;                              // simple set of relevant iovs
   std::map<std::string, int> _overrideTids;  // fake tids for text tables
+  // tables being read from the database, by cid
+  std::map<int, std::shared_future<DbTable::cptr_t>> _inflight;
+  // idle copies of _reader, one is taken for each read
+  std::vector<std::unique_ptr<DbReader>> _readers;
 
   // lock for threaded access
   mutable std::shared_mutex _mutex;
   // count the time locked
   std::chrono::microseconds _lockWaitTime;
   std::chrono::microseconds _lockTime;
+  // time waiting for another thread to read a table, in us
+  std::atomic<long long> _fetchWaitTime;
+  std::atomic<int> _nFetch;      // tables read from the database
+  std::atomic<int> _nFetchWait;  // lookups that waited on another read
 };
 }  // namespace mu2e
 #endif
@@ -11,10 +11,12 @@
 // this code will retry up to the timeout, then abort
 // if you want to handle the failure, set setAbortOnFail(false)
 //
+#include "Offline/DbService/inc/DbDiskCache.hh"
 #include "Offline/DbTables/inc/DbId.hh"
 #include "Offline/DbTables/inc/DbValCache.hh"
 #include <chrono>
 #include <curl/curl.h>
+#include <memory>
 #include <string>
 
 namespace mu2e {
@@ -31,6 +33,10 @@ class DbReader {
   };
 
   DbReader();
+  // a reader with the same settings, for use in another thread.  It relies
+  // on the curl global init of the original, so must not outlive it
+  DbReader(const DbReader& other);
+  DbReader& operator=(const DbReader&) = delete;
   ~DbReader();
 
   const DbId& id() const { return _id; }
@@ -65,6 +71,10 @@ class DbReader {
   void setVerbose(int verbose) { _verbose = verbose; }
   void setTimeVerbose(int timeVerbose) { _timeVerbose = timeVerbose; }
   void setSaveCsv(bool saveCsv) { _saveCsv = saveCsv; }
+  // local cache of tables, looked at before reading a table by cid
+  void setDiskCache(std::shared_ptr<DbDiskCache> diskCache) {
+    _diskCache = diskCache;
+  }
 
  private:
   // for internal use with curl
@@ -94,6 +104,8 @@ class DbReader {
   int _verbose;
   int _timeVerbose;
   bool _saveCsv;
+  bool _globalInit;  // this reader called curl_global_init
+  std::shared_ptr<DbDiskCache> _diskCache;
 };
 }  // namespace mu2e
 #endif
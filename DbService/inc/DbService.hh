@@ -28,6 +28,9 @@ class DbService {
         Comment("while adding tables, check purge every this many (20)")};
     fhicl::OptionalAtom<float> purgeEnd{
         Name("purgeEnd"), Comment("purge to this fraction of limit (0.9)")};
+    fhicl::OptionalAtom<std::string> diskCache{
+        Name("diskCache"),
+        Comment("directory for a local copy of tables, shared by jobs (none)")};
   };
 
   struct Config {
@@ -60,6 +63,10 @@ class DbService {
         Name("nearestMatch"),
         Comment("if no proper IoV, accept nearby calibrations, default false"),
         false};
+    fhicl::OptionalSequence<std::string> prefetch{
+        Name("prefetch"),
+        Comment("run ranges, like 1201:0-1205, whose tables are read at "
+                "beginJob, instead of at the first event that needs them")};
     fhicl::Table<cacheConfig> cacheParameters{
         Name("cacheParameters"), Comment("database data caching details")};
   };
@@ -0,0 +1,150 @@
+#include "Offline/DbService/inc/DbDiskCache.hh"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+// file layout, all integers in native byte order:
+// magic[8] cid(int32) nameSize(uint32) name size(uint64) checksum(uint64)
+// content
+const char cxMagic[8] = {'M', 'U', '2', 'E', 'D', 'B', 'T', '2'};
+
+template <typename T>
+void putValue(std::string& buf, T value) {
+  buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool getValue(std::string const& buf, size_t& pos, T& value) {
+  if (buf.size() - pos < sizeof(T)) return false;
+  std::memcpy(&value, buf.data() + pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+}  // namespace
+
+mu2e::DbDiskCache::DbDiskCache(std::string const& dir) :
+    _dir(dir), _nHit(0), _nMiss(0), _nBad(0), _nWrite(0), _nWriteFail(0),
+    _bytesRead(0) {}
+
+std::string mu2e::DbDiskCache::fileName(std::string const& dbname,
+                                        int cid) const {
+  return _dir + "/" + dbname + "/" + std::to_string(cid) + ".dbt";
+}
+
+uint64_t mu2e::DbDiskCache::checksum(std::string const& name,
+                                     std::string const& content) {
+  // 64 bit FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : name) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  for (unsigned char c : content) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool mu2e::DbDiskCache::read(std::string const& dbname,
+                             std::string const& tableName, int cid,
+                             std::string& content) {
+  std::ifstream in(fileName(dbname, cid), std::ios::binary);
+  if (!in) {
+    _nMiss++;
+    return false;
+  }
+  std::string buf((std::istreambuf_iterator<char>(in)),
+                  std::istreambuf_iterator<char>());
+
+  size_t pos = 0;
+  int32_t fcid = -1;
+  uint32_t nameSize = 0;
+  uint64_t size = 0, sum = 0;
+  bool ok = buf.size() >= sizeof(cxMagic) &&
+            std::memcmp(buf.data(), cxMagic, sizeof(cxMagic)) == 0;
+  pos = sizeof(cxMagic);
+  ok = ok && getValue(buf, pos, fcid) && fcid == cid;
+  ok = ok && getValue(buf, pos, nameSize) && nameSize == tableName.size() &&
+       buf.compare(pos, nameSize, tableName) == 0;
+  pos += nameSize;
+  ok = ok && getValue(buf, pos, size) && getValue(buf, pos, sum) &&
+       buf.size() - pos == size;
+  if (ok) {
+    content = buf.substr(pos);
+    ok = checksum(tableName, content) == sum;
+  }
+
+  if (!ok) {
+    // truncated, from an older format or overwritten, read it again
+    content.clear();
+    _nBad++;
+    _nMiss++;
+    return false;
+  }
+  _nHit++;
+  _bytesRead += buf.size();
+  return true;
+}
+
+void mu2e::DbDiskCache::write(std::string const& dbname,
+                              std::string const& tableName, int cid,
+                              std::string const& content) {
+  namespace fs = std::filesystem;
+  std::string fn = fileName(dbname, cid);
+  std::error_code ec;
+  // called after a miss, if another job has written the file since, it is
+  // replaced by the same content
+  fs::create_directories(_dir + "/" + dbname, ec);
+
+  std::string buf(cxMagic, sizeof(cxMagic));
+  putValue(buf, int32_t(cid));
+  putValue(buf, uint32_t(tableName.size()));
+  buf.append(tableName);
+  putValue(buf, uint64_t(content.size()));
+  putValue(buf, checksum(tableName, content));
+  buf.append(content);
+
+  // unique in this node: process and thread
+  std::ostringstream tmp;
+  tmp << fn << ".tmp." << getpid() << "."
+      << std::hash<std::thread::id>()(std::this_thread::get_id());
+  std::string tmpName = tmp.str();
+
+  bool ok = false;
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    if (out) {
+      out.write(buf.data(), buf.size());
+      out.close();
+      ok = !out.fail();
+    }
+  }
+  // rename replaces any existing file in one step
+  if (ok) {
+    fs::rename(tmpName, fn, ec);
+    ok = !ec;
+  }
+  if (ok) {
+    _nWrite++;
+  } else {
+    fs::remove(tmpName, ec);
+    _nWriteFail++;
+  }
+}
+
+void mu2e::DbDiskCache::printStats() const {
+  std::cout << "  Database disk cache stats: " << _dir << "\n";
+  std::cout << "    disk cache nHit  : " << _nHit << "\n";
+  std::cout << "    disk cache nMiss : " << _nMiss << "\n";
+  std::cout << "    disk cache nBad  : " << _nBad << "\n";
+  std::cout << "    disk cache nWrite : " << _nWrite << "\n";
+  std::cout << "    disk cache nWriteFail : " << _nWriteFail << "\n";
+  std::cout << "    disk cache read  : " << _bytesRead << " b\n";
+}
@@ -2,9 +2,11 @@
 #include "Offline/DbService/inc/DbValTool.hh"
 #include "Offline/DbTables/inc/DbTableFactory.hh"
 #include "cetlib_except/exception.h"
+#include "tbb/parallel_for.h"
 #include <chrono>
 #include <iostream>
 #include <mutex>
+#include <set>
 
 using namespace std;
 
@@ -31,7 +33,7 @@ int mu2e::DbEngine::beginJob() {
   // only the text file content will be available
   if (_version.purpose() == "EMPTY") {
     if (_verbose > 2) cout << "DbEngine::beginJob exit early, purpose=EMPTY\n";
-    _initialized = true;
+    _initialized.store(true, std::memory_order_release);
     return 0;
   }
 
@@ -74,7 +76,7 @@ int mu2e::DbEngine::beginJob() {
 
   if (_verbose > 4) cout << "DbEngine::beginJob end" << endl;
 
-  _initialized = true;
+  _initialized.store(true, std::memory_order_release);
   return 0;
 }
 
@@ -108,13 +110,16 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
   int cid = -1;
   DbIoV iov;
 
-  // try to find the needed cid and the table itself
+  // find the needed cid, without locking: the set is not changed after
+  // beginJob, and lazyBeginJob above synchronized with its completion
+  auto row = _dbset.find(tid, run, subrun);
+  cid = row.cid();
+  iov = row.iov();
+
+  // try to find the table itself
   {
     std::shared_lock lock(_mutex);  // shared read lock
-    auto row = _dbset.find(tid, run, subrun);
-    cid = row.cid();
-    iov = row.iov();
-    ptr = _cache.get(row.cid());
+    ptr = _cache.get(cid);
   }  // read lock goes out of scope
 
   // if no cid now, then table can't be found - have to stop
@@ -124,46 +129,70 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
         << run << ":" << subrun << "\n";
   }
 
-  // if it wasn't found in cache, try to read from database
+  // if it wasn't found in cache, read it from the database, or wait
+  // for the thread that is already reading it
   if (!ptr) {
-    auto stime = std::chrono::high_resolution_clock::now();
-    std::unique_lock lock(_mutex);  // write lock
-    auto mtime = std::chrono::high_resolution_clock::now();
-    auto dt =
-        std::chrono::duration_cast<std::chrono::microseconds>(mtime - stime);
-    _lockWaitTime += dt;
-
-    // have to check if some other thread loaded it
-    // since the above read attempt
-    if (_cache.hasTable(cid)) {
-      ptr = _cache.get(cid);
-    } else {
-      auto const& tabledef = _vcache->valTables().row(tid);
-      // this makes the memory
-      auto ncptr = DbTableFactory::newTable(tabledef.name());
-      // the actual http read
-      int rc = _reader.fillTableByCid(ncptr, cid);
-
-      // reader does not abort, so do it here
-      if (rc != 0) {
-        auto const& tabledef = _vcache->valTables().row(tid);
-        throw cet::exception("DBENGINE_UPDATE_FAILED")
-            << " DbEngine::update failed to find table " << tabledef.name()
-            << " for run:subrun " << run << ":" << subrun << ", cid =" << cid
-            << ", rc =" << rc << "\n";
+    std::promise<DbTable::cptr_t> promise;
+    std::shared_future<DbTable::cptr_t> future;
+    bool first = false;
+    {
+      auto stime = std::chrono::high_resolution_clock::now();
+      std::unique_lock lock(_mutex);  // write lock
+      auto mtime = std::chrono::high_resolution_clock::now();
+      auto dt =
+          std::chrono::duration_cast<std::chrono::microseconds>(mtime - stime);
+      _lockWaitTime += dt;
+
+      // have to check if some other thread loaded it
+      // since the above read attempt
+      if (_cache.hasTable(cid)) {
+        ptr = _cache.get(cid);
+      } else {
+        auto it = _inflight.find(cid);
+        if (it != _inflight.end()) {
+          future = it->second;
+        } else {
+          // this thread will read it, others will wait on the future
+          future = promise.get_future().share();
+          _inflight[cid] = future;
+          first = true;
+        }
       }
 
-      // make it const
-      ptr = std::const_pointer_cast<const mu2e::DbTable, mu2e::DbTable>(ncptr);
-      // push to cache
-      _cache.add(cid, ptr);
+      auto etime = std::chrono::high_resolution_clock::now();
+      dt = std::chrono::duration_cast<std::chrono::microseconds>(etime - mtime);
+      _lockTime += dt;
+    }  // write lock goes out of scope
+
+    if (first) {
+      try {
+        ptr = fetch(tid, cid, run, subrun);
+      } catch (...) {
+        // let the waiting threads see the failure, and the next
+        // request try again
+        {
+          std::unique_lock lock(_mutex);
+          _inflight.erase(cid);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+      {
+        std::unique_lock lock(_mutex);
+        _cache.add(cid, ptr);
+        _inflight.erase(cid);
+      }
+      promise.set_value(ptr);
+    } else if (!ptr) {
+      auto stime = std::chrono::high_resolution_clock::now();
+      ptr = future.get();  // rethrows if the read failed
+      auto etime = std::chrono::high_resolution_clock::now();
+      _fetchWaitTime +=
+          std::chrono::duration_cast<std::chrono::microseconds>(etime - stime)
+              .count();
+      _nFetchWait++;
     }
-
-    auto etime = std::chrono::high_resolution_clock::now();
-    dt = std::chrono::duration_cast<std::chrono::microseconds>(etime - mtime);
-    _lockTime += dt;
-
-  }  // write lock goes out of scope
+  }
 
   // this code handles the case where an override takes effect
   // in the middle of a database IOV - remove the override
@@ -179,6 +208,104 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
   return dblt;
 }
 
+// read one table with a copy of the reader, so that several tables can be
+// read at once, and the engine lock is only held to take and return the copy
+
+mu2e::DbTable::cptr_t mu2e::DbEngine::fetch(int tid, int cid, uint32_t run,
+                                            uint32_t subrun) {
+  std::unique_ptr<DbReader> reader;
+  {
+    std::unique_lock lock(_mutex);
+    if (_readers.empty()) {
+      reader = std::make_unique<DbReader>(_reader);
+    } else {
+      reader = std::move(_readers.back());
+      _readers.pop_back();
+    }
+  }
+
+  // the val tables do not change after beginJob
+  auto const& tabledef = _vcache->valTables().row(tid);
+  // this makes the memory
+  auto ncptr = DbTableFactory::newTable(tabledef.name());
+  // the actual http read
+  int rc = 0;
+  try {
+    rc = reader->fillTableByCid(ncptr, cid);
+  } catch (...) {
+    std::unique_lock lock(_mutex);
+    _readers.push_back(std::move(reader));
+    throw;
+  }
+
+  {
+    std::unique_lock lock(_mutex);
+    _readers.push_back(std::move(reader));
+  }
+
+  // reader does not abort, so do it here
+  if (rc != 0) {
+    throw cet::exception("DBENGINE_UPDATE_FAILED")
+        << " DbEngine::update failed to find table " << tabledef.name()
+        << " for run:subrun " << run << ":" << subrun << ", cid =" << cid
+        << ", rc =" << rc << "\n";
+  }
+  _nFetch++;
+
+  // make it const
+  return std::const_pointer_cast<const mu2e::DbTable, mu2e::DbTable>(ncptr);
+}
+
+int mu2e::DbEngine::prefetch(std::vector<DbIoV> const& ranges) {
+  lazyBeginJob();  // initialize if needed
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  // one lookup for each cid valid in the ranges, at the first
+  // run:subrun where it is valid
+  struct Point {
+    int tid;
+    uint32_t run;
+    uint32_t subrun;
+  };
+  std::vector<Point> points;
+  std::set<int> cids;
+  for (auto const& p : _dbset.emap()) {
+    for (auto const& eiov : p.second) {
+      auto const& iov = eiov.iov();
+      for (auto const& range : ranges) {
+        if (range.isOverlapping(iov) == 0) continue;
+        if (!cids.insert(eiov.cid()).second) break;
+        if (iov.startRun() > range.startRun() ||
+            (iov.startRun() == range.startRun() &&
+             iov.startSubrun() > range.startSubrun())) {
+          points.push_back({p.first, iov.startRun(), iov.startSubrun()});
+        } else {
+          points.push_back({p.first, range.startRun(), range.startSubrun()});
+        }
+        break;
+      }
+    }
+  }
+
+  // the lookups run as tasks in the caller's arena, so they use the
+  // threads art was given.  The first failure cancels the rest and is
+  // rethrown here
+  tbb::parallel_for(std::size_t(0), points.size(), [&](std::size_t i) {
+    update(points[i].tid, points[i].run, points[i].subrun);
+  });
+
+  if (_verbose > 1) {
+    auto dt = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    cout << "DbEngine::prefetch found " << points.size() << " tables in "
+         << ranges.size() << " run ranges in " << dt.count() * 1.0e-6
+         << " s" << endl;
+  }
+
+  return points.size();
+}
+
 int mu2e::DbEngine::tidByName(std::string const& name) {
   lazyBeginJob();  // initialize if needed
 
@@ -195,8 +322,17 @@ int mu2e::DbEngine::tidByName(std::string const& name) {
   return -1;
 }
 
+void mu2e::DbEngine::setDiskCache(std::string const& dir) {
+  if (dir.empty()) {
+    _diskCache.reset();
+  } else {
+    _diskCache = std::make_shared<DbDiskCache>(dir);
+  }
+  _reader.setDiskCache(_diskCache);
+}
+
 void mu2e::DbEngine::addOverride(DbTableCollection const& coll) {
-  if (_initialized) {
+  if (_initialized.load(std::memory_order_acquire)) {
     throw cet::exception("DBENGINE_LATE_OVERRIDE")
         << "DbEngine::addOverride engine already initialized\n";
   }
@@ -287,9 +423,9 @@ int mu2e::DbEngine::updateOverrideTid() {
 
 void mu2e::DbEngine::lazyBeginJob() {
   {
-    // check if initialized
-    // don't lock since bool is either set or not
-    if (_initialized) return;
+    // check if initialized, without locking: the acquire load pairs with
+    // the release store at the end of beginJob, so the DbSet is complete
+    if (_initialized.load(std::memory_order_acquire)) return;
   }
 
   // need to call beginRun, so must write lock
@@ -301,7 +437,7 @@ void mu2e::DbEngine::lazyBeginJob() {
   _lockWaitTime += dt;
 
   // if another thread initialized since the above check
-  if (_initialized) return;
+  if (_initialized.load(std::memory_order_acquire)) return;
 
   beginJob();
 
@@ -318,16 +454,24 @@ int mu2e::DbEngine::endJob() {
   if (!_vcache) return 0;
   if (_verbose > 1) {
     std::cout << "DbEngine::endJob" << std::endl;
-    std::cout << "    Total time in reading DB: " << _reader.totalTime() << " s"
+    double readTime = _reader.totalTime();
+    for (auto const& r : _readers) readTime += r->totalTime();
+    std::cout << "    Total time in reading DB: " << readTime << " s"
+              << std::endl;
+    std::cout << "    Tables read from DB or disk cache: " << _nFetch
               << std::endl;
     std::cout << "    Total time waiting for locks: "
               << _lockWaitTime.count() * 1.0e-6 << " s" << std::endl;
     std::cout << "    Total time in locks: " << _lockTime.count() * 1.0e-6
               << " s" << std::endl;
+    std::cout << "    Total time waiting for other threads to read: "
+              << _fetchWaitTime * 1.0e-6 << " s in " << _nFetchWait
+              << " lookups" << std::endl;
     std::cout << "    valcache memory: " << _vcache->size() << " b"
               << std::endl;
     std::cout << "  Database cache stats:\n";
     _cache.printStats();
+    if (_diskCache) _diskCache->printStats();
   }
   return 0;
 }
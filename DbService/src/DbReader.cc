@@ -11,14 +11,25 @@ using namespace std;
 mu2e::DbReader::DbReader() :
     _curl_handle(nullptr), _timeout(3600), _totalTime(0), _removeHeader(true),
     _abortOnFail(true), _useCache(true), _cacheLifetime(0), _verbose(0),
-    _timeVerbose(0), _saveCsv(true) {
+    _timeVerbose(0), _saveCsv(true), _globalInit(true) {
   // allocates memory for curl
   curl_global_init(CURL_GLOBAL_ALL);
 }
 
+mu2e::DbReader::DbReader(const DbReader& other) :
+    _id(other._id), _curl_handle(nullptr), _timeout(other._timeout),
+    _lastTime(0), _totalTime(0), _removeHeader(other._removeHeader),
+    _abortOnFail(other._abortOnFail), _useCache(other._useCache),
+    _cacheLifetime(other._cacheLifetime), _verbose(other._verbose),
+    _timeVerbose(other._timeVerbose), _saveCsv(other._saveCsv),
+    _globalInit(false), _diskCache(other._diskCache) {
+  // curl_global_init is not thread safe, and this copy may be made while
+  // other readers are active, so it is left to the original
+}
+
 mu2e::DbReader::~DbReader() {
   // free memory
-  curl_global_cleanup();
+  if (_globalInit) curl_global_cleanup();
 }
 
 int mu2e::DbReader::query(std::string& csv, const std::string& select,
@@ -62,12 +73,33 @@ int mu2e::DbReader::multiQuery(std::vector<QueryForm>& qfv) {
 }
 
 int mu2e::DbReader::fillTableByCid(DbTable::ptr_t ptr, int cid) {
+  DbColumns columns;
+  std::string buf;
+  // the content of a cid never changes, so a local copy is good
+  if (_diskCache && _diskCache->read(_id.name(), ptr->name(), cid, buf)) {
+    bool ok = true;
+    try {
+      columns.fromBinary(buf);
+    } catch (cet::exception const&) {
+      ok = false;  // read it again, and replace it
+    }
+    if (ok) {
+      ptr->fill(columns, _saveCsv);
+      return 0;
+    }
+  }
   std::string csv;
   StringVec where;
   where.emplace_back("cid:eq:" + std::to_string(cid));
   int rc = query(csv, ptr->query(), ptr->dbname(), where, ptr->orderBy());
   if (rc != 0) return rc;
-  ptr->fill(csv, _saveCsv);
+  columns.fromCsv(csv);
+  ptr->fill(columns, _saveCsv);
+  // only save content that made a good table
+  if (_diskCache) {
+    columns.toBinary(buf);
+    _diskCache->write(_id.name(), ptr->name(), cid, buf);
+  }
   return 0;
 }
 
@@ -83,6 +83,10 @@ DbService::DbService(Parameters const& config,
   if (_config.cacheParameters().purgeEnd(purgeEnd)) {
     _engine.cache().setPurgeEnd(purgeEnd);
   }
+  std::string diskCache;
+  if (_config.cacheParameters().diskCache(diskCache)) {
+    _engine.setDiskCache(diskCache);
+  }
 
   // service will start calling the database at the first event,
   // so the service can exist without the DB being contacted.
@@ -101,7 +105,17 @@ DbService::DbService(Parameters const& config,
 DbService::~DbService() {}
 
 /********************************************************/
-void DbService::postBeginJob() {}
+void DbService::postBeginJob() {
+  // read the tables for the requested runs before the events
+  std::vector<std::string> prefetch;
+  if (_config.prefetch(prefetch)) {
+    std::vector<DbIoV> ranges;
+    for (auto const& ss : prefetch) ranges.emplace_back(ss);
+    if (_verbose > 2)
+      std::cout << "DbService::postBeginJob prefetch tables" << std::endl;
+    _engine.prefetch(ranges);
+  }
+}
 
 /********************************************************/
 void DbService::postEndJob() {
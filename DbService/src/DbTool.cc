@@ -94,11 +94,17 @@ int mu2e::DbTool::printContent() {
   args["name"] = "";
   args["user"] = "";
   args["cid"] = "";
+  args["cache"] = "";
   if ((rc = getArgs(args))) return rc;
   std::string name = args["name"];
   std::string user = args["user"];
   std::vector<int> cids = intList(args["cid"]);
 
+  // also save the tables in binary form in a local cache directory
+  if (!args["cache"].empty()) {
+    _reader.setDiskCache(std::make_shared<DbDiskCache>(args["cache"]));
+  }
+
   // if this is a val table, just dump it and exit
   if (name.substr(0, 3) == "Val") {
     if (_pretty) {
@@ -2721,6 +2727,8 @@ int mu2e::DbTool::help() {
            "    --name NAME : name of the table\n"
            "    --user USERNAME : only print tables committed by this user \n"
            "    --cid CID : only print contents for this cid \n"
+           "    --cache DIR : also write the tables to this DbService\n"
+           "             disk cache directory (cacheParameters.diskCache)\n"
            " \n"
         << std::endl;
   } else if (_action == "print-calibration") {
@@ -0,0 +1,145 @@
+//
+// Benchmark of the time to fill the largest calibration tables from their
+// content, in the three ways it can be done:
+//   strings: split the csv into lines and columns of strings for addRow,
+//            the way DbTable::fill worked before DbColumns
+//   csv:     DbTable::fill from the csv text, through DbColumns
+//   binary:  DbTable::fill from DbColumns read from the binary form, as
+//            from the DbService disk cache
+// The content is made up, in the format of the database, and the three
+// tables filled from it are checked to be the same.
+//
+// arguments are
+// NREPEAT: optional, number of times to fill each table (default 20)
+//
+// example:
+// dbFillBench 50
+//
+
+#include "Offline/DbTables/inc/CRVSiPM.hh"
+#include "Offline/DbTables/inc/CalEnergyCalib.hh"
+#include "Offline/DbTables/inc/DbColumns.hh"
+#include "Offline/DbTables/inc/DbUtil.hh"
+#include "Offline/DbTables/inc/TrkAlignStraw.hh"
+#include "Offline/DbTables/inc/TrkPreampStraw.hh"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace mu2e;
+using namespace std;
+
+namespace {
+
+// made up csv content, with the row formats of the database
+string makeCsv(string const& name, size_t nrow) {
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> flat(-2.0, 2.0);
+  ostringstream ss;
+  for (size_t i = 0; i < nrow; i++) {
+    if (name == "TrkPreampStraw") {
+      ss << i << fixed << setprecision(1);
+      for (int j = 0; j < 5; j++) ss << "," << 10.0 + 5.0 * flat(gen);
+    } else if (name == "TrkAlignStraw") {
+      uint16_t upanel = i / StrawId::_nstraws;
+      ss << i << "," << upanel / StrawId::_npanels << "_"
+         << upanel % StrawId::_npanels << "_" << i % StrawId::_nstraws
+         << fixed << setprecision(4);
+      for (int j = 0; j < 8; j++) ss << "," << 0.1 * flat(gen);
+    } else if (name == "CalEnergyCalib") {
+      ss << i << fixed << setprecision(5) << "," << 0.1 + 0.01 * flat(gen)
+         << "," << 0.001 * (3.0 + flat(gen)) << "," << 1;
+    } else if (name == "CRVSiPM") {
+      ss << i << fixed << setprecision(3) << "," << 0.5 * flat(gen) << ","
+         << 10.0 + flat(gen) << "," << 500.0 + 10.0 * flat(gen);
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+// the fill before DbColumns
+void fillStrings(DbTable& table, string const& csv) {
+  auto lines = DbUtil::splitCsvLines(csv);
+  vector<string> columns;
+  for (auto const& line : lines) {
+    columns = DbUtil::splitCsv(line);
+    table.addRow(columns);
+  }
+}
+
+template <typename T>
+int bench(size_t nrow, int nrepeat) {
+  string name = T().name();
+  string csv = makeCsv(name, nrow);
+  DbColumns columns;
+  columns.fromCsv(csv);
+  string binary;
+  columns.toBinary(binary);
+
+  double tStrings = 0, tCsv = 0, tBinary = 0;
+  string csvStrings, csvCsv, csvBinary;
+  for (int irep = 0; irep < nrepeat; irep++) {
+    T t1, t2, t3;
+
+    auto t0 = chrono::high_resolution_clock::now();
+    fillStrings(t1, csv);
+    auto ta = chrono::high_resolution_clock::now();
+    t2.fill(csv, false);
+    auto tb = chrono::high_resolution_clock::now();
+    DbColumns cols;
+    cols.fromBinary(binary);
+    t3.fill(cols, false);
+    auto tc = chrono::high_resolution_clock::now();
+
+    tStrings += chrono::duration<double>(ta - t0).count();
+    tCsv += chrono::duration<double>(tb - ta).count();
+    tBinary += chrono::duration<double>(tc - tb).count();
+
+    if (irep == 0) {
+      t1.toCsv();
+      t2.toCsv();
+      t3.toCsv();
+      csvStrings = t1.csv();
+      csvCsv = t2.csv();
+      csvBinary = t3.csv();
+    }
+  }
+
+  cout << setw(16) << name << setw(8) << nrow << setw(10) << csv.size()
+       << setw(10) << binary.size() << fixed << setprecision(3) << setw(12)
+       << 1.0e3 * tStrings / nrepeat << setw(12) << 1.0e3 * tCsv / nrepeat
+       << setw(12) << 1.0e3 * tBinary / nrepeat << endl;
+
+  if (csvCsv != csvStrings || csvBinary != csvStrings || columns.csv() != csv) {
+    cout << "dbFillBench FAILED " << name
+         << " tables filled in different ways differ" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int nrepeat = 20;
+  if (argc > 1) nrepeat = stoi(string(argv[1]));
+
+  cout << "dbFillBench mean time to fill a table, in ms, over " << nrepeat
+       << " fills" << endl;
+  cout << setw(16) << "table" << setw(8) << "rows" << setw(10) << "csv b"
+       << setw(10) << "binary b" << setw(12) << "strings" << setw(12) << "csv"
+       << setw(12) << "binary" << endl;
+
+  int rc = 0;
+  rc += bench<TrkPreampStraw>(TrkPreampStraw().nrowFix(), nrepeat);
+  rc += bench<TrkAlignStraw>(TrkAlignStraw().nrowFix(), nrepeat);
+  rc += bench<CRVSiPM>(CRVId::nChannels, nrepeat);
+  rc += bench<CalEnergyCalib>(CalEnergyCalib().nrowFix(), nrepeat);
+
+  if (rc == 0) cout << "dbFillBench passed" << endl;
+  return rc;
+}
@@ -0,0 +1,206 @@
+//
+// Benchmark of the IoV lookups in DbSet::find and ProditionsCache::findByRun
+// on made up calibration histories, compared to the linear searches they
+// replaced.  The answers of the two are checked to be the same.
+//   ordered:  IoVs of a few runs each, in order, with gaps
+//   shuffled: the same IoVs added in random order
+//   overlap:  IoVs of random length and position, overlapping
+// DbSet lookups are done with nearest match on, so lookups in the gaps
+// exercise it.  The cache lookups are done as in ProditionsCache, where the
+// IoVs are grouped by cache item and searched item by item.
+//
+// arguments are
+// NIOV: optional, number of IoVs in a history (default 10000)
+// NLOOKUP: optional, number of lookups (default 10000)
+//
+// example:
+// dbIoVBench 10000 100000
+//
+
+#include "Offline/DbTables/inc/DbIoVIndex.hh"
+#include "Offline/DbTables/inc/DbSet.hh"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+using namespace std;
+
+namespace {
+
+struct Lookup {
+  uint32_t run;
+  uint32_t subrun;
+};
+
+// DbSet::find before the index
+DbSet::EIoV linearFind(vector<DbSet::EIoV> const& eiovs, uint32_t run,
+                       uint32_t subrun) {
+  for (auto const& ee : eiovs) {
+    if (ee.iov().inInterval(run, subrun)) return ee;
+  }
+  DbSet::EIoV br;
+  int brr = DbIoV::maxRun(), bsr = DbIoV::maxSubrun();
+  for (auto const& r : eiovs) {
+    int dr = run - r.iov().endRun();
+    int ds = subrun + DbIoV::maxSubrun() - r.iov().endSubrun();
+    if (dr == 0) ds = subrun - r.iov().endSubrun();
+    if (dr > 0 && ds > 0 && (dr < brr || (dr == brr && ds < bsr))) {
+      brr = dr;
+      bsr = ds;
+      br = r;
+    }
+  }
+  if (br.cid() > 0) return br;
+  return DbSet::EIoV();
+}
+
+vector<DbIoV> makeHistory(string const& type, size_t niov, mt19937& gen) {
+  vector<DbIoV> iovs;
+  uniform_int_distribution<uint32_t> length(1, 5), subrun(0, 50);
+  uniform_int_distribution<uint32_t> percent(0, 99);
+  uint32_t run = 1000;
+  if (type == "overlap") {
+    uniform_int_distribution<uint32_t> start(1000, 1000 + 3 * niov);
+    uniform_int_distribution<uint32_t> longer(0, 30);
+    for (size_t i = 0; i < niov; i++) {
+      uint32_t r0 = start(gen);
+      iovs.emplace_back(r0, subrun(gen), r0 + longer(gen), subrun(gen));
+    }
+    return iovs;
+  }
+  for (size_t i = 0; i < niov; i++) {
+    uint32_t end = run + length(gen) - 1;
+    // some end within a run, some at the end of a run
+    uint32_t endSubrun = percent(gen) < 30 ? subrun(gen) : DbIoV::maxSubrun();
+    iovs.emplace_back(run, 0, end, endSubrun);
+    run = end + 1;
+    if (percent(gen) < 10) run += length(gen);  // a gap
+  }
+  if (type == "shuffled") shuffle(iovs.begin(), iovs.end(), gen);
+  return iovs;
+}
+
+template <typename F>
+double timeIt(F const& f) {
+  auto t0 = chrono::high_resolution_clock::now();
+  f();
+  auto t1 = chrono::high_resolution_clock::now();
+  return chrono::duration<double>(t1 - t0).count();
+}
+
+int bench(string const& type, size_t niov, size_t nlookup) {
+  mt19937 gen(4321);
+  auto iovs = makeHistory(type, niov, gen);
+
+  uint32_t minRun = DbIoV::maxRun(), maxRun = 0;
+  for (auto const& iov : iovs) {
+    minRun = min(minRun, iov.startRun());
+    maxRun = max(maxRun, iov.endRun());
+  }
+  uniform_int_distribution<uint32_t> runs(minRun - 2, maxRun + 2);
+  uniform_int_distribution<uint32_t> subruns(0, 60);
+  vector<Lookup> lookups;
+  for (size_t i = 0; i < nlookup; i++) {
+    lookups.push_back({runs(gen), subruns(gen)});
+  }
+
+  // DbSet, with cid counting from 1 as in the database
+  int tid = 7;
+  DbSet dbset;
+  dbset.setNearestMatch(true);
+  vector<DbSet::EIoV> eiovs;
+  double tAdd = timeIt([&] {
+    for (size_t i = 0; i < iovs.size(); i++) dbset.add(tid, i + 1, iovs[i]);
+  });
+  for (size_t i = 0; i < iovs.size(); i++) eiovs.emplace_back(i + 1, iovs[i]);
+
+  vector<int> cidLinear(nlookup), cidIndex(nlookup);
+  double tSetLinear = timeIt([&] {
+    for (size_t i = 0; i < nlookup; i++)
+      cidLinear[i] = linearFind(eiovs, lookups[i].run, lookups[i].subrun).cid();
+  });
+  double tSetIndex = timeIt([&] {
+    for (size_t i = 0; i < nlookup; i++)
+      cidIndex[i] = dbset.find(tid, lookups[i].run, lookups[i].subrun).cid();
+  });
+  int nfound = 0;
+  for (size_t i = 0; i < nlookup; i++) nfound += cidIndex[i] > 0;
+  bool ok = cidLinear == cidIndex;
+
+  // the cache, the iovs spread over items, searched item by item
+  size_t nitem = max(size_t(1), niov / 10);
+  uniform_int_distribution<size_t> item(0, nitem - 1);
+  vector<vector<DbIoV>> items(nitem);
+  for (auto const& iov : iovs) items[item(gen)].push_back(iov);
+  DbIoVIndex index;
+  vector<size_t> itemOf;
+  for (size_t ii = 0; ii < nitem; ii++) {
+    for (auto const& iov : items[ii]) {
+      index.add(iov);
+      itemOf.push_back(ii);
+    }
+  }
+
+  vector<int> itemLinear(nlookup), itemIndex(nlookup);
+  double tCacheLinear = timeIt([&] {
+    for (size_t i = 0; i < nlookup; i++) {
+      itemLinear[i] = -1;
+      for (size_t ii = 0; ii < nitem && itemLinear[i] < 0; ii++) {
+        for (auto const& iov : items[ii]) {
+          if (iov.inInterval(lookups[i].run, lookups[i].subrun)) {
+            itemLinear[i] = ii;
+            break;
+          }
+        }
+      }
+    }
+  });
+  double tCacheIndex = timeIt([&] {
+    for (size_t i = 0; i < nlookup; i++) {
+      int j = index.find(lookups[i].run, lookups[i].subrun);
+      itemIndex[i] = j < 0 ? -1 : itemOf[j];
+    }
+  });
+  ok = ok && itemLinear == itemIndex;
+
+  double us = 1.0e6 / nlookup;
+  cout << setw(10) << type << setw(8) << niov << setw(10) << index.nSegment()
+       << setw(8) << nfound << fixed << setprecision(3) << setw(10)
+       << 1.0e3 * tAdd << setw(10) << tSetLinear * us << setw(10)
+       << tSetIndex * us << setw(10) << tCacheLinear * us << setw(10)
+       << tCacheIndex * us << endl;
+
+  if (!ok) {
+    cout << "dbIoVBench FAILED " << type
+         << " the index and the linear search differ" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t niov = 10000, nlookup = 10000;
+  if (argc > 1) niov = stoul(string(argv[1]));
+  if (argc > 2) nlookup = stoul(string(argv[2]));
+
+  cout << "dbIoVBench lookup times in us, DbSet add time in ms" << endl;
+  cout << setw(10) << "history" << setw(8) << "IoVs" << setw(10) << "segments"
+       << setw(8) << "found" << setw(10) << "set add" << setw(10) << "set lin"
+       << setw(10) << "set idx" << setw(10) << "cache lin" << setw(10)
+       << "cache idx" << endl;
+
+  int rc = 0;
+  rc += bench("ordered", niov, nlookup);
+  rc += bench("shuffled", niov, nlookup);
+  rc += bench("overlap", niov, nlookup);
+
+  if (rc == 0) cout << "dbIoVBench passed" << endl;
+  return rc;
+}
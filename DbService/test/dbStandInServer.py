@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+# A stand-in for the conditions database web server, for testing DbEngine
+# and DbReader without a connection to the real database.  It answers the
+# same url queries (dbname=..&t=table&c=columns&w=cid:eq:N...) from a
+# small, fixed calibration set:
+#   purpose TEST, version v1_0, table TstCalib1 (tid 1),
+#   one calibration (cid = run) for each run 1..NRUN
+# The flag column of the TstCalib1 rows is set to the cid, so the
+# client can check it got the right table.
+#
+# Reads of calibration tables are delayed, to look like a slow network.
+#
+# usage:
+#   dbStandInServer.py [--port 8642] [--delay 0.5] [--nrun 20]
+# stop it with ctrl-C or kill, it then prints the number of reads of each table
+#
+# then point a DbId at url http://localhost:8642/query?
+# See dbThreadTest_main.cc
+#
+
+import argparse
+import signal
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse, parse_qs
+
+TIME = "2026-01-01 00:00:00.000000-06:00"
+USER = "mu2etest"
+
+
+def valTables(nrun):
+    """the csv content of the val tables, without the header line"""
+    tables = {
+        "val.tables": ["1,TstCalib1,tst.calib1,%s,%s" % (TIME, USER)],
+        "val.calibrations": ["%d,1,%s,%s" % (cid, TIME, USER)
+                             for cid in range(1, nrun + 1)],
+        "val.iovs": ["%d,%d,%d,0,%d,999999,%s,%s" % (cid, cid, cid, cid, TIME, USER)
+                     for cid in range(1, nrun + 1)],
+        "val.groups": ["1,%s,%s" % (TIME, USER)],
+        "val.grouplists": ["1,%d" % iid for iid in range(1, nrun + 1)],
+        "val.purposes": ["1,TEST,stand-in test purpose,%s,%s" % (TIME, USER)],
+        "val.lists": ["1,TEST_LIST,stand-in test list,%s,%s" % (TIME, USER)],
+        "val.tablelists": ["1,1"],
+        "val.versions": ["1,1,1,1,0,stand-in test version,%s,%s" % (TIME, USER)],
+        "val.extensions": ["1,1,1,%s,%s" % (TIME, USER)],
+        "val.extensionlists": ["1,1"],
+    }
+    return tables
+
+
+class Handler(BaseHTTPRequestHandler):
+
+    def do_GET(self):
+        query = parse_qs(urlparse(self.path).query)
+        table = query.get("t", [""])[0]
+        columns = query.get("c", [""])[0]
+        lines = None
+        if table in self.server.val:
+            lines = self.server.val[table]
+        elif table == "tst.calib1":
+            cid = None
+            for w in query.get("w", []):
+                if w.startswith("cid:eq:"):
+                    cid = int(w[len("cid:eq:"):])
+            if cid is not None and 1 <= cid <= self.server.nrun:
+                time.sleep(self.server.delay)
+                lines = ["%d,%d,%.3f" % (ch, cid, 1.0 + 0.1 * ch)
+                         for ch in range(3)]
+                with self.server.lock:
+                    self.server.reads[cid] = self.server.reads.get(cid, 0) + 1
+        if lines is None:
+            self.send_error(404, "unknown table or cid")
+            return
+        body = (columns + "\n" + "".join(ln + "\n" for ln in lines)).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "text/csv")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            super().log_message(format, *args)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="stand-in conditions database web server")
+    parser.add_argument("--port", type=int, default=8642)
+    parser.add_argument("--delay", type=float, default=0.5,
+                        help="seconds to wait before answering a table read")
+    parser.add_argument("--nrun", type=int, default=20)
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("localhost", args.port), Handler)
+    server.val = valTables(args.nrun)
+    server.nrun = args.nrun
+    server.delay = args.delay
+    server.verbose = args.verbose
+    server.lock = threading.Lock()
+    server.reads = {}
+    print("dbStandInServer listening on http://localhost:%d/query?" % args.port,
+          flush=True)
+    # stop cleanly on ctrl-C or kill, also when run in the background
+    signal.signal(signal.SIGINT, signal.default_int_handler)
+    signal.signal(signal.SIGTERM, signal.default_int_handler)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    # each table should be read only once, however many threads ask for it
+    print("dbStandInServer table reads by cid:", server.reads)
+    repeated = [cid for cid, n in server.reads.items() if n > 1]
+    if repeated:
+        print("dbStandInServer tables read more than once:", repeated)
+
+
+if __name__ == "__main__":
+    main()
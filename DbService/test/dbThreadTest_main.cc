@@ -0,0 +1,137 @@
+//
+// Multi-threaded test of DbEngine::update against the stand-in web server
+// dbStandInServer.py, which is slow to answer table reads.
+// One thread repeatedly asks for a table that is already in the cache,
+// while NTHREAD others ask for tables which have to be read, each thread
+// asking for all of them, starting at a different run.  The cached lookups should
+// never wait for a read, so their maximum time should be well below the
+// server delay, all the reads should overlap, and each table should be read
+// once (the server reports tables read more than once when it stops).
+//
+// arguments are
+// PORT: the port of the stand-in server
+// NTHREAD: number of threads asking for new tables
+// NRUN: number of runs (tables) given to the server
+// DELAY: the server delay, in s
+// DISKCACHE: optional, directory for the local table cache.  On the
+//   first run the tables are read from the server and written there, on a
+//   second run they all come from the directory, and the server sees no reads
+//
+// example:
+// python3 Offline/DbService/test/dbStandInServer.py --port 8642 --delay 0.5 --nrun 20 &
+// dbThreadTest 8642 8 20 0.5
+// dbThreadTest 8642 8 20 0.5 /tmp/dbcache
+//
+
+#include "Offline/DbService/inc/DbEngine.hh"
+#include "Offline/DbTables/inc/TstCalib1.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mu2e;
+using namespace std;
+
+int main(int argc, char** argv) {
+  if (argc != 5 && argc != 6) {  // first arg is exe name
+    cout << "Four required arguments: PORT NTHREAD NRUN DELAY, "
+         << "and optional DISKCACHE" << endl;
+    return 1;
+  }
+
+  string port(argv[1]);
+  int nthread = stoi(string(argv[2]));
+  int nrun = stoi(string(argv[3]));
+  double delay = stod(string(argv[4]));
+
+  if (nthread < 1 || nrun < 2) {
+    cout << "Need at least one thread and two runs" << endl;
+    return 1;
+  }
+
+  string url = "http://localhost:" + port + "/query?";
+  DbEngine engine;
+  engine.setVerbose(2);
+  engine.setDbId(DbId("mu2e_conditions_test", "localhost", port, url, url));
+  engine.setVersion(DbVersion("TEST", "v1_0"));
+  if (argc == 6) engine.setDiskCache(string(argv[5]));
+
+  int tid = engine.tidByName("TstCalib1");
+  if (tid < 0) {
+    cout << "TstCalib1 not found on the server" << endl;
+    return 1;
+  }
+
+  // check the table is the one for this run, the server puts the cid,
+  // which is the run number, in the flag column
+  atomic<int> nerr(0);
+  auto check = [&](DbLiveTable const& lt, uint32_t run) {
+    auto const& tab = dynamic_cast<TstCalib1 const&>(lt.table());
+    if (lt.cid() != int(run) || tab.nrow() != 3 ||
+        tab.rowAt(0).flag() != int(run)) {
+      nerr++;
+    }
+  };
+
+  // put run 1 in the cache
+  check(engine.update(tid, 1, 0), 1);
+
+  auto start = chrono::high_resolution_clock::now();
+
+  atomic<int> nrunning(nthread);
+  vector<thread> threads;
+  for (int ithread = 0; ithread < nthread; ithread++) {
+    threads.emplace_back([&, ithread]() {
+      for (int i = 0; i < nrun - 1; i++) {
+        uint32_t run = 2 + (i + ithread * (nrun - 1) / nthread) % (nrun - 1);
+        check(engine.update(tid, run, 0), run);
+      }
+      nrunning--;
+    });
+  }
+
+  // cached lookups while the reads are in progress
+  int nlookup = 0;
+  chrono::microseconds maxLookup(0);
+  while (nrunning > 0) {
+    auto stime = chrono::high_resolution_clock::now();
+    check(engine.update(tid, 1, 0), 1);
+    auto etime = chrono::high_resolution_clock::now();
+    maxLookup =
+        max(maxLookup, chrono::duration_cast<chrono::microseconds>(etime - stime));
+    nlookup++;
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+
+  for (auto& t : threads) t.join();
+
+  auto end = chrono::high_resolution_clock::now();
+  double wall = chrono::duration_cast<chrono::microseconds>(end - start).count() *
+                1.0e-6;
+
+  cout << "dbThreadTest " << nthread << " threads read " << nrun - 1
+       << " tables in " << wall << " s, serial reads would take "
+       << (nrun - 1) * delay << " s" << endl;
+  cout << "dbThreadTest " << nlookup << " cached lookups, longest "
+       << maxLookup.count() * 1.0e-6 << " s" << endl;
+  engine.endJob();
+
+  int rc = 0;
+  if (nerr > 0) {
+    cout << "dbThreadTest FAILED " << nerr << " lookups returned the wrong table"
+         << endl;
+    rc = 2;
+  }
+  if (maxLookup.count() * 1.0e-6 > 0.5 * delay) {
+    cout << "dbThreadTest FAILED cached lookups waited on database reads"
+         << endl;
+    rc = 3;
+  }
+  if (rc == 0) cout << "dbThreadTest passed" << endl;
+
+  return rc;
+}
@@ -54,6 +54,16 @@ class CRVPhoton : public DbTable {
     _rows.emplace_back(std::stoi(columns[0]), std::stof(columns[1]));
   }
 
+  void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+    std::uint16_t channel = columns.getInt(irow, 0);
+    if (channel >= CRVId::nChannels || channel != _rows.size()) {
+      throw cet::exception("CRVPHOTON_BAD_CHANNEL")
+          << "CRVPhoton::addRow bad channel, saw " << columns.text(irow, 0)
+          << ", expected " << _rows.size() << "\n";
+    }
+    _rows.emplace_back(columns.getInt(irow, 0), columns.getFloat(irow, 1));
+  }
+
   void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
     Row const& r = _rows.at(irow);
     sstream << r.channel() << ",";
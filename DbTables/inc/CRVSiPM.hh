@@ -60,6 +60,17 @@ class CRVSiPM : public DbTable {
                        std::stof(columns[2]), std::stof(columns[3]));
   }
 
+  void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+    std::uint16_t channel = columns.getInt(irow, 0);
+    if (channel >= CRVId::nChannels || channel != _rows.size()) {
+      throw cet::exception("CRVSIPM_BAD_CHANNEL")
+          << "CRVSiPM::addRow bad channel, saw " << columns.text(irow, 0)
+          << ", expected " << _rows.size() << "\n";
+    }
+    _rows.emplace_back(columns.getInt(irow, 0), columns.getFloat(irow, 1),
+                       columns.getFloat(irow, 2), columns.getFloat(irow, 3));
+  }
+
   void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
     Row const& r = _rows.at(irow);
     sstream << r.channel() << ",";
@@ -50,6 +50,16 @@ class CRVTime : public DbTable {
     _rows.emplace_back(channel, std::stof(columns[1]));
   }
 
+  void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+    std::uint16_t channel = columns.getInt(irow, 0);
+    if (channel >= CRVId::nChannels || channel != _rows.size()) {
+      throw cet::exception("CRVTIME_BAD_CHANNEL")
+          << "CRVTime::addRow bad channel, saw " << columns.text(irow, 0)
+          << ", expected " << _rows.size() << "\n";
+    }
+    _rows.emplace_back(channel, columns.getFloat(irow, 1));
+  }
+
   void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
     Row const& r = _rows.at(irow);
     sstream << r.channel() << ",";
@@ -52,6 +52,16 @@ namespace mu2e {
 
     }
 
+    void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+      std::uint16_t index = columns.getInt(irow,0);
+      if (index >= CaloConst::_nChannel  || index != _rows.size()) {
+        throw cet::exception("CALOLaserEnergyCALIB_BAD_INDEX")
+        << "CalLaserEnergyCalib::addRow found index out of order: "
+        <<index<< " != " <<  _rows.size() <<"\n";
+      }
+      _rows.emplace_back(CaloSiPMId(index),columns.getFloat(irow,1),columns.getFloat(irow,2),columns.getFloat(irow,3));
+    }
+
     void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
       Row const& r = _rows.at(irow);
       sstream << std::fixed << std::setprecision(5);
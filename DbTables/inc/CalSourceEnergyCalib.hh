@@ -86,6 +86,19 @@ namespace mu2e {
 
     }
 
+    void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+      std::uint16_t index = columns.getInt(irow,0);
+      if (index >= CaloConst::_nChannel  || index != _rows.size()) {
+        throw cet::exception("CALOSOURCECALIB_BAD_INDEX")
+        << "CalSourceEnergyCalib::addRow found index out of order: "
+        <<index << " != " << _rows.size() <<"\n";
+      }
+      _rows.emplace_back(CaloSiPMId(index),columns.getFloat(irow,1),columns.getFloat(irow,2),columns.getFloat(irow,3),
+      columns.getFloat(irow,4),columns.getFloat(irow,5),columns.getFloat(irow,6),columns.getFloat(irow,7),
+      columns.getFloat(irow,8),columns.getFloat(irow,9),columns.getFloat(irow,10),columns.getFloat(irow,11),
+      columns.getFloat(irow,12),columns.getFloat(irow,13),columns.getFloat(irow,14),columns.getFloat(irow,15),columns.getFloat(irow,16));
+    }
+
     void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
       Row const& r = _rows.at(irow);
       sstream << std::fixed << std::setprecision(5);
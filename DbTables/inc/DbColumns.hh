@@ -0,0 +1,74 @@
+#ifndef DbTables_DbColumns_hh
+#define DbTables_DbColumns_hh
+
+// The content of a table as typed columns, parsed once from the csv text of
+// a query and then kept, or saved, in a binary form.  Tables are filled from
+// this (DbTable::fill) without splitting the text into strings again.
+//
+// Each column holds the text of its cells, exactly as in the csv, and if all
+// its cells are integers, or numbers, their values as int64, or as both
+// double and float (the result of stod and stof on the text).  The typed
+// accessors return the same values as std::stoi/stof/stod on the text of the
+// cell, and if the column is not of that type, they do just that.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mu2e {
+
+class DbColumns {
+ public:
+  enum colType : uint8_t { String = 0, Int = 1, Real = 2 };
+
+  DbColumns() : _nrow(0) {}
+
+  // split csv, one row per line, each ending in a newline, columns split
+  // by csv rules with quotes.  All lines must have the same number of columns
+  void fromCsv(std::string const& csv);
+  // the csv text the columns were made from
+  std::string csv() const;
+
+  // the binary form, which includes the text
+  void toBinary(std::string& buf) const;
+  void fromBinary(std::string const& buf);
+
+  std::size_t nrow() const { return _nrow; }
+  std::size_t ncol() const { return _cols.size(); }
+  colType type(std::size_t icol) const { return _cols.at(icol).type; }
+
+  std::string_view text(std::size_t irow, std::size_t icol) const;
+  std::string getString(std::size_t irow, std::size_t icol) const {
+    return std::string(text(irow, icol));
+  }
+  int getInt(std::size_t irow, std::size_t icol) const;
+  float getFloat(std::size_t irow, std::size_t icol) const;
+  double getDouble(std::size_t irow, std::size_t icol) const;
+  // all the cells of a row as text
+  void row(std::size_t irow, std::vector<std::string>& columns) const;
+
+  void clear() {
+    _cols.clear();
+    _nrow = 0;
+  }
+
+ private:
+  struct Column {
+    colType type = String;
+    std::string text;            // the cells, one after the other
+    std::vector<uint32_t> ends;  // end of each cell in text
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+    std::vector<float> floats;
+  };
+
+  Column const& column(std::size_t irow, std::size_t icol) const;
+  void setTypes();
+
+  std::size_t _nrow;
+  std::vector<Column> _cols;
+};
+
+}  // namespace mu2e
+#endif
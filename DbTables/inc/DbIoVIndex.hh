@@ -0,0 +1,63 @@
+#ifndef DbTables_DbIoVIndex_hh
+#define DbTables_DbIoVIndex_hh
+
+// An index of a list of IoVs, to find the IoV containing a run:subrun
+// without searching the list.  The IoVs are numbered in the order they
+// are added, and find returns the number of the first one which contains
+// the run:subrun, the same as a linear search through the list, even if
+// the IoVs overlap.
+//
+// The run:subrun axis is cut into segments at the IoV ends, each labeled
+// with the first IoV covering it, so find is a binary search.  Adding an
+// IoV is a binary search and an insert into a sorted vector, cheap when
+// IoVs are added in order of run.
+
+#include "Offline/DbTables/inc/DbIoV.hh"
+#include <cstdint>
+#include <vector>
+
+namespace mu2e {
+
+class DbIoVIndex {
+ public:
+  DbIoVIndex() : _size(0) {}
+
+  // add the next IoV, it will be found only where no earlier IoV is valid
+  void add(DbIoV const& iov);
+  // the number of the first IoV valid for this run:subrun, or -1 if none
+  int find(uint32_t run, uint32_t subrun) const;
+  // true if some IoV already added is valid for a point in this IoV
+  bool overlaps(DbIoV const& iov) const;
+
+  // number of IoVs added
+  std::size_t size() const { return _size; }
+  // number of segments the run:subrun axis is cut into
+  std::size_t nSegment() const { return _segments.size(); }
+  void clear() {
+    _segments.clear();
+    _size = 0;
+  }
+
+ private:
+  // a point on the run:subrun axis, ordered as in DbIoV::inInterval
+  static uint64_t key(uint32_t run, uint32_t subrun) {
+    return (uint64_t(run) << 32) | subrun;
+  }
+  // the points from start, until the start of the next segment, are in
+  // the IoV numbered owner, or in none if owner is -1.  The points
+  // before the first segment are in none
+  struct Segment {
+    uint64_t start;
+    int owner;
+  };
+  // index of the first segment which starts after k
+  std::size_t after(uint64_t k) const;
+  // index of the segment which starts at k, cutting one if needed
+  std::size_t split(uint64_t k);
+
+  std::vector<Segment> _segments;  // ordered by start
+  std::size_t _size;
+};
+
+}  // namespace mu2e
+#endif
@@ -6,8 +6,10 @@
 // and groups down to the list of IoVs.  This container
 // holds just the list of IoVs which is the result of flattening the
 // heirarchical structure.  For faster and simpler lookup and manipulation
+// The IoVs of each table are also indexed, so find is a binary search.
 
 #include "Offline/DbTables/inc/DbIoV.hh"
+#include "Offline/DbTables/inc/DbIoVIndex.hh"
 #include <map>
 #include <vector>
 
@@ -45,6 +47,15 @@ class DbSet {
  private:
   // for each tid key, hold a vector of (IoV,cid)
   std::map<int, std::vector<EIoV>> _emap;
+  // for each tid key, the lookup of its IoVs, by position in _emap
+  struct TidIndex {
+    DbIoVIndex iovs;
+    // positions ordered by the end of their IoV, for nearest matches
+    std::vector<std::size_t> byEnd;
+    // the same, without those ending at the last subrun of a run
+    std::vector<std::size_t> byEndBeforeMax;
+  };
+  std::map<int, TidIndex> _index;
   // whether or not to accept nearest matches in cid find
   bool _nearestMatch;
 };
@@ -1,6 +1,7 @@
 #ifndef DbTables_DbTable_hh
 #define DbTables_DbTable_hh
 
+#include "Offline/DbTables/inc/DbColumns.hh"
 #include <cstdint>
 #include <memory>
 #include <sstream>
@@ -43,11 +44,17 @@ class DbTable {
 
   // take the cvs text from a query and build out the table contents
   int fill(const std::string& csv, bool saveCsv = true);
+  // the same from the typed columns, parsed from csv or read in binary
+  int fill(const DbColumns& columns, bool saveCsv = true);
   // in case table was filled with binary values, convert to csv
   int toCsv();
 
   // part of building content, convert list of strings to binary row
   virtual void addRow(const std::vector<std::string>& columns) = 0;
+  // the same from row irow of the typed columns.  By default the row is
+  // converted to strings for addRow, large tables override this to read the
+  // values directly
+  virtual void addBinaryRow(const DbColumns& columns, std::size_t irow);
   // convert a row in a binary format to a string
   virtual void rowToCsv(std::ostringstream& stream, size_t irow) const = 0;
   // remove all rows
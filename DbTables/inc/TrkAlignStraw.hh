@@ -52,6 +52,22 @@ class TrkAlignStraw : public DbTable {
                        std::stof(columns[9]));
   }
 
+  void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+    int index = columns.getInt(irow, 0);
+    if (index != int(_rows.size())) {
+      throw cet::exception("TRKALIGNSTRAW_BAD_INDEX")
+          << "TrkAlignStraw::addRow found index out of order: " << index
+          << " != " << _rows.size() << "\n";
+    }
+
+    _rows.emplace_back(
+        index, StrawId(columns.getString(irow, 1)), columns.getFloat(irow, 2),
+        columns.getFloat(irow, 3), columns.getFloat(irow, 4),
+        columns.getFloat(irow, 5), columns.getFloat(irow, 6),
+        columns.getFloat(irow, 7), columns.getFloat(irow, 8),
+        columns.getFloat(irow, 9));
+  }
+
   void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
     TrkStrawEndAlign const& r = _rows.at(irow);
     sstream << r._index << ",";
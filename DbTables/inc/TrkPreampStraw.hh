@@ -63,6 +63,18 @@ class TrkPreampStraw : public DbTable {
                        std::stof(columns[5]));
   }
 
+  void addBinaryRow(const DbColumns& columns, std::size_t irow) override {
+    int index = columns.getInt(irow, 0);
+    if (index != int(_rows.size())) {
+      throw cet::exception("TRKPREAMPSTRAW_BAD_INDEX")
+          << "TrkPreampStraw::addRow found index out of order: " << index
+          << " != " << _rows.size() << "\n";
+    }
+    _rows.emplace_back(index, columns.getFloat(irow, 1),
+                       columns.getFloat(irow, 2), columns.getFloat(irow, 3),
+                       columns.getFloat(irow, 4), columns.getFloat(irow, 5));
+  }
+
   void rowToCsv(std::ostringstream& sstream, std::size_t irow) const override {
     Row const& r = _rows.at(irow);
     sstream << r.index() << ",";
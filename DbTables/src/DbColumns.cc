@@ -0,0 +1,335 @@
+#include "Offline/DbTables/inc/DbColumns.hh"
+#include "cetlib_except/exception.h"
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+// binary layout, all integers in native byte order:
+// magic[8] nrow(uint64) ncol(uint32), then for each column:
+// type(uint8) textSize(uint64) text ends(nrow uint32) and the values,
+// nrow int64 for Int, nrow double and nrow float for Real
+const char cxMagic[8] = {'D', 'B', 'C', 'O', 'L', 'S', '0', '1'};
+
+template <typename T>
+void putValues(std::string& buf, T const* values, std::size_t n) {
+  buf.append(reinterpret_cast<const char*>(values), n * sizeof(T));
+}
+
+template <typename T>
+void getValues(std::string const& buf, std::size_t& pos, T* values,
+               std::size_t n) {
+  if ((buf.size() - pos) / sizeof(T) < n) {
+    throw cet::exception("DBCOLUMNS_BAD_BINARY")
+        << "DbColumns::fromBinary buffer too short at byte " << pos << "\n";
+  }
+  std::memcpy(values, buf.data() + pos, n * sizeof(T));
+  pos += n * sizeof(T);
+}
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+  return s;
+}
+
+// the same rules as DbUtil::splitCsv, the cells are not trimmed
+void splitLine(std::string_view line,
+               std::vector<std::pair<std::size_t, std::size_t>>& cells) {
+  cells.clear();
+  std::size_t i, j;
+  i = j = 0;  // i=beginning of current column, j=current position in parse
+  bool quote = false;
+  while (i < line.size()) {
+    if (line[j] == '"') {
+      if (!quote) {
+        quote = true;
+        j++;
+      } else {
+        if (line[j - 1] == '\\') {  // has form \"
+          j++;
+        } else if (j < line.size() - 1 && line[j + 1] == '"') {  // form ""
+          j = j + 2;
+        } else {  // must be end quote
+          quote = false;
+          j++;
+        }
+      }
+    } else if (line[j] == ',') {
+      if (quote) {
+        j++;
+      } else {
+        cells.emplace_back(i, j);
+        j++;
+        i = j;
+      }
+    } else {
+      j++;
+    }
+    if (j == line.size()) {
+      if (quote) {
+        throw cet::exception("DBUTIL_OPEN_QUOTE")
+            << "DbUtil::splitCsv open quotes at end of line:"
+            << std::string(line) << "\n";
+      }
+      cells.emplace_back(i, j);
+      i = j;
+    }
+  }
+}
+
+}  // namespace
+
+void mu2e::DbColumns::fromCsv(std::string const& csv) {
+  clear();
+  if (csv.empty()) return;
+  if (csv.back() != '\n') {
+    throw cet::exception("DBUTIL_NO_TERMINAL_NEWLINE")
+        << "DbUtil::splitCsvLines csv did not have terminal newline\n";
+  }
+
+  std::string_view all(csv);
+  std::vector<std::pair<std::size_t, std::size_t>> cells;
+  std::size_t pos = 0;
+  while (pos < all.size()) {
+    std::size_t eol = all.find('\n', pos);
+    std::string_view line = all.substr(pos, eol - pos);
+    pos = eol + 1;
+    splitLine(line, cells);
+    if (_nrow == 0) _cols.resize(cells.size());
+    if (cells.size() != _cols.size()) {
+      throw cet::exception("DBTABLE_BAD_COLUMN_COUNT")
+          << "DbTable::fill found " << cells.size() << " columns "
+          << " when " << _cols.size()
+          << " was seen in previous rows. Text:" << std::string(line)
+          << " \n";
+    }
+    for (std::size_t icol = 0; icol < cells.size(); icol++) {
+      auto& col = _cols[icol];
+      col.text.append(line.data() + cells[icol].first,
+                      cells[icol].second - cells[icol].first);
+      col.ends.push_back(col.text.size());
+    }
+    _nrow++;
+  }
+
+  setTypes();
+}
+
+// decide the type of each column, and convert the values
+void mu2e::DbColumns::setTypes() {
+  std::string buf;  // null terminated copy of a cell, for strtod
+  for (std::size_t icol = 0; icol < _cols.size(); icol++) {
+    auto& col = _cols[icol];
+    col.type = String;
+    col.ints.clear();
+    col.doubles.clear();
+    col.floats.clear();
+    if (_nrow == 0) continue;
+
+    // integers, as read by stoi, with an optional sign
+    bool isInt = true;
+    col.ints.reserve(_nrow);
+    for (std::size_t irow = 0; irow < _nrow && isInt; irow++) {
+      auto cell = trim(text(irow, icol));
+      bool neg = !cell.empty() && cell.front() == '-';
+      if (!cell.empty() && (cell.front() == '+' || neg)) cell.remove_prefix(1);
+      if (cell.empty() || cell.front() < '0' || cell.front() > '9') {
+        isInt = false;
+        break;
+      }
+      uint64_t u = 0;
+      auto res = std::from_chars(cell.data(), cell.data() + cell.size(), u);
+      // -0 is left to the reals, it is a different float than 0
+      if (res.ec != std::errc() || res.ptr != cell.data() + cell.size() ||
+          u > uint64_t(INT64_MAX) || (neg && u == 0)) {
+        isInt = false;
+        break;
+      }
+      col.ints.push_back(neg ? -int64_t(u) : int64_t(u));
+    }
+    if (isInt) {
+      col.type = Int;
+      continue;
+    }
+    col.ints.clear();
+
+    // numbers, kept as both the stod and the stof value
+    bool isReal = true;
+    col.doubles.reserve(_nrow);
+    col.floats.reserve(_nrow);
+    for (std::size_t irow = 0; irow < _nrow && isReal; irow++) {
+      auto cell = trim(text(irow, icol));
+      buf.assign(cell.data(), cell.size());
+      char* end = nullptr;
+      errno = 0;
+      double d = std::strtod(buf.c_str(), &end);
+      bool ok = !buf.empty() && end == buf.c_str() + buf.size() && errno == 0;
+      float f = std::strtof(buf.c_str(), &end);
+      // stof and stod throw on out of range values, leave them that chance
+      ok = ok && end == buf.c_str() + buf.size() && errno == 0;
+      if (!ok) {
+        isReal = false;
+        break;
+      }
+      col.doubles.push_back(d);
+      col.floats.push_back(f);
+    }
+    if (isReal) {
+      col.type = Real;
+    } else {
+      col.doubles.clear();
+      col.floats.clear();
+    }
+  }
+}
+
+std::string mu2e::DbColumns::csv() const {
+  std::string csv;
+  std::size_t size = 0;
+  for (auto const& col : _cols) size += col.text.size() + _nrow;
+  csv.reserve(size);
+  for (std::size_t irow = 0; irow < _nrow; irow++) {
+    for (std::size_t icol = 0; icol < _cols.size(); icol++) {
+      if (icol > 0) csv.push_back(',');
+      csv.append(text(irow, icol));
+    }
+    csv.push_back('\n');
+  }
+  return csv;
+}
+
+mu2e::DbColumns::Column const& mu2e::DbColumns::column(
+    std::size_t irow, std::size_t icol) const {
+  if (icol >= _cols.size() || irow >= _nrow) {
+    throw cet::exception("DBCOLUMNS_BAD_INDEX")
+        << "DbColumns asked for row " << irow << " column " << icol
+        << " but has " << _nrow << " rows and " << _cols.size()
+        << " columns\n";
+  }
+  return _cols[icol];
+}
+
+std::string_view mu2e::DbColumns::text(std::size_t irow,
+                                       std::size_t icol) const {
+  auto const& col = column(irow, icol);
+  std::size_t begin = irow == 0 ? 0 : col.ends[irow - 1];
+  return std::string_view(col.text).substr(begin, col.ends[irow] - begin);
+}
+
+int mu2e::DbColumns::getInt(std::size_t irow, std::size_t icol) const {
+  auto const& col = column(irow, icol);
+  if (col.type == Int && col.ints[irow] >= INT_MIN && col.ints[irow] <= INT_MAX)
+    return int(col.ints[irow]);
+  return std::stoi(getString(irow, icol));
+}
+
+float mu2e::DbColumns::getFloat(std::size_t irow, std::size_t icol) const {
+  auto const& col = column(irow, icol);
+  if (col.type == Real) return col.floats[irow];
+  if (col.type == Int) return float(col.ints[irow]);
+  return std::stof(getString(irow, icol));
+}
+
+double mu2e::DbColumns::getDouble(std::size_t irow, std::size_t icol) const {
+  auto const& col = column(irow, icol);
+  if (col.type == Real) return col.doubles[irow];
+  if (col.type == Int) return double(col.ints[irow]);
+  return std::stod(getString(irow, icol));
+}
+
+void mu2e::DbColumns::row(std::size_t irow,
+                          std::vector<std::string>& columns) const {
+  columns.resize(_cols.size());
+  for (std::size_t icol = 0; icol < _cols.size(); icol++) {
+    columns[icol].assign(text(irow, icol));
+  }
+}
+
+void mu2e::DbColumns::toBinary(std::string& buf) const {
+  buf.assign(cxMagic, sizeof(cxMagic));
+  uint64_t nrow = _nrow;
+  uint32_t ncol = _cols.size();
+  putValues(buf, &nrow, 1);
+  putValues(buf, &ncol, 1);
+  for (auto const& col : _cols) {
+    uint8_t type = col.type;
+    uint64_t textSize = col.text.size();
+    putValues(buf, &type, 1);
+    putValues(buf, &textSize, 1);
+    buf.append(col.text);
+    putValues(buf, col.ends.data(), _nrow);
+    if (col.type == Int) {
+      putValues(buf, col.ints.data(), _nrow);
+    } else if (col.type == Real) {
+      putValues(buf, col.doubles.data(), _nrow);
+      putValues(buf, col.floats.data(), _nrow);
+    }
+  }
+}
+
+void mu2e::DbColumns::fromBinary(std::string const& buf) {
+  clear();
+  if (buf.size() < sizeof(cxMagic) ||
+      std::memcmp(buf.data(), cxMagic, sizeof(cxMagic)) != 0) {
+    throw cet::exception("DBCOLUMNS_BAD_BINARY")
+        << "DbColumns::fromBinary buffer does not start with the DbColumns "
+           "header\n";
+  }
+  std::size_t pos = sizeof(cxMagic);
+  uint64_t nrow = 0;
+  uint32_t ncol = 0;
+  getValues(buf, pos, &nrow, 1);
+  getValues(buf, pos, &ncol, 1);
+  if (nrow > buf.size() || ncol > buf.size()) {
+    throw cet::exception("DBCOLUMNS_BAD_BINARY")
+        << "DbColumns::fromBinary bad size " << nrow << " rows, " << ncol
+        << " columns\n";
+  }
+
+  // fill a copy, so a bad buffer leaves this empty
+  std::vector<Column> cols(ncol);
+  for (auto& col : cols) {
+    uint8_t type = 0;
+    uint64_t textSize = 0;
+    getValues(buf, pos, &type, 1);
+    getValues(buf, pos, &textSize, 1);
+    if (type > Real || textSize > buf.size() - pos) {
+      throw cet::exception("DBCOLUMNS_BAD_BINARY")
+          << "DbColumns::fromBinary bad column type " << int(type)
+          << " or text size " << textSize << "\n";
+    }
+    col.type = colType(type);
+    col.text.assign(buf, pos, textSize);
+    pos += textSize;
+    col.ends.resize(nrow);
+    getValues(buf, pos, col.ends.data(), nrow);
+    bool ok = nrow == 0 ? textSize == 0 : col.ends.back() == textSize;
+    for (std::size_t i = 1; i < nrow && ok; i++) {
+      ok = col.ends[i] >= col.ends[i - 1];
+    }
+    if (!ok) {
+      throw cet::exception("DBCOLUMNS_BAD_BINARY")
+          << "DbColumns::fromBinary cells do not match the text\n";
+    }
+    if (col.type == Int) {
+      col.ints.resize(nrow);
+      getValues(buf, pos, col.ints.data(), nrow);
+    } else if (col.type == Real) {
+      col.doubles.resize(nrow);
+      col.floats.resize(nrow);
+      getValues(buf, pos, col.doubles.data(), nrow);
+      getValues(buf, pos, col.floats.data(), nrow);
+    }
+  }
+  if (pos != buf.size()) {
+    throw cet::exception("DBCOLUMNS_BAD_BINARY")
+        << "DbColumns::fromBinary " << buf.size() - pos
+        << " bytes left after the columns\n";
+  }
+  _cols.swap(cols);
+  _nrow = nrow;
+}
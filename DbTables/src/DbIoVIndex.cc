@@ -0,0 +1,60 @@
+#include "Offline/DbTables/inc/DbIoVIndex.hh"
+#include <algorithm>
+
+std::size_t mu2e::DbIoVIndex::after(uint64_t k) const {
+  auto it = std::upper_bound(
+      _segments.begin(), _segments.end(), k,
+      [](uint64_t k, Segment const& s) { return k < s.start; });
+  return it - _segments.begin();
+}
+
+std::size_t mu2e::DbIoVIndex::split(uint64_t k) {
+  std::size_t i = after(k);
+  if (i > 0 && _segments[i - 1].start == k) return i - 1;
+  int owner = i > 0 ? _segments[i - 1].owner : -1;
+  _segments.insert(_segments.begin() + i, Segment{k, owner});
+  return i;
+}
+
+void mu2e::DbIoVIndex::add(DbIoV const& iov) {
+  int n = _size++;
+  uint64_t first = key(iov.startRun(), iov.startSubrun());
+  uint64_t last = key(iov.endRun(), iov.endSubrun());
+  if (first > last) return;  // contains no points
+
+  std::size_t ib = split(first);
+  std::size_t ie = last == UINT64_MAX ? _segments.size() : split(last + 1);
+  for (std::size_t i = ib; i < ie; i++) {
+    if (_segments[i].owner < 0) _segments[i].owner = n;
+  }
+
+  // merge the segments in this range which now have the same owner as
+  // the one before, so IoVs added end to end don't leave extra segments
+  std::size_t end = std::min(ie + 1, _segments.size());
+  std::size_t out = ib;
+  for (std::size_t i = ib; i < end; i++) {
+    int before = out == 0 ? -1 : _segments[out - 1].owner;
+    if (_segments[i].owner == before) continue;
+    _segments[out++] = _segments[i];
+  }
+  _segments.erase(_segments.begin() + out, _segments.begin() + end);
+}
+
+int mu2e::DbIoVIndex::find(uint32_t run, uint32_t subrun) const {
+  std::size_t i = after(key(run, subrun));
+  return i == 0 ? -1 : _segments[i - 1].owner;
+}
+
+bool mu2e::DbIoVIndex::overlaps(DbIoV const& iov) const {
+  uint64_t first = key(iov.startRun(), iov.startSubrun());
+  uint64_t last = key(iov.endRun(), iov.endSubrun());
+  if (first > last) return false;
+
+  // the segment containing first, and all those starting before last
+  std::size_t i = after(first);
+  if (i > 0) i--;
+  for (; i < _segments.size() && _segments[i].start <= last; i++) {
+    if (_segments[i].owner >= 0) return true;
+  }
+  return false;
+}
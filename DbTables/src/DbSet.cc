@@ -1,15 +1,39 @@
 
 #include "Offline/DbTables/inc/DbSet.hh"
 #include "cetlib_except/exception.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
 namespace mu2e {
 
+namespace {
+bool endsBefore(DbIoV const& a, DbIoV const& b) {
+  return a.endRun() < b.endRun() ||
+         (a.endRun() == b.endRun() && a.endSubrun() < b.endSubrun());
+}
+}  // namespace
+
 //***********************************************
 
 void DbSet::add(int tid, int cid, DbIoV const& iov) {
-  _emap[tid].emplace_back(cid, iov);
+  auto& eiovs = _emap[tid];
+  eiovs.emplace_back(cid, iov);
+  std::size_t pos = eiovs.size() - 1;
+
+  auto& ti = _index[tid];
+  ti.iovs.add(iov);
+  // after any with the same end, so the first added stays first
+  auto insert = [&](std::vector<std::size_t>& byEnd) {
+    auto it = std::upper_bound(byEnd.begin(), byEnd.end(), pos,
+                               [&](std::size_t a, std::size_t b) {
+                                 return endsBefore(eiovs[a].iov(),
+                                                   eiovs[b].iov());
+                               });
+    byEnd.insert(it, pos);
+  };
+  insert(ti.byEnd);
+  if (iov.endSubrun() < DbIoV::maxSubrun()) insert(ti.byEndBeforeMax);
 }
 
 //***********************************************
@@ -20,28 +44,39 @@ DbSet::EIoV DbSet::find(int tid, uint32_t run, uint32_t subrun) const {
     return EIoV();
   }
 
-  for (auto const& ee : iter->second) {
-    if (ee.iov().inInterval(run, subrun)) {
-      return ee;
-    }
-  }
+  auto const& eiovs = iter->second;
+  auto const& ti = _index.at(tid);
+
+  // the first entry whose interval contains the run:subrun
+  int pos = ti.iovs.find(run, subrun);
+  if (pos >= 0) return eiovs[pos];
 
   // if no return above, then find a nearby entry, if requested
   if (_nearestMatch) {
-    EIoV br;
-    int brr = DbIoV::maxRun(), bsr = DbIoV::maxSubrun();
-    for (auto const& r : iter->second) {  // find closest entry
-      int dr = run - r.iov().endRun();
-      int ds = subrun + DbIoV::maxSubrun() - r.iov().endSubrun();
-      if (dr == 0) ds = subrun - r.iov().endSubrun();
-      if (dr > 0 && ds > 0 && (dr < brr || (dr == brr && ds < bsr))) {
-        brr = dr;
-        bsr = ds;
-        br = r;
+    // the closest entry is the one with the latest end in an earlier
+    // run, the first added if several have that end.  At subrun 0, an
+    // entry ending at the last subrun of its run is at distance zero in
+    // subruns, and is not accepted
+    auto const& byEnd = subrun == 0 ? ti.byEndBeforeMax : ti.byEnd;
+    auto it = std::lower_bound(byEnd.begin(), byEnd.end(), run,
+                               [&](std::size_t a, uint32_t run) {
+                                 return eiovs[a].iov().endRun() < run;
+                               });
+    if (it != byEnd.begin()) {
+      // first of the entries with the same end
+      DbIoV const& near = eiovs[*std::prev(it)].iov();
+      it = std::lower_bound(byEnd.begin(), it, near,
+                            [&](std::size_t a, DbIoV const& b) {
+                              return endsBefore(eiovs[a].iov(), b);
+                            });
+      EIoV const& br = eiovs[*it];
+      int dr = run - br.iov().endRun();
+      int ds = subrun + DbIoV::maxSubrun() - br.iov().endSubrun();
+      int brr = DbIoV::maxRun(), bsr = DbIoV::maxSubrun();
+      if (dr > 0 && ds > 0 && (dr < brr || (dr == brr && ds < bsr)) &&
+          br.cid() > 0) {  // then something was found
+        return br;
       }
-    }                    // loop over Rows for table type
-    if (br.cid() > 0) {  // then something was found
-      return br;
     }
   }  // try nearest match
 
@@ -50,7 +85,10 @@ DbSet::EIoV DbSet::find(int tid, uint32_t run, uint32_t subrun) const {
 
 //***********************************************
 
-void DbSet::clear() { _emap.clear(); }
+void DbSet::clear() {
+  _emap.clear();
+  _index.clear();
+}
 
 //***********************************************
 
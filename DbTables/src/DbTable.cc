@@ -1,23 +1,25 @@
 #include "Offline/DbTables/inc/DbTable.hh"
-#include "Offline/DbTables/inc/DbUtil.hh"
 #include "cetlib_except/exception.h"
-#include <boost/algorithm/string/split.hpp>
 #include <iostream>
 
 int mu2e::DbTable::fill(const std::string& csv, bool saveCsv) {
-  std::vector<std::string> lines = DbUtil::splitCsvLines(csv);
-  std::vector<std::string> columns;  // columns of a row as text
-  size_t ncol = 0;                   // check they all have the same columns
-  for (auto const& line : lines) {
-    columns = DbUtil::splitCsv(line);
-    if (ncol == 0) ncol = columns.size();
-    if (columns.size() != ncol) {
-      throw cet::exception("DBTABLE_BAD_COLUMN_COUNT")
-          << "DbTable::fill found " << columns.size() << " columns "
-          << " when " << ncol << " was seen in previous rows. Text:" << line
-          << " \n";
-    }
-    addRow(columns);
+  DbColumns columns;
+  columns.fromCsv(csv);
+  fill(columns, false);
+
+  // save the plain text
+  if (saveCsv) {
+    _csv = csv;
+  } else {
+    _csv.clear();
+  }
+
+  return 0;
+}
+
+int mu2e::DbTable::fill(const DbColumns& columns, bool saveCsv) {
+  for (std::size_t irow = 0; irow < columns.nrow(); irow++) {
+    addBinaryRow(columns, irow);
   }
 
   // if this table has a fixed number of rows, check that
@@ -28,9 +30,9 @@ int mu2e::DbTable::fill(const std::string& csv, bool saveCsv) {
         << name();
   }
 
-  // save the plain text
+  // the columns keep the text exactly as it was read
   if (saveCsv) {
-    _csv = csv;
+    _csv = columns.csv();
   } else {
     _csv.clear();
   }
@@ -51,6 +53,12 @@ void mu2e::DbTable::addRow(const std::vector<std::string>& columns) {
       << "DbTable::addRow must be overridden ";
 }
 
+void mu2e::DbTable::addBinaryRow(const DbColumns& columns, std::size_t irow) {
+  std::vector<std::string> row;
+  columns.row(irow, row);
+  addRow(row);
+}
+
 void mu2e::DbTable::rowToCsv(std::ostringstream& stream, size_t irow) const {
   throw cet::exception("DBTABLE_FUNCTION_NOT_IMPLEMENTED")
       << "DbTable::rowToCsv must be overridden ";
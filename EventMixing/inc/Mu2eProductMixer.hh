@@ -33,7 +33,9 @@
 #include "Offline/MCDataProducts/inc/GenParticle.hh"
 #include "Offline/MCDataProducts/inc/SimParticle.hh"
 #include "Offline/MCDataProducts/inc/StepPointMC.hh"
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
 #include "Offline/MCDataProducts/inc/MCTrajectoryCollection.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
 #include "Offline/MCDataProducts/inc/CaloShowerStep.hh"
 #include "Offline/MCDataProducts/inc/StrawGasStep.hh"
 #include "Offline/MCDataProducts/inc/CrvStep.hh"
@@ -98,7 +100,11 @@ namespace mu2e {
       fhicl::Table<CollectionMixerConfig> genParticleMixer { fhicl::Name("genParticleMixer") };
       fhicl::Table<CollectionMixerConfig> simParticleMixer { fhicl::Name("simParticleMixer") };
       fhicl::Table<CollectionMixerConfig> stepPointMCMixer { fhicl::Name("stepPointMCMixer") };
+      fhicl::Table<CollectionMixerConfig> stepPointMCCompactMixer { fhicl::Name("stepPointMCCompactMixer"),
+          fhicl::Comment("StepPointMCCompactCollections, mixed into StepPointMCCollections") };
       fhicl::Table<CollectionMixerConfig> mcTrajectoryMixer { fhicl::Name("mcTrajectoryMixer") };
+      fhicl::Table<CollectionMixerConfig> mcTrajectoryCompactMixer { fhicl::Name("mcTrajectoryCompactMixer"),
+          fhicl::Comment("MCTrajectoryCompactCollections, mixed into MCTrajectoryCollections") };
       fhicl::Table<CollectionMixerConfig> caloShowerStepMixer { fhicl::Name("caloShowerStepMixer") };
       fhicl::Table<CollectionMixerConfig> strawGasStepMixer { fhicl::Name("strawGasStepMixer") };
       fhicl::Table<CollectionMixerConfig> crvStepMixer { fhicl::Name("crvStepMixer") };
@@ -134,10 +140,18 @@ namespace mu2e {
                          StepPointMCCollection& out,
                          art::PtrRemapper const& remap);
 
+    bool mixStepPointMCCompacts(std::vector<StepPointMCCompactCollection const*> const& in,
+                                StepPointMCCollection& out,
+                                art::PtrRemapper const& remap);
+
     bool mixMCTrajectories(std::vector<MCTrajectoryCollection const*> const& in,
                            MCTrajectoryCollection& out,
                            art::PtrRemapper const& remap);
 
+    bool mixMCTrajectoryCompacts(std::vector<MCTrajectoryCompactCollection const*> const& in,
+                                 MCTrajectoryCollection& out,
+                                 art::PtrRemapper const& remap);
+
     bool mixCaloShowerSteps(std::vector<CaloShowerStepCollection const*> const& in,
                             CaloShowerStepCollection& out,
                             art::PtrRemapper const& remap);
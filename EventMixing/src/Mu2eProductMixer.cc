@@ -67,11 +67,21 @@ namespace mu2e {
         (e.inTag, e.resolvedInstanceName(), &Mu2eProductMixer::mixStepPointMCs, *this);
     }
 
+    for(const auto& e: conf.stepPointMCCompactMixer().mixingMap()) {
+      helper.declareMixOp
+        (e.inTag, e.resolvedInstanceName(), &Mu2eProductMixer::mixStepPointMCCompacts, *this);
+    }
+
     for(const auto& e: conf.mcTrajectoryMixer().mixingMap()) {
       helper.declareMixOp
         (e.inTag, e.resolvedInstanceName(), &Mu2eProductMixer::mixMCTrajectories, *this);
     }
 
+    for(const auto& e: conf.mcTrajectoryCompactMixer().mixingMap()) {
+      helper.declareMixOp
+        (e.inTag, e.resolvedInstanceName(), &Mu2eProductMixer::mixMCTrajectoryCompacts, *this);
+    }
+
     for(const auto& e: conf.caloShowerStepMixer().mixingMap()) {
       helper.declareMixOp
         (e.inTag, e.resolvedInstanceName(), &Mu2eProductMixer::mixCaloShowerSteps, *this);
@@ -306,6 +316,27 @@ namespace mu2e {
     return true;
   }
 
+  //----------------------------------------------------------------
+  bool Mu2eProductMixer::mixStepPointMCCompacts(std::vector<StepPointMCCompactCollection const*> const& in,
+                                                StepPointMCCollection& out,
+                                                art::PtrRemapper const& remap)
+  {
+    for(std::vector<StepPointMCCompactCollection const*>::size_type ieIndex = 0; ieIndex < in.size(); ++ieIndex) {
+      if(in[ieIndex] != nullptr) {
+        const auto first = out.size();
+        in[ieIndex]->expand(out);
+        for(auto i = first; i < out.size(); ++i) {
+          auto& step = out[i];
+          step.simParticle() = remap(step.simParticle(), simOffsets_[ieIndex]);
+          if(applyTimeOffset_){
+            step.time() += stoff_.timeOffset_;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
   //----------------------------------------------------------------
   bool Mu2eProductMixer::mixMCTrajectories(std::vector<MCTrajectoryCollection const*> const& in,
                                            MCTrajectoryCollection& out,
@@ -341,6 +372,31 @@ namespace mu2e {
     return true;
   }
 
+  //----------------------------------------------------------------
+  bool Mu2eProductMixer::mixMCTrajectoryCompacts(std::vector<MCTrajectoryCompactCollection const*> const& in,
+                                                 MCTrajectoryCollection& out,
+                                                 art::PtrRemapper const& remap)
+  {
+    // The points are restored directly with the time offset.
+    for(std::vector<MCTrajectoryCompactCollection const*>::size_type ieIndex = 0; ieIndex < in.size(); ++ieIndex) {
+      if (in[ieIndex] != nullptr) {
+        const double timeOffset = applyTimeOffset_ ? stoff_.timeOffset_ : 0.;
+        for(size_t i = 0; i < in[ieIndex]->size(); ++i) {
+          auto sim = remap(in[ieIndex]->trajectories()[i].sim(), simOffsets_[ieIndex]);
+          auto res = out.insert(std::make_pair(sim, MCTrajectory(sim)));
+          if(!res.second) {
+            throw cet::exception("BUG")<<"mixMCTrajectoryCompacts(): failed to insert an entry, ieIndex="<<ieIndex
+              <<", orig ptr = "<<in[ieIndex]->trajectories()[i].sim()
+              <<std::endl;
+          }
+          res.first->second.points() = in[ieIndex]->points(i, timeOffset);
+        }
+      }
+    }
+
+    return true;
+  }
+
   //----------------------------------------------------------------
   bool Mu2eProductMixer::mixCaloShowerSteps(std::vector<CaloShowerStepCollection const*> const& in,
                                             CaloShowerStepCollection& out,
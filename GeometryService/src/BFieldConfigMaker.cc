@@ -43,6 +43,8 @@ namespace mu2e {
     BFieldConfigMaker::BFieldConfigMaker(const SimpleConfig& config, const Beamline& beamg)
         : bfconf_(new BFieldConfig()) {
         bfconf_->writeBinaries_ = config.getBool("bfield.writeG4BLBinaries", false);
+        bfconf_->writeMappedMaps_ = config.getBool("bfield.writeMappedMaps", false);
+        bfconf_->verifyMapChecksums_ = config.getBool("bfield.verifyMapChecksums", true);
         bfconf_->verbosityLevel_ = config.getInt("bfield.verbosityLevel");
         bfconf_->flipBFieldMaps_ = config.getBool("bfield.flipMaps", false);
 
@@ -5,6 +5,7 @@
 
 // Includes from C++
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -30,6 +31,7 @@
 
 // Includes from Mu2e
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
 #include "Offline/BFieldGeom/inc/BFieldConfig.hh"
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/GeneralUtilities/inc/MinMax.hh"
@@ -148,6 +150,15 @@ namespace mu2e {
             }
         }
 
+        if (config.writeMappedMaps()) {
+            for (auto mapptr : allMaps) {
+                auto const* gridmap = dynamic_cast<const BFGridMap*>(mapptr.get());
+                if (gridmap != nullptr) {
+                    writeMappedBinary(*gridmap, mapptr->getKey() + ".bfmap");
+                }
+            }
+        }
+
         // For debug purposes: print the field in the target region
         if (bfieldVerbosityLevel > 0) {
             CLHEP::Hep3Vector b = _bfmgr->getBField(CLHEP::Hep3Vector(3900.0, 0.0, -6550.0));
@@ -347,12 +358,26 @@ namespace mu2e {
             if (bfieldVerbosityLevel > 0) {
                 cout << "Reading " << files[i] << endl;
             }
+            auto t0 = std::chrono::steady_clock::now();
             const std::string mapkey = basename(files[i]);
             if ( mapTypeList[i] == BFMapType::PARAM) {
                 loadParam(mapContainer, mapkey, _resolveFullPath(files[i]), config);
+            } else if (files[i].size() > 6 && files[i].compare(files[i].size() - 6, 6, ".bfmap") == 0) {
+                loadMapped(mapContainer, mapkey, _resolveFullPath(files[i]), config);
             } else {
                 loadG4BL(mapContainer, mapkey, _resolveFullPath(files[i]), config);
             }
+            if (bfieldVerbosityLevel > 0) {
+                std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+                cout << "Loaded " << mapkey << " in " << dt.count() << " s";
+                auto const* gridmap = dynamic_cast<const BFGridMap*>(mapContainer.back().get());
+                if (gridmap != nullptr) {
+                    cout << "; field values: "
+                         << sizeof(CLHEP::Hep3Vector) * gridmap->nx() * gridmap->ny() * gridmap->nz()
+                         << " bytes " << (gridmap->isMapped() ? "shared from the file" : "in memory");
+                }
+                cout << endl;
+            }
         }
     }
 
@@ -402,11 +427,43 @@ namespace mu2e {
 
         if(config.flipBFieldMaps()) flipMap(*dsmap);
 
+        // The compact style interpolates in a single precision copy of the field values.
+        if (config.interpolationStyle() == BFInterpolationStyle::compact) {
+            dsmap->_compact = dsmap->makeCompactGrid();
+        }
+
         mapContainer.emplace_back(dsmap);
 
     }
 
 
+    // Create a map that uses the field values of a mapped binary file in place.
+    // The file describes its own grid, so there is no header to parse.
+    void BFieldManagerMaker::loadMapped(MapContainerType& mapContainer,
+                                        const std::string& key,
+                                        const std::string& resolvedFileName,
+                                        const BFieldConfig& config) {
+        auto mapping =
+            std::make_shared<const BFMapFile>(resolvedFileName, config.verifyMapChecksums());
+        auto dsmap = std::make_shared<BFGridMap>(key, mapping,
+                                                 BFMapType::G4BL,
+                                                 config.scaleFactor(),
+                                                 config.interpolationStyle());
+
+        // The field values are read-only; flip the map through the sign of its scale factor.
+        if (config.flipBFieldMaps()) {
+            std::cout << "Flipping B field vector in map " << key << std::endl;
+            dsmap->_scaleFactor = -dsmap->_scaleFactor;
+        }
+
+        // The compact style interpolates in a single precision copy of the field values.
+        if (config.interpolationStyle() == BFInterpolationStyle::compact) {
+            dsmap->_compact = dsmap->makeCompactGrid();
+        }
+
+        mapContainer.emplace_back(dsmap);
+    }
+
     //
     // Read one magnetic field map file in G4BL (TD) format.
     //
@@ -762,6 +819,21 @@ namespace mu2e {
     }  // end BFieldManagerMaker::writeG4BLBinary
 
 
+    void BFieldManagerMaker::writeMappedBinary(const BFGridMap& bf, const std::string& outputfile) {
+        BFMapFileHeader header = BFMapFile::makeHeader();
+        header.flags = bf._flipy ? BFMapFile::flipyFlag : 0;
+        header.nx = bf.nx();
+        header.ny = bf.ny();
+        header.nz = bf.nz();
+        header.xmin = bf.xmin();
+        header.ymin = bf.ymin();
+        header.zmin = bf.zmin();
+        header.dx = bf.dx();
+        header.dy = bf.dy();
+        header.dz = bf.dz();
+        BFMapFile::write(outputfile, header, &bf._field.get(0, 0, 0));
+    }
+
     void BFieldManagerMaker::flipMap(BFGridMap& bf) {
         std::cout << "Flipping B field vector in map " << bf.getKey() << std::endl;
         for (int ix = 0; ix < bf.nx(); ++ix) {
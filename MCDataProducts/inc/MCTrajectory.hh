@@ -59,6 +59,16 @@ namespace mu2e {
       points_.push_back(p);
     }
 
+    // Drop the points that the polyline through the remaining ones
+    // describes to within maxDistance (mm) in position and maxEnergyChange
+    // (MeV) in kinetic energy.  The first and last points are always kept.
+    // The distance of a dropped point is taken to the segment between the
+    // kept points around it; its kinetic energy is compared to the linear
+    // interpolation along that segment.  A non-positive maxDistance leaves
+    // the points unchanged, a non-positive maxEnergyChange disables the
+    // energy check.  Returns the number of points dropped.
+    size_t simplify(double maxDistance, double maxEnergyChange);
+
   private:
 
     art::Ptr<SimParticle> sim_;
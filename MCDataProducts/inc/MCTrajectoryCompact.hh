@@ -0,0 +1,120 @@
+#ifndef MCDataProducts_MCTrajectoryCompact_hh
+#define MCDataProducts_MCTrajectoryCompact_hh
+//
+// A compact persistent form of an MCTrajectoryCollection.
+//
+// The first point of each trajectory is stored as it is.  The position,
+// time and kinetic energy of the other points are stored relative to the
+// first point, rounded to multiples of the resolutions held by the
+// collection, as the differences from the previous point.  These are
+// written as little endian integers of 1, 2, 4 or 8 bytes, the width
+// being chosen for each of the five quantities of a trajectory from its
+// largest difference, so that the short steps between successive points
+// take one or two bytes per quantity and the points are restored without
+// a branch on every value.  The rounding errors do not accumulate along
+// the trajectory: every restored point is within half a resolution step
+// (plus the float precision) of the original one.
+//
+// The key of each trajectory in the MCTrajectoryCollection is its sim(),
+// as for all collections made in Offline; the restored collections use
+// the sim() as the key.
+//
+// The points are restored with points() or trajectory(), for one
+// trajectory, and expand(), which adds all the trajectories to an
+// MCTrajectoryCollection.  Mu2eProductMixer mixes the compact collections
+// directly into MCTrajectoryCollections; all other readers need the
+// ExpandMCTrajectories module in the path before them.
+//
+// The compact form only saves space.  Restoring the points costs more
+// than copying full ones, so mixing a compact collection is slower than
+// mixing the full collection of the same trajectories: in
+// MCTrajectoryCompactBench, 7.2 ms against 4.4 ms for 2000 unsimplified
+// trajectories.  Even with a 1 mm simplifyTolerance the compact form
+// takes 4.7 ms, more than the 4.4 ms of the unsimplified full form.
+// Mixing gets faster only from the fewer points of MCTrajectory::simplify()
+// in the full form: 3.1 ms at 1 mm, 1.9 ms at 5 mm.
+//
+
+#include "canvas/Persistency/Common/Ptr.h"
+
+#include "Offline/MCDataProducts/inc/MCTrajectoryCollection.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryPoint.hh"
+#include "Offline/MCDataProducts/inc/SimParticle.hh"
+
+#include <vector>
+
+namespace mu2e {
+
+  class MCTrajectoryCompact {
+
+  public:
+
+    MCTrajectoryCompact() : npoints_(0), widths_(0) {}
+
+    // Accept compiler generated versions of: d'tor, copy c'tor, assignment operator
+
+    art::Ptr<SimParticle> const& sim() const { return sim_; }
+    art::Ptr<SimParticle>      & sim()       { return sim_; }
+
+    size_t size()   const { return npoints_; }
+    size_t nBytes() const { return deltas_.size(); }
+
+  private:
+    friend class MCTrajectoryCompactCollection;
+
+    art::Ptr<SimParticle>      sim_;
+    MCTrajectoryPoint          first_;
+    unsigned                   npoints_;
+    unsigned                   widths_; // bytes per difference of x, y, z, t, kinetic energy, 4 bits each
+    std::vector<unsigned char> deltas_; // x, y, z, t, kinetic energy of each point after the first
+  };
+
+  class MCTrajectoryCompactCollection {
+
+  public:
+
+    // The default resolutions
+    static constexpr float defaultPositionStep = 0.05;  // mm
+    static constexpr float defaultTimeStep     = 0.001; // ns
+    static constexpr float defaultEnergyStep   = 0.001; // MeV
+
+    MCTrajectoryCompactCollection()
+      : positionStep_(defaultPositionStep), timeStep_(defaultTimeStep), energyStep_(defaultEnergyStep) {}
+
+    MCTrajectoryCompactCollection(MCTrajectoryCollection const& trajectories,
+                                  float positionStep = defaultPositionStep,
+                                  float timeStep = defaultTimeStep,
+                                  float energyStep = defaultEnergyStep);
+
+    // Accept compiler generated versions of: d'tor, copy c'tor, assignment operator
+
+    size_t size()  const { return trajectories_.size(); }
+    bool   empty() const { return trajectories_.empty(); }
+
+    float positionStep() const { return positionStep_; }
+    float timeStep()     const { return timeStep_; }
+    float energyStep()   const { return energyStep_; }
+
+    // In the order of the MCTrajectoryCollection they were made from.
+    std::vector<MCTrajectoryCompact> const& trajectories() const { return trajectories_; }
+
+    // Restore the points of one trajectory, with timeOffset added to their times.
+    std::vector<MCTrajectoryPoint> points(size_t i, double timeOffset = 0.) const;
+
+    // Restore one trajectory.
+    MCTrajectory trajectory(size_t i, double timeOffset = 0.) const;
+
+    // Add the restored trajectories to out.
+    void expand(MCTrajectoryCollection& out) const;
+
+  private:
+
+    float                            positionStep_;
+    float                            timeStep_;
+    float                            energyStep_;
+    std::vector<MCTrajectoryCompact> trajectories_;
+  };
+
+} // namespace mu2e
+
+#endif /* MCDataProducts_MCTrajectoryCompact_hh */
@@ -0,0 +1,93 @@
+#ifndef MCDataProducts_StepPointMCCompact_hh
+#define MCDataProducts_StepPointMCCompact_hh
+//
+// A compact persistent form of a StepPointMCCollection, for the large
+// collections written in the simulation stages (virtual detectors, CRV,
+// stopping target, ...).
+//
+// Positions and momenta are stored in single precision.  The positions
+// are stored relative to an origin held by the collection, the centre
+// of the box around all positions, so that their precision is set by
+// the extent of the collection and not by the distance from the
+// Mu2e origin.  The time is kept in double precision since it carries
+// the time offsets of the later stages.
+//
+// The post-step position and momentum can be dropped when the collection
+// is made.  The StepPointMCs restored from such a collection have zero
+// post-step position and momentum; hasPostStep() tells if they were kept.
+//
+// The StepPointMCs are restored with expand(), which appends them to a
+// StepPointMCCollection.  Mu2eProductMixer mixes the compact collections
+// directly into StepPointMCCollections.  No other reader is aware of them:
+// FromStepPointMCs, the compression modules and the rest need the
+// ExpandStepPointMCs module in the path before them (see
+// CommonMC.ExpandStepPointMCs in CommonMC/fcl/prolog.fcl).
+//
+
+#include "canvas/Persistency/Common/Ptr.h"
+
+#include "Offline/DataProducts/inc/GenVector.hh"
+#include "Offline/MCDataProducts/inc/ProcessCode.hh"
+#include "Offline/MCDataProducts/inc/SimParticle.hh"
+#include "Offline/MCDataProducts/inc/StepPointMC.hh"
+
+#include <vector>
+
+namespace mu2e {
+
+  // The part of a StepPointMC that is always stored.
+  struct StepPointMCCompact {
+    art::Ptr<SimParticle> _track;
+    unsigned              _volumeId = 0;
+    float                 _totalEnergyDeposit = 0;
+    float                 _nonIonizingEnergyDeposit = 0;
+    float                 _visibleEnergyDeposit = 0;
+    XYZVectorF            _position;    // relative to the origin of the collection
+    XYZVectorF            _momentum;
+    double                _time = 0;
+    float                 _proper = 0;
+    float                 _stepLength = 0;
+    ProcessCode           _endProcessCode;
+  };
+
+  // The optional post-step part of a StepPointMC.
+  struct StepPointMCCompactPost {
+    XYZVectorF            _postPosition; // relative to the origin of the collection
+    XYZVectorF            _postMomentum;
+  };
+
+  class StepPointMCCompactCollection {
+
+  public:
+
+    StepPointMCCompactCollection() : _hasPostStep(false) {}
+
+    StepPointMCCompactCollection(StepPointMCCollection const& steps, bool keepPostStep);
+
+    // Accept compiler generated versions of: d'tor, copy c'tor, assignment operator
+
+    size_t size()         const { return _steps.size(); }
+    bool   empty()        const { return _steps.empty(); }
+    bool   hasPostStep()  const { return _hasPostStep; }
+    XYZVectorD const& origin() const { return _origin; }
+
+    std::vector<StepPointMCCompact> const&     steps()     const { return _steps; }
+    std::vector<StepPointMCCompactPost> const& postSteps() const { return _postSteps; }
+
+    // Restore one StepPointMC.
+    StepPointMC step(size_t i) const;
+
+    // Append the restored StepPointMCs to out.
+    void expand(StepPointMCCollection& out) const;
+
+  private:
+
+    XYZVectorD                          _origin;
+    bool                                _hasPostStep;
+    std::vector<StepPointMCCompact>     _steps;
+    std::vector<StepPointMCCompactPost> _postSteps; // empty unless _hasPostStep
+  };
+
+} // namespace mu2e
+
+#endif /* MCDataProducts_StepPointMCCompact_hh */
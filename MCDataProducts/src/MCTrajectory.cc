@@ -0,0 +1,77 @@
+//
+// A trajectory defined as a collection of 3D points + time + kinetic energy.
+//
+
+#include "Offline/MCDataProducts/inc/MCTrajectory.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace mu2e {
+
+  namespace {
+    // Distance of p from the segment a-b.
+    double segmentDistance(CLHEP::Hep3Vector const& p, CLHEP::Hep3Vector const& a, CLHEP::Hep3Vector const& b) {
+      const CLHEP::Hep3Vector ab = b - a;
+      const double len2 = ab.mag2();
+      double f = len2 > 0. ? (p - a).dot(ab)/len2 : 0.;
+      f = std::min(1., std::max(0., f));
+      return (p - (a + f*ab)).mag();
+    }
+  }
+
+  size_t MCTrajectory::simplify(double maxDistance, double maxEnergyChange) {
+    const size_t n = points_.size();
+    if(n < 3 || maxDistance <= 0.) return 0;
+
+    // Path length along the original points, to interpolate the kinetic energy.
+    std::vector<double> path(n, 0.);
+    for(size_t i=1; i<n; ++i) {
+      path[i] = path[i-1] + (points_[i].pos() - points_[i-1].pos()).mag();
+    }
+
+    // Douglas-Peucker: split each segment at its worst point until all
+    // the points between the kept ones are within the tolerances.
+    std::vector<bool> keep(n, false);
+    keep.front() = keep.back() = true;
+    std::vector<std::pair<size_t,size_t> > segments{{0, n-1}};
+    while(!segments.empty()) {
+      const auto [first, last] = segments.back();
+      segments.pop_back();
+      if(last - first < 2) continue;
+
+      const CLHEP::Hep3Vector a = points_[first].pos(), b = points_[last].pos();
+      const double ea = points_[first].kineticEnergy(), eb = points_[last].kineticEnergy();
+      const double ds = path[last] - path[first];
+
+      size_t worst = first;
+      double worstDeviation = 1.; // in units of the tolerance
+      for(size_t i=first+1; i<last; ++i) {
+        double deviation = segmentDistance(points_[i].pos(), a, b)/maxDistance;
+        if(maxEnergyChange > 0.) {
+          const double f = ds > 0. ? (path[i] - path[first])/ds : 0.;
+          deviation = std::max(deviation, std::abs(points_[i].kineticEnergy() - (ea + f*(eb - ea)))/maxEnergyChange);
+        }
+        if(deviation > worstDeviation) {
+          worstDeviation = deviation;
+          worst = i;
+        }
+      }
+
+      if(worst != first) {
+        keep[worst] = true;
+        segments.emplace_back(first, worst);
+        segments.emplace_back(worst, last);
+      }
+    }
+
+    size_t nkept = 0;
+    for(size_t i=0; i<n; ++i) {
+      if(keep[i]) points_[nkept++] = points_[i];
+    }
+    points_.resize(nkept);
+    return n - nkept;
+  }
+
+} // namespace mu2e
@@ -0,0 +1,159 @@
+//
+// A compact persistent form of an MCTrajectoryCollection.
+//
+
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
+
+#include "cetlib_except/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace mu2e {
+
+  namespace {
+    // Multiples of the step that are exact in double precision.
+    const double maxSteps = 9007199254740992.; // 2^53
+
+    int64_t quantize(double value, double step) {
+      const double q = std::round(value/step);
+      if(!(std::abs(q) < maxSteps)) {
+        throw cet::exception("RANGE")<<"MCTrajectoryCompactCollection: "<<value
+                                     <<" does not fit the compact format with resolution "<<step<<"\n";
+      }
+      return static_cast<int64_t>(q);
+    }
+
+    // The number of bytes for differences of at most maxabs in magnitude.
+    unsigned byteWidth(int64_t maxabs) {
+      return maxabs < 0x80 ? 1 : maxabs < 0x8000 ? 2 : maxabs < 0x80000000LL ? 4 : 8;
+    }
+
+    void putInt(std::vector<unsigned char>& bytes, int64_t value, unsigned width) {
+      for(unsigned b=0; b<width; ++b) {
+        bytes.push_back(static_cast<unsigned char>(static_cast<uint64_t>(value) >> 8*b));
+      }
+    }
+
+    template<typename T> int64_t getInt(unsigned char const*& p) {
+      uint64_t u = 0;
+      for(unsigned b=0; b<sizeof(T); ++b) u |= static_cast<uint64_t>(p[b]) << 8*b;
+      p += sizeof(T);
+      return static_cast<T>(u);
+    }
+
+    int64_t getInt(unsigned char const*& p, unsigned width) {
+      switch(width) {
+      case 1:  return getInt<int8_t>(p);
+      case 2:  return getInt<int16_t>(p);
+      case 4:  return getInt<int32_t>(p);
+      default: return getInt<int64_t>(p);
+      }
+    }
+  }
+
+  MCTrajectoryCompactCollection::MCTrajectoryCompactCollection(MCTrajectoryCollection const& trajectories,
+                                                               float positionStep, float timeStep, float energyStep)
+    : positionStep_(positionStep), timeStep_(timeStep), energyStep_(energyStep)
+  {
+    if(!(positionStep_ > 0 && timeStep_ > 0 && energyStep_ > 0)) {
+      throw cet::exception("CONFIG")<<"MCTrajectoryCompactCollection: the resolutions must be positive\n";
+    }
+
+    trajectories_.reserve(trajectories.size());
+    for(auto const& entry : trajectories) {
+      auto const& traj = entry.second;
+      if(entry.first != traj.sim()) {
+        throw cet::exception("BUG")<<"MCTrajectoryCompactCollection: key "<<entry.first
+                                   <<" differs from the trajectory sim "<<traj.sim()<<"\n";
+      }
+
+      MCTrajectoryCompact c;
+      c.sim_ = traj.sim();
+      c.npoints_ = traj.size();
+      auto const& points = traj.points();
+      if(!points.empty()) {
+        c.first_ = points.front();
+        auto const& p0 = c.first_;
+
+        // differences from the previous point, in resolution steps
+        std::vector<int64_t> deltas(5*(points.size() - 1));
+        int64_t prev[5] = {0, 0, 0, 0, 0};
+        int64_t maxabs[5] = {0, 0, 0, 0, 0};
+        for(size_t i=1; i<points.size(); ++i) {
+          auto const& p = points[i];
+          const int64_t q[5] = {
+            quantize(double(p.x()) - p0.x(), positionStep_),
+            quantize(double(p.y()) - p0.y(), positionStep_),
+            quantize(double(p.z()) - p0.z(), positionStep_),
+            quantize(double(p.t()) - p0.t(), timeStep_),
+            quantize(double(p.kineticEnergy()) - p0.kineticEnergy(), energyStep_)
+          };
+          for(int k=0; k<5; ++k) {
+            const int64_t d = q[k] - prev[k];
+            deltas[5*(i-1) + k] = d;
+            maxabs[k] = std::max(maxabs[k], d < 0 ? -d : d);
+            prev[k] = q[k];
+          }
+        }
+
+        unsigned width[5];
+        for(int k=0; k<5; ++k) {
+          width[k] = byteWidth(maxabs[k]);
+          c.widths_ |= width[k] << 4*k;
+        }
+        c.deltas_.reserve((width[0] + width[1] + width[2] + width[3] + width[4])*(points.size() - 1));
+        for(size_t i=0; i<deltas.size(); ++i) {
+          putInt(c.deltas_, deltas[i], width[i%5]);
+        }
+      }
+      trajectories_.push_back(std::move(c));
+    }
+  }
+
+  std::vector<MCTrajectoryPoint> MCTrajectoryCompactCollection::points(size_t i, double timeOffset) const {
+    auto const& c = trajectories_.at(i);
+    std::vector<MCTrajectoryPoint> out;
+    if(c.npoints_ == 0) return out;
+    out.reserve(c.npoints_);
+
+    auto const& p0 = c.first_;
+    const double x0 = p0.x(), y0 = p0.y(), z0 = p0.z(), t0 = p0.t() + timeOffset, e0 = p0.kineticEnergy();
+    out.emplace_back(CLHEP::Hep3Vector(x0, y0, z0), t0, e0);
+
+    unsigned width[5];
+    for(int k=0; k<5; ++k) width[k] = (c.widths_ >> 4*k) & 0xf;
+
+    int64_t q[5] = {0, 0, 0, 0, 0};
+    unsigned char const* p = c.deltas_.data();
+    for(unsigned ip=1; ip<c.npoints_; ++ip) {
+      for(int k=0; k<5; ++k) q[k] += getInt(p, width[k]);
+      out.emplace_back(CLHEP::Hep3Vector(x0 + q[0]*double(positionStep_),
+                                         y0 + q[1]*double(positionStep_),
+                                         z0 + q[2]*double(positionStep_)),
+                       t0 + q[3]*double(timeStep_),
+                       e0 + q[4]*double(energyStep_));
+    }
+    return out;
+  }
+
+  MCTrajectory MCTrajectoryCompactCollection::trajectory(size_t i, double timeOffset) const {
+    MCTrajectory traj(trajectories_.at(i).sim());
+    traj.points() = points(i, timeOffset);
+    return traj;
+  }
+
+  void MCTrajectoryCompactCollection::expand(MCTrajectoryCollection& out) const {
+    for(size_t i=0; i<trajectories_.size(); ++i) {
+      auto const& sim = trajectories_[i].sim();
+      auto res = out.emplace(sim, MCTrajectory(sim));
+      if(!res.second) {
+        throw cet::exception("BUG")<<"MCTrajectoryCompactCollection::expand(): duplicate trajectory for "<<sim<<"\n";
+      }
+      res.first->second.points() = points(i);
+    }
+  }
+
+} // namespace mu2e
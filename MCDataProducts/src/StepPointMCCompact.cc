@@ -0,0 +1,99 @@
+//
+// A compact persistent form of a StepPointMCCollection.
+//
+
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
+
+#include "cetlib_except/exception.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace mu2e {
+
+  namespace {
+    XYZVectorF toFloat(CLHEP::Hep3Vector const& v) {
+      return XYZVectorF(v.x(), v.y(), v.z());
+    }
+  }
+
+  StepPointMCCompactCollection::StepPointMCCompactCollection(StepPointMCCollection const& steps, bool keepPostStep)
+    : _hasPostStep(keepPostStep)
+  {
+    if(steps.empty()) return;
+
+    // The origin is the centre of the box around all stored positions.
+    CLHEP::Hep3Vector lo(steps.front().position()), hi(lo);
+    auto extend = [&lo, &hi](CLHEP::Hep3Vector const& p) {
+      lo.set(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+      hi.set(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+    };
+    for(auto const& step : steps) {
+      extend(step.position());
+      if(_hasPostStep) extend(step.postPosition());
+    }
+    CLHEP::Hep3Vector origin = 0.5*(lo + hi);
+    _origin = XYZVectorD(origin.x(), origin.y(), origin.z());
+
+    _steps.reserve(steps.size());
+    if(_hasPostStep) _postSteps.reserve(steps.size());
+    for(auto const& step : steps) {
+      if(step.volumeId() > std::numeric_limits<unsigned>::max()) {
+        throw cet::exception("RANGE")<<"StepPointMCCompactCollection: volumeId "<<step.volumeId()
+                                     <<" does not fit the compact format\n";
+      }
+      StepPointMCCompact c;
+      c._track                    = step.simParticle();
+      c._volumeId                 = step.volumeId();
+      c._totalEnergyDeposit       = step.totalEDep();
+      c._nonIonizingEnergyDeposit = step.nonIonizingEDep();
+      c._visibleEnergyDeposit     = step.visibleEDep();
+      c._position                 = toFloat(step.position() - origin);
+      c._momentum                 = toFloat(step.momentum());
+      c._time                     = step.time();
+      c._proper                   = step.properTime();
+      c._stepLength               = step.stepLength();
+      c._endProcessCode           = step.endProcessCode();
+      _steps.push_back(c);
+
+      if(_hasPostStep) {
+        StepPointMCCompactPost p;
+        p._postPosition = toFloat(step.postPosition() - origin);
+        p._postMomentum = toFloat(step.postMomentum());
+        _postSteps.push_back(p);
+      }
+    }
+  }
+
+  StepPointMC StepPointMCCompactCollection::step(size_t i) const {
+    StepPointMCCompact const& c = _steps[i];
+
+    CLHEP::Hep3Vector postPosition, postMomentum;
+    if(_hasPostStep) {
+      postPosition = GenVector::Hep3Vec(_origin + XYZVectorD(_postSteps[i]._postPosition));
+      postMomentum = GenVector::Hep3Vec(_postSteps[i]._postMomentum);
+    }
+
+    return StepPointMC(c._track,
+                       c._volumeId,
+                       c._totalEnergyDeposit,
+                       c._nonIonizingEnergyDeposit,
+                       c._visibleEnergyDeposit,
+                       c._time,
+                       c._proper,
+                       GenVector::Hep3Vec(_origin + XYZVectorD(c._position)),
+                       postPosition,
+                       GenVector::Hep3Vec(c._momentum),
+                       postMomentum,
+                       c._stepLength,
+                       c._endProcessCode);
+  }
+
+  void StepPointMCCompactCollection::expand(StepPointMCCollection& out) const {
+    out.reserve(out.size() + _steps.size());
+    for(size_t i=0; i<_steps.size(); ++i) {
+      out.push_back(step(i));
+    }
+  }
+
+} // namespace mu2e
@@ -0,0 +1,241 @@
+//
+// Benchmark of MCTrajectory::simplify() and the MCTrajectoryCompactCollection on made up
+// trajectories like those of Mu2eG4: electrons of about 100 MeV/c on helices in the DS,
+// low momentum pions and muons curling in the TS, straight cosmic like tracks with a coarse
+// point spacing, and low energy electrons, with points every 15 mm along the helices.
+// For each simplification tolerance it prints the points per trajectory, the bytes per
+// trajectory in the full and in the compact form, estimated from the sizes of the streamed
+// members (before the ROOT compression, without the ROOT headers), the
+// time to mix the collection (the deep copy with a time offset of Mu2eProductMixer, and the
+// restore with the time offset from the compact form), and the largest deviations of the
+// original points from the restored trajectories.  It fails if a deviation exceeds the
+// tolerance plus the resolution of the compact form.
+//
+// arguments are
+// NTRAJ: optional, number of trajectories per collection (default 2000)
+// NREP:  optional, number of repetitions (default 20)
+//
+// example:
+// MCTrajectoryCompactBench 10000 10
+//
+#include "Offline/MCDataProducts/inc/MCTrajectoryCollection.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace {
+
+  const double timeOffset = 1234.5; // ns
+  const double energyTolerance = 0.1; // MeV
+
+  // bytes of the streamed members: art::Ptr (product id and key), vector length, points
+  const size_t ptrBytes = 4 + 8;
+  const size_t pointBytes = 5*sizeof(float);
+  const size_t fullBytes = 2*ptrBytes + sizeof(unsigned);     // + points
+  const size_t compactBytes = ptrBytes + pointBytes + 2*sizeof(unsigned); // + deltas
+
+  // A helix along z around (x0,y0,z0) with points every ds of path, losing dedx per mm
+  // and, with probability pjump per point, a larger loss of up to ejump.
+  MCTrajectory makeHelix(std::mt19937& gen, art::Ptr<SimParticle> const& sim, CLHEP::Hep3Vector const& x0,
+                         double mass, double p, double pt, double bfield, double length, double ds,
+                         double dedx, double pjump, double ejump) {
+    std::uniform_real_distribution<double> flat(0., 1.);
+    const double radius = pt/(0.299792458*bfield);
+    const double phi0 = 2.*M_PI*flat(gen);
+    const double sinl = std::sqrt(1. - (pt/p)*(pt/p));
+    MCTrajectory traj(sim);
+    double ekin = std::sqrt(p*p + mass*mass) - mass;
+    double t = 100.*flat(gen);
+    for(double s = 0.; s <= length && ekin > 0.; s += ds) {
+      const double phi = phi0 + s*std::sqrt(1. - sinl*sinl)/radius;
+      CLHEP::Hep3Vector x = x0 + CLHEP::Hep3Vector(radius*std::cos(phi), radius*std::sin(phi), s*sinl);
+      traj.addPoint(MCTrajectoryPoint(x, t, ekin));
+      const double e = ekin + mass;
+      t += ds/(299.792458*std::sqrt(e*e - mass*mass)/e);
+      ekin -= dedx*ds;
+      if(flat(gen) < pjump) ekin -= ejump*flat(gen);
+    }
+    return traj;
+  }
+
+  MCTrajectoryCollection makeTrajectories(std::mt19937& gen, size_t nTraj) {
+    std::uniform_real_distribution<double> flat(0., 1.);
+    const CLHEP::Hep3Vector ds(-3904., 0., 8000.), ts(0., 0., 2500.);
+    const art::ProductID pid(1, 1);
+
+    MCTrajectoryCollection trajectories;
+    for(size_t i=0; i<nTraj; ++i) {
+      art::Ptr<SimParticle> sim(pid, i, nullptr);
+      const double type = flat(gen);
+      if(type < 0.4) { // electron of about 100 MeV/c in the DS, crossing the tracker
+        const double p = 90. + 15.*flat(gen);
+        trajectories[sim] = makeHelix(gen, sim, ds, 0.511, p, p*(0.55 + 0.3*flat(gen)), 1.0, 5000., 15., 1.e-6, 0.02, 1.);
+      }
+      else if(type < 0.7) { // pion or muon curling in the TS
+        const double p = 20. + 40.*flat(gen);
+        trajectories[sim] = makeHelix(gen, sim, ts, 105.66, p, p*(0.2 + 0.4*flat(gen)), 2.5, 4000., 15., 1.e-6, 0., 0.);
+      }
+      else if(type < 0.9) { // cosmic like, straight through regions with the default spacing
+        trajectories[sim] = makeHelix(gen, sim, ds, 105.66, 3000., 3000.*flat(gen), 1.e-6, 10000., 500., 2.e-3, 0., 0.);
+      }
+      else { // low energy electron
+        const double p = 2. + 8.*flat(gen);
+        trajectories[sim] = makeHelix(gen, sim, ds, 0.511, p, p*(0.3 + 0.6*flat(gen)), 1.0, 1000., 15., 1.e-4, 0.05, 0.5);
+      }
+    }
+    return trajectories;
+  }
+
+  // the deep copy with a time offset of Mu2eProductMixer::mixMCTrajectories
+  void mixFull(MCTrajectoryCollection const& in, MCTrajectoryCollection& out) {
+    for(const auto & orig : in) {
+      std::vector<MCTrajectoryPoint> newpoints;
+      newpoints.reserve(orig.second.points().size());
+      for(auto const& mcpt : orig.second.points())
+        newpoints.emplace_back(mcpt.pos(),mcpt.t()+timeOffset,mcpt.kineticEnergy());
+      out.insert(std::make_pair(orig.first, MCTrajectory(orig.second.sim(), newpoints)));
+    }
+  }
+
+  // Mu2eProductMixer::mixMCTrajectoryCompacts
+  void mixCompact(MCTrajectoryCompactCollection const& in, MCTrajectoryCollection& out) {
+    for(size_t i = 0; i < in.size(); ++i) {
+      auto const& sim = in.trajectories()[i].sim();
+      auto res = out.insert(std::make_pair(sim, MCTrajectory(sim)));
+      res.first->second.points() = in.points(i, timeOffset);
+    }
+  }
+
+  double segmentDistance(CLHEP::Hep3Vector const& p, CLHEP::Hep3Vector const& a, CLHEP::Hep3Vector const& b) {
+    const CLHEP::Hep3Vector ab = b - a;
+    const double len2 = ab.mag2();
+    double f = len2 > 0. ? (p - a).dot(ab)/len2 : 0.;
+    f = std::min(1., std::max(0., f));
+    return (p - (a + f*ab)).mag();
+  }
+
+  struct Deviation {
+    double position = 0, time = 0, energy = 0;
+  };
+
+  // Deviations of the original points from the restored trajectory.  The kept points are
+  // found in the original ones by value; the others are compared to the restored segment
+  // around them, and their energy to the interpolation along the original path.
+  Deviation compare(MCTrajectory const& orig, MCTrajectory const& kept, std::vector<MCTrajectoryPoint> const& restored) {
+    Deviation d;
+    auto const& op = orig.points();
+    auto const& kp = kept.points();
+    std::vector<double> path(op.size(), 0.);
+    for(size_t i=1; i<op.size(); ++i) path[i] = path[i-1] + (op[i].pos() - op[i-1].pos()).mag();
+
+    std::vector<size_t> index; // of the kept points in the original ones
+    for(size_t i=0; i<op.size() && index.size()<kp.size(); ++i) {
+      auto const& a = op[i];
+      auto const& b = kp[index.size()];
+      if(a.x() == b.x() && a.y() == b.y() && a.z() == b.z() && a.t() == b.t() && a.kineticEnergy() == b.kineticEnergy()) {
+        index.push_back(i);
+      }
+    }
+    if(index.size() != kp.size() || restored.size() != kp.size() || index.front() != 0 || index.back()+1 != op.size()) {
+      d.position = d.time = d.energy = 1.e30;
+      return d;
+    }
+
+    for(size_t j=0; j<index.size(); ++j) {
+      d.time   = std::max(d.time, std::abs(restored[j].t() - (op[index[j]].t() + timeOffset)));
+      d.energy = std::max(d.energy, std::abs(double(restored[j].kineticEnergy()) - op[index[j]].kineticEnergy()));
+      d.position = std::max(d.position, (restored[j].pos() - op[index[j]].pos()).mag());
+    }
+    for(size_t j=0; j+1<index.size(); ++j) {
+      const size_t a = index[j], b = index[j+1];
+      const double ea = restored[j].kineticEnergy(), eb = restored[j+1].kineticEnergy();
+      for(size_t i=a+1; i<b; ++i) {
+        d.position = std::max(d.position, segmentDistance(op[i].pos(), restored[j].pos(), restored[j+1].pos()));
+        const double f = (path[i] - path[a])/(path[b] - path[a]);
+        d.energy = std::max(d.energy, std::abs(op[i].kineticEnergy() - (ea + f*(eb - ea))));
+      }
+    }
+    return d;
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t nTraj = argc > 1 ? std::stoul(argv[1]) : 2000;
+  int    nRep  = argc > 2 ? std::stoi(argv[2]) : 20;
+
+  std::mt19937 gen(97531);
+  const MCTrajectoryCollection trajectories = makeTrajectories(gen, nTraj);
+
+  std::cout<<"MCTrajectoryCompactBench "<<nTraj<<" trajectories, "<<nRep<<" repetitions, energy tolerance "
+           <<energyTolerance<<" MeV"<<std::endl;
+  std::cout<<std::setw(10)<<"tol [mm]"<<std::setw(10)<<"points"<<std::setw(12)<<"est. full"<<std::setw(14)<<"est. compact"
+           <<std::setw(12)<<"mix full"<<std::setw(14)<<"mix compact"<<std::setw(12)<<"max dpos"<<std::setw(12)<<"max dt"
+           <<std::setw(12)<<"max dE"<<std::endl;
+  std::cout<<std::setw(10)<<""<<std::setw(10)<<"/traj"<<std::setw(12)<<"bytes/traj"<<std::setw(14)<<"bytes/traj"
+           <<std::setw(12)<<"[ms]"<<std::setw(14)<<"[ms]"<<std::setw(12)<<"[mm]"<<std::setw(12)<<"[ns]"
+           <<std::setw(12)<<"[MeV]"<<std::endl;
+
+  int nBad(0);
+  for(double tolerance : {0., 0.2, 0.5, 1., 2., 5.}) {
+    // Mu2eG4 simplifies each trajectory when it is complete
+    MCTrajectoryCollection simplified(trajectories);
+    size_t nPoints(0);
+    for(auto& entry : simplified) {
+      entry.second.simplify(tolerance, energyTolerance);
+      nPoints += entry.second.size();
+    }
+    const MCTrajectoryCompactCollection compact(simplified);
+    size_t nFullBytes(0), nCompactBytes(0);
+    for(auto const& entry : simplified) nFullBytes += fullBytes + entry.second.size()*pointBytes;
+    for(auto const& c : compact.trajectories()) nCompactBytes += compactBytes + c.nBytes();
+
+    double tFull(0), tCompact(0);
+    for(int iRep=0; iRep<nRep; ++iRep) {
+      MCTrajectoryCollection outFull, outCompact;
+      auto t0 = std::chrono::high_resolution_clock::now();
+      mixFull(simplified, outFull);
+      auto t1 = std::chrono::high_resolution_clock::now();
+      mixCompact(compact, outCompact);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      tFull    += std::chrono::duration<double>(t1-t0).count();
+      tCompact += std::chrono::duration<double>(t2-t1).count();
+    }
+
+    Deviation dmax;
+    size_t i(0);
+    for(auto const& entry : trajectories) {
+      auto const& kept = simplified.at(entry.first);
+      const Deviation d = compare(entry.second, kept, compact.points(i++, timeOffset));
+      dmax.position = std::max(dmax.position, d.position);
+      dmax.time     = std::max(dmax.time, d.time);
+      dmax.energy   = std::max(dmax.energy, d.energy);
+    }
+    // the float precision of the times is about 1e-4 ns
+    if(dmax.position > tolerance + compact.positionStep()
+       || dmax.time > compact.timeStep() + 1.e-3
+       || dmax.energy > energyTolerance + compact.energyStep()) ++nBad;
+
+    std::cout<<std::setw(10)<<tolerance<<std::fixed<<std::setprecision(1)
+             <<std::setw(10)<<double(nPoints)/nTraj
+             <<std::setw(12)<<double(nFullBytes)/nTraj<<std::setw(14)<<double(nCompactBytes)/nTraj
+             <<std::setprecision(3)<<std::setw(12)<<1.e3*tFull/nRep<<std::setw(14)<<1.e3*tCompact/nRep
+             <<std::setprecision(4)<<std::setw(12)<<dmax.position<<std::setw(12)<<dmax.time<<std::setw(12)<<dmax.energy
+             <<std::defaultfloat<<std::endl;
+  }
+
+  if(nBad > 0) {
+    std::cout<<"MCTrajectoryCompactBench FAILED "<<nBad<<" tolerances with deviations above the limits"<<std::endl;
+    return 1;
+  }
+  std::cout<<"MCTrajectoryCompactBench passed"<<std::endl;
+  return 0;
+}
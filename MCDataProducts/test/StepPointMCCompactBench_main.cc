@@ -0,0 +1,144 @@
+//
+// Test of the StepPointMCCompactCollection on made up virtual detector like steps,
+// spread over a few meters around a point far from the Mu2e origin.
+// For the full and the compact forms (with and without the post-step fields) it prints
+// an estimate of the bytes per step, the time to make the compact collection, the time
+// to restore the StepPointMCs (the read path of Mu2eProductMixer and ExpandStepPointMCs),
+// and the largest differences of the restored positions, momenta, and times.  It fails
+// if a position differs by more than the float precision over the extent of the steps,
+// a momentum by more than the float precision, or a time at all.
+//
+// The bytes per step are the sum of the sizes of the streamed data members, not a size
+// measured from a ROOT file: they leave out the ROOT streaming overhead and compression.
+//
+// arguments are
+// NSTEP: optional, number of steps per collection (default 100000)
+// NREP:  optional, number of repetitions (default 20)
+//
+// example:
+// StepPointMCCompactBench 500000 10
+//
+#include "Offline/MCDataProducts/inc/StepPointMC.hh"
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace {
+
+  // estimated bytes of the streamed members: art::Ptr (product id and key), volume id,
+  // energy deposits, vectors, times, step length, process code
+  const size_t ptrBytes = 4 + 8;
+  const size_t fullBytes = ptrBytes + sizeof(unsigned long) + 3*sizeof(float) + 4*3*sizeof(double)
+                         + 2*sizeof(double) + sizeof(float) + sizeof(int);
+  const size_t compactBytes = ptrBytes + sizeof(unsigned) + 3*sizeof(float) + 2*3*sizeof(float)
+                            + sizeof(double) + 2*sizeof(float) + sizeof(int);
+  const size_t postBytes = 2*3*sizeof(float);
+
+  const double halfExtent = 2000.; // mm
+
+  StepPointMCCollection makeSteps(std::mt19937& gen, size_t nStep) {
+    std::uniform_real_distribution<double> pos(-halfExtent, halfExtent), mom(-100., 100.), time(0., 1.e5), flat(0., 1.);
+    const CLHEP::Hep3Vector center(-3904., 0., 10200.);
+
+    StepPointMCCollection steps;
+    steps.reserve(nStep);
+    for(size_t i=0; i<nStep; ++i) {
+      CLHEP::Hep3Vector position = center + CLHEP::Hep3Vector(pos(gen), pos(gen), pos(gen));
+      CLHEP::Hep3Vector momentum(mom(gen), mom(gen), mom(gen));
+      double stepLength = flat(gen);
+      CLHEP::Hep3Vector postPosition = position + stepLength*momentum.unit();
+      CLHEP::Hep3Vector postMomentum = (1. - 1.e-3*flat(gen))*momentum;
+      double t = time(gen);
+      steps.emplace_back(art::Ptr<SimParticle>(), 1 + i%120, 1.e-3*flat(gen), 0., 0., t, 1.e-2*t,
+                         position, postPosition, momentum, postMomentum, stepLength, ProcessCode(ProcessCode::Transportation));
+    }
+    return steps;
+  }
+
+  struct Deviation {
+    double position = 0, momentum = 0, time = 0;
+  };
+
+  Deviation compare(const StepPointMCCollection& a, const StepPointMCCollection& b, bool post) {
+    Deviation d;
+    for(size_t i=0; i<a.size(); ++i) {
+      d.position = std::max(d.position, (a[i].position() - b[i].position()).mag());
+      d.momentum = std::max(d.momentum, (a[i].momentum() - b[i].momentum()).mag()/a[i].momentum().mag());
+      d.time     = std::max(d.time, std::abs(a[i].time() - b[i].time()));
+      if(post) {
+        d.position = std::max(d.position, (a[i].postPosition() - b[i].postPosition()).mag());
+        d.momentum = std::max(d.momentum, (a[i].postMomentum() - b[i].postMomentum()).mag()/a[i].postMomentum().mag());
+      }
+    }
+    return d;
+  }
+}
+
+
+int main(int argc, char** argv) {
+  size_t nStep = argc > 1 ? std::stoul(argv[1]) : 100000;
+  int    nRep  = argc > 2 ? std::stoi(argv[2]) : 20;
+
+  std::mt19937 gen(2468);
+  const StepPointMCCollection steps = makeSteps(gen, nStep);
+
+  std::cout<<"StepPointMCCompactBench "<<nStep<<" steps, "<<nRep<<" repetitions"<<std::endl;
+  std::cout<<std::setw(14)<<"form"<<std::setw(12)<<"est. bytes"<<std::setw(14)<<"write Mstep/s"<<std::setw(14)<<"read Mstep/s"
+           <<std::setw(14)<<"max dpos [mm]"<<std::setw(12)<<"max dp/p"<<std::setw(14)<<"max dt [ns]"<<std::endl;
+
+  // the full form: copying the collection stands in for the read
+  {
+    double tRead(0);
+    for(int iRep=0; iRep<nRep; ++iRep) {
+      auto t0 = std::chrono::high_resolution_clock::now();
+      StepPointMCCollection out(steps);
+      auto t1 = std::chrono::high_resolution_clock::now();
+      tRead += std::chrono::duration<double>(t1-t0).count();
+    }
+    std::cout<<std::setw(14)<<"full"<<std::setw(12)<<fullBytes<<std::setw(14)<<"-"
+             <<std::setw(14)<<std::setprecision(4)<<1.e-6*nStep*nRep/tRead<<std::endl;
+  }
+
+  // positions are stored in single precision relative to the centre of the steps, momenta in single precision,
+  // times unchanged
+  const double positionLimit = 2.*halfExtent*FLT_EPSILON, momentumLimit = FLT_EPSILON;
+  int nBad = 0;
+  for(bool keepPostStep : {true, false}) {
+    double tWrite(0), tRead(0);
+    Deviation d;
+    for(int iRep=0; iRep<nRep; ++iRep) {
+      auto t0 = std::chrono::high_resolution_clock::now();
+      StepPointMCCompactCollection compact(steps, keepPostStep);
+      auto t1 = std::chrono::high_resolution_clock::now();
+      StepPointMCCollection out;
+      compact.expand(out);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      tWrite += std::chrono::duration<double>(t1-t0).count();
+      tRead  += std::chrono::duration<double>(t2-t1).count();
+      if(iRep==0) d = compare(steps, out, keepPostStep);
+    }
+    std::cout<<std::setw(14)<<(keepPostStep ? "compact" : "compact-nopost")
+             <<std::setw(12)<<compactBytes + (keepPostStep ? postBytes : 0)
+             <<std::setw(14)<<std::setprecision(4)<<1.e-6*nStep*nRep/tWrite
+             <<std::setw(14)<<1.e-6*nStep*nRep/tRead
+             <<std::setw(14)<<d.position<<std::setw(12)<<d.momentum<<std::setw(14)<<d.time<<std::endl;
+    if(d.position > positionLimit || d.momentum > momentumLimit || d.time != 0.) ++nBad;
+  }
+
+  if(nBad > 0) {
+    std::cout<<"StepPointMCCompactBench FAILED "<<nBad<<" forms with differences above the limits"<<std::endl;
+    return 1;
+  }
+  std::cout<<"StepPointMCCompactBench passed"<<std::endl;
+  return 0;
+}
@@ -29,6 +29,10 @@
 // which would be collected by the stacking cut and re-used by the
 // next stage despite of the last steb being re-simulated as well.
 //
+// createMu2eG4Cuts() compiles the whole configuration into a flat
+// Mu2eG4CutProgram, so the stepping and stacking actions make one
+// virtual call per step or track, whatever the number of cuts.
+//
 // Andrei Gaponenko, 2015
 
 #ifndef Mu2eG4_IMu2eG4Cut_hh
@@ -91,6 +91,16 @@ namespace mu2e {
       fhicl::Sequence<std::string> sensitiveVolumes {Name("sensitiveVolumes"), {}};
       fhicl::Sequence<std::string> preSimulatedHits {Name("preSimulatedHits"), {}};
 
+      fhicl::Sequence<std::string> compactSteps {Name("compactSteps"),
+          Comment("Instance names of the step collections to be written as StepPointMCCompactCollection.\n"
+                  "Jobs reading them, except through Mu2eProductMixer, need ExpandStepPointMCs in the path."),
+          {}
+      };
+      fhicl::Atom<bool> compactStepsKeepPostStep {Name("compactStepsKeepPostStep"),
+          Comment("Keep the post-step position and momentum in the compact step collections."),
+          true
+      };
+
       // FIXME: why is this necessary?
       fhicl::Sequence<std::string> inputs {Name("inputs"), {}};
       fhicl::Atom<double> cutMomentumMin {Name("cutMomentumMin"), 0.};
@@ -179,6 +189,29 @@ namespace mu2e {
       fhicl::OptionalDelegatedParameter perVolumeMinDistance {Name("perVolumeMinDistance"),
           Comment("A table that maps names to min distance between saved trajectory points.")
           };
+
+      fhicl::Atom<double> simplifyTolerance {Name("simplifyTolerance"),
+          Comment("If positive, drop the trajectory points that are within this distance (mm)\n"
+                  "of the polyline through the kept points, see MCTrajectory::simplify()."),
+          0.
+          };
+      fhicl::Atom<double> simplifyEnergyTolerance {Name("simplifyEnergyTolerance"),
+          Comment("The largest kinetic energy change (MeV) of a dropped point relative to the\n"
+                  "interpolation between the kept points.  Not checked if not positive."),
+          0.1
+          };
+
+      fhicl::Atom<bool> compact {Name("compact"),
+          Comment("Write the trajectories as an MCTrajectoryCompactCollection.  This saves space only:\n"
+                  "readers other than Mu2eProductMixer need CommonMC ExpandMCTrajectories, and mixing\n"
+                  "the compact form is slower than mixing the full one."),
+          false
+          };
+      fhicl::Sequence<double,3> compactResolution {Name("compactResolution"),
+          Comment("Resolution of the position (mm), time (ns) and kinetic energy (MeV)\n"
+                  "of the points in the compact trajectories."),
+          {0.05, 0.001, 0.001}
+          };
     };
 
     struct EventLevelVolInfos {
@@ -0,0 +1,128 @@
+// The Mu2eG4 cuts configuration compiled into a flat form, evaluated
+// on every G4 step and new track without virtual calls.
+//
+// The fcl syntax is the one documented in IMu2eG4Cut.hh and handled
+// by createMu2eG4Cuts(): "union" and "intersection" of the cuts in
+// "pars", "plane", "observerPlane", "inVolume", "pdgId", ... each
+// with an optional "write" collection.  The tree is stored in
+// pre-order in a single vector of nodes, the children of a node
+// following it, with the index past its subtree used to skip to the
+// next sibling.  The node parameters are kept in flat tables: the
+// plane normals and offsets, the energy and time cut values, and the
+// sorted PDG ids of all the nodes.  The volumes of all the inVolume
+// and notInVolume nodes are compiled, once the geometry is built,
+// into one table sorted by volume address, holding for each volume a
+// row of bits, one per volume node.  Successive steps are mostly in
+// the same volume, so the row of the last volume is cached.
+//
+// The quantities the cuts use are read from the G4Step or G4Track
+// once per call into a Mu2eG4CutInput, and only those needed by the
+// configured cuts.  When the cut of a node with a "write" collection
+// is satisfied in the stepping action, the index of its output is
+// reported to the caller, which writes the StepPointMC.
+
+#ifndef Mu2eG4_Mu2eG4CutProgram_hh
+#define Mu2eG4_Mu2eG4CutProgram_hh
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CLHEP/Vector/ThreeVector.h"
+#include "canvas/Utilities/InputTag.h"
+
+class G4VPhysicalVolume;
+
+namespace fhicl { class ParameterSet; }
+
+namespace mu2e {
+
+  class ParticleDataList;
+
+  struct Mu2eG4CutInput {
+    // the quantities a cut program may need, see Mu2eG4CutProgram::needs()
+    enum Need { volume=1, pdgId=2, kineticEnergy=4, globalTime=8, parentId=16, position=32, prePosition=64 };
+
+    const G4VPhysicalVolume* vol = nullptr; // not defined in the stacking action
+    int pdg = 0;
+    int parent = 0;
+    double ekin = 0.;
+    double time = 0.;
+    CLHEP::Hep3Vector pos;    // post-step point, or track position in the stacking action
+    CLHEP::Hep3Vector prePos; // pre-step point, stepping action only
+  };
+
+  class Mu2eG4CutProgram {
+  public:
+
+    enum Type { unionCut, intersectionCut, plane, observerPlane, volumeCut, pdgIdCut,
+                neutral, charged, kineticEnergy, globalTime, primaryOnly, constant };
+
+    struct Node {
+      Type     type = constant;
+      unsigned end = 0;    // one past the last node of the subtree
+      int      output = -1;// index of the "write" collection, or -1
+      unsigned par = 0;    // index of the first parameter in the table of the type
+      unsigned npar = 0;   // number of parameters: PDG ids
+      bool     flag = false; // negated volume and PDG id cuts, doNotCut, constant value
+    };
+
+    struct Output {
+      std::string   name;
+      art::InputTag preSimulatedHits;
+    };
+
+    explicit Mu2eG4CutProgram(const fhicl::ParameterSet& pset);
+
+    // Resolve the volume names of the cuts, once the geometry is built.
+    void compileVolumes(const std::function<const G4VPhysicalVolume*(const std::string&)>& findVolume);
+    bool volumesCompiled() const { return volumesCompiled_; }
+
+    // OR of the Mu2eG4CutInput::Need of the cuts
+    unsigned needs() const { return needs_; }
+
+    // The outputs of the satisfied nodes with a "write" collection are appended to fired
+    bool steppingActionCut(const Mu2eG4CutInput& in, std::vector<unsigned>& fired);
+    bool stackingActionCut(const Mu2eG4CutInput& in);
+
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::vector<Output>& outputs() const { return outputs_; }
+
+  private:
+    struct PlanePars {
+      double normal[3];
+      double offset;
+      bool behind(const CLHEP::Hep3Vector& p) const { return p.x()*normal[0] + p.y()*normal[1] + p.z()*normal[2] >= offset; }
+    };
+
+    void parse(const fhicl::ParameterSet& pset);
+    bool eval(unsigned inode, const Mu2eG4CutInput& in, std::vector<unsigned>* fired);
+    const uint64_t* volumeRow(const G4VPhysicalVolume* vol);
+    bool chargeCut(int pdgId, bool acceptCharged);
+
+    std::vector<Node>      nodes_;
+    std::vector<Output>    outputs_;
+    std::vector<PlanePars> planes_;
+    std::vector<double>    values_;  // kineticEnergy and globalTime cuts
+    std::vector<int>       pdgIds_;  // sorted within each node
+    unsigned               needs_ = 0;
+
+    // volume names of each volume node, and the compiled table
+    std::vector<std::vector<std::string> > volumeNames_;
+    bool                   volumesCompiled_ = false;
+    unsigned               nwords_ = 0; // words per row
+    std::vector<std::pair<const G4VPhysicalVolume*, unsigned> > volumeRows_; // sorted by address
+    std::vector<uint64_t>  volumeBits_; // row 0 is for the volumes not on any list
+    const G4VPhysicalVolume* lastVolume_ = nullptr;
+    const uint64_t*        lastRow_ = nullptr;
+
+    // charge of the particles seen so far, sorted by PDG id
+    const ParticleDataList* pdt_ = nullptr; // only if there are charge cuts
+    std::vector<std::pair<int,bool> > charged_;
+  };
+
+} // end namespace mu2e
+
+#endif /* Mu2eG4_Mu2eG4CutProgram_hh */
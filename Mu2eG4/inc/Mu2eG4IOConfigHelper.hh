@@ -16,6 +16,9 @@
 #include "Offline/Mu2eG4/inc/Mu2eG4ResourceLimits.hh"
 #include "fhiclcpp/ParameterSet.h"
 
+#include <set>
+#include <string>
+
 namespace art { class Event; }
 namespace art { class ProducesCollector; }
 namespace art { class ConsumesCollector; }
@@ -32,6 +35,9 @@ namespace mu2e {
     bool timeVD_enabled_;
     bool extMonPixelsEnabled_;
 
+    std::set<std::string> compactSteps_;
+    bool compactStepsKeepPostStep_;
+
     Mu2eG4ResourceLimits mu2elimits_;
     fhicl::ParameterSet stackingCutsConf_;
     fhicl::ParameterSet steppingCutsConf_;
@@ -50,6 +56,10 @@ namespace mu2e {
     bool timeVD_enabled() const { return timeVD_enabled_; }
     bool extMonPixelsEnabled() const { return extMonPixelsEnabled_; }
 
+    // Step collections written as StepPointMCCompactCollection
+    bool compactSteps(const std::string& instance) const { return compactSteps_.count(instance) > 0; }
+    bool compactStepsKeepPostStep() const { return compactStepsKeepPostStep_; }
+
     const Mu2eG4ResourceLimits& mu2elimits() const { return mu2elimits_; }
     const fhicl::ParameterSet& stackingCutsConf() const { return stackingCutsConf_; }
     const fhicl::ParameterSet& steppingCutsConf() const { return steppingCutsConf_; }
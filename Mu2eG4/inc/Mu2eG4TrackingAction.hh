@@ -104,6 +104,8 @@ namespace mu2e {
     double _mcTrajectoryMomentumCut;
     double _saveTrajectoryMomentumCut;
     int    _mcTrajectoryMinSteps;
+    double _simplifyTolerance;
+    double _simplifyEnergyTolerance;
     unsigned _nKilledByFieldPropagator;
     unsigned _numKilledTracks;
     double _rangeToIgnore;
@@ -3,6 +3,7 @@
 #ifndef Mu2eG4_Mu2eG4TrajectoryControl_hh
 #define Mu2eG4_Mu2eG4TrajectoryControl_hh
 
+#include <array>
 #include <string>
 #include <map>
 
@@ -23,6 +24,16 @@ namespace mu2e {
     double saveTrajectoryMomentumCut() const { return saveTrajectoryMomentumCut_; }
     const PerVolumeDistanceMap& perVolumeMinDistance() const { return perVolumeMinDistance_; }
 
+    // See MCTrajectory::simplify(), no simplification if simplifyTolerance is not positive
+    double simplifyTolerance() const { return simplifyTolerance_; }
+    double simplifyEnergyTolerance() const { return simplifyEnergyTolerance_; }
+
+    // Write an MCTrajectoryCompactCollection with these resolutions
+    bool compact() const { return compact_; }
+    double compactPositionStep() const { return compactResolution_[0]; }
+    double compactTimeStep() const { return compactResolution_[1]; }
+    double compactEnergyStep() const { return compactResolution_[2]; }
+
   private:
     bool produce_;
     double defaultMinPointDistance_;
@@ -30,6 +41,10 @@ namespace mu2e {
     double mcTrajectoryMomentumCut_;
     double saveTrajectoryMomentumCut_;
     PerVolumeDistanceMap perVolumeMinDistance_;
+    double simplifyTolerance_;
+    double simplifyEnergyTolerance_;
+    bool compact_;
+    std::array<double,3> compactResolution_;
   };
 
 } // end namespace mu2e
@@ -20,6 +20,7 @@
 // From C++ and STL
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -70,6 +71,9 @@ namespace mu2e {
     void instantiateLVSDs(const SimpleConfig& config);
 
     bool extMonPixelsEnabled() const { return extMonPixelsEnabled_; }
+
+    // Instance names of the step collections written as StepPointMCCompactCollection
+    const std::set<std::string>& compactSteps() const { return compactSteps_; }
     ExtMonFNALPixelSD* getExtMonFNALPixelSD() const { return extMonFNALPixelSD_; }
 
     int verbosityLevel() const { return verbosityLevel_; }
@@ -111,6 +115,9 @@ namespace mu2e {
     typedef std::vector<art::InputTag> InputTags;
     InputTags preSimulatedHits_;
 
+    // Collections to be written in the compact form
+    std::set<std::string> compactSteps_;
+
     // Return all of the instances names of the data products to be produced.
     std::vector<std::string> stepInstanceNamesToBeProduced() const;
 
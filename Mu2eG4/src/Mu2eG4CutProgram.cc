@@ -0,0 +1,269 @@
+// The Mu2eG4 cuts configuration compiled into a flat form.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include "Offline/Mu2eG4/inc/Mu2eG4CutProgram.hh"
+#include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
+#include "Offline/GlobalConstantsService/inc/ParticleDataList.hh"
+
+namespace mu2e {
+
+  namespace {
+    typedef std::vector<fhicl::ParameterSet> PSVector;
+
+    struct VolumeLess {
+      bool operator()(const std::pair<const G4VPhysicalVolume*, unsigned>& a, const G4VPhysicalVolume* b) const {
+        return std::less<const G4VPhysicalVolume*>()(a.first, b);
+      }
+    };
+  }
+
+  Mu2eG4CutProgram::Mu2eG4CutProgram(const fhicl::ParameterSet& pset) {
+    parse(pset);
+    nwords_ = (volumeNames_.size() + 63)/64;
+    // until the volumes are compiled no volume is on any list
+    volumeBits_.assign(nwords_, 0);
+  }
+
+  //================================================================
+  void Mu2eG4CutProgram::parse(const fhicl::ParameterSet& pset) {
+    const unsigned inode = nodes_.size();
+    nodes_.emplace_back();
+    Node node;
+
+    if(pset.is_empty()) { // no cuts
+      node.type = constant;
+      node.flag = false;
+      node.end = nodes_.size();
+      nodes_[inode] = node;
+      return;
+    }
+
+    const std::string write = pset.get<std::string>("write", "");
+    if(!write.empty()) {
+      node.output = outputs_.size();
+      outputs_.push_back(Output{write, pset.get<art::InputTag>("preSimulatedHits", art::InputTag())});
+    }
+
+    const std::string cuttype = pset.get<std::string>("type");
+
+    if(cuttype == "union" || cuttype == "intersection") {
+      node.type = (cuttype == "union") ? unionCut : intersectionCut;
+      for(const auto& p: pset.get<PSVector>("pars")) {
+        parse(p);
+      }
+    }
+    else if(cuttype == "plane" || cuttype == "observerPlane") {
+      node.type = (cuttype == "plane") ? plane : observerPlane;
+      std::vector<double> n{pset.get<std::vector<double> >("normal")};
+      if(n.size() != 3) {
+        throw std::runtime_error("SteppingCut::Plane(): normal should be a vector of 3 doubles. Error in pset = "+pset.to_string());
+      }
+      std::vector<double> x0{pset.get<std::vector<double> >("point")};
+      if(x0.size() != 3) {
+        throw cet::exception("CONFIG")<<"SteppingCut::Plane(): point should be a vector of 3 doubles. "
+                                      <<"Error in pset = "<<pset.to_string()<<"\n";
+      }
+      // the cut:
+      //             (x-x0)*normal >= 0
+      // rewrite as
+      //
+      //              x*normal >= x0*normal =: offset
+      PlanePars pp;
+      std::copy(n.begin(), n.end(), pp.normal);
+      pp.offset = std::inner_product(n.begin(), n.end(), x0.begin(), 0.);
+      node.par = planes_.size();
+      planes_.push_back(pp);
+      if(node.type == observerPlane) {
+        node.flag = pset.get<bool>("doNotCut");
+        needs_ |= Mu2eG4CutInput::prePosition;
+      }
+      needs_ |= Mu2eG4CutInput::position;
+    }
+    else if(cuttype == "inVolume" || cuttype == "notInVolume") {
+      node.type = volumeCut;
+      node.flag = (cuttype == "notInVolume");
+      node.par = volumeNames_.size();
+      volumeNames_.push_back(pset.get<std::vector<std::string> >("pars"));
+      needs_ |= Mu2eG4CutInput::volume;
+    }
+    else if(cuttype == "pdgId" || cuttype == "notPdgId") {
+      node.type = pdgIdCut;
+      node.flag = (cuttype == "notPdgId");
+      std::vector<int> ids(pset.get<std::vector<int> >("pars"));
+      std::sort(ids.begin(), ids.end());
+      node.par = pdgIds_.size();
+      node.npar = ids.size();
+      pdgIds_.insert(pdgIds_.end(), ids.begin(), ids.end());
+      needs_ |= Mu2eG4CutInput::pdgId;
+    }
+    else if(cuttype == "isNeutral" || cuttype == "isCharged") {
+      node.type = (cuttype == "isNeutral") ? neutral : charged;
+      if(!pdt_) {
+        GlobalConstantsHandle<ParticleDataList> pdt;
+        pdt_ = &*pdt;
+      }
+      needs_ |= Mu2eG4CutInput::pdgId;
+    }
+    else if(cuttype == "kineticEnergy" || cuttype == "globalTime") {
+      node.type = (cuttype == "kineticEnergy") ? kineticEnergy : globalTime;
+      node.par = values_.size();
+      values_.push_back(pset.get<double>("cut"));
+      needs_ |= (node.type == kineticEnergy) ? Mu2eG4CutInput::kineticEnergy : Mu2eG4CutInput::globalTime;
+    }
+    else if(cuttype == "primary") {
+      node.type = primaryOnly;
+      needs_ |= Mu2eG4CutInput::parentId;
+    }
+    else if(cuttype == "constant") {
+      node.type = constant;
+      node.flag = pset.get<bool>("value");
+    }
+    else {
+      throw cet::exception("CONFIG")<< "mu2e::createMu2eG4Cuts(): can not parse pset = "<<pset.to_string()<<"\n";
+    }
+
+    node.end = nodes_.size();
+    nodes_[inode] = node;
+  }
+
+  //================================================================
+  void Mu2eG4CutProgram::compileVolumes(const std::function<const G4VPhysicalVolume*(const std::string&)>& findVolume) {
+    std::vector<std::pair<const G4VPhysicalVolume*, unsigned> > entries; // (volume, node bit)
+    for(unsigned ibit=0; ibit<volumeNames_.size(); ++ibit) {
+      for(const auto& name: volumeNames_[ibit]) {
+        entries.emplace_back(findVolume(name), ibit);
+      }
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return std::less<const G4VPhysicalVolume*>()(a.first, b.first) || (a.first == b.first && a.second < b.second);
+      });
+
+    volumeRows_.clear();
+    volumeBits_.assign(nwords_, 0);
+    for(const auto& e: entries) {
+      if(volumeRows_.empty() || volumeRows_.back().first != e.first) {
+        volumeRows_.emplace_back(e.first, volumeBits_.size()/nwords_);
+        volumeBits_.resize(volumeBits_.size() + nwords_, 0);
+      }
+      volumeBits_[volumeRows_.back().second*nwords_ + e.second/64] |= uint64_t(1) << (e.second%64);
+    }
+
+    lastVolume_ = nullptr;
+    lastRow_ = nullptr;
+    volumesCompiled_ = true;
+  }
+
+  const uint64_t* Mu2eG4CutProgram::volumeRow(const G4VPhysicalVolume* vol) {
+    if(vol != lastVolume_) {
+      auto it = std::lower_bound(volumeRows_.begin(), volumeRows_.end(), vol, VolumeLess());
+      const unsigned row = (it != volumeRows_.end() && it->first == vol) ? it->second : 0;
+      lastRow_ = volumeBits_.data() + row*nwords_;
+      lastVolume_ = vol;
+    }
+    return lastRow_;
+  }
+
+  bool Mu2eG4CutProgram::chargeCut(int pdgId, bool acceptCharged) {
+    auto it = std::lower_bound(charged_.begin(), charged_.end(), std::make_pair(pdgId, false));
+    if(it == charged_.end() || it->first != pdgId) {
+      const double charge = pdt_->particle(pdgId).charge();
+      it = charged_.insert(it, std::make_pair(pdgId, std::abs(charge) > 0.1));
+    }
+    return acceptCharged ? it->second : !it->second;
+  }
+
+  //================================================================
+  // fired is null in the stacking action
+  bool Mu2eG4CutProgram::eval(unsigned inode, const Mu2eG4CutInput& in, std::vector<unsigned>* fired) {
+    const Node& node = nodes_[inode];
+    bool result = false;
+
+    switch(node.type) {
+    case unionCut:
+      for(unsigned i=inode+1; i<node.end; i=nodes_[i].end) {
+        if(eval(i, in, fired)) {
+          result = true;
+          break;
+        }
+      }
+      break;
+
+    case intersectionCut:
+      result = true;
+      for(unsigned i=inode+1; i<node.end; i=nodes_[i].end) {
+        if(!eval(i, in, fired)) {
+          result = false;
+          break;
+        }
+      }
+      break;
+
+    case plane:
+      result = planes_[node.par].behind(in.pos);
+      break;
+
+    case observerPlane:
+      // triggers on steps crossing the plane, never in the stacking action
+      if(!fired) return false;
+      result = planes_[node.par].behind(in.pos) && !planes_[node.par].behind(in.prePos);
+      if(result && node.output >= 0) fired->push_back(node.output);
+      return node.flag ? false : result;
+
+    case volumeCut:
+      // Volume is not defined when we are called from the stacking action.
+      // This protection is important for the negated case.
+      if(in.vol) {
+        result = (volumeRow(in.vol)[node.par/64] >> (node.par%64)) & 1;
+        if(node.flag) result = !result;
+      }
+      break;
+
+    case pdgIdCut:
+      result = std::binary_search(pdgIds_.begin() + node.par, pdgIds_.begin() + node.par + node.npar, in.pdg);
+      if(node.flag) result = !result;
+      break;
+
+    case neutral:
+    case charged:
+      result = chargeCut(in.pdg, node.type == charged);
+      break;
+
+    case kineticEnergy:
+      result = in.ekin < values_[node.par];
+      break;
+
+    case globalTime:
+      result = in.time > values_[node.par];
+      break;
+
+    case primaryOnly:
+      result = (in.parent != 0);
+      break;
+
+    case constant:
+      // writes every step
+      if(fired && node.output >= 0) fired->push_back(node.output);
+      return node.flag;
+    }
+
+    if(result && fired && node.output >= 0) fired->push_back(node.output);
+    return result;
+  }
+
+  bool Mu2eG4CutProgram::steppingActionCut(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) {
+    return eval(0, in, &fired);
+  }
+
+  bool Mu2eG4CutProgram::stackingActionCut(const Mu2eG4CutInput& in) {
+    return eval(0, in, nullptr);
+  }
+
+} // end namespace mu2e
@@ -13,6 +13,7 @@
 #include "Offline/MCDataProducts/inc/StepPointMC.hh"
 #include "Offline/MCDataProducts/inc/StageParticle.hh"
 #include "Offline/MCDataProducts/inc/MCTrajectoryCollection.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
 #include "Offline/MCDataProducts/inc/PhysicalVolumeInfoMultiCollection.hh"
 
 #include "art/Framework/Core/ProducesCollector.h"
@@ -29,6 +30,7 @@ namespace mu2e {
     , trajectoryControl_(conf.TrajectoryControl())
     , timeVD_enabled_(conf.SDConfig().TimeVD().enabled())
     , extMonPixelsEnabled_{false}
+    , compactStepsKeepPostStep_{conf.SDConfig().compactStepsKeepPostStep()}
     , mu2elimits_{conf.ResourceLimits()}
     , stackingCutsConf_{conf.Mu2eG4StackingOnlyCut.get<fhicl::ParameterSet>()}
     , steppingCutsConf_{conf.Mu2eG4SteppingOnlyCut.get<fhicl::ParameterSet>()}
@@ -37,6 +39,7 @@ namespace mu2e {
     // Use temporary local objects to parse config and declare i/o below
     SensitiveDetectorHelper sd(conf.SDConfig());
     extMonPixelsEnabled_ = sd.extMonPixelsEnabled();
+    compactSteps_ = sd.compactSteps();
 
     switch(inputs_.primaryType().id()) {
     default: throw cet::exception("CONFIG")
@@ -92,7 +95,12 @@ namespace mu2e {
     }
 
     if(trajectoryControl_.produce()) {
-      pc.produces<MCTrajectoryCollection>();
+      if(trajectoryControl_.compact()) {
+        pc.produces<MCTrajectoryCompactCollection>();
+      }
+      else {
+        pc.produces<MCTrajectoryCollection>();
+      }
     }
 
     // Use temporary local objects to call the declare methods
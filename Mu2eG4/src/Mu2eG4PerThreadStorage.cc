@@ -8,7 +8,9 @@
 #include "Offline/Mu2eG4/inc/Mu2eG4PerThreadStorage.hh"
 #include "Offline/Mu2eG4/inc/SimParticleHelper.hh"
 #include "Offline/Mu2eG4/inc/SimParticlePrimaryHelper.hh"
+#include "Offline/MCDataProducts/inc/MCTrajectoryCompact.hh"
 #include "Offline/MCDataProducts/inc/StepInstanceName.hh"
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
 
 namespace mu2e {
 
@@ -64,7 +66,12 @@ namespace mu2e {
                                                    simProductGetter);
       }
 
-      artEvent->put(std::move(i->second), i->first);
+      if(ioconf.compactSteps(i->first)) {
+        artEvent->put(std::make_unique<StepPointMCCompactCollection>(*i->second, ioconf.compactStepsKeepPostStep()), i->first);
+      }
+      else {
+        artEvent->put(std::move(i->second), i->first);
+      }
     }
   }
 
@@ -90,7 +97,16 @@ namespace mu2e {
       }
 
       if(ioconf.produceMCTrajectories()) {
-        artEvent->put(std::move(mcTrajectories));
+        const auto& tc = ioconf.trajectoryControl();
+        if(tc.compact()) {
+          artEvent->put(std::make_unique<MCTrajectoryCompactCollection>(*mcTrajectories,
+                                                                        tc.compactPositionStep(),
+                                                                        tc.compactTimeStep(),
+                                                                        tc.compactEnergyStep()));
+        }
+        else {
+          artEvent->put(std::move(mcTrajectories));
+        }
       }
 
       if(ioconf.multiStage()) {
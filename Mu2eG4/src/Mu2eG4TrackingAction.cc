@@ -81,6 +81,8 @@ namespace mu2e {
     _mcTrajectoryMomentumCut(pts->ioconf.trajectoryControl().mcTrajectoryMomentumCut()),
     _saveTrajectoryMomentumCut(pts->ioconf.trajectoryControl().saveTrajectoryMomentumCut()),
     _mcTrajectoryMinSteps(pts->ioconf.trajectoryControl().mcTrajectoryMinSteps()),
+    _simplifyTolerance(pts->ioconf.trajectoryControl().simplifyTolerance()),
+    _simplifyEnergyTolerance(pts->ioconf.trajectoryControl().simplifyEnergyTolerance()),
     _nKilledByFieldPropagator(0),
     _numKilledTracks(0),
     _rangeToIgnore(conf.physics().rangeToIgnore()),
@@ -830,6 +832,9 @@ namespace mu2e {
     // Add the end point of the last step.
     traj.points().emplace_back( trk->GetPosition()-_mu2eOrigin, trk->GetGlobalTime(), trk->GetKineticEnergy() );
 
+    // Drop the points that the others describe to within the tolerances.
+    traj.simplify( _simplifyTolerance, _simplifyEnergyTolerance );
+
   }//swapTrajectory
 
 
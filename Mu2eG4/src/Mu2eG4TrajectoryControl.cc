@@ -9,6 +9,10 @@ namespace mu2e {
     , mcTrajectoryMinSteps_{std::numeric_limits<unsigned>::max() }
     , mcTrajectoryMomentumCut_{std::numeric_limits<double>::max() }
     , saveTrajectoryMomentumCut_{std::numeric_limits<double>::max() }
+    , simplifyTolerance_(tc.simplifyTolerance())
+    , simplifyEnergyTolerance_(tc.simplifyEnergyTolerance())
+    , compact_(tc.compact())
+    , compactResolution_(tc.compactResolution())
   {
     if(produce_) {
 
@@ -36,6 +40,14 @@ namespace mu2e {
           perVolumeMinDistance_[k] = volumeCutsPS.get<double>(k);
         }
       }
+
+      if(compact_) {
+        for(const auto r: compactResolution_) {
+          if(!(r > 0.)) {
+            throw cet::exception("CONFIG")<< "Error: compactResolution must be positive\n";
+          }
+        }
+      }
     }
   }
 }
@@ -21,6 +21,7 @@
 // From Mu2e
 #include "Offline/Mu2eG4/inc/SensitiveDetectorHelper.hh"
 #include "Offline/MCDataProducts/inc/StepPointMC.hh"
+#include "Offline/MCDataProducts/inc/StepPointMCCompact.hh"
 #include "Offline/MCDataProducts/inc/ExtMonFNALSimHit.hh"
 #include "Offline/Mu2eG4/inc/SensitiveDetectorName.hh"
 #include "Offline/Mu2eG4Helper/inc/Mu2eG4Helper.hh"
@@ -122,6 +123,15 @@ namespace mu2e {
       }//if
     }//for
 
+    //----------------
+    // These outputs will be written as StepPointMCCompactCollection
+    for(const auto& s : conf.compactSteps()) {
+      if(std::find(outputs.begin(), outputs.end(), s) == outputs.end()) {
+        throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: no matching step collection for compactSteps = "<<s<<"\n";
+      }//if
+      compactSteps_.insert(s);
+    }//for
+
     //----------------
 
     for(const auto& i : conf.inputs()) {
@@ -378,7 +388,12 @@ namespace mu2e {
 
     vector<string> const& instanceNames = stepInstanceNamesToBeProduced();
     for(const auto& name: instanceNames) {
-      collector.produces<StepPointMCCollection>(name);
+      if(compactSteps_.count(name)) {
+        collector.produces<StepPointMCCompactCollection>(name);
+      }
+      else {
+        collector.produces<StepPointMCCollection>(name);
+      }
     }
     if(extMonPixelsEnabled_)
       collector.produces<ExtMonFNALSimHitCollection>();
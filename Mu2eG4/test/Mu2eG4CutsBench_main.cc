@@ -0,0 +1,319 @@
+//
+// Benchmark of the Mu2eG4 cut evaluation on made up steps.  For a few
+// cut configurations, in the fcl syntax of the Mu2eG4 cuts, it prints the
+// time per step of the stepping and stacking cuts evaluated by
+// Mu2eG4CutProgram, and by a tree of cut objects with virtual calls and
+// std::set volume lookups as the cuts were evaluated before.  The
+// decisions and the written outputs are checked to be identical.
+//
+// The steps are not G4Steps: both evaluate the same Mu2eG4CutInput, so
+// the times do not include the G4 accessor calls, which the tree made
+// once per cut node and the program makes once per step.  The volumes
+// are only compared by address, so placeholder addresses are used.
+// The isCharged and isNeutral cuts need the GlobalConstantsService and
+// are not used here.
+//
+// arguments are
+// NSTEP: optional, number of steps (default 1000000)
+//
+// example:
+// Mu2eG4CutsBench 5000000
+//
+#include "Offline/Mu2eG4/inc/Mu2eG4CutProgram.hh"
+
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace {
+
+  typedef std::vector<fhicl::ParameterSet> PSVector;
+
+  const unsigned nVolumes = 200;
+  std::vector<double> volumeStorage(nVolumes);
+  std::vector<const G4VPhysicalVolume*> volumes;
+
+  const G4VPhysicalVolume* findVolume(const std::string& name) {
+    unsigned ivol = std::stoul(name.substr(1));
+    if(ivol >= nVolumes) throw cet::exception("CONFIG")<<"Mu2eG4CutsBench: no volume "<<name<<"\n";
+    return volumes[ivol];
+  }
+
+  std::string volumeList(unsigned first, unsigned n) {
+    std::string list;
+    for(unsigned i=first; i<first+n; ++i) list += (list.empty() ? "" : ", ") + std::string("V") + std::to_string(i);
+    return "[ " + list + " ]";
+  }
+
+  //================================================================
+  // The cuts as they were evaluated before
+  class Cut {
+  public:
+    explicit Cut(const fhicl::ParameterSet& pset) : output_(-1) {
+      if(!pset.get<std::string>("write", "").empty()) output_ = nOutputs++;
+    }
+    virtual ~Cut() {}
+    virtual bool stepping(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) {
+      const bool result = cut_impl(in);
+      if(result && output_ >= 0) fired.push_back(output_);
+      return result;
+    }
+    virtual bool stacking(const Mu2eG4CutInput& in) { return cut_impl(in); }
+    static int nOutputs;
+  protected:
+    virtual bool cut_impl(const Mu2eG4CutInput& in) { return false; }
+    int output_;
+  };
+  int Cut::nOutputs = 0;
+
+  std::unique_ptr<Cut> makeCut(const fhicl::ParameterSet& pset);
+
+  class Union: public Cut {
+  public:
+    explicit Union(const fhicl::ParameterSet& pset) : Cut(pset) {
+      for(const auto& p: pset.get<PSVector>("pars")) cuts_.push_back(makeCut(p));
+    }
+    bool stepping(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) override {
+      bool result = false;
+      for(const auto& cut: cuts_) if(cut->stepping(in, fired)) { result = true; break; }
+      if(result && output_ >= 0) fired.push_back(output_);
+      return result;
+    }
+    bool stacking(const Mu2eG4CutInput& in) override {
+      for(const auto& cut: cuts_) if(cut->stacking(in)) return true;
+      return false;
+    }
+  private:
+    std::vector<std::unique_ptr<Cut> > cuts_;
+  };
+
+  class Intersection: public Cut {
+  public:
+    explicit Intersection(const fhicl::ParameterSet& pset) : Cut(pset) {
+      for(const auto& p: pset.get<PSVector>("pars")) cuts_.push_back(makeCut(p));
+    }
+    bool stepping(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) override {
+      bool result = true;
+      for(const auto& cut: cuts_) if(!cut->stepping(in, fired)) { result = false; break; }
+      if(result && output_ >= 0) fired.push_back(output_);
+      return result;
+    }
+    bool stacking(const Mu2eG4CutInput& in) override {
+      for(const auto& cut: cuts_) if(!cut->stacking(in)) return false;
+      return true;
+    }
+  private:
+    std::vector<std::unique_ptr<Cut> > cuts_;
+  };
+
+  class Plane: public Cut {
+  public:
+    explicit Plane(const fhicl::ParameterSet& pset) : Cut(pset), doNotCut_(pset.get<bool>("doNotCut", false)) {
+      normal_ = pset.get<std::vector<double> >("normal");
+      std::vector<double> x0 = pset.get<std::vector<double> >("point");
+      offset_ = std::inner_product(normal_.begin(), normal_.end(), x0.begin(), 0.);
+      observer_ = pset.get<std::string>("type") == "observerPlane";
+    }
+    bool stepping(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) override {
+      if(!observer_) return Cut::stepping(in, fired);
+      const bool result = behind(in.pos) && !behind(in.prePos);
+      if(result && output_ >= 0) fired.push_back(output_);
+      return doNotCut_ ? false : result;
+    }
+    bool stacking(const Mu2eG4CutInput& in) override { return observer_ ? false : behind(in.pos); }
+  private:
+    bool cut_impl(const Mu2eG4CutInput& in) override { return behind(in.pos); }
+    bool behind(const CLHEP::Hep3Vector& p) { return p.x()*normal_[0] + p.y()*normal_[1] + p.z()*normal_[2] >= offset_; }
+    std::vector<double> normal_;
+    double offset_;
+    bool observer_, doNotCut_;
+  };
+
+  class Volume: public Cut {
+  public:
+    explicit Volume(const fhicl::ParameterSet& pset) : Cut(pset), negate_(pset.get<std::string>("type") == "notInVolume") {
+      for(const auto& name: pset.get<std::vector<std::string> >("pars")) volumes_.insert(findVolume(name));
+    }
+  private:
+    bool cut_impl(const Mu2eG4CutInput& in) override {
+      if(!in.vol) return false;
+      const bool result = volumes_.find(in.vol) != volumes_.end();
+      return negate_ ? !result : result;
+    }
+    std::set<const G4VPhysicalVolume*> volumes_;
+    bool negate_;
+  };
+
+  class ParticleId: public Cut {
+  public:
+    explicit ParticleId(const fhicl::ParameterSet& pset) : Cut(pset), pdgIds_(pset.get<std::vector<int> >("pars")),
+      negate_(pset.get<std::string>("type") == "notPdgId") { std::sort(pdgIds_.begin(), pdgIds_.end()); }
+  private:
+    bool cut_impl(const Mu2eG4CutInput& in) override {
+      const bool found = std::binary_search(pdgIds_.begin(), pdgIds_.end(), in.pdg);
+      return negate_ ? !found : found;
+    }
+    std::vector<int> pdgIds_;
+    bool negate_;
+  };
+
+  class Value: public Cut {
+  public:
+    explicit Value(const fhicl::ParameterSet& pset) : Cut(pset), type_(pset.get<std::string>("type")),
+      cut_(type_ == "primary" ? 0. : pset.get<double>("cut")) {}
+  private:
+    bool cut_impl(const Mu2eG4CutInput& in) override {
+      if(type_ == "kineticEnergy") return in.ekin < cut_;
+      if(type_ == "globalTime") return in.time > cut_;
+      return in.parent != 0;
+    }
+    std::string type_;
+    double cut_;
+  };
+
+  class Constant: public Cut {
+  public:
+    explicit Constant(const fhicl::ParameterSet& pset) : Cut(pset), value_(!pset.is_empty() && pset.get<bool>("value")) {}
+    bool stepping(const Mu2eG4CutInput& in, std::vector<unsigned>& fired) override {
+      if(output_ >= 0) fired.push_back(output_);
+      return value_;
+    }
+    bool stacking(const Mu2eG4CutInput& in) override { return value_; }
+  private:
+    bool value_;
+  };
+
+  std::unique_ptr<Cut> makeCut(const fhicl::ParameterSet& pset) {
+    if(pset.is_empty()) return std::make_unique<Constant>(pset);
+    const std::string type = pset.get<std::string>("type");
+    if(type == "union") return std::make_unique<Union>(pset);
+    if(type == "intersection") return std::make_unique<Intersection>(pset);
+    if(type == "plane" || type == "observerPlane") return std::make_unique<Plane>(pset);
+    if(type == "inVolume" || type == "notInVolume") return std::make_unique<Volume>(pset);
+    if(type == "pdgId" || type == "notPdgId") return std::make_unique<ParticleId>(pset);
+    if(type == "kineticEnergy" || type == "globalTime" || type == "primary") return std::make_unique<Value>(pset);
+    if(type == "constant") return std::make_unique<Constant>(pset);
+    throw cet::exception("CONFIG")<<"Mu2eG4CutsBench: cut type "<<type<<" not handled\n";
+  }
+
+  //================================================================
+  // Steps of tracks of a few particle types, in runs of steps in the same volume
+  std::vector<Mu2eG4CutInput> makeSteps(std::mt19937& gen, size_t nStep) {
+    const std::vector<int> pdgIds{11, 11, 11, -11, 22, 22, 22, 2212, 2112, 13, -211, 12};
+    std::uniform_int_distribution<unsigned> volume(0, nVolumes-1), pdg(0, pdgIds.size()-1), run(1, 20);
+    std::uniform_real_distribution<double> pos(-5000., 5000.), time(0., 2.e6), flat(0., 1.);
+    std::exponential_distribution<double> ekin(0.2);
+
+    std::vector<Mu2eG4CutInput> steps;
+    steps.reserve(nStep);
+    while(steps.size() < nStep) {
+      Mu2eG4CutInput in;
+      in.pdg = pdgIds[pdg(gen)];
+      in.parent = flat(gen) < 0.05 ? 0 : 1;
+      in.time = time(gen);
+      in.ekin = ekin(gen);
+      in.pos = CLHEP::Hep3Vector(pos(gen), pos(gen), pos(gen));
+      for(unsigned istep=0, nrun=run(gen); istep<nrun && steps.size()<nStep; ++istep) {
+        if(istep%5 == 0) in.vol = volumes[volume(gen)];
+        in.prePos = in.pos;
+        in.pos += CLHEP::Hep3Vector(50.*flat(gen), 50.*flat(gen), 50.*flat(gen));
+        in.time += 0.1;
+        in.ekin *= 0.99;
+        steps.push_back(in);
+      }
+    }
+    return steps;
+  }
+}
+
+
+int main(int argc, char** argv) {
+  size_t nStep = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  for(unsigned ivol=0; ivol<nVolumes; ++ivol) {
+    volumes.push_back(reinterpret_cast<const G4VPhysicalVolume*>(&volumeStorage[ivol]));
+  }
+
+  // a beam stage-1 like configuration, a cosmic like configuration, the default stacking cut
+  const std::vector<std::pair<std::string, std::string> > configs{
+    {"stage1",
+        "type: union pars: [ { type: intersection pars: [ { type: kineticEnergy cut: 1.0 }, { type: pdgId pars: [ 11 ] } ] },"
+        " { type: inVolume pars: " + volumeList(0, 12) + " write: killed },"
+        " { type: plane normal: [ 0, 0, 1 ] point: [ 0, 0, 4000 ] write: downstream },"
+        " { type: globalTime cut: 1.9e6 } ]"},
+    {"cosmic",
+        "type: intersection pars: [ { type: notInVolume pars: " + volumeList(20, 60) + " },"
+        " { type: union pars: [ { type: observerPlane normal: [ 0, 1, 0 ] point: [ 0, 1000, 0 ] doNotCut: true write: crossing },"
+        " { type: kineticEnergy cut: 0.5 }, { type: primary }, { type: notPdgId pars: [ 11, -11, 13, -13, 22, 2212 ] } ] } ]"},
+    {"neutrinos",
+        "type: pdgId pars: [ 12, -12, 14, -14, 16, -16 ]"}
+  };
+
+  std::mt19937 gen(86420);
+  const std::vector<Mu2eG4CutInput> steps = makeSteps(gen, nStep);
+
+  std::cout<<"Mu2eG4CutsBench "<<nStep<<" steps, time per step in ns"<<std::endl;
+  std::cout<<std::setw(12)<<"config"<<std::setw(10)<<"nodes"<<std::setw(14)<<"step tree"<<std::setw(14)<<"step flat"
+           <<std::setw(14)<<"stack tree"<<std::setw(14)<<"stack flat"<<std::setw(10)<<"cut [%]"<<std::endl;
+
+  int nBad(0);
+  for(const auto& config: configs) {
+    const fhicl::ParameterSet pset = fhicl::ParameterSet::make(config.second);
+    Cut::nOutputs = 0;
+    std::unique_ptr<Cut> tree = makeCut(pset);
+    Mu2eG4CutProgram program(pset);
+    program.compileVolumes(findVolume);
+
+    std::vector<char> treeStep(nStep), flatStep(nStep), treeStack(nStep), flatStack(nStep);
+    std::vector<unsigned> treeFired, flatFired;
+    std::vector<size_t> treeCount(Cut::nOutputs), flatCount(program.outputs().size());
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for(size_t i=0; i<nStep; ++i) {
+      treeFired.clear();
+      treeStep[i] = tree->stepping(steps[i], treeFired);
+      for(unsigned iout: treeFired) ++treeCount[iout];
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(size_t i=0; i<nStep; ++i) {
+      flatFired.clear();
+      flatStep[i] = program.steppingActionCut(steps[i], flatFired);
+      for(unsigned iout: flatFired) ++flatCount[iout];
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for(size_t i=0; i<nStep; ++i) treeStack[i] = tree->stacking(steps[i]);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    for(size_t i=0; i<nStep; ++i) flatStack[i] = program.stackingActionCut(steps[i]);
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    if(treeStep != flatStep || treeStack != flatStack || treeCount != flatCount) ++nBad;
+
+    const double nsPerStep = 1.e9/nStep;
+    std::cout<<std::setw(12)<<config.first<<std::setw(10)<<program.nodes().size()<<std::fixed<<std::setprecision(2)
+             <<std::setw(14)<<nsPerStep*std::chrono::duration<double>(t1-t0).count()
+             <<std::setw(14)<<nsPerStep*std::chrono::duration<double>(t2-t1).count()
+             <<std::setw(14)<<nsPerStep*std::chrono::duration<double>(t3-t2).count()
+             <<std::setw(14)<<nsPerStep*std::chrono::duration<double>(t4-t3).count()
+             <<std::setw(10)<<std::setprecision(1)<<100.*std::count(flatStep.begin(), flatStep.end(), 1)/nStep
+             <<std::defaultfloat<<std::endl;
+  }
+
+  if(nBad > 0) {
+    std::cout<<"Mu2eG4CutsBench FAILED "<<nBad<<" configurations with different results"<<std::endl;
+    return 1;
+  }
+  std::cout<<"Mu2eG4CutsBench passed"<<std::endl;
+  return 0;
+}
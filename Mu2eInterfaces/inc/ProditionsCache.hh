@@ -8,9 +8,11 @@
 #include <mutex>
 #include <chrono>
 #include <iostream>
+#include <vector>
 
 #include "canvas/Persistency/Provenance/EventID.h"
 #include "Offline/DbTables/inc/DbIoV.hh"
+#include "Offline/DbTables/inc/DbIoVIndex.hh"
 #include "Offline/Mu2eInterfaces/inc/ProditionsEntity.hh"
 
 namespace mu2e {
@@ -18,7 +20,8 @@ namespace mu2e {
 
   protected:
 
-    // lock for threaded access
+    // lock for threaded access, taken to make entities. Lookups
+    // of existing entities do not lock, see _lookup
     std::shared_mutex _mutex;
 
     // count the time waiting and locked
@@ -83,17 +86,13 @@ namespace mu2e {
         _lockTime += dt;  // time we spent write locked
       } // end initialize, write lock out of scope, released
 
-      // gain shared read lock to find what
-      // set of tables are needed
+      // find what set of tables are needed, without a lock
       bool made = false;
       bool found = false;
       ProditionsEntity::ptr p;
       set_t cids;
       DbIoV iov;
-      { // start read lock scope
-        std::shared_lock lock(_mutex);
-        p = findByRun(eid,iov);  // if found, iov is valid
-      } // end read lock lifetime
+      p = findByRun(eid,iov);  // if found, iov is valid
 
       // if it was not found in cache, make it
       if(!p) {
@@ -117,12 +116,14 @@ namespace mu2e {
            // at this point, we might have existing cache items with
            // the same cids, but not the relevant iov,
            // in this case just add the iov
+           size_t icache = 0;
            for(auto& ci : _cache) {
              if(ci._p->getCids()==cids) {
                ci._iovs.emplace_back(iov);
                found = true;
                break;
              }
+             icache++;
            }
            if(!found) {
              cacheItem ci;
@@ -132,6 +133,7 @@ namespace mu2e {
              made = true;
              if(_verbose>7) p->print(std::cout);
            }
+           publish(icache,iov);
          } // p not found
 
          auto etime = std::chrono::high_resolution_clock::now();
@@ -163,27 +165,88 @@ namespace mu2e {
 
     } // end update
 
+    // make, or find, the entities for all of this run range, ahead of
+    // the events which need them, return the number of iovs in the range
+    int prefetch(DbIoV const& range) {
+      int n = 0;
+      uint32_t run = range.startRun();
+      uint32_t subrun = range.startSubrun();
+      while(range.inInterval(run,subrun)) {
+        auto ret = update(art::EventID(run,subrun,0));
+        DbIoV const& iov = std::get<1>(ret);
+        n++;
+        // continue after this iov, stop if it does not say where
+        if(!iov.inInterval(run,subrun)) break;
+        if(iov.endSubrun()<DbIoV::maxSubrun()) {
+          run = iov.endRun();
+          subrun = iov.endSubrun()+1;
+        } else {
+          if(iov.endRun()>=DbIoV::maxRun()) break;
+          run = iov.endRun()+1;
+          subrun = 0;
+        }
+      }
+      return n;
+    }
+
     // is there a cache entry covering this run/subrun?
-    // return good pointer or null, and fill iov
-    ProditionsEntity::ptr  findByRun(art::EventID eid, DbIoV& iov) {
-      uint32_t run = eid.run();
-      uint32_t subrun = eid.subRun();
-      for(auto const& ci : _cache) {
-        for(auto const& ii : ci._iovs) {
-          if(ii.inInterval(run,subrun)) {
-            iov = ii;
-            return ci._p;
+    // return good pointer or null, and fill iov.
+    // The answer is the first iov found looping over the cache items
+    // and their iovs, in order, found by index without a loop
+    ProditionsEntity::ptr  findByRun(art::EventID eid, DbIoV& iov) const {
+      auto lookup = std::atomic_load(&_lookup);
+      if(!lookup) return ProditionsEntity::ptr();
+      int i = lookup->index.find(eid.run(),eid.subRun());
+      if(i<0) return ProditionsEntity::ptr();
+      iov = lookup->iovs[i];
+      return lookup->entities[i];
+    }
+
+  private:
+
+    // all the iovs of the cache items, in the order findByRun
+    // would loop over them, indexed for lookup.  Once published,
+    // a lookup is never changed, so it is read without a lock
+    struct lookup_t {
+      DbIoVIndex index;
+      std::vector<DbIoV> iovs;
+      std::vector<ProditionsEntity::ptr> entities;
+    };
+
+    // with the write lock, make a new lookup after the iov was added
+    // to the cache item icache, and replace the published one
+    void publish(size_t icache, DbIoV const& iov) {
+      auto old = std::atomic_load(&_lookup);
+      auto lookup = old ? std::make_shared<lookup_t>(*old)
+                        : std::make_shared<lookup_t>();
+      // the new iov comes last in the loop order if it was added to
+      // the last item, or if it overlaps no other iov, so it can be
+      // added to the index, otherwise the index is made again in order
+      if(icache+1==_cache.size() || !lookup->index.overlaps(iov)) {
+        lookup->index.add(iov);
+        lookup->iovs.emplace_back(iov);
+        lookup->entities.emplace_back(_cache[icache]._p);
+      } else {
+        lookup->index.clear();
+        lookup->iovs.clear();
+        lookup->entities.clear();
+        for(auto const& ci : _cache) {
+          for(auto const& ii : ci._iovs) {
+            lookup->index.add(ii);
+            lookup->iovs.emplace_back(ii);
+            lookup->entities.emplace_back(ci._p);
           }
         }
       }
-      return ProditionsEntity::ptr();
+      std::atomic_store(&_lookup,
+                        std::shared_ptr<const lookup_t>(std::move(lookup)));
     }
 
-  private:
     std::string _name;
     int _verbose;
     bool _initialized;
     std::vector<cacheItem> _cache;
+    std::shared_ptr<const lookup_t> _lookup;
 
   };
 
@@ -1,7 +1,8 @@
 #ifndef Mu2eKinKal_Chi2SHU_hh
 #define Mu2eKinKal_Chi2SHU_hh
 //
-// Coherently update a cluster of StrawHits by minimizing the chisquared of every possible hit state combination through exhaustive search
+// Coherently update a cluster of StrawHits by minimizing the chisquared of every possible hit state combination through exhaustive search.
+// The combinations are evaluated incrementally by ClusterStateSearch, optionally pruning those that cannot be selected
 //
 #include "KinKal/General/Chisq.hh"
 #include "KinKal/Fit/MetaIterConfig.hh"
@@ -41,7 +42,8 @@ namespace mu2e {
           return a.chi2_.chisqPerNDOF() < b.chi2_.chisqPerNDOF();
         }
       };
-      Chi2SHU(Config const& config);
+      // pruning is configured separately (KinKalConfig Chi2SHUPrune), so the Config tuple is unchanged
+      Chi2SHU(Config const& config, bool prune=false);
       ClusterState selectBest(ClusterStateCOL& cscores) const; // find the best cluster configuration given the score for each
       // the work is done here
       template <class KTRAJ> void updateCluster(KKStrawHitCluster<KTRAJ>& cluster,KinKal::MetaIterConfig const& miconfig) const;
@@ -54,6 +56,7 @@ namespace mu2e {
       WHSCOL allowed_; // states to allow
       WHSMask freeze_; // states to freeze
       WHSMask unfreeze_; // states to unfreeze
+      bool prune_ = false; // prune combinations that can't be selected
       int diag_ =0; // diag print level
   };
   std::ostream& operator <<(std::ostream& os, ClusterState const& cscore );
@@ -4,6 +4,7 @@
 #ifndef Mu2eKinKal_Chi2SHU_updateCluster_hh
 #define Mu2eKinKal_Chi2SHU_updateCluster_hh
 #include "Offline/Mu2eKinKal/inc/Chi2SHU.hh"
+#include "Offline/Mu2eKinKal/inc/ClusterStateSearch.hh"
 #include "Offline/Mu2eKinKal/inc/KKStrawHitCluster.hh"
 #include "Offline/Mu2eKinKal/inc/KKStrawHit.hh"
 namespace mu2e {
@@ -37,66 +38,26 @@ namespace mu2e {
       if(diag_ > 2)std::cout << "Negative unbiased covar determinant = " << determinant << std::endl;
       return;
     }
-    // iterate over allowed states of each hit, and incrementally compute the total chisquared for all the hits in the cluster WRT the unbiased parameters
+    // compute the residuals of each hit in each allowed state once; they are WRT the reference parameters, and don't depend on the other hits
+    ClusterStateSearch search(uparams,uweights,allowed_,inactivep_,nullp_,miconfig.varianceScale());
+    for(auto const& shptr : hits) {
+      std::vector<RESIDCOL> resids(allowed_.size());
+      for(size_t istate=0;istate < allowed_.size(); ++istate) {
+        if(allowed_[istate].active()) shptr->setResiduals(miconfig,allowed_[istate],resids[istate]);
+      }
+      search.addHit(shptr->referenceParameters().parameters(),resids);
+    }
+    // incrementally compute the total chisquared of all the allowed state combinations WRT the unbiased parameters
     WHSIterator whsiter(hits.size(),allowed_);
-    // set the null hit docas: it can't be done in the
     size_t nstates = whsiter.nStates();
     ClusterStateCOL cstates(0);
-    cstates.reserve(nstates);
-    do {
-      auto cparams = uparams;
-      auto cweights = uweights;
-      // loop over hits and compute their residuals
-      double chisq(0.0);
-      unsigned ndof(0);
-      for(size_t ihit=0;ihit < hits.size(); ++ihit) {
-        auto const& shptr = hits[ihit];
-        auto const& whstate = whsiter.current()[ihit];
-        if(whstate.active()) {
-          // compute the chisquared contribution for this hit against the current parameters
-          RESIDCOL resids;
-          // compute residuals using this state (still WRT the reference parameters)
-          DVEC dpvec = cparams.parameters() - shptr->referenceParameters().parameters();
-          shptr->setResiduals(miconfig,whstate,resids);
-          // only use distance residual
-          auto const& resid = resids[Mu2eKinKal::dresid];
-          if(resid.active()) {
-            // update residuals to refer to unbiased parameters
-            double uresidval = resid.value() - ROOT::Math::Dot(dpvec,resid.dRdP());
-            double pvar = ROOT::Math::Similarity(resid.dRdP(),cparams.covariance());
-            //              if(pvar<0) throw cet::exception("RECO")<<"mu2e::KKStrawHitCluster: negative variance " << pvar << std::endl;
-            if(pvar<0){
-              // another symptom of under-constrained clusters is negative variances.  I need a better strategy for these TODO
-              if(diag_ > 2) std::cout <<"mu2e::KKStrawHitCluster: negative variance " << pvar
-                << " determinant = " << determinant << std::endl;
-              pvar = resid.parameterVariance();
-            }
-            // Use the unbiased residual to compute the chisq
-            Residual uresid(uresidval,resid.variance(),pvar,resid.active(),resid.dRdP());
-            chisq += uresid.chisq();
-            ++ndof;
-          }
-          // add null penalty
-          if(whstate == WireHitState::null) chisq += nullp_;
-          // compute the weight from this hits state, and update the parameters to use for subsequent hits
-          // this isn't necessary for the last hit since there are no subsequent hits
-          if(ihit+1 < hits.size()){
-            for(auto resid : resids) {
-              if(resid.active())cweights +=  resid.weight(cparams.parameters(),miconfig.varianceScale());
-            }
-            cparams = Parameters(cweights);
-          }
-        } else {
-          // add penalty
-          chisq += inactivep_;
-          ++ndof; // count this as a DOF
-        }
-      }
-      // record this chisq with the state of all the hits
-      cstates.emplace_back(Chisq(chisq,ndof),whsiter.current());
-    } while(whsiter.increment());
+    cstates.reserve(prune_ ? 0 : nstates);
+    search.search(cstates,mindchi2_,prune_);
+    // another symptom of under-constrained clusters is negative variances.  I need a better strategy for these TODO
+    if(diag_ > 2 && search.nNegativeVariance() > 0)std::cout <<"mu2e::KKStrawHitCluster: " << search.nNegativeVariance()
+      << " negative variances, determinant = " << determinant << std::endl;
     // test
-    if(cstates.size() != nstates){
+    if(cstates.size() + search.nPruned() != nstates){
       throw cet::exception("RECO")<<"mu2e::KKStrawHitCluster: incomplete chisquared combinatorics" << std::endl;
     }
     // choose the best cluster state
@@ -0,0 +1,65 @@
+#ifndef Mu2eKinKal_ClusterStateSearch_hh
+#define Mu2eKinKal_ClusterStateSearch_hh
+//
+//  Incremental evaluation of the chisquared of every allowed state combination of a cluster of StrawHits.
+//  Each hit is tested against the unbiased parameters updated with the weights of the preceding active hits,
+//  so the chisquared of a combination depends on its leading hit states.  The combinations are visited depth-first in
+//  WHSIterator order (last hit fastest), keeping the parameters, weights and partial chisquared after each hit, so
+//  moving to the next combination only re-evaluates the hits after the one whose state changed: on average
+//  S/(S-1) hits per combination for S allowed states, instead of all of them.  The residuals of each hit in each
+//  allowed state WRT the reference parameters are computed once, by the caller.
+//  The combinations and their chisquared are identical to those of the exhaustive loop.
+//
+//  Optionally, branches are pruned when their chisquared/NDOF lower bound is above that of a combination that is
+//  certain to end the merging of nearly degenerate states in Chi2SHU::selectBest.  The best state and quality are then
+//  unchanged (up to ties in chisquared/NDOF), but only the combinations selectBest looks at are returned.
+//
+#include "KinKal/General/Parameters.hh"
+#include "KinKal/General/Weights.hh"
+#include "KinKal/Detector/Residual.hh"
+#include "Offline/Mu2eKinKal/inc/Chi2SHU.hh"
+#include "Offline/Mu2eKinKal/inc/WireHitState.hh"
+#include <array>
+#include <vector>
+
+namespace mu2e {
+  using KinKal::Parameters;
+  using KinKal::Weights;
+  using KinKal::DVEC;
+  using RESIDCOL = std::array<KinKal::Residual,2>;
+
+  class ClusterStateSearch {
+    public:
+      // unbiased parameters and weights, states allowed for each hit, chisquared penalties, and variance scale
+      ClusterStateSearch(Parameters const& uparams, Weights const& uweights, WHSCOL const& allowed,
+          double inactivep, double nullp, double varianceScale);
+      // add a hit given its reference parameters and its residuals in each allowed state (those of inactive states are not used)
+      void addHit(DVEC const& refparams, std::vector<RESIDCOL> const& resids);
+      size_t nHits() const { return refparams_.size(); }
+      // compute the chisquared of all the combinations, appending them to cstates in WHSIterator order.
+      // If prune is set and the penalties and mindchi2 are positive, skip the combinations that can't be selected.
+      void search(ClusterStateCOL& cstates, double mindchi2=0.0, bool prune=false);
+      size_t nPruned() const { return npruned_; } // # of combinations skipped in the last search
+      size_t nNegativeVariance() const { return nnegvar_; } // # of unbiased residuals whose parameter variance was negative
+    private:
+      // partial result after a given number of hits
+      struct Level {
+        Parameters params_;
+        Weights weights_;
+        double chisq_ =0;
+        unsigned ndof_ =0;
+      };
+      // evaluate hit ihit in allowed state istate, starting from level ihit and setting level ihit+1
+      void evaluate(size_t ihit, size_t istate);
+      Parameters uparams_;
+      Weights uweights_;
+      WHSCOL const& allowed_;
+      double inactivep_, nullp_, varscale_;
+      std::vector<DVEC> refparams_; // reference parameters of each hit
+      std::vector<std::vector<RESIDCOL>> resids_; // residuals of each hit in each allowed state
+      std::vector<Level> levels_;
+      size_t npruned_ =0;
+      size_t nnegvar_ =0;
+  };
+}
+#endif
@@ -59,13 +59,19 @@
 // root
 #include "TH1F.h"
 #include "TTree.h"
+// TBB
+#include "tbb/concurrent_queue.h"
+#include "tbb/parallel_for.h"
 // C++
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <functional>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <set>
 namespace mu2e {
   using PKTRAJ = KinKal::ParticleTrajectory<KTRAJ>;
   using KKTRK = KKTrack<KTRAJ>;
@@ -101,6 +107,7 @@ namespace mu2e {
   struct KKHelixModuleConfig : KKModuleConfig {
     fhicl::Sequence<art::InputTag> seedCollections         {Name("HelixSeedCollections"),     Comment("Seed fit collections to be processed ") };
     fhicl::OptionalAtom<double> fixedBField { Name("ConstantBField"), Comment("Constant BField value") };
+    fhicl::Atom<bool> concurrentFits { Name("ConcurrentSeedFits"), Comment("Fit the seeds of an event concurrently on the art thread pool; the output is the same as fitting them in turn"), false };
   };
 
   struct HelixFitConfig {
@@ -139,6 +146,21 @@ namespace mu2e {
       // parameter-specific functions that need to be overridden in subclasses
       virtual KTRAJ makeSeedTraj(HelixSeed const& hseed,TimeRange const& trange,VEC3 const& bnom, int charge) const = 0;
       virtual bool goodFit(KKTRK const& ktrk) const = 0;
+      // fit configurations.  The updaters hold MVA sessions that aren't reentrant, so each concurrent fit needs its own set
+      struct FitConfigs {
+        Config config_; // initial fit configuration object
+        Config exconfig_; // extension configuration object
+      };
+      // result of fitting one seed
+      struct SeedFit {
+        std::unique_ptr<KKTRK> kktrk_; // null if no track was created from the seed
+        bool goodfit_ = false;
+        KalSeed kseed_; // filled if the fit is to be saved
+      };
+      SeedFit fitSeed(HPtr const& hptr, FitConfigs const& configs, Tracker const& tracker, StrawResponse const& strawresponse,
+          KKStrawMaterial const& smat, ComboHitCollection const& chcol, KKComboHitIndex const* chindex,
+          Calorimeter const& calo, CCHandle const& cc_H) const;
+      std::unique_ptr<FitConfigs> checkoutConfigs();
       // data payload
       std::vector<art::ProductToken<HelixSeedCollection>> hseedCols_;
       art::ProductToken<ComboHitCollection> chcol_T_;
@@ -157,8 +179,14 @@ namespace mu2e {
       double mass_; // particle mass
       int PDGcharge_; // PDG particle charge
       std::unique_ptr<KinKal::BFieldMap> kkbf_;
-      Config config_; // initial fit configuration object
-      Config exconfig_; // extension configuration object
+      bool usebfgrid_; // cache the field on a grid in detector coordinates
+      std::vector<float> bfgridrange_; // extent of that grid; empty to cover the tracker and calorimeter
+      bool indexhits_; // index the hits of each event when adding hits to extended fits
+      FitConfigs configs_; // fit configuration objects
+      bool concurrent_; // fit seeds concurrently
+      fhicl::ParameterSet fitpset_, extpset_; // fit and extension settings, to make more fit configuration objects
+      tbb::concurrent_queue<std::unique_ptr<FitConfigs>> configpool_; // fit configuration objects not used by any concurrent fit
+      std::mutex configmutex_; // serializes making fit configuration objects from the settings
       KinKal::ExtraConfig xconfig_; // tolerance and maximum Dt when extrapolating
       bool fixedfield_; // special case usage for seed fits, if no BField corrections are needed
       SurfaceMap::SurfacePairCollection extrap_; // surfaces to extrapolate the fit to
@@ -176,10 +204,15 @@ namespace mu2e {
     usePDGCharge_(settings().pdgCharge()),
     kkfit_(settings().kkfitSettings()),
     kkmat_(settings().matSettings()),
-    config_(Mu2eKinKal::makeConfig(settings().fitSettings())),
-    exconfig_(Mu2eKinKal::makeConfig(settings().extSettings())),
+    usebfgrid_(settings().modSettings().bfieldGrid()),
+    indexhits_(settings().modSettings().indexHits()),
+    configs_{Mu2eKinKal::makeConfig(settings().fitSettings()),Mu2eKinKal::makeConfig(settings().extSettings())},
+    concurrent_(settings().modSettings().concurrentFits()),
+    fitpset_(settings().fitSettings.get_PSet()),
+    extpset_(settings().extSettings.get_PSet()),
     fixedfield_(false)
     {
+      settings().modSettings().bfieldGridRange(bfgridrange_);
       // collection handling
       for(const auto& hseedtag : settings().modSettings().seedCollections()) { hseedCols_.emplace_back(consumes<HelixSeedCollection>(hseedtag)); }
       produces<KKTRKCOL>();
@@ -192,7 +225,7 @@ namespace mu2e {
       for(size_t ipar=0;ipar < seederrors.size(); ++ipar){
         seedcov_[ipar][ipar] = seederrors[ipar]*seederrors[ipar];
       }
-      if(print_ > 0) std::cout << "Fit " << config_ << "Extension " << exconfig_;
+      if(print_ > 0) std::cout << "Fit " << configs_.config_ << "Extension " << configs_.exconfig_;
       double bz(0.0);
       if(settings().modSettings().fixedBField(bz)){
         fixedfield_ = true;
@@ -219,11 +252,30 @@ namespace mu2e {
     if(!fixedfield_){
       GeomHandle<BFieldManager> bfmgr;
       GeomHandle<DetectorSystem> det;
-      kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det));
+      std::shared_ptr<const KKBFieldGrid> bfgrid;
+      if(usebfgrid_){
+        GeomHandle<Tracker> tracker;
+        GeomHandle<Calorimeter> calo;
+        auto range = bfgridrange_.empty() ? KKBFieldGrid::Range(*det,*tracker,*calo) : KKBFieldGrid::Range(bfgridrange_);
+        bfgrid = KKBFieldGrid::shared(*bfmgr,*det,range);
+      }
+      kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det,bfgrid));
     }
     if(print_ > 0) kkbf_->print(std::cout);
   }
 
+  std::unique_ptr<HelixFit::FitConfigs> HelixFit::checkoutConfigs() {
+    // take a free set of configurations for one fit, or make a new one if all are in use
+    std::unique_ptr<FitConfigs> configs;
+    if(!configpool_.try_pop(configs)){
+      std::lock_guard<std::mutex> lock(configmutex_);
+      configs = std::make_unique<FitConfigs>(FitConfigs{
+          Mu2eKinKal::makeConfig(fhicl::Table<KKConfig>{fitpset_, std::set<std::string>{}}()),
+          Mu2eKinKal::makeConfig(fhicl::Table<KKConfig>{extpset_, std::set<std::string>{}}())});
+    }
+    return configs;
+  }
+
   void HelixFit::produce(art::Event& event ) {
     GeomHandle<Calorimeter> calo_h;
     // find current proditions
@@ -233,115 +285,53 @@ namespace mu2e {
     auto ch_H = event.getValidHandle<ComboHitCollection>(chcol_T_);
     auto cc_H = event.getValidHandle<CaloClusterCollection>(cccol_T_);
     auto const& chcol = *ch_H;
+    // index the hits once for all the fits of this event
+    std::unique_ptr<KKComboHitIndex> chindex;
+    if(indexhits_ && kkfit_.addHits() && configs_.exconfig_.schedule().size() > 0) chindex = std::make_unique<KKComboHitIndex>(chcol);
+    // the straw material is created on first use: do that before any fits run
+    auto const& smat = kkmat_.strawMaterial();
     // create output
     unique_ptr<KKTRKCOL> kktrkcol(new KKTRKCOL );
     unique_ptr<KalSeedCollection> kkseedcol(new KalSeedCollection );
     unique_ptr<KalHelixAssns> kkseedassns(new KalHelixAssns());
     auto KalSeedCollectionPID = event.getProductID<KalSeedCollection>();
     auto KalSeedCollectionGetter = event.productGetter(KalSeedCollectionPID);
-    // find the helix seed collections
+    // find the seeds to fit, in output order
     unsigned nseed(0);
+    std::vector<HPtr> hptrs;
     for (auto const& hseedtag : hseedCols_) {
       auto const& hseedcol_h = event.getValidHandle<HelixSeedCollection>(hseedtag);
       auto const& hseedcol = *hseedcol_h;
       nseed += hseedcol.size();
-      // loop over the seeds
       for(size_t iseed=0; iseed < hseedcol.size(); ++iseed) {
-        auto const& hseed = hseedcol[iseed];
-        auto hptr = HPtr(hseedcol_h,iseed);
-        // check helicity.  The test on the charge and helicity
-        if(hseed.status().hasAllProperties(goodseed_) ){
-          // test helix
-          auto const& helix = hseed.helix();
-          if(helix.radius() == 0.0 || helix.lambda() == 0.0 )
-            throw cet::exception("RECO")<<"mu2e::HelixFit: degenerate seed parameters" << endl;
-          auto zcent = Mu2eKinKal::zMid(hseed.hits());
-          // take the magnetic field at the helix center as nominal
-          VEC3 center(helix.centerx(), helix.centery(),zcent);
-          auto bnom = kkbf_->fieldVect(center);
-          // compute the charge from the helicity, fit direction, and BField direction
-          double bz = bnom.Z();
-          int charge = static_cast<int>(copysign(PDGcharge_,(-1)*helix.helicity().value()*fdir_.dzdt()*bz));
-          // test consistency.  Modify this later when the HelixSeed knows which direction it's going TODO
-          auto fitpart = fpart_;
-          if(charge*PDGcharge_ < 0){
-            if(usePDGCharge_)throw cet::exception("RECO")<<"mu2e::HelixFit: inconsistent charge" << endl;
-            fitpart = static_cast<PDGCode::type>(-1*fitpart); // reverse sign
-          }
-          // time range of the hits
-          auto trange = Mu2eKinKal::timeBounds(hseed.hits());
-          // construt the seed trajectory
-          KTRAJ seedtraj = makeSeedTraj(hseed,trange,bnom,charge);
-          // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
-          PKTRAJ pseedtraj(seedtraj);
-          // first, we need to unwind the combohits.  We use this also to find the time range
-          StrawHitIndexCollection strawHitIdxs;
-          auto chcolptr = hseed.hits().fillStrawHitIndices(strawHitIdxs, StrawIdMask::uniquestraw);
-          if(chcolptr != &chcol)
-            throw cet::exception("RECO")<<"mu2e::KKHelixFit: inconsistent ComboHitCollection" << std::endl;
-          // next, build straw hits and materials from these
-          KKSTRAWHITCOL strawhits;
-          strawhits.reserve(strawHitIdxs.size());
-          KKSTRAWXINGCOL strawxings;
-          strawxings.reserve(strawHitIdxs.size());
-          if(kkfit_.makeStrawHits(*tracker, *strawresponse, *kkbf_, kkmat_.strawMaterial(), pseedtraj, chcol, strawHitIdxs, strawhits, strawxings)){
-            // optionally (and if present) add the CaloCluster as a constraint
-            // verify the cluster looks physically reasonable before adding it TODO!  Or, let the KKCaloHit updater do it TODO
-            KKCALOHITCOL calohits;
-            if (kkfit_.useCalo() && hseed.caloCluster().isNonnull())kkfit_.makeCaloHit(hseed.caloCluster(),*calo_h, pseedtraj, calohits);
-            // set the seed range given the hits and xings
-            seedtraj.range() = kkfit_.range(strawhits,calohits,strawxings);
-            // create and fit the track
-            auto kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,fitpart,kkfit_.strawHitClusterer(),strawhits,strawxings,calohits);
-            // Check the fit
-            auto goodfit = goodFit(*kktrk);
-            // if we have an extension schedule, extend.
-            if(goodfit && exconfig_.schedule().size() > 0) {
-              kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
-              goodfit = goodFit(*kktrk);
-            }
-            // extrapolate as required
-            if(goodfit && extrap_.size()>0) {
-              // test the drection of this fit
-              auto const& ftraj = kktrk->fitTraj();
-              bool downstream = ftraj.momentum3(ftraj.range().mid()).Z() > 0.0; // replace with momentum at tracker middle TODO
-              const static VEC3 opos(0.0,0.0,0.0);
-              for(auto const& surf : extrap_){
-                // configure the extrapolation time direction according to the surface and the track momentum direction
-                if(surf.first.id() == SurfaceIdEnum::TT_Front){
-                  xconfig_.xdir_ = downstream ? TimeDir::backwards : TimeDir::forwards;
-                  double zpos = surf.second->tangentPlane(opos).center().Z(); // this is crude: I need an accessor that knows the TT_Front is a plane TODO
-                  ExtrapolateToZ xtoz(*kktrk,xconfig_.xdir_,zpos);
-                  kktrk->extrapolate(xconfig_,xtoz);
-                } else if(surf.first.id() == SurfaceIdEnum::TT_Back){
-                  xconfig_.xdir_ = downstream ? TimeDir::forwards : TimeDir::backwards;
-                  double zpos = surf.second->tangentPlane(opos).center().Z();
-                  ExtrapolateToZ xtoz(*kktrk,xconfig_.xdir_,zpos);
-                  kktrk->extrapolate(xconfig_,xtoz);
-                } else if(surf.first.id() == SurfaceIdEnum::TT_Outer){
-                  // extrapolate in both time directions
-                }
-              }
-            }
-
-            if(print_>0)kktrk->printFit(std::cout,print_);
-            if(goodfit || saveall_){
-              TrkFitFlag fitflag(hptr->status());
-              fitflag.merge(fitflag_);
-              if(goodfit)
-                fitflag.merge(TrkFitFlag::FitOK);
-              else
-                fitflag.clear(TrkFitFlag::FitOK);
-              kkseedcol->push_back(kkfit_.createSeed(*kktrk,fitflag,*calo_h));
-              // fill assns with the helix seed
-              auto hptr = art::Ptr<HelixSeed>(hseedcol_h,iseed);
-              auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
-              kkseedassns->addSingle(kseedptr,hptr);
-              // save (unpersistable) KKTrk in the event
-              kktrkcol->push_back(kktrk.release());
-            }
-          }
-        }
+        if(hseedcol[iseed].status().hasAllProperties(goodseed_) ) hptrs.push_back(HPtr(hseedcol_h,iseed));
+      }
+    }
+    // fit the seeds.  The fits are independent, and each fills its own result
+    std::vector<SeedFit> fits(hptrs.size());
+    if(concurrent_ && hptrs.size() > 1){
+      tbb::parallel_for(size_t(0),hptrs.size(),[&](size_t ifit){
+          // the configurations are held for the whole fit, whichever threads run it
+          auto configs = checkoutConfigs();
+          fits[ifit] = fitSeed(hptrs[ifit],*configs,*tracker,*strawresponse,smat,chcol,chindex.get(),*calo_h,cc_H);
+          configpool_.push(std::move(configs));
+          });
+    } else {
+      for(size_t ifit=0; ifit < hptrs.size(); ++ifit)
+        fits[ifit] = fitSeed(hptrs[ifit],configs_,*tracker,*strawresponse,smat,chcol,chindex.get(),*calo_h,cc_H);
+    }
+    // collect the output in seed order
+    for(size_t ifit=0; ifit < fits.size(); ++ifit){
+      auto& fit = fits[ifit];
+      if(!fit.kktrk_)continue;
+      if(print_>0)fit.kktrk_->printFit(std::cout,print_);
+      if(fit.goodfit_ || saveall_){
+        kkseedcol->push_back(std::move(fit.kseed_));
+        // fill assns with the helix seed
+        auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
+        kkseedassns->addSingle(kseedptr,hptrs[ifit]);
+        // save (unpersistable) KKTrk in the event
+        kktrkcol->push_back(fit.kktrk_.release());
       }
     }
     // put the output products into the event
@@ -351,4 +341,97 @@ namespace mu2e {
     event.put(move(kkseedassns));
   }
 
+  HelixFit::SeedFit HelixFit::fitSeed(HPtr const& hptr, FitConfigs const& configs, Tracker const& tracker, StrawResponse const& strawresponse,
+      KKStrawMaterial const& smat, ComboHitCollection const& chcol, KKComboHitIndex const* chindex,
+      Calorimeter const& calo, CCHandle const& cc_H) const {
+    SeedFit retval;
+    auto const& hseed = *hptr;
+    // test helix
+    auto const& helix = hseed.helix();
+    if(helix.radius() == 0.0 || helix.lambda() == 0.0 )
+      throw cet::exception("RECO")<<"mu2e::HelixFit: degenerate seed parameters" << endl;
+    auto zcent = Mu2eKinKal::zMid(hseed.hits());
+    // take the magnetic field at the helix center as nominal
+    VEC3 center(helix.centerx(), helix.centery(),zcent);
+    auto bnom = kkbf_->fieldVect(center);
+    // compute the charge from the helicity, fit direction, and BField direction
+    double bz = bnom.Z();
+    int charge = static_cast<int>(copysign(PDGcharge_,(-1)*helix.helicity().value()*fdir_.dzdt()*bz));
+    // test consistency.  Modify this later when the HelixSeed knows which direction it's going TODO
+    auto fitpart = fpart_;
+    if(charge*PDGcharge_ < 0){
+      if(usePDGCharge_)throw cet::exception("RECO")<<"mu2e::HelixFit: inconsistent charge" << endl;
+      fitpart = static_cast<PDGCode::type>(-1*fitpart); // reverse sign
+    }
+    // time range of the hits
+    auto trange = Mu2eKinKal::timeBounds(hseed.hits());
+    // construt the seed trajectory
+    KTRAJ seedtraj = makeSeedTraj(hseed,trange,bnom,charge);
+    // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
+    PKTRAJ pseedtraj(seedtraj);
+    // first, we need to unwind the combohits.  We use this also to find the time range
+    StrawHitIndexCollection strawHitIdxs;
+    auto chcolptr = hseed.hits().fillStrawHitIndices(strawHitIdxs, StrawIdMask::uniquestraw);
+    if(chcolptr != &chcol)
+      throw cet::exception("RECO")<<"mu2e::KKHelixFit: inconsistent ComboHitCollection" << std::endl;
+    // next, build straw hits and materials from these
+    KKSTRAWHITCOL strawhits;
+    strawhits.reserve(strawHitIdxs.size());
+    KKSTRAWXINGCOL strawxings;
+    strawxings.reserve(strawHitIdxs.size());
+    if(kkfit_.makeStrawHits(tracker, strawresponse, *kkbf_, smat, pseedtraj, chcol, strawHitIdxs, strawhits, strawxings)){
+      // optionally (and if present) add the CaloCluster as a constraint
+      // verify the cluster looks physically reasonable before adding it TODO!  Or, let the KKCaloHit updater do it TODO
+      KKCALOHITCOL calohits;
+      if (kkfit_.useCalo() && hseed.caloCluster().isNonnull())kkfit_.makeCaloHit(hseed.caloCluster(),calo, pseedtraj, calohits);
+      // set the seed range given the hits and xings
+      seedtraj.range() = kkfit_.range(strawhits,calohits,strawxings);
+      // create and fit the track
+      auto kktrk = make_unique<KKTRK>(configs.config_,*kkbf_,seedtraj,fitpart,kkfit_.strawHitClusterer(),strawhits,strawxings,calohits);
+      // Check the fit
+      auto goodfit = goodFit(*kktrk);
+      // if we have an extension schedule, extend.
+      if(goodfit && configs.exconfig_.schedule().size() > 0) {
+        kkfit_.extendTrack(configs.exconfig_,*kkbf_, tracker,strawresponse, smat, chcol, chindex, calo, cc_H, *kktrk );
+        goodfit = goodFit(*kktrk);
+      }
+      // extrapolate as required
+      if(goodfit && extrap_.size()>0) {
+        // test the drection of this fit
+        auto const& ftraj = kktrk->fitTraj();
+        bool downstream = ftraj.momentum3(ftraj.range().mid()).Z() > 0.0; // replace with momentum at tracker middle TODO
+        const static VEC3 opos(0.0,0.0,0.0);
+        KinKal::ExtraConfig xconfig(xconfig_);
+        for(auto const& surf : extrap_){
+          // configure the extrapolation time direction according to the surface and the track momentum direction
+          if(surf.first.id() == SurfaceIdEnum::TT_Front){
+            xconfig.xdir_ = downstream ? TimeDir::backwards : TimeDir::forwards;
+            double zpos = surf.second->tangentPlane(opos).center().Z(); // this is crude: I need an accessor that knows the TT_Front is a plane TODO
+            ExtrapolateToZ xtoz(*kktrk,xconfig.xdir_,zpos);
+            kktrk->extrapolate(xconfig,xtoz);
+          } else if(surf.first.id() == SurfaceIdEnum::TT_Back){
+            xconfig.xdir_ = downstream ? TimeDir::forwards : TimeDir::backwards;
+            double zpos = surf.second->tangentPlane(opos).center().Z();
+            ExtrapolateToZ xtoz(*kktrk,xconfig.xdir_,zpos);
+            kktrk->extrapolate(xconfig,xtoz);
+          } else if(surf.first.id() == SurfaceIdEnum::TT_Outer){
+            // extrapolate in both time directions
+          }
+        }
+      }
+      if(goodfit || saveall_){
+        TrkFitFlag fitflag(hseed.status());
+        fitflag.merge(fitflag_);
+        if(goodfit)
+          fitflag.merge(TrkFitFlag::FitOK);
+        else
+          fitflag.clear(TrkFitFlag::FitOK);
+        retval.kseed_ = kkfit_.createSeed(*kktrk,fitflag,calo);
+      }
+      retval.goodfit_ = goodfit;
+      retval.kktrk_ = std::move(kktrk);
+    }
+    return retval;
+  }
+
 } // mu2e
@@ -6,6 +6,7 @@
 // Mu2e includes
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
+#include "Offline/Mu2eKinKal/inc/KKBFieldGrid.hh"
 // KinKal includes
 #include "KinKal/General/BFieldMap.hh"
 
@@ -16,8 +17,9 @@ namespace mu2e
     public:
       using Grad = ROOT::Math::SMatrix<double,3>; // field gradient: ie dBi/d(x,y,z)
       // construct from BField object and system translator.
-      // This should be a single BField map valid in the detector system, to avoid making continuous translations FIXME!
-      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det) : bfmgr_(bfmgr), det_(det) {}
+      // Points inside the (optional) detector grid are looked up there directly; others go through the BField manager.
+      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det, std::shared_ptr<const KKBFieldGrid> grid = nullptr) :
+        bfmgr_(bfmgr), det_(det), grid_(std::move(grid)) {}
       virtual ~KKBField() {}
       // KinKal BField interface
       // return value of the field at a poin
@@ -30,8 +32,11 @@ namespace mu2e
       bool inRange(VEC3 const& position) const override;
       void print(std::ostream& os ) const override;
     private:
+      // field and its derivatives dB/dx_j, from a single map lookup
+      VEC3 fieldAndGrad(VEC3 const& position, CLHEP::Hep3Vector gradient[3]) const;
       BFieldManager const& bfmgr_;
       DetectorSystem const& det_;
+      std::shared_ptr<const KKBFieldGrid> grid_; // field in detector coordinates over the tracker and calorimeter
   };
 }
 #endif
@@ -0,0 +1,56 @@
+#ifndef Mu2eKinKal_KKBFieldGrid_hh
+#define Mu2eKinKal_KKBFieldGrid_hh
+//
+//  Copy of the Mu2e field over the tracker and calorimeter, stored on a grid in detector coordinates,
+//  so that KinKal fits look up the field without translating the point or searching the maps.
+//  The grid nodes are the nodes of the field map covering the detector origin, so inside the grid
+//  the interpolated field is that of the map (up to the float rounding of BFCompactGrid).
+//  The grid is read-only once built; modules running in the same job share it.
+//
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFCompactGrid.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+#include "Offline/GeometryService/inc/DetectorSystem.hh"
+#include "Offline/TrackerGeom/inc/Tracker.hh"
+#include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
+#include "CLHEP/Vector/ThreeVector.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mu2e
+{
+  class KKBFieldGrid {
+    public:
+      // requested extent, in detector coordinates (mm): |x|,|y| < rmax, zmin < z < zmax
+      struct Range {
+        double rmax_, zmin_, zmax_;
+        Range(double rmax, double zmin, double zmax) : rmax_(rmax), zmin_(zmin), zmax_(zmax) {}
+        // from the fhicl sequence (rmax, zmin, zmax)
+        explicit Range(std::vector<float> const& range);
+        // covering the tracker mother volume and the calorimeter envelope
+        Range(DetectorSystem const& det, Tracker const& tracker, Calorimeter const& calo);
+        bool operator == (Range const& other) const { return rmax_ == other.rmax_ && zmin_ == other.zmin_ && zmax_ == other.zmax_; }
+      };
+      // Build the grid for this field and detector system, or return the one already built by another module.
+      // Returns null if no grid map covers the detector origin; callers should then use the BFieldManager directly.
+      static std::shared_ptr<const KKBFieldGrid> shared(BFieldManager const& bfmgr, DetectorSystem const& det, Range const& range);
+      // field (and its derivatives dB/dx_j) at a point in detector coordinates; false outside the grid
+      bool field(CLHEP::Hep3Vector const& position, CLHEP::Hep3Vector& bfield) const { return grid_.interpolate(position,bfield); }
+      bool field(CLHEP::Hep3Vector const& position, CLHEP::Hep3Vector& bfield, CLHEP::Hep3Vector gradient[3]) const {
+        return grid_.interpolate(position,bfield,gradient); }
+      bool inRange(double x, double y, double z) const {
+        return x >= lo_.x() && x <= hi_.x() && y >= lo_.y() && y <= hi_.y() && z >= lo_.z() && z <= hi_.z(); }
+      // actual extent of the grid, in detector coordinates; this is the requested range clipped to the map
+      CLHEP::Hep3Vector const& low() const { return lo_; }
+      CLHEP::Hep3Vector const& high() const { return hi_; }
+      void print(std::ostream& os) const;
+    private:
+      KKBFieldGrid(BFieldManager const& bfmgr, DetectorSystem const& det, BFGridMap const& source, Range const& range);
+      BFCompactGrid grid_; // field values, scale factor included
+      CLHEP::Hep3Vector lo_, hi_; // grid extent
+      std::string source_; // key of the map the grid nodes are taken from
+  };
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef Mu2eKinKal_KKComboHitIndex_hh
+#define Mu2eKinKal_KKComboHitIndex_hh
+//
+//  Index of the straw ComboHits of an event by tracker plane and time, used to find the hits to add to a track
+//  when extending a fit.  It is built once per event and shared by all the fits made from that event's seeds.
+//  The candidates it returns for a trajectory are a superset of the hits that pass the time test of KKFit::addStrawHits
+//  only when KKFitUtilities::zTime converges to the crossing of the hit z on the trajectory.  When it does not, the two
+//  can select different hits, so the index is used only when ModuleSettings.IndexComboHits is set
+//
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+#include "KinKal/Trajectory/ParticleTrajectory.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+namespace mu2e {
+  class KKComboHitIndex {
+    public:
+      explicit KKComboHitIndex(ComboHitCollection const& chcol);
+      ComboHitCollection const& comboHits() const { return *chcol_; }
+      // append the indices of the hits in this plane with time in [tmin,tmax]
+      void hits(unsigned plane, double tmin, double tmax, std::vector<StrawHitIndex>& hits) const;
+      // indices of the hits whose time is within dt of the time the trajectory crosses the hit z position, sorted and unique
+      template <class KTRAJ> void candidates(KinKal::ParticleTrajectory<KTRAJ> const& ptraj, double dt, std::vector<StrawHitIndex>& hits) const;
+    private:
+      struct Entry {
+        float time_; // corrected hit time
+        StrawHitIndex index_; // index into the ComboHit collection
+      };
+      ComboHitCollection const* chcol_;
+      std::vector<size_t> first_; // start of each plane's entries; the last element is the total
+      std::vector<Entry> entries_; // sorted by plane, then time
+      std::vector<float> zmin_, zmax_; // z range of the hits in each plane
+  };
+
+  // The z position of each trajectory piece is linear in time, so the times a piece spends in the z range of a plane's hits
+  // form one interval.  The first and last pieces are open-ended, as KKFitUtilities::zTime extrapolates them.
+  template <class KTRAJ> void KKComboHitIndex::candidates(KinKal::ParticleTrajectory<KTRAJ> const& ptraj, double dt, std::vector<StrawHitIndex>& hits) const {
+    static const double inf = std::numeric_limits<double>::infinity();
+    hits.clear();
+    size_t npieces = ptraj.pieces().size();
+    for(size_t ipiece=0; ipiece < npieces; ++ipiece){
+      auto const& piece = ptraj.piece(ipiece);
+      double tbeg = ipiece == 0 ? -inf : piece.range().begin();
+      double tend = ipiece+1 == npieces ? inf : piece.range().end();
+      double tref = piece.range().mid();
+      double zref = piece.position3(tref).Z();
+      double vz = piece.velocity(tref).Z();
+      for(unsigned iplane=0; iplane+1 < first_.size(); ++iplane){
+        if(first_[iplane] == first_[iplane+1])continue;
+        double tmin(tbeg), tmax(tend);
+        if(vz != 0.0){
+          double t0 = tref + (zmin_[iplane]-zref)/vz;
+          double t1 = tref + (zmax_[iplane]-zref)/vz;
+          tmin = std::max(tmin,std::min(t0,t1));
+          tmax = std::min(tmax,std::max(t0,t1));
+        } else if(zref < zmin_[iplane] || zref > zmax_[iplane])
+          continue;
+        if(tmin <= tmax)this->hits(iplane,tmin-dt,tmax+dt,hits);
+      }
+    }
+    // neighboring pieces can return the same hit
+    std::sort(hits.begin(),hits.end());
+    hits.erase(std::unique(hits.begin(),hits.end()),hits.end());
+  }
+}
+#endif
@@ -9,6 +9,7 @@
 #include "Offline/Mu2eKinKal/inc/KKStrawXing.hh"
 #include "Offline/Mu2eKinKal/inc/KKStrawMaterial.hh"
 #include "Offline/Mu2eKinKal/inc/KKCaloHit.hh"
+#include "Offline/Mu2eKinKal/inc/KKComboHitIndex.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitSettings.hh"
 #include "Offline/Mu2eKinKal/inc/WireHitState.hh"
@@ -41,6 +42,7 @@
 // Other
 #include "cetlib_except/exception.h"
 #include <memory>
+#include <mutex>
 #include <cmath>
 #include <algorithm>
 namespace mu2e {
@@ -91,10 +93,11 @@ namespace mu2e {
           KKSTRAWHITCOL& hits, KKSTRAWXINGCOL& exings) const;
       SensorLine caloAxis(CaloCluster const& cluster, Calorimeter const& calo) const; // should come from CaloCluster TODO
       bool makeCaloHit(CCPtr const& cluster, Calorimeter const& calo, PKTRAJ const& pktraj, KKCALOHITCOL& hits) const;
-      // extend a track with a new configuration, optionally searching for and adding hits and straw material
+      // extend a track with a new configuration, optionally searching for and adding hits and straw material.
+      // If given, the index of chcol limits the hits tested for adding to those close in time to the track
       void extendTrack(Config const& config, BFieldMap const& kkbf, Tracker const& tracker,
           StrawResponse const& strawresponse, KKStrawMaterial const& smat, ComboHitCollection const& chcol,
-          Calorimeter const& calo, CCHandle const& cchandle,
+          KKComboHitIndex const* chindex, Calorimeter const& calo, CCHandle const& cchandle,
           KKTRK& kktrk) const;
       // extend the fit to the surfaces specified in the config
       void extendFit(KKTRK& kktrk);
@@ -109,7 +112,7 @@ namespace mu2e {
     private:
       void fillTrackerInfo(Tracker const& tracker) const;
       void addStrawHits(Tracker const& tracker,StrawResponse const& strawresponse, BFieldMap const& kkbf, KKStrawMaterial const& smat,
-          KKTRK const& kktrk, ComboHitCollection const& chcol, KKSTRAWHITCOL& hits) const;
+          KKTRK const& kktrk, ComboHitCollection const& chcol, KKComboHitIndex const* chindex, KKSTRAWHITCOL& hits) const;
       void addStraws(Tracker const& tracker, KKStrawMaterial const& smat, KKTRK const& kktrk, KKSTRAWHITCOL const& addhits, KKSTRAWXINGCOL& addexings) const;
       void addCaloHit(Calorimeter const& calo, KKTRK& kktrk, CCHandle cchandle, KKCALOHITCOL& hits) const;
       void sampleFit(KKTRK const& kktrk,KalIntersectionCollection& inters) const; // sample fit at the surfaces specified in the config
@@ -132,12 +135,13 @@ namespace mu2e {
       // parameters controlling adding hits
       float maxStrawHitDoca_, maxStrawHitDt_, maxStrawDoca_, maxStrawDocaCon_;
       int maxDStraw_; // maximum distance from the track a strawhit can be to consider it for adding.
-      // cached info computed from the tracker, used in hit adding; these must be lazy-evaluated as the tracker doesn't exist on construction
+      // cached info computed from the tracker, used in hit adding; these must be lazy-evaluated as the tracker doesn't exist on construction.
+      // They are filled once, also when tracks are fit concurrently
       mutable double strawradius_;
       mutable double ymin_, ymax_, umax_; // panel-level info
       mutable double rmin_, rmax_; // plane-level info
       mutable double spitch_;
-      mutable bool needstrackerinfo_ = true;
+      mutable std::once_flag trackerinfo_;
 
       double sampletol_; // surface intersection tolerance (mm)
       double sampletbuff_; // simple time buffer; replace this with extrapolation TODO
@@ -263,12 +267,12 @@ namespace mu2e {
 
   template <class KTRAJ> void KKFit<KTRAJ>::extendTrack(Config const& exconfig, BFieldMap const& kkbf, Tracker const& tracker,
       StrawResponse const& strawresponse, KKStrawMaterial const& smat, ComboHitCollection const& chcol,
-      Calorimeter const& calo, CCHandle const& cchandle,
+      KKComboHitIndex const* chindex, Calorimeter const& calo, CCHandle const& cchandle,
       KKTRK& kktrk) const {
     KKSTRAWHITCOL addstrawhits;
     KKCALOHITCOL addcalohits;
     KKSTRAWXINGCOL addstrawxings;
-    if(addhits_)addStrawHits(tracker, strawresponse, kkbf, smat, kktrk, chcol, addstrawhits );
+    if(addhits_)addStrawHits(tracker, strawresponse, kkbf, smat, kktrk, chcol, chindex, addstrawhits );
     if(matcorr_ && addmat_)addStraws(tracker, smat, kktrk, addstrawhits, addstrawxings);
     if(addhits_ && usecalo_ && kktrk.caloHits().size()==0)addCaloHit(calo, kktrk, cchandle, addcalohits);
     if(printLevel_ > 1){
@@ -281,13 +285,25 @@ namespace mu2e {
   }
 
   template <class KTRAJ> void KKFit<KTRAJ>::addStrawHits(Tracker const& tracker,StrawResponse const& strawresponse, BFieldMap const& kkbf, KKStrawMaterial const& smat,
-      KKTRK const& kktrk, ComboHitCollection const& chcol, KKSTRAWHITCOL& addhits) const {
+      KKTRK const& kktrk, ComboHitCollection const& chcol, KKComboHitIndex const* chindex, KKSTRAWHITCOL& addhits) const {
     auto const& ftraj = kktrk.fitTraj();
-    // build the set of existing hits
-    std::set<StrawHitIndex> oldhits;
-    for(auto const& strawhit : kktrk.strawHits())oldhits.insert(strawhit->strawHitIndex());
-    for( size_t ich=0; ich < chcol.size();++ich){
-      if(oldhits.find(ich)==oldhits.end()){      // make sure this hit wasn't already found
+    // build the sorted list of existing hits
+    StrawHitIndexCollection oldhits;
+    oldhits.reserve(kktrk.strawHits().size());
+    for(auto const& strawhit : kktrk.strawHits())oldhits.push_back(strawhit->strawHitIndex());
+    std::sort(oldhits.begin(),oldhits.end());
+    // candidate hits, in collection order: either those the index finds near the track in time, or all of them
+    StrawHitIndexCollection candidates;
+    if(chindex){
+      if(&chindex->comboHits() != &chcol)
+        throw cet::exception("RECO")<<"mu2e::KKFit: ComboHit index doesn't match collection" << std::endl;
+      chindex->candidates(ftraj,maxStrawHitDt_,candidates);
+    } else {
+      candidates.resize(chcol.size());
+      for(size_t ich=0; ich < chcol.size();++ich)candidates[ich] = ich;
+    }
+    for(auto ich : candidates){
+      if(!std::binary_search(oldhits.begin(),oldhits.end(),ich)){      // make sure this hit wasn't already found
         ComboHit const& strawhit = chcol[ich];
         if(strawhit.flag().hasAllProperties(addsel_) && (!strawhit.flag().hasAnyProperty(addrej_))){
           double zt = Mu2eKinKal::zTime(ftraj,strawhit.pos().Z(),strawhit.correctedTime());
@@ -315,7 +331,7 @@ namespace mu2e {
     // build the set of existing straws
     auto const& ftraj = kktrk.fitTraj();
     // pre-compute some tracker info if needed
-    if(needstrackerinfo_)fillTrackerInfo(tracker);
+    std::call_once(trackerinfo_,[this,&tracker](){ fillTrackerInfo(tracker); });
     // list the IDs of existing straws: this speeds the search
     std::set<StrawId> oldstraws;
     for(auto const& strawxing : kktrk.strawXings())oldstraws.insert(strawxing->strawId());
@@ -455,7 +471,6 @@ namespace mu2e {
     rmin_ = innerstraw_origin.y() - maxDStraw_*strawradius_;
     rmax_ = outerstraw.wireEnd(StrawEnd::cal).mag() + maxDStraw_*strawradius_;
     spitch_ = (StrawId::_nstraws-1)/(ymax_-ymin_);
-    needstrackerinfo_= false;
   }
 
 
@@ -47,6 +47,7 @@ namespace mu2e {
       BkgANNSHUSettings bkgshuConfig{ Name("BkgANNSHUSettings"), Comment(BkgANNSHU::configDescription()) };
       using Chi2SHUSettings = fhicl::OptionalSequence<fhicl::Tuple<unsigned,float,float,float,std::string,std::string,std::string,std::string,int>>;
       Chi2SHUSettings combishuConfig{ Name("Chi2SHUSettings"), Comment(Chi2SHU::configDescription()) };
+      fhicl::Atom<bool> chi2shuPrune { Name("Chi2SHUPrune"), Comment("Prune the Chi2SHU hit state combinations that cannot be selected"), false };
       using StrawXingUpdaterSettings = fhicl::Sequence<fhicl::Tuple<float,float,float,bool,int>>;
       StrawXingUpdaterSettings sxuConfig{ Name("StrawXingUpdaterSettings"), Comment(StrawXingUpdater::configDescription()) };
     };
@@ -99,6 +100,9 @@ namespace mu2e {
       fhicl::Sequence<std::string> extrapSurfs { Name("ExtrapolateSurfaces"), Comment("Extrapolate successful fits to these surfaces") };
       fhicl::Atom<float> extrapTol { Name("ExtrapolationTolerance"), Comment("Tolerance on fractional momemtum precision when extrapolating fits") };
       fhicl::Atom<float> extrapMaxDt { Name("ExtrapolationMaxDt"), Comment("Maximum time to extrapolate a fit") };
+      fhicl::Atom<bool> bfieldGrid { Name("DetectorBFieldGrid"), Comment("Copy the field over the tracker and calorimeter onto a grid in detector coordinates at beginRun"), false };
+      fhicl::OptionalSequence<float> bfieldGridRange { Name("DetectorBFieldGridRange"), Comment("Extent of the detector field grid: max |x| and |y|, min z, max z (mm, detector coordinates).  Default is the tracker and calorimeter envelopes") };
+      fhicl::Atom<bool> indexHits { Name("IndexComboHits"), Comment("Find the hits to add when extending a fit with a per-event index by plane and time, instead of testing every hit.  Can miss hits where zTime does not converge"), false };
     };
   }
 }
@@ -148,6 +148,9 @@ namespace mu2e {
       DMAT seedcov_; // seed covariance matrix
       double mass_; // particle mass
       std::unique_ptr<KinKal::BFieldMap> kkbf_;
+      bool usebfgrid_; // cache the field on a grid in detector coordinates
+      std::vector<float> bfgridrange_; // extent of that grid; empty to cover the tracker and calorimeter
+      bool indexhits_; // index the hits of each event when adding hits to extended fits
       Config config_; // initial fit configuration object
       Config exconfig_; // extension configuration object
       bool fixedfield_; //
@@ -168,6 +171,8 @@ namespace mu2e {
     fpart_(static_cast<PDGCode::type>(settings().modSettings().fitParticle())),
     kkfit_(settings().kkfitSettings()),
     kkmat_(settings().matSettings()),
+    usebfgrid_(settings().modSettings().bfieldGrid()),
+    indexhits_(settings().modSettings().indexHits()),
     config_(Mu2eKinKal::makeConfig(settings().fitSettings())),
     exconfig_(Mu2eKinKal::makeConfig(settings().extSettings())),
     fixedfield_(false),
@@ -175,6 +180,7 @@ namespace mu2e {
     seedMom_(settings().modSettings().seedMom()),
     seedCharge_(settings().modSettings().seedCharge())
     {
+      settings().modSettings().bfieldGridRange(bfgridrange_);
       // collection handling
       produces<KKTRKCOL>();
       produces<KalSeedCollection>();
@@ -202,7 +208,14 @@ namespace mu2e {
     if(!fixedfield_){
       GeomHandle<BFieldManager> bfmgr;
       GeomHandle<DetectorSystem> det;
-      kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det));
+      std::shared_ptr<const KKBFieldGrid> bfgrid;
+      if(usebfgrid_){
+        GeomHandle<Tracker> tracker;
+        GeomHandle<Calorimeter> calo;
+        auto range = bfgridrange_.empty() ? KKBFieldGrid::Range(*det,*tracker,*calo) : KKBFieldGrid::Range(bfgridrange_);
+        bfgrid = KKBFieldGrid::shared(*bfmgr,*det,range);
+      }
+      kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det,bfgrid));
     }
     if(print_ > 0) kkbf_->print(std::cout);
   }
@@ -217,6 +230,9 @@ namespace mu2e {
     auto ph_H = event.getValidHandle<ComboHitCollection>(phcol_T_);
     auto cc_H = event.getValidHandle<CaloClusterCollection>(cccol_T_);
     auto const& chcol = *ch_H;
+    // index the hits once for all the fits of this event
+    std::unique_ptr<KKComboHitIndex> chindex;
+    if(indexhits_ && kkfit_.addHits() && exconfig_.schedule().size() > 0) chindex = std::make_unique<KKComboHitIndex>(chcol);
     auto const& phcol = *ph_H;
     // create output
     unique_ptr<KKTRKCOL> kktrkcol(new KKTRKCOL );
@@ -316,7 +332,7 @@ namespace mu2e {
         // if we have an extension schedule, extend.
         if(goodfit && exconfig_.schedule().size() > 0) {
           //  std::cout << "EXTENDING TRACK " << event.id() << " " << index << std::endl;
-          kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
+          kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, chindex.get(), *calo_h, cc_H, *kktrk );
           goodfit = goodFit(*kktrk);
         }
 
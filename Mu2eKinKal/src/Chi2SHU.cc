@@ -5,7 +5,7 @@
 #include <iostream>
 namespace mu2e {
 
-  Chi2SHU::Chi2SHU(Config const& config) {
+  Chi2SHU::Chi2SHU(Config const& config, bool prune) : prune_(prune) {
     csize_ = std::get<0>(config);
     inactivep_ = std::get<1>(config);
     nullp_ = std::get<2>(config);
@@ -25,7 +25,7 @@ namespace mu2e {
       allowed_.emplace_back(WireHitState::left,StrawHitUpdaters::Chi2,kkshflag_);
       allowed_.emplace_back(WireHitState::right,StrawHitUpdaters::Chi2,kkshflag_);
     }
-    if(diag_ > 0)std::cout << "Chi2SHU, inactive penalty " << inactivep_ << " null penalty " << nullp_ << " min dchi2 " << mindchi2_ << " flag " << flag << " allowed states" << allowed << " states to freeze " << freeze_  << " states to unfreeze" << unfreeze_ << std::endl;
+    if(diag_ > 0)std::cout << "Chi2SHU, inactive penalty " << inactivep_ << " null penalty " << nullp_ << " min dchi2 " << mindchi2_ << " flag " << flag << " allowed states" << allowed << " states to freeze " << freeze_  << " states to unfreeze" << unfreeze_ << " prune " << prune_ << std::endl;
   }
 
   // set the state of unambiguous hits to their drift value.
@@ -0,0 +1,126 @@
+#include "Offline/Mu2eKinKal/inc/ClusterStateSearch.hh"
+#include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+#include "cetlib_except/exception.h"
+#include <algorithm>
+#include <limits>
+namespace mu2e {
+  using KinKal::Residual;
+  using KinKal::Chisq;
+
+  ClusterStateSearch::ClusterStateSearch(Parameters const& uparams, Weights const& uweights, WHSCOL const& allowed,
+      double inactivep, double nullp, double varianceScale) :
+    uparams_(uparams), uweights_(uweights), allowed_(allowed),
+    inactivep_(inactivep), nullp_(nullp), varscale_(varianceScale) {}
+
+  void ClusterStateSearch::addHit(DVEC const& refparams, std::vector<RESIDCOL> const& resids) {
+    if(resids.size() != allowed_.size())
+      throw cet::exception("RECO")<<"mu2e::ClusterStateSearch: residuals don't match the allowed states" << std::endl;
+    refparams_.push_back(refparams);
+    resids_.push_back(resids);
+  }
+
+  void ClusterStateSearch::evaluate(size_t ihit, size_t istate) {
+    auto const& prev = levels_[ihit];
+    auto& next = levels_[ihit+1];
+    bool last = ihit+1 == nHits();
+    next.chisq_ = prev.chisq_;
+    next.ndof_ = prev.ndof_;
+    auto const& whstate = allowed_[istate];
+    if(whstate.active()) {
+      auto const& resids = resids_[ihit][istate];
+      // only use distance residual
+      auto const& resid = resids[Mu2eKinKal::dresid];
+      if(resid.active()) {
+        // update residuals to refer to unbiased parameters
+        DVEC dpvec = prev.params_.parameters() - refparams_[ihit];
+        double uresidval = resid.value() - ROOT::Math::Dot(dpvec,resid.dRdP());
+        double pvar = ROOT::Math::Similarity(resid.dRdP(),prev.params_.covariance());
+        if(pvar<0){
+          // another symptom of under-constrained clusters is negative variances.
+          ++nnegvar_;
+          pvar = resid.parameterVariance();
+        }
+        Residual uresid(uresidval,resid.variance(),pvar,resid.active(),resid.dRdP());
+        next.chisq_ += uresid.chisq();
+        ++next.ndof_;
+      }
+      // add null penalty
+      if(whstate == WireHitState::null) next.chisq_ += nullp_;
+      // update the parameters to use for subsequent hits; this isn't necessary for the last hit
+      if(!last){
+        next.weights_ = prev.weights_;
+        for(auto const& resid : resids) {
+          if(resid.active())next.weights_ += resid.weight(prev.params_.parameters(),varscale_);
+        }
+        next.params_ = Parameters(next.weights_);
+      }
+    } else {
+      // add penalty
+      next.chisq_ += inactivep_;
+      ++next.ndof_; // count this as a DOF
+      if(!last){
+        next.weights_ = prev.weights_;
+        next.params_ = prev.params_;
+      }
+    }
+  }
+
+  void ClusterStateSearch::search(ClusterStateCOL& cstates, double mindchi2, bool prune) {
+    npruned_ = nnegvar_ = 0;
+    size_t nhits = nHits();
+    size_t nallowed = allowed_.size();
+    if(nhits == 0 || nallowed == 0)return;
+    levels_.resize(nhits+1);
+    levels_.front().params_ = uparams_;
+    levels_.front().weights_ = uweights_;
+    levels_.front().chisq_ = 0.0;
+    levels_.front().ndof_ = 0;
+    // Pruning relies on every hit adding a non-negative chisquared and at most 1 DOF, so that chisq/(ndof + # of remaining hits)
+    // bounds the chisquared/NDOF of every combination below a partial one.  selectBest needs all the combinations up to the
+    // first (in chisquared/NDOF) whose chisquared exceeds that of the best by mindchi2.  The best chisquared is at most
+    // nhits times the best chisquared/NDOF found so far, so a combination found with a chisquared above that plus mindchi2
+    // is certain to end the merging, and its chisquared/NDOF is a safe threshold.
+    prune &= mindchi2 > 0.0 && inactivep_ >= 0.0 && nullp_ >= 0.0;
+    double bestcpn = std::numeric_limits<double>::max();
+    double threshold = std::numeric_limits<double>::max();
+    // leaves below each hit, to count the pruned combinations
+    std::vector<size_t> nleaves(nhits,1);
+    for(size_t ihit = nhits-1; ihit > 0; --ihit) nleaves[ihit-1] = nleaves[ihit]*nallowed;
+    std::vector<size_t> istates(nhits,0);
+    WHSCOL current(nhits,allowed_.front());
+    size_t ihit(0); // first hit to (re)evaluate
+    while(true){
+      // evaluate the hits from the first one that changed
+      bool pruned(false);
+      for(;ihit < nhits; ++ihit){
+        current[ihit] = allowed_[istates[ihit]];
+        evaluate(ihit,istates[ihit]);
+        if(prune){
+          auto const& level = levels_[ihit+1];
+          unsigned maxndof = level.ndof_ + nhits - ihit - 1;
+          if(maxndof > 0 && level.chisq_/maxndof > threshold){
+            npruned_ += nleaves[ihit];
+            pruned = true;
+            break;
+          }
+        }
+      }
+      if(!pruned){
+        auto const& level = levels_.back();
+        cstates.emplace_back(Chisq(level.chisq_,level.ndof_),current);
+        if(prune && level.ndof_ > 0){
+          double cpn = level.chisq_/level.ndof_;
+          bestcpn = std::min(bestcpn,cpn);
+          if(level.chisq_ >= bestcpn*nhits + mindchi2) threshold = std::min(threshold,cpn);
+        }
+        ihit = nhits-1;
+      }
+      // advance to the next combination; the states of the hits after ihit are already reset
+      while(++istates[ihit] == nallowed){
+        istates[ihit] = 0;
+        if(ihit == 0)return;
+        --ihit;
+      }
+    }
+  }
+}
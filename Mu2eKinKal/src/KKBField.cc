@@ -5,10 +5,11 @@ namespace mu2e {
   using SVEC3 = KinKal::SVEC3;
 
   VEC3 KKBField::fieldVect(VEC3 const& position) const {
-    // change coordinates to mu2e; the map should be native in detector coordinates FIXME!
     CLHEP::Hep3Vector vpoint(position.x(),position.y(),position.z());
-    CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
     CLHEP::Hep3Vector field;
+    if(grid_ && grid_->field(vpoint,field))return VEC3(field);
+    // outside the detector grid: change coordinates to mu2e and search the maps
+    CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
     //    = bfmgr_.getBField(vpoint_mu2e);
     if(bfmgr_.getBFieldWithStatus(vpoint_mu2e,field))
       return VEC3(field);
@@ -21,27 +22,44 @@ namespace mu2e {
       throw cet::exception("RECO")<<"mu2e::KKBfield: out-of-range access point "<< vpoint_mu2e << endl;
   }
 
+  // field and its derivatives dB/dx_j (tesla/mm) from the same interpolation stencil
+  VEC3 KKBField::fieldAndGrad(VEC3 const& position, CLHEP::Hep3Vector gradient[3]) const {
+    CLHEP::Hep3Vector vpoint(position.x(),position.y(),position.z());
+    CLHEP::Hep3Vector field;
+    if(grid_ && grid_->field(vpoint,field,gradient))return VEC3(field);
+    // the translation to mu2e coordinates does not change the derivatives
+    CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
+    if(bfmgr_.getBFieldAndGradientWithStatus(vpoint_mu2e,field,gradient))
+      return VEC3(field);
+    else
+      if(bfmgr_.getInnerMaps().size() == 0){
+        static const VEC3 nullfield(0.0,0.0,0.0);
+        return nullfield;
+      } else
+        throw cet::exception("RECO")<<"mu2e::KKBfield: out-of-range access point "<< vpoint_mu2e << endl;
+  }
+
   Grad KKBField::fieldGrad(VEC3 const& position) const {
     Grad retval;
-    auto dBdx = fieldDeriv(position,VEC3(1.0,0.0,0.0));
-    auto dBdy = fieldDeriv(position,VEC3(0.0,1.0,0.0));
-    auto dBdz = fieldDeriv(position,VEC3(0.0,0.0,1.0));
-    SVEC3 dBdxv(dBdx.X(),dBdx.Y(), dBdx.Z());
-    SVEC3 dBdyv(dBdy.X(),dBdy.Y(), dBdy.Z());
-    SVEC3 dBdzv(dBdz.X(),dBdz.Y(), dBdz.Z());
-    retval.Place_in_row(dBdxv,0,0);
-    retval.Place_in_row(dBdyv,1,0);
-    retval.Place_in_row(dBdzv,2,0);
+    CLHEP::Hep3Vector gradient[3];
+    fieldAndGrad(position,gradient);
+    for(unsigned irow=0;irow<3;++irow){
+      SVEC3 dBdxv(gradient[irow].x(),gradient[irow].y(),gradient[irow].z());
+      retval.Place_in_row(dBdxv,irow,0);
+    }
     return retval;
   }
-  // numerical derivatives for now: TODO!
+
   VEC3 KKBField::fieldDeriv(VEC3 const& position, VEC3 const& velocity) const {
-    static double dt(0.1); // 100 psec, ~3cm.  this is arbitrary and should be set according to the field sampling TODO
-    VEC3 start = fieldVect(position);
-    VEC3 end = fieldVect(position + velocity*dt);
-    return (end-start)/dt;
+    CLHEP::Hep3Vector gradient[3];
+    fieldAndGrad(position,gradient);
+    CLHEP::Hep3Vector dBdt = velocity.x()*gradient[0] + velocity.y()*gradient[1] + velocity.z()*gradient[2];
+    return VEC3(dBdt);
   }
+
   bool KKBField::inRange(VEC3 const& position) const {
+    // the detector grid lies inside a single map
+    if(grid_ && grid_->inRange(position.x(),position.y(),position.z()))return true;
     // clumsy conversion to CLHEP
     CLHEP::Hep3Vector vpoint(position.x(),position.y(),position.z());
     CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
@@ -58,6 +76,7 @@ namespace mu2e {
   void KKBField::print(std::ostream& os) const {
     os << "KKBField based on ";
     bfmgr_.print(os);
+    if(grid_) grid_->print(os);
   }
 
 }
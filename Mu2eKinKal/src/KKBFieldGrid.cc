@@ -0,0 +1,108 @@
+#include "Offline/Mu2eKinKal/inc/KKBFieldGrid.hh"
+#include "cetlib_except/exception.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+namespace mu2e {
+
+  KKBFieldGrid::Range::Range(std::vector<float> const& range) {
+    if(range.size() != 3 || range[0] <= 0.0 || range[1] >= range[2])
+      throw cet::exception("RECO")<<"mu2e::KKBFieldGrid: range must be (rmax, zmin, zmax)\n";
+    rmax_ = range[0]; zmin_ = range[1]; zmax_ = range[2];
+  }
+
+  KKBFieldGrid::Range::Range(DetectorSystem const& det, Tracker const& tracker, Calorimeter const& calo) {
+    // the tracker mother is placed in mu2e coordinates, as are the calorimeter envelope z limits
+    auto const& mother = tracker.g4Tracker()->mother();
+    auto const& caloinfo = calo.caloInfo();
+    rmax_ = std::max(mother.tubsParams().outerRadius(),caloinfo.getDouble("envelopeRadiusOut"));
+    zmin_ = det.toDetector(mother.position() - CLHEP::Hep3Vector(0.0,0.0,mother.tubsParams().zHalfLength())).z();
+    zmax_ = det.toDetector(CLHEP::Hep3Vector(mother.position().x(),mother.position().y(),caloinfo.getDouble("envelopeZ1"))).z();
+  }
+
+  namespace {
+    // nodes k of one axis of the source map (at min + k*step, mu2e coordinates) covering the interval [lo,hi],
+    // clipped to the nodes kmin..kmax the map can interpolate from.  Returns the number of nodes
+    int axisNodes(double lo, double hi, double min, double step, int kmin, int kmax, int& kfirst) {
+      int klo = std::max(int(std::floor((lo-min)/step)),kmin);
+      int khi = std::min(int(std::ceil((hi-min)/step)),kmax);
+      kfirst = klo;
+      return std::max(khi-klo+1,0);
+    }
+  }
+
+  KKBFieldGrid::KKBFieldGrid(BFieldManager const& bfmgr, DetectorSystem const& det, BFGridMap const& source, Range const& range) :
+    source_(source.getKey()) {
+    auto const& origin = det.getOrigin();
+    // stop one node short of the upper edge so every node has a full cell above it.
+    // Reflected maps start at y=0 and also cover the negative y nodes.
+    int nymin = source.flipy() && source.ymin() == 0.0 ? 2-source.ny() : 0;
+    int ix, iy, iz;
+    int nx = axisNodes(origin.x()-range.rmax_, origin.x()+range.rmax_, source.xmin(), source.dx(), 0, source.nx()-2, ix);
+    int ny = axisNodes(origin.y()-range.rmax_, origin.y()+range.rmax_, source.ymin(), source.dy(), nymin, source.ny()-2, iy);
+    int nz = axisNodes(origin.z()+range.zmin_, origin.z()+range.zmax_, source.zmin(), source.dz(), 0, source.nz()-2, iz);
+    if(nx < 2 || ny < 2 || nz < 2)
+      throw cet::exception("RECO")<<"mu2e::KKBFieldGrid: map " << source_ << " does not cover the requested range\n";
+    CLHEP::Hep3Vector first(source.xmin() + ix*source.dx(), source.ymin() + iy*source.dy(), source.zmin() + iz*source.dz());
+    lo_ = det.toDetector(first);
+    hi_ = lo_ + CLHEP::Hep3Vector((nx-1)*source.dx(), (ny-1)*source.dy(), (nz-1)*source.dz());
+    grid_ = BFCompactGrid(nx, lo_.x(), source.dx(), ny, lo_.y(), source.dy(), nz, lo_.z(), source.dz(), false);
+    // sample through the manager, so that overlaps are resolved as in the direct lookup
+    CLHEP::Hep3Vector bfield;
+    for(int jx=0; jx < nx; ++jx){
+      for(int jy=0; jy < ny; ++jy){
+        for(int jz=0; jz < nz; ++jz){
+          CLHEP::Hep3Vector node(first.x() + jx*source.dx(), first.y() + jy*source.dy(), first.z() + jz*source.dz());
+          if(!bfmgr.getBFieldWithStatus(node,bfield))
+            throw cet::exception("RECO")<<"mu2e::KKBFieldGrid: no field at node "<< node << "\n";
+          grid_.set(jx,jy,jz,bfield);
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<const KKBFieldGrid> KKBFieldGrid::shared(BFieldManager const& bfmgr, DetectorSystem const& det, Range const& range) {
+    // the grid nodes come from the first inner map covering the detector origin, the map the manager would use there
+    std::shared_ptr<const BFGridMap> source;
+    for(auto const& bfmap : bfmgr.getInnerMaps()){
+      if(bfmap->isValid(det.getOrigin())){
+        source = std::dynamic_pointer_cast<const BFGridMap>(bfmap);
+        break;
+      }
+    }
+    if(!source)return std::shared_ptr<const KKBFieldGrid>();
+    // grids already built in this job.  The weak pointer to the source map expires when the geometry is rebuilt
+    struct Entry {
+      std::weak_ptr<const BFGridMap> source_;
+      CLHEP::Hep3Vector origin_;
+      Range range_;
+      std::weak_ptr<const KKBFieldGrid> grid_;
+    };
+    static std::mutex mutex;
+    static std::vector<Entry> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const KKBFieldGrid> retval;
+    for(auto ientry = cache.begin(); ientry != cache.end(); ){
+      auto grid = ientry->grid_.lock();
+      auto map = ientry->source_.lock();
+      if(!grid || !map){
+        ientry = cache.erase(ientry);
+        continue;
+      }
+      if(map == source && ientry->origin_ == det.getOrigin() && ientry->range_ == range) retval = grid;
+      ++ientry;
+    }
+    if(!retval){
+      retval = std::shared_ptr<const KKBFieldGrid>(new KKBFieldGrid(bfmgr,det,*source,range));
+      cache.push_back(Entry{source,det.getOrigin(),range,retval});
+    }
+    return retval;
+  }
+
+  void KKBFieldGrid::print(std::ostream& os) const {
+    os << "KKBFieldGrid from map " << source_ << " in detector coordinates, x " << lo_.x() << " to " << hi_.x()
+      << " y " << lo_.y() << " to " << hi_.y() << " z " << lo_.z() << " to " << hi_.z() << " mm, "
+      << grid_.nx() << "x" << grid_.ny() << "x" << grid_.nz() << " nodes, " << grid_.memorySize() << " bytes" << std::endl;
+  }
+
+}
@@ -0,0 +1,36 @@
+#include "Offline/Mu2eKinKal/inc/KKComboHitIndex.hh"
+#include "Offline/DataProducts/inc/StrawId.hh"
+#include "cetlib_except/exception.h"
+namespace mu2e {
+
+  KKComboHitIndex::KKComboHitIndex(ComboHitCollection const& chcol) : chcol_(&chcol),
+    first_(StrawId::_nplanes+1,0), zmin_(StrawId::_nplanes,std::numeric_limits<float>::max()), zmax_(StrawId::_nplanes,std::numeric_limits<float>::lowest()) {
+    // count the hits in each plane, then fill the entries plane by plane
+    for(auto const& ch : chcol){
+      auto plane = ch.strawId().plane();
+      if(!StrawId::validPlane(plane))
+        throw cet::exception("RECO")<<"mu2e::KKComboHitIndex: invalid plane " << plane << "\n";
+      ++first_[plane+1];
+      zmin_[plane] = std::min(zmin_[plane],ch.pos().Z());
+      zmax_[plane] = std::max(zmax_[plane],ch.pos().Z());
+    }
+    for(size_t iplane=0; iplane < StrawId::_nplanes; ++iplane) first_[iplane+1] += first_[iplane];
+    entries_.resize(chcol.size());
+    std::vector<size_t> next(first_.begin(),first_.end()-1);
+    for(size_t ich=0; ich < chcol.size(); ++ich){
+      auto const& ch = chcol[ich];
+      entries_[next[ch.strawId().plane()]++] = Entry{ch.correctedTime(),static_cast<StrawHitIndex>(ich)};
+    }
+    auto bytime = [](Entry const& a, Entry const& b) { return a.time_ < b.time_; };
+    for(size_t iplane=0; iplane < StrawId::_nplanes; ++iplane)
+      std::sort(entries_.begin()+first_[iplane],entries_.begin()+first_[iplane+1],bytime);
+  }
+
+  void KKComboHitIndex::hits(unsigned plane, double tmin, double tmax, std::vector<StrawHitIndex>& hits) const {
+    auto begin = entries_.begin()+first_[plane];
+    auto end = entries_.begin()+first_[plane+1];
+    auto ient = std::lower_bound(begin,end,tmin,[](Entry const& entry, double time) { return entry.time_ < time; });
+    for(; ient != end && ient->time_ <= tmax; ++ient) hits.push_back(ient->index_);
+  }
+
+}
@@ -50,7 +50,7 @@ namespace mu2e {
           } else if(alg == StrawHitUpdaters::BkgANN) {
             miconfig.addUpdater(std::any(BkgANNSHU(bkgannshusettings.at(nbkg++))));
           } else if(alg == StrawHitUpdaters::Chi2) {
-            miconfig.addUpdater(std::any(Chi2SHU(chi2shusettings.at(ncomb++))));
+            miconfig.addUpdater(std::any(Chi2SHU(chi2shusettings.at(ncomb++),fitconfig.chi2shuPrune())));
           } else if(alg == StrawHitUpdaters::none) {
             ++nnone;
           } else {
@@ -143,6 +143,9 @@ namespace mu2e {
     double mass_; // particle mass
     int charge_; // particle charge
     std::unique_ptr<KKBField> kkbf_;
+    bool usebfgrid_; // cache the field on a grid in detector coordinates
+    std::vector<float> bfgridrange_; // extent of that grid; empty to cover the tracker and calorimeter
+    bool indexhits_; // index the hits of each event when adding hits to extended fits
     Config config_; // initial fit configuration object
     Config exconfig_; // extension configuration object
   };
@@ -157,9 +160,12 @@ namespace mu2e {
     fpart_(static_cast<PDGCode::type>(settings().modSettings().fitParticle())),
     kkfit_(settings().mu2eSettings()),
     kkmat_(settings().matSettings()),
+    usebfgrid_(settings().modSettings().bfieldGrid()),
+    indexhits_(settings().modSettings().indexHits()),
     config_(Mu2eKinKal::makeConfig(settings().fitSettings())),
     exconfig_(Mu2eKinKal::makeConfig(settings().extSettings()))
     {
+      settings().modSettings().bfieldGridRange(bfgridrange_);
       // collection handling
       for(const auto& seedtag : settings().modSettings().seedCollections()) { seedCols_.emplace_back(consumes<CosmicTrackSeedCollection>(seedtag)); }
       produces<KKTRKCOL>();
@@ -197,7 +203,14 @@ namespace mu2e {
     // create KKBField
     GeomHandle<BFieldManager> bfmgr;
     GeomHandle<DetectorSystem> det;
-    kkbf_ = std::make_unique<KKBField>(*bfmgr,*det);
+    std::shared_ptr<const KKBFieldGrid> bfgrid;
+    if(usebfgrid_){
+      GeomHandle<Tracker> tracker;
+      GeomHandle<Calorimeter> calo;
+      auto range = bfgridrange_.empty() ? KKBFieldGrid::Range(*det,*tracker,*calo) : KKBFieldGrid::Range(bfgridrange_);
+      bfgrid = KKBFieldGrid::shared(*bfmgr,*det,range);
+    }
+    kkbf_ = std::make_unique<KKBField>(*bfmgr,*det,bfgrid);
   }
 
   void KinematicLineFit::produce(art::Event& event ) {
@@ -209,6 +222,9 @@ namespace mu2e {
     auto ch_H = event.getValidHandle<ComboHitCollection>(chcol_T_);
     auto cc_H = event.getValidHandle<CaloClusterCollection>(cccol_T_);
     auto const& chcol = *ch_H;
+    // index the hits once for all the fits of this event
+    std::unique_ptr<KKComboHitIndex> chindex;
+    if(indexhits_ && kkfit_.addHits() && exconfig_.schedule().size() > 0) chindex = std::make_unique<KKComboHitIndex>(chcol);
     // create output
     unique_ptr<KKTRKCOL> kktrkcol(new KKTRKCOL );
     unique_ptr<KalSeedCollection> kkseedcol(new KalSeedCollection ); //Needs to return a KalSeed
@@ -262,7 +278,7 @@ namespace mu2e {
           auto kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,fpart_,kkfit_.strawHitClusterer(),strawhits,strawxings,calohits,paramconstraints_);
           auto goodfit = goodFit(*kktrk);
           if(goodfit && exconfig_.schedule().size() > 0){
-            kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
+            kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, chindex.get(), *calo_h, cc_H, *kktrk );
           }
           bool save = goodFit(*kktrk);
           if(save || saveall_){
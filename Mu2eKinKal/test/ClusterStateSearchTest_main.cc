@@ -0,0 +1,199 @@
+//
+// Test of ClusterStateSearch on made up clusters of straw hits.  For each cluster the
+// chisquared of every state combination is computed by the exhaustive loop Chi2SHU used
+// before (each combination from scratch, in WHSIterator order) and by ClusterStateSearch,
+// and checked to be identical.  The best state and quality chosen by Chi2SHU::selectBest
+// with pruning are checked against those without.  The time per cluster is printed for each
+// cluster size.
+//
+// arguments are
+// NCLUSTER: optional, number of clusters per cluster size (default 200)
+// MAXSIZE:  optional, largest cluster size (default 8)
+//
+// example:
+// ClusterStateSearchTest 1000 10
+//
+#include "Offline/Mu2eKinKal/inc/ClusterStateSearch.hh"
+#include "Offline/Mu2eKinKal/inc/Chi2SHU.hh"
+#include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+#include "Offline/Mu2eKinKal/inc/WHSIterator.hh"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+using KinKal::DMAT;
+using KinKal::Residual;
+
+namespace {
+
+  const double inactivep(1.0), nullp(0.5), mindchi2(1.0), varscale(1.0);
+  const size_t npar = DVEC::kSize;
+
+  struct Cluster {
+    Parameters uparams;
+    Weights uweights;
+    std::vector<DVEC> refparams;
+    std::vector<std::vector<RESIDCOL>> resids;
+  };
+
+  DVEC randomVector(std::mt19937& gen, double scale) {
+    std::normal_distribution<double> norm(0.0,scale);
+    DVEC vec;
+    for(size_t ipar=0;ipar<npar;++ipar) vec[ipar] = norm(gen);
+    return vec;
+  }
+
+  // hits of a track crossing neighboring straws: the drift residuals of the right ambiguity are small,
+  // those of the wrong ambiguity and of the null state are of the order of the drift radius
+  Cluster makeCluster(std::mt19937& gen, size_t nhits, WHSCOL const& allowed) {
+    std::uniform_real_distribution<double> flat(0.0,1.0);
+    std::normal_distribution<double> norm(0.0,1.0);
+    Cluster cluster;
+    // diagonally dominant, so positive-definite, covariance
+    DMAT cov;
+    for(size_t ipar=0;ipar<npar;++ipar){
+      cov(ipar,ipar) = 1.0 + flat(gen);
+      for(size_t jpar=0;jpar<ipar;++jpar) cov(ipar,jpar) = 0.1*(2.0*flat(gen)-1.0);
+    }
+    cluster.uparams = Parameters(randomVector(gen,1.0),cov);
+    cluster.uweights = Weights(cluster.uparams);
+    for(size_t ihit=0;ihit<nhits;++ihit){
+      cluster.refparams.push_back(cluster.uparams.parameters() + randomVector(gen,0.1));
+      double rdrift = 2.5*flat(gen);
+      double lr = flat(gen) < 0.5 ? -1.0 : 1.0;
+      DVEC dRdP = randomVector(gen,0.3);
+      std::vector<RESIDCOL> resids(allowed.size());
+      for(size_t istate=0;istate<allowed.size();++istate){
+        auto const& whs = allowed[istate];
+        if(!whs.active())continue;
+        double dval = whs == WireHitState::null ? rdrift : (whs.lrSign()*lr < 0 ? 2.0*rdrift : 0.0);
+        double dvar = whs == WireHitState::null ? 1.5 : 0.01;
+        resids[istate][Mu2eKinKal::dresid] = Residual(dval + 0.1*norm(gen),dvar,0.0,true,dRdP);
+        resids[istate][Mu2eKinKal::tresid] = Residual(norm(gen),4.0,0.0,flat(gen) < 0.5,randomVector(gen,0.1));
+      }
+      cluster.resids.push_back(resids);
+    }
+    return cluster;
+  }
+
+  // the exhaustive search used before: every combination from the unbiased parameters
+  void exhaustive(Cluster const& cluster, WHSCOL const& allowed, ClusterStateCOL& cstates) {
+    size_t nhits = cluster.refparams.size();
+    WHSIterator whsiter(nhits,allowed);
+    do {
+      auto cparams = cluster.uparams;
+      auto cweights = cluster.uweights;
+      double chisq(0.0);
+      unsigned ndof(0);
+      for(size_t ihit=0;ihit < nhits; ++ihit) {
+        auto const& whstate = whsiter.current()[ihit];
+        if(whstate.active()) {
+          size_t istate(0);
+          while(!(allowed[istate] == whstate))++istate;
+          auto const& resids = cluster.resids[ihit][istate];
+          DVEC dpvec = cparams.parameters() - cluster.refparams[ihit];
+          auto const& resid = resids[Mu2eKinKal::dresid];
+          if(resid.active()) {
+            double uresidval = resid.value() - ROOT::Math::Dot(dpvec,resid.dRdP());
+            double pvar = ROOT::Math::Similarity(resid.dRdP(),cparams.covariance());
+            if(pvar<0) pvar = resid.parameterVariance();
+            Residual uresid(uresidval,resid.variance(),pvar,resid.active(),resid.dRdP());
+            chisq += uresid.chisq();
+            ++ndof;
+          }
+          if(whstate == WireHitState::null) chisq += nullp;
+          if(ihit+1 < nhits){
+            for(auto resid : resids) {
+              if(resid.active())cweights +=  resid.weight(cparams.parameters(),varscale);
+            }
+            cparams = Parameters(cweights);
+          }
+        } else {
+          chisq += inactivep;
+          ++ndof;
+        }
+      }
+      cstates.emplace_back(Chisq(chisq,ndof),whsiter.current());
+    } while(whsiter.increment());
+  }
+
+  bool sameStates(WHSCOL const& a, WHSCOL const& b) {
+    if(a.size() != b.size())return false;
+    for(size_t ihit=0;ihit<a.size();++ihit) if(a[ihit] != b[ihit]) return false;
+    return true;
+  }
+}
+
+int main(int argc, char** argv) {
+  int nCluster = argc > 1 ? std::stoi(argv[1]) : 200;
+  size_t maxSize = argc > 2 ? std::stoul(argv[2]) : 8;
+
+  Chi2SHU chi2shu(Chi2SHU::Config(2,inactivep,nullp,mindchi2,"TOT","Inactive:Null:Drift","","",0));
+  WHSCOL allowed;
+  allowed.emplace_back(WireHitState::inactive,StrawHitUpdaters::Chi2,KKSHFlag("TOT"));
+  allowed.emplace_back(WireHitState::null,StrawHitUpdaters::Chi2,KKSHFlag("TOT"));
+  allowed.emplace_back(WireHitState::left,StrawHitUpdaters::Chi2,KKSHFlag("TOT"));
+  allowed.emplace_back(WireHitState::right,StrawHitUpdaters::Chi2,KKSHFlag("TOT"));
+
+  std::mt19937 gen(13579);
+  std::cout << "ClusterStateSearchTest mean time per cluster in ms, " << nCluster << " clusters per size" << std::endl;
+  std::cout << std::setw(6) << "hits" << std::setw(10) << "states" << std::setw(14) << "exhaustive"
+    << std::setw(14) << "incremental" << std::setw(10) << "pruned" << std::setw(12) << "% pruned" << std::endl;
+
+  int nBad(0);
+  for(size_t nhits=2; nhits<=maxSize; ++nhits){
+    double tOld(0), tNew(0), tPrune(0), fPruned(0);
+    size_t nstates(0);
+    for(int icluster=0;icluster<nCluster;++icluster){
+      Cluster cluster = makeCluster(gen,nhits,allowed);
+      ClusterStateCOL oldstates, newstates, prunedstates;
+      auto t0 = std::chrono::high_resolution_clock::now();
+      exhaustive(cluster,allowed,oldstates);
+      auto t1 = std::chrono::high_resolution_clock::now();
+      ClusterStateSearch search(cluster.uparams,cluster.uweights,allowed,inactivep,nullp,varscale);
+      for(size_t ihit=0;ihit<nhits;++ihit) search.addHit(cluster.refparams[ihit],cluster.resids[ihit]);
+      search.search(newstates);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      ClusterStateSearch psearch(cluster.uparams,cluster.uweights,allowed,inactivep,nullp,varscale);
+      for(size_t ihit=0;ihit<nhits;++ihit) psearch.addHit(cluster.refparams[ihit],cluster.resids[ihit]);
+      psearch.search(prunedstates,mindchi2,true);
+      auto t3 = std::chrono::high_resolution_clock::now();
+      tOld += std::chrono::duration<double>(t1-t0).count();
+      tNew += std::chrono::duration<double>(t2-t1).count();
+      tPrune += std::chrono::duration<double>(t3-t2).count();
+      nstates = oldstates.size();
+      fPruned += double(psearch.nPruned())/nstates;
+
+      // every combination, in the same order, with the same chisquared
+      bool same = newstates.size() == nstates && search.nPruned() == 0 && prunedstates.size() + psearch.nPruned() == nstates;
+      for(size_t istate=0;same && istate<nstates;++istate){
+        same = oldstates[istate].chi2_.chisq() == newstates[istate].chi2_.chisq()
+          && oldstates[istate].chi2_.nDOF() == newstates[istate].chi2_.nDOF()
+          && sameStates(oldstates[istate].hitstates_,newstates[istate].hitstates_);
+      }
+      // the same selection with pruning
+      if(same){
+        auto best = chi2shu.selectBest(oldstates);
+        auto pbest = chi2shu.selectBest(prunedstates);
+        same = sameStates(best.hitstates_,pbest.hitstates_)
+          && best.hitstates_.front().quality_[WireHitState::chi2] == pbest.hitstates_.front().quality_[WireHitState::chi2];
+      }
+      if(!same)++nBad;
+    }
+    std::cout << std::setw(6) << nhits << std::setw(10) << nstates << std::fixed << std::setprecision(4)
+      << std::setw(14) << 1e3*tOld/nCluster << std::setw(14) << 1e3*tNew/nCluster << std::setw(10) << 1e3*tPrune/nCluster
+      << std::setw(12) << std::setprecision(1) << 100.0*fPruned/nCluster << std::defaultfloat << std::endl;
+  }
+
+  if(nBad > 0){
+    std::cout << "ClusterStateSearchTest FAILED " << nBad << " clusters with different results" << std::endl;
+    return 1;
+  }
+  std::cout << "ClusterStateSearchTest passed" << std::endl;
+  return 0;
+}
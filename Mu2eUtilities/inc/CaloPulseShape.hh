@@ -14,6 +14,8 @@
 //
 // 1) digitizedPulse(hitTime) returns a waveform with hitTime corresponding to low edge of first bin
 // 2) evaluate(deltaTime) return value of digitized bin at a given time difference with peak time value
+// 3) the digitized pulse depends on the hit time only through its phase, the sub-sample step of the hit
+//    time within the digitization bin, phase(hitTime) in [0,nPhase())
 //
 //  NOTE: uncomment the pline creation if the discontinuities in the second order derivative arising from the
 //        linear piecewise approxmiation are problematic for the minimization
@@ -31,6 +33,8 @@ namespace mu2e {
           void buildShapes();
 
           const std::vector<double>& digitizedPulse  (double hitTime)        const;
+          int                        phase           (double hitTime)        const {return int(hitTime/digiStep_)%nSteps_;}
+          int                        nPhase          ()                      const {return nSteps_;}
           double                     evaluate        (double timeDifference) const;
           double                     fromPeakToT0    (double timePeak)       const;
           void                       diag            (bool fullDiag=false)   const;
@@ -0,0 +1,80 @@
+#ifndef Mu2eUtilities_CounterRandomEngine_hh
+#define Mu2eUtilities_CounterRandomEngine_hh
+//
+// Counter based random engine: the n'th number of a stream is a function of
+// (key, stream, n) only, computed with the Philox4x32-10 bijection of
+// Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11.
+//
+// Any number of independent streams can be created for the same key, in any
+// order and on any thread, with no state shared between them.  This allows
+// work to be split into pieces (for instance the straws of an event), each
+// with its own stream, so that the results do not depend on how the pieces
+// are scheduled.
+//
+// The key is normally made from the event id and a seed from the
+// SeedService, see eventKey().
+//
+
+#include "Offline/SeedService/inc/SeedService.hh"
+
+#include "canvas/Persistency/Provenance/EventID.h"
+#include "CLHEP/Random/RandomEngine.h"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace mu2e {
+
+  class CounterRandomEngine : public CLHEP::HepRandomEngine {
+
+  public:
+
+    CounterRandomEngine( std::uint64_t key, std::uint64_t stream );
+
+    // Key for the streams of an event: a function of the event id and the salt.
+    static std::uint64_t eventKey( art::EventID const& id, SeedService::seed_t salt );
+
+    // Restart at the first number of a stream.
+    void setStream( std::uint64_t stream );
+
+    std::uint64_t key()    const { return key_;    }
+    std::uint64_t stream() const { return stream_; }
+
+    // Uniform in (0,1), with 53 random bits.
+    double flat() override;
+    void flatArray( const int size, double* vect ) override;
+
+    // The first seed is the key; the stream is restarted at 0.
+    void setSeed( long seed, int ) override;
+    void setSeeds( const long* seeds, int ) override;
+
+    void saveStatus( const char filename[] = "CounterRandomEngine.conf" ) const override;
+    void restoreStatus( const char filename[] = "CounterRandomEngine.conf" ) override;
+    void showStatus() const override;
+
+    std::string name() const override { return "CounterRandomEngine"; }
+
+    std::ostream& put( std::ostream& os ) const override;
+    std::istream& get( std::istream& is ) override;
+
+    // The Philox4x32-10 function itself.
+    typedef std::array<std::uint32_t,4> Block;
+    static Block philox( Block counter, std::array<std::uint32_t,2> key );
+
+  private:
+
+    void fill();
+
+    std::uint64_t key_;
+    std::uint64_t stream_;
+    std::uint64_t counter_;  // next block of the stream
+    Block         block_;    // last block computed
+    unsigned      next_;     // next unused 64 bit word of block_: 0, 1 or 2 (none left)
+
+  };
+
+} // namespace mu2e
+
+#endif
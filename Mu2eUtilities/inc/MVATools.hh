@@ -8,6 +8,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/dom/DOMDocument.hpp>
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -30,8 +31,13 @@ namespace mu2e
        virtual ~MVATools();
        xercesc::DOMDocument* getXmlDoc();
        void     initMVA();
+       // evaluation is reentrant: one instance can be shared between threads
        float    evalMVA(const std::vector<float>&,  const MVAMask& vmask=0xffffffff) const;
        float    evalMVA(const std::vector<double>&, const MVAMask& vmask=0xffffffff) const;
+       // evaluate nrows feature rows of nvars values each, stored row after row; results has nrows entries.
+       // Gives the same values as evaluating the rows one at a time.
+       void     evalMVA(std::size_t nrows, std::size_t nvars, const float* rows, float* results,
+                        const MVAMask& vmask=0xffffffff) const;
        void     showMVA() const;
 
        const std::vector<std::string>& titles() const { return title_;}
@@ -46,10 +52,9 @@ namespace mu2e
        void   getNorm(xercesc::DOMDocument* xmlDoc);
        void   getWgts(xercesc::DOMDocument* xmlDoc);
        float  activation(float arg) const;
+       unsigned nInputs(std::size_t nvars, const MVAMask& mask) const;
+       template <class T> float evalRow(const T* v, std::size_t nvars, const MVAMask& mask) const;
 
-       mutable std::vector<float> x_;
-       mutable std::vector<float> y_;
-       mutable std::vector<float> fv_;
        std::vector<float>         wgts_;
        std::vector<unsigned>      links_;
        unsigned                   maxNeurons_;
@@ -58,7 +58,7 @@ namespace mu2e {
    // forward shift in waveform = backward shift in time origin
    const std::vector<double>& CaloPulseShape::digitizedPulse(double hitTime) const
    {
-       int shiftBin = nSteps_ - int(hitTime/digiStep_)%nSteps_;
+       int shiftBin = nSteps_ - phase(hitTime);
        for (int i=0;i<nBinShape_;++i) digitizedPulse_[i] = pulseVec_[shiftBin+i*nSteps_];
        return digitizedPulse_;
    }
@@ -0,0 +1,158 @@
+//
+// Counter based random engine using Philox4x32-10.
+//
+// Each block of 4 32 bit words is the Philox function of the counter
+// (block number, stream) and the key; it gives two 64 bit words, each of
+// which makes one double.
+//
+
+#include "Offline/Mu2eUtilities/inc/CounterRandomEngine.hh"
+#include "cetlib_except/exception.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace mu2e {
+
+  namespace {
+
+    const std::uint32_t philoxM0 = 0xD2511F53;
+    const std::uint32_t philoxM1 = 0xCD9E8D57;
+    const std::uint32_t philoxW0 = 0x9E3779B9;
+    const std::uint32_t philoxW1 = 0xBB67AE85;
+
+    inline std::uint32_t lo32( std::uint64_t x ) { return static_cast<std::uint32_t>(x); }
+    inline std::uint32_t hi32( std::uint64_t x ) { return static_cast<std::uint32_t>(x >> 32); }
+
+    // Map 64 random bits to (0,1), never returning either end.
+    inline double toDouble( std::uint64_t x ){
+      return ( static_cast<double>(x >> 11) + 0.5 ) * 0x1.0p-53;
+    }
+
+  }
+
+  CounterRandomEngine::CounterRandomEngine( std::uint64_t key, std::uint64_t stream )
+    :key_(key)
+    ,stream_(stream)
+    ,counter_(0)
+    ,block_{}
+    ,next_(2)
+  {
+    theSeed = static_cast<long>(key_);
+  }
+
+  std::uint64_t CounterRandomEngine::eventKey( art::EventID const& id, SeedService::seed_t salt ){
+    const std::uint64_t s = static_cast<std::uint64_t>(salt);
+    Block b = philox( Block{ id.event(), id.subRun(), id.run(), 0 }, { lo32(s), hi32(s) } );
+    return ( static_cast<std::uint64_t>(b[1]) << 32 ) | b[0];
+  }
+
+  CounterRandomEngine::Block CounterRandomEngine::philox( Block ctr, std::array<std::uint32_t,2> key ){
+    for ( int round=0; round<10; ++round ){
+      if ( round > 0 ){
+        key[0] += philoxW0;
+        key[1] += philoxW1;
+      }
+      const std::uint64_t p0 = static_cast<std::uint64_t>(philoxM0) * ctr[0];
+      const std::uint64_t p1 = static_cast<std::uint64_t>(philoxM1) * ctr[2];
+      ctr = Block{ hi32(p1) ^ ctr[1] ^ key[0], lo32(p1),
+                   hi32(p0) ^ ctr[3] ^ key[1], lo32(p0) };
+    }
+    return ctr;
+  }
+
+  void CounterRandomEngine::fill(){
+    block_ = philox( Block{ lo32(counter_), hi32(counter_), lo32(stream_), hi32(stream_) },
+                     { lo32(key_), hi32(key_) } );
+    ++counter_;
+    next_ = 0;
+  }
+
+  void CounterRandomEngine::setStream( std::uint64_t stream ){
+    stream_  = stream;
+    counter_ = 0;
+    next_    = 2;
+  }
+
+  double CounterRandomEngine::flat(){
+    if ( next_ > 1 ) fill();
+    const std::uint64_t x = ( static_cast<std::uint64_t>(block_[2*next_+1]) << 32 ) | block_[2*next_];
+    ++next_;
+    return toDouble(x);
+  }
+
+  void CounterRandomEngine::flatArray( const int size, double* vect ){
+    for ( int i=0; i<size; ++i ){
+      vect[i] = flat();
+    }
+  }
+
+  void CounterRandomEngine::setSeed( long seed, int ){
+    key_ = static_cast<std::uint64_t>(seed);
+    theSeed = seed;
+    setStream(stream_);
+  }
+
+  void CounterRandomEngine::setSeeds( const long* seeds, int ){
+    if ( seeds == nullptr || seeds[0] == 0 ){
+      throw cet::exception("RANDOM")
+        << "CounterRandomEngine::setSeeds requires a non-empty, zero terminated, list of seeds\n";
+    }
+    setSeed( seeds[0], 0 );
+  }
+
+  void CounterRandomEngine::saveStatus( const char filename[] ) const{
+    std::ofstream os( filename );
+    if ( !os ){
+      throw cet::exception("RANDOM")
+        << "CounterRandomEngine::saveStatus cannot open " << filename << "\n";
+    }
+    put(os);
+  }
+
+  void CounterRandomEngine::restoreStatus( const char filename[] ){
+    std::ifstream is( filename );
+    if ( !is ){
+      throw cet::exception("RANDOM")
+        << "CounterRandomEngine::restoreStatus cannot open " << filename << "\n";
+    }
+    get(is);
+  }
+
+  void CounterRandomEngine::showStatus() const{
+    std::cout << "CounterRandomEngine: key " << key_
+              << " stream " << stream_
+              << " block " << counter_
+              << " words used " << next_
+              << std::endl;
+  }
+
+  std::ostream& CounterRandomEngine::put( std::ostream& os ) const{
+    os << name() << " " << key_ << " " << stream_ << " " << counter_ << " " << next_ << "\n";
+    return os;
+  }
+
+  std::istream& CounterRandomEngine::get( std::istream& is ){
+    std::string tag;
+    std::uint64_t key(0), stream(0), counter(0);
+    unsigned next(2);
+    is >> tag >> key >> stream >> counter >> next;
+    if ( !is || tag != name() || next > 2 ){
+      throw cet::exception("RANDOM")
+        << "CounterRandomEngine::get: invalid engine state\n";
+    }
+    key_   = key;
+    theSeed = static_cast<long>(key_);
+    stream_ = stream;
+    // regenerate the partially used block
+    counter_ = counter;
+    next_    = 2;
+    if ( next < 2 && counter_ > 0 ){
+      --counter_;
+      fill();
+      next_ = next;
+    }
+    return is;
+  }
+
+} // end namespace mu2e
@@ -38,9 +38,6 @@ namespace mu2e
 {
 
   MVATools::MVATools(const Config& config) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -59,9 +56,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(fhicl::ParameterSet const& pset) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -80,9 +74,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(const std::string& xmlfilename) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -376,8 +367,6 @@ namespace mu2e
       }
 
       maxNeurons_ = *std::max_element(links_.begin(),links_.end());
-      x_ = std::vector<float>(maxNeurons_,0.0f);
-      y_ = std::vector<float>(maxNeurons_,0.0f);
 
       XMLString::release(&ATT_INDEX);
       XMLString::release(&ATT_NSYNAPSES);
@@ -430,30 +419,57 @@ namespace mu2e
   }
 
 
+  namespace {
+    // per-thread work space for the evaluation; it only allocates when it grows
+    float* scratch(size_t n)
+    {
+       thread_local std::vector<float> buffer;
+       if (buffer.size() < n) buffer.resize(n);
+       return buffer.data();
+    }
+
+    // number of feature rows evaluated together by the batch interface
+    constexpr size_t blockRows = 16;
+  }
+
+  unsigned MVATools::nInputs(size_t nvars, const MVAMask& mask) const
+  {
+      unsigned ival(0);
+      for (size_t ivar=0; ivar < nvars; ivar++) if ( mask & (1<<ivar) ) ++ival;
+
+      if (ival != links_[0]-1)
+        throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << ival << ") and network architecture (links_[0]-1 = " << links_[0]-1 << ")" << std::endl;
+      return ival;
+  }
+
   float MVATools::evalMVA(const std::vector<double >& v, const MVAMask& mask) const
   {
-     for (size_t i=0;i<v.size();++i)  fv_[i] = static_cast<float>(v[i]);
-     return evalMVA(fv_,mask);
+     return evalRow(v.data(),v.size(),mask);
   }
 
   float MVATools::evalMVA(const std::vector<float>& v, const MVAMask& mask) const
   {
+     return evalRow(v.data(),v.size(),mask);
+  }
+
+  template <class T> float MVATools::evalRow(const T* v, size_t nvars, const MVAMask& mask) const
+  {
+      nInputs(nvars,mask);
+      float* x = scratch(2*maxNeurons_);
+      float* y = x + maxNeurons_;
 
       // Normalize the input data and add the bias node, skip masked values
       size_t ival(0);
-      for (size_t ivar=0; ivar < v.size(); ivar++)
+      for (size_t ivar=0; ivar < nvars; ivar++)
       {
          if ( mask & (1<<ivar) )
          {
-            x_[ival]= isNorm_ ? (v[ivar]-voffset_[ival])*vscale_[ival] - 1.0 : v[ivar];
+            float val = static_cast<float>(v[ivar]);
+            x[ival]= isNorm_ ? (val-voffset_[ival])*vscale_[ival] - 1.0 : val;
             ++ival;
          }
       }
-      x_[ival] = 1.0;
-
-      if (ival != links_[0]-1)
-        throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << ival << ") and network architecture (links_[0]-1 = " << links_[0]-1 << ")" << std::endl;
-
+      x[ival] = 1.0;
 
       //perform feed forward calculation up to the last hidden layer
       unsigned idxWeight(0);
@@ -462,24 +478,86 @@ namespace mu2e
           //the number of synpases is given by the number of neurons in the next layer -1 (do not count bias neuron!)
           for (unsigned j=0;j<links_[k+1]-1;++j)
           {
-             y_[j]=0.0f;
-             for (unsigned i=0;i<links_[k];++i) y_[j] += wgts_[i+idxWeight]*x_[i];
-             y_[j] = activation(y_[j]);
+             y[j]=0.0f;
+             for (unsigned i=0;i<links_[k];++i) y[j] += wgts_[i+idxWeight]*x[i];
+             y[j] = activation(y[j]);
              idxWeight += links_[k];
           }
-          x_.swap(y_);
-          x_[links_[k+1]-1] = 1.0f; //add bias neuron
+          std::swap(x,y);
+          x[links_[k+1]-1] = 1.0f; //add bias neuron
       }
 
       //calculate output neuron value
       float yf(0.0);
-      for (unsigned i=0;i<links_.back();++i) yf += wgts_[i+idxWeight]*x_[i];
+      for (unsigned i=0;i<links_.back();++i) yf += wgts_[i+idxWeight]*x[i];
 
       if (oldMVA_) return yf;
       return  1.0/(1.0+expf(-yf));
   }
 
+  // Same calculation as evalRow for a block of rows at a time: the neuron values of the block are
+  // stored neuron by neuron, so each weight is loaded once per block and the inner loop over
+  // the rows vectorizes.  The sums are done in the same order as for a single row.
+  void MVATools::evalMVA(size_t nrows, size_t nvars, const float* rows, float* results, const MVAMask& mask) const
+  {
+      nInputs(nvars,mask);
+      float* x = scratch(2*maxNeurons_*blockRows);
+      float* y = x + maxNeurons_*blockRows;
+
+      for (size_t first=0; first < nrows; first += blockRows)
+      {
+          const size_t nb = std::min(blockRows,nrows-first);
+          float* xb = x;
+          float* yb = y;
+
+          size_t ival(0);
+          for (size_t ivar=0; ivar < nvars; ivar++)
+          {
+             if ( mask & (1<<ivar) )
+             {
+                for (size_t r=0;r<nb;++r)
+                {
+                   float val = rows[(first+r)*nvars+ivar];
+                   xb[ival*blockRows+r] = isNorm_ ? (val-voffset_[ival])*vscale_[ival] - 1.0 : val;
+                }
+                ++ival;
+             }
+          }
+          for (size_t r=0;r<nb;++r) xb[ival*blockRows+r] = 1.0f;
 
+          unsigned idxWeight(0);
+          for (unsigned k=0;k<links_.size()-1;++k)
+          {
+              for (unsigned j=0;j<links_[k+1]-1;++j)
+              {
+                 float* yj = yb + j*blockRows;
+                 for (size_t r=0;r<nb;++r) yj[r] = 0.0f;
+                 for (unsigned i=0;i<links_[k];++i)
+                 {
+                    const float w = wgts_[i+idxWeight];
+                    const float* xi = xb + i*blockRows;
+                    for (size_t r=0;r<nb;++r) yj[r] += w*xi[r];
+                 }
+                 for (size_t r=0;r<nb;++r) yj[r] = activation(yj[r]);
+                 idxWeight += links_[k];
+              }
+              std::swap(xb,yb);
+              float* bias = xb + (links_[k+1]-1)*blockRows;
+              for (size_t r=0;r<nb;++r) bias[r] = 1.0f;
+          }
+
+          float yf[blockRows];
+          for (size_t r=0;r<nb;++r) yf[r] = 0.0f;
+          for (unsigned i=0;i<links_.back();++i)
+          {
+             const float w = wgts_[i+idxWeight];
+             const float* xi = xb + i*blockRows;
+             for (size_t r=0;r<nb;++r) yf[r] += w*xi[r];
+          }
+
+          for (size_t r=0;r<nb;++r) results[first+r] = oldMVA_ ? yf[r] : 1.0/(1.0+expf(-yf[r]));
+      }
+  }
 
 
   float MVATools::activation(float arg) const
@@ -51,6 +51,16 @@ class ProditionsService {
     using Name = fhicl::Name;
     using Comment = fhicl::Comment;
     fhicl::Atom<int> verbose{Name("verbose"), Comment("verbosity 0 or 1"), 0};
+    fhicl::OptionalSequence<std::string> prefetch{
+        Name("prefetch"),
+        Comment("run ranges, like 1201:0-1205, whose entities are made "
+                "at the first run, instead of at the first event using them")};
+    fhicl::Atom<bool> prefetchRun{
+        Name("prefetchRun"),
+        Comment("make the entities for each run as it begins"), false};
+    fhicl::OptionalSequence<std::string> prefetchCaches{
+        Name("prefetchCaches"),
+        Comment("names of the caches to prefetch (all)")};
     fhicl::Table<CRVOrdinalConfig> crvOrdinal{
         Name("crvOrdinal"),
         Comment("CRV online-offline numbering configuration")};
@@ -111,14 +121,20 @@ class ProditionsService {
   }
 
   // void postBeginJob();
+  // after the geometry is made for the run, make the entities requested
+  void preBeginRun(art::Run const& run);
 
  private:
+  // make all the entities of the prefetch caches for these run ranges
+  void prefetch(std::vector<DbIoV> const& ranges);
+
   // This is not copyable or assignable - private and unimplemented.
   ProditionsService const& operator=(ProditionsService const& rhs);
   ProditionsService(ProditionsService const& rhs);
 
   Config _config;
   std::map<std::string, ProditionsCache::ptr> _caches;
+  bool _prefetched;  // the prefetch run ranges are done
 };
 
 }  // namespace mu2e
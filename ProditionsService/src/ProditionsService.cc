@@ -33,7 +33,12 @@
 #include "Offline/AnalysisConditions/inc/TrkQualCatalogCache.hh"
 #include "Offline/SimulationConditions/inc/SimBookkeeperCache.hh"
 
+#include "art/Framework/Principal/Run.h"
 #include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "tbb/parallel_for.h"
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <typeinfo>
 
@@ -43,11 +48,13 @@ namespace mu2e {
 
 ProditionsService::ProditionsService(Parameters const& sTable,
                                      art::ActivityRegistry& iRegistry) :
-    _config(sTable()) {
+    _config(sTable()), _prefetched(false) {
   // create this here to force DbService to be active before Proditions
   art::ServiceHandle<DbService> d;
   // and then Geometry
   art::ServiceHandle<GeometryService> g;
+  // after the geometry, so it is made for the run before the prefetch
+  iRegistry.sPreBeginRun.watch(this, &ProditionsService::preBeginRun);
 
   auto cor = std::make_shared<mu2e::CRVOrdinalCache>(_config.crvOrdinal());
   _caches[cor->name()] = cor;
@@ -109,4 +116,66 @@ ProditionsService::ProditionsService(Parameters const& sTable,
   }
 }
 
+void ProditionsService::preBeginRun(art::Run const& run) {
+  std::vector<DbIoV> ranges;
+  if (!_prefetched) {
+    std::vector<std::string> prefetch;
+    if (_config.prefetch(prefetch)) {
+      for (auto const& ss : prefetch) ranges.emplace_back(ss);
+    }
+    _prefetched = true;
+  }
+  if (_config.prefetchRun()) {
+    ranges.emplace_back(run.run(), 0, run.run(), DbIoV::maxSubrun());
+  }
+  if (!ranges.empty()) prefetch(ranges);
+}
+
+void ProditionsService::prefetch(std::vector<DbIoV> const& ranges) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  std::vector<std::string> names;
+  if (!_config.prefetchCaches(names)) {
+    for (auto const& cc : _caches) names.push_back(cc.first);
+  }
+  for (auto const& name : names) {
+    if (_caches.count(name) == 0) {
+      throw cet::exception("PRODITIONS_BAD_PREFETCH")
+          << "ProditionsService prefetch asked for unknown cache " << name
+          << "\n";
+    }
+  }
+
+  // one task per cache in the caller's arena, so the entities are made
+  // on the threads art was given; the caches have their own locks.
+  // An entity which can't be made now is left to be made, or fail,
+  // when an event asks for it, this job may not need it
+  std::atomic<int> nent(0);
+  std::vector<std::string> errors(names.size());
+  tbb::parallel_for(std::size_t(0), names.size(), [&](std::size_t i) {
+    try {
+      for (auto const& range : ranges) {
+        nent += _caches.at(names[i])->prefetch(range);
+      }
+    } catch (std::exception const& e) {
+      errors[i] = e.what();
+    }
+  });
+
+  for (std::size_t i = 0; i < names.size(); i++) {
+    if (errors[i].empty()) continue;
+    mf::LogWarning warn("ProditionsService");
+    warn << "ProditionsService could not prefetch " << names[i] << ": "
+         << errors[i] << "\n";
+  }
+
+  if (_config.verbose() > 0) {
+    auto dt = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    cout << "ProditionsService prefetch found " << nent << " entities in "
+         << names.size() << " caches in " << dt.count() * 1.0e-6 << " s"
+         << endl;
+  }
+}
+
 }  // namespace mu2e
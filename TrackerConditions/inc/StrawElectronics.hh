@@ -45,6 +45,16 @@ namespace mu2e {
           _sigma(sigma), _t0(t0) {};
       };
 
+      // the parts of the response to a charge that depend only on its wire distance,
+      // computed once per cluster and reused for every sample of the waveform
+      struct ClusterResponse{
+        int _distIndex; // wire distance point below the distance
+        double _distFrac; // interpolation weight of that point
+        double _reflectionTime;
+        double _reflectionScale;
+        double _saturationTime; // time after the charge from which the linear response no longer changes
+      };
+
       typedef std::shared_ptr<StrawElectronics> ptr_t;
       typedef std::shared_ptr<const StrawElectronics> cptr_t;
       constexpr static const char* cxname = {"StrawElectronics"};
@@ -108,11 +118,15 @@ namespace mu2e {
       // linear response to a charge pulse.  This does NOT include saturation effects,
       // since those are cumulative and cannot be computed for individual charges
       double linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation=false) const; // mvolts per pCoulomb
+      // same, with the distance dependent part precomputed
+      ClusterResponse clusterResponse(Straw const& straw, double distance) const;
+      double linearResponse(Straw const& straw, Path ipath, double time, double charge, ClusterResponse const& cresp, bool forsaturation=false) const;
       double adcImpulseResponse(StrawId sid, double time, double charge) const;
       // Given a (linear) total voltage, compute the saturated voltage
       double saturatedResponse(double lineearresponse) const;
       // relative time when linear response is maximal
       double maxResponseTime(StrawId id, Path ipath,double distance) const;
+      double maxResponseTime(StrawId id, Path ipath,ClusterResponse const& cresp) const;
       // digization
       TrkTypes::ADCValue adcResponse(StrawId id, double mvolts) const; // ADC response to analog inputs
       TrkTypes::TDCValue tdcResponse(double time) const; // TDC response to a signal input to electronics at a given time (in ns since eventWindowMarker)
@@ -155,6 +169,7 @@ namespace mu2e {
 
       double currentToVoltage(StrawId sid, Path ipath) const { return _dVdI[ipath][sid.uniqueStraw()]; }
       double maxLinearResponse(StrawId sid, Path ipath,double distance,double charge=1.0) const;
+      double maxLinearResponse(StrawId sid, Path ipath,ClusterResponse const& cresp,double charge=1.0) const;
       double clusterLookbackTime() const { return _clusterLookbackTime;}
 
       double truncationTime(Path ipath) const { return _ttrunc[ipath];}
@@ -249,6 +264,8 @@ namespace mu2e {
       // but an actual TDC value that will be compared against
       // helper functions
       static inline double mypow(double,unsigned);
+      // find the wire distance points bracketing a distance, and the interpolation weight
+      void wireDistanceBin(double distance, int& distIndex, double& distFrac) const;
 
       int _responseBins;
       double _sampleRate;
@@ -67,30 +67,45 @@ namespace mu2e {
       response[i] *= 1 / gain_160;
   }
 
+  void StrawElectronics::wireDistanceBin(double distance, int& distIndex, double& distFrac) const {
+    // the last point below the distance, excluding the first and last points
+    auto ipoint = std::upper_bound(_wPoints.begin()+1,_wPoints.end()-1,distance,
+        [](double dist, WireDistancePoint const& wpoint) { return dist < wpoint._distance; });
+    distIndex = std::distance(_wPoints.begin(),ipoint)-1;
+    distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+  }
+
+  StrawElectronics::ClusterResponse StrawElectronics::clusterResponse(Straw const& straw, double distance) const {
+    ClusterResponse cresp;
+    wireDistanceBin(distance,cresp._distIndex,cresp._distFrac);
+    double straw_length = 2*straw.halfLength();
+    cresp._reflectionTime = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
+    cresp._reflectionScale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
+    // past this both the direct and reflected indices are in the last response bin; one bin of margin
+    cresp._saturationTime = std::max(cresp._reflectionTime,0.0) + (_responseBins/2.)/_sampleRate;
+    return cresp;
+  }
+
   double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation) const {
+    return linearResponse(straw,ipath,time,charge,clusterResponse(straw,distance),forsaturation);
+  }
+
+  double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, double charge, ClusterResponse const& cresp, bool forsaturation) const {
     int index = time*_sampleRate + _responseBins/2.;
     if ( index >= _responseBins)
       index = _responseBins-1;
     if (index < 0)
       index = 0;
 
-    double straw_length = 2*straw.halfLength();
-    double reflection_time = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
-    int index_refl = (time - reflection_time)*_sampleRate + _responseBins/2.;
+    int index_refl = (time - cresp._reflectionTime)*_sampleRate + _responseBins/2.;
     if (index_refl >= _responseBins)
       index_refl = _responseBins-1;
     if (index_refl < 0)
       index_refl = 0;
 
-    double reflection_scale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
-
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+    double reflection_scale = cresp._reflectionScale;
+    int distIndex = cresp._distIndex;
+    double distFrac = cresp._distFrac;
     double p0, p1;
     if (ipath == thresh){
       if (forsaturation){
@@ -124,31 +139,29 @@ namespace mu2e {
   }
 
   double StrawElectronics::maxResponseTime(StrawId sid, Path ipath,double distance) const {
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
-    double p0 = _wPoints[distIndex]._tmax[ipath][sid.getStraw()];
-    double p1 = _wPoints[distIndex + 1]._tmax[ipath][sid.getStraw()];
+    ClusterResponse cresp;
+    wireDistanceBin(distance,cresp._distIndex,cresp._distFrac);
+    return maxResponseTime(sid,ipath,cresp);
+  }
 
-    return p0 * distFrac + p1 * (1 - distFrac);
+  double StrawElectronics::maxResponseTime(StrawId sid, Path ipath,ClusterResponse const& cresp) const {
+    double p0 = _wPoints[cresp._distIndex]._tmax[ipath][sid.getStraw()];
+    double p1 = _wPoints[cresp._distIndex + 1]._tmax[ipath][sid.getStraw()];
+
+    return p0 * cresp._distFrac + p1 * (1 - cresp._distFrac);
   }
 
   double StrawElectronics::maxLinearResponse(StrawId sid, Path ipath,double distance,double charge) const {
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
-    double p0 = _wPoints[distIndex]._linmax[ipath][sid.getStraw()];
-    double p1 = _wPoints[distIndex + 1]._linmax[ipath][sid.getStraw()];
+    ClusterResponse cresp;
+    wireDistanceBin(distance,cresp._distIndex,cresp._distFrac);
+    return maxLinearResponse(sid,ipath,cresp,charge);
+  }
+
+  double StrawElectronics::maxLinearResponse(StrawId sid, Path ipath,ClusterResponse const& cresp,double charge) const {
+    double p0 = _wPoints[cresp._distIndex]._linmax[ipath][sid.getStraw()];
+    double p1 = _wPoints[cresp._distIndex + 1]._linmax[ipath][sid.getStraw()];
 
-    return charge * (p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath][sid.uniqueStraw()];
+    return charge * (p0 * cresp._distFrac + p1 * (1 - cresp._distFrac)) * _dVdI[ipath][sid.uniqueStraw()];
   }
 
   ADCValue StrawElectronics::adcResponse(StrawId sid, double mvolts) const {
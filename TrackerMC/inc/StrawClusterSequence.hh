@@ -1,21 +1,22 @@
 #ifndef TrackerMC_StrawClusterSequence_hh
 #define TrackerMC_StrawClusterSequence_hh
 //
-// StrawClusterSequence is a time-ordered sequence of StrawClusters
+// StrawClusterSequence is a time-ordered sequence of StrawClusters.  The clusters are
+// stored contiguously, so that the waveform sampling can index and bisect them.
 //
 // Original author David Brown, LBNL
 //
 
 // C++ includes
 #include <iostream>
-#include <list>
+#include <vector>
 // Mu2e includes
 #include "Offline/TrackerMC/inc/StrawCluster.hh"
 #include "Offline/DataProducts/inc/StrawId.hh"
 
 namespace mu2e {
   namespace TrackerMC {
-    typedef std::list<StrawCluster> StrawClusterList;
+    typedef std::vector<StrawCluster> StrawClusterList;
     class StrawClusterSequence {
       public:
         // constructors
@@ -24,9 +25,9 @@ namespace mu2e {
         StrawClusterSequence(StrawId const& sid, StrawEnd end);
         StrawClusterSequence(StrawClusterSequence const& other);
         StrawClusterSequence& operator =(StrawClusterSequence const& other);
-        // accessors: just hand over the list!
+        // accessors: just hand over the clusters!
         StrawClusterList const& clustList() const { return _clist; }
-        // insert a new clust, in time order.
+        // insert a new clust, in time order.  This invalidates iterators to the clusts
         StrawClusterList::iterator insert(StrawCluster const& clust);
         StrawId const& strawId() const { return _strawId; }
         StrawEnd const& strawEnd() const { return _end; }
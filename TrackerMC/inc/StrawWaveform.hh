@@ -5,6 +5,10 @@
 // a straw, over the time period of 1 microbunch.  It includes all physical and electronics
 // effects prior to digitization.
 //
+// The distance dependent part of the response of each clust is computed once.  Past a fixed time
+// the response of a clust no longer changes, so those responses are summed once, in time order;
+// a sample then only adds the clusts between the last of those and the sample time.
+//
 // Original author David Brown, LBNL
 //
 
@@ -40,8 +44,9 @@ namespace mu2e {
     struct WFX;
     class StrawWaveform{
       public:
-        // construct from a clust sequence and response object.  Scale affects the voltage
-        StrawWaveform(Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
+        // construct from a clust sequence and response object.  Scale affects the voltage.
+        // The clust sequence must not change after this
+        StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
         // disallow copy and assignment
         StrawWaveform() = delete; // don't allow default constructor, references can't be assigned empty
         StrawWaveform(StrawWaveform const& other);
@@ -61,15 +66,28 @@ namespace mu2e {
         StrawEnd const& strawEnd() const { return _cseq.strawEnd(); }
         Straw const& straw() const { return _straw;}
       private:
+        // responses: threshold and ADC paths, and threshold path as input to the saturation
+        enum Response {threshresp=0,adcresp,satresp,nresp};
         // clust sequence used in this waveform
         StrawClusterSequence const& _cseq;
         XTalk _xtalk; // X-talk applied to all voltages
         Straw const& _straw;
+        // distance dependent response of each clust
+        std::vector<StrawElectronics::ClusterResponse> _cresp;
+        // time from which the response of this and all earlier clusts is constant
+        std::vector<double> _tconst;
+        // constant response of each clust, and the running sum of those, starting at 0
+        std::array<std::vector<double>,nresp> _rconst, _rsum;
         // helper functions
         void returnCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const;
         bool roughCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const;
         bool fineCrossing(StrawElectronics const& strawele, double threshold, double vmax, WFX& wfx) const;
         double maxLinearResponse(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const;
+        double maxResponseTime(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const;
+        double linearResponse(StrawElectronics const& strawele,Response iresp,size_t iclust,double time) const;
+        // linear response summed over all clusts before the time
+        double linearResponse(StrawElectronics const& strawele,Response iresp,double time) const;
+        size_t clustIndex(StrawClusterList::const_iterator const& iclust) const { return iclust - _cseq.clustList().begin(); }
     };
 
     struct WFX { // waveform crossing
@@ -0,0 +1,102 @@
+//
+// Check that two digitizations of the same StrawGasSteps produced identical
+// StrawDigis, StrawDigiADCWaveforms and StrawDigiMCs.  Used to check that
+// StrawDigisFromStrawGasSteps with PerStrawRandomStreams gives the same digis
+// whatever the number of threads, see TrackerMC/test/StrawDigiThreads.fcl.
+//
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+#include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
+
+namespace mu2e {
+
+  class CompareStrawDigis : public art::EDAnalyzer {
+    public:
+      struct Config {
+        using Name=fhicl::Name;
+        using Comment=fhicl::Comment;
+        fhicl::Atom<art::InputTag> refTag{Name("ReferenceDigis"), Comment("StrawDigisFromStrawGasSteps module of the reference digitization")};
+        fhicl::Atom<art::InputTag> testTag{Name("TestDigis"), Comment("StrawDigisFromStrawGasSteps module of the digitization to compare")};
+      };
+      using Parameters = art::EDAnalyzer::Table<Config>;
+      explicit CompareStrawDigis(const Parameters& config);
+      void analyze(const art::Event& event) override;
+      void endJob() override;
+    private:
+      art::InputTag _refTag, _testTag;
+      unsigned long _nevents, _ndigis;
+      void fail(art::Event const& event, const char* what, size_t index) const;
+  };
+
+  CompareStrawDigis::CompareStrawDigis(const Parameters& config) : art::EDAnalyzer{config},
+    _refTag(config().refTag()),
+    _testTag(config().testTag()),
+    _nevents(0), _ndigis(0)
+  {
+    consumes<StrawDigiCollection>(_refTag);
+    consumes<StrawDigiCollection>(_testTag);
+    consumes<StrawDigiADCWaveformCollection>(_refTag);
+    consumes<StrawDigiADCWaveformCollection>(_testTag);
+    consumes<StrawDigiMCCollection>(_refTag);
+    consumes<StrawDigiMCCollection>(_testTag);
+  }
+
+  void CompareStrawDigis::fail(art::Event const& event, const char* what, size_t index) const {
+    throw cet::exception("RECO") << "mu2e::CompareStrawDigis: " << what << " " << index
+      << " differs between " << _refTag << " and " << _testTag << " in event " << event.id() << "\n";
+  }
+
+  void CompareStrawDigis::analyze(const art::Event& event) {
+    auto const& refdigis = *event.getValidHandle<StrawDigiCollection>(_refTag);
+    auto const& testdigis = *event.getValidHandle<StrawDigiCollection>(_testTag);
+    if(refdigis.size() != testdigis.size())
+      fail(event,"number of StrawDigis",refdigis.size());
+    for(size_t idigi=0; idigi < refdigis.size(); ++idigi){
+      auto const& ref = refdigis[idigi];
+      auto const& test = testdigis[idigi];
+      if(!(ref.strawId() == test.strawId()) || ref.TDC() != test.TDC() || ref.TOT() != test.TOT()
+          || ref.PMP() != test.PMP() || !(ref.digiFlag() == test.digiFlag()))
+        fail(event,"StrawDigi",idigi);
+    }
+
+    auto const& refadcs = *event.getValidHandle<StrawDigiADCWaveformCollection>(_refTag);
+    auto const& testadcs = *event.getValidHandle<StrawDigiADCWaveformCollection>(_testTag);
+    if(refadcs.size() != testadcs.size())
+      fail(event,"number of StrawDigiADCWaveforms",refadcs.size());
+    for(size_t iadc=0; iadc < refadcs.size(); ++iadc){
+      if(refadcs[iadc].samples() != testadcs[iadc].samples())
+        fail(event,"StrawDigiADCWaveform",iadc);
+    }
+
+    auto const& refmcs = *event.getValidHandle<StrawDigiMCCollection>(_refTag);
+    auto const& testmcs = *event.getValidHandle<StrawDigiMCCollection>(_testTag);
+    if(refmcs.size() != testmcs.size())
+      fail(event,"number of StrawDigiMCs",refmcs.size());
+    for(size_t imc=0; imc < refmcs.size(); ++imc){
+      auto const& ref = refmcs[imc];
+      auto const& test = testmcs[imc];
+      bool same = ref.strawId() == test.strawId() && ref.provenance() == test.provenance();
+      for(auto end : {StrawEnd::cal, StrawEnd::hv}){
+        same = same && ref.strawGasStep(end) == test.strawGasStep(end) && ref.clusterPos(end) == test.clusterPos(end)
+          && ref.clusterTime(end) == test.clusterTime(end) && ref.wireEndTime(end) == test.wireEndTime(end);
+      }
+      if(!same) fail(event,"StrawDigiMC",imc);
+    }
+    ++_nevents;
+    _ndigis += refdigis.size();
+  }
+
+  void CompareStrawDigis::endJob() {
+    mf::LogInfo("CompareStrawDigis") << "CompareStrawDigis: " << _refTag << " and " << _testTag
+      << " made identical digis in " << _nevents << " events, " << _ndigis << " StrawDigis";
+  }
+
+}
+
+DEFINE_ART_MODULE(mu2e::CompareStrawDigis)
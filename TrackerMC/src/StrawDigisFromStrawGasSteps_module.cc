@@ -30,6 +30,7 @@
 #include "BTrk/BField/BField.hh"
 // utiliities
 #include "Offline/Mu2eUtilities/inc/TwoLinePCA.hh"
+#include "Offline/Mu2eUtilities/inc/CounterRandomEngine.hh"
 #include "Offline/DataProducts/inc/TrkTypes.hh"
 // persistent data
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
@@ -49,7 +50,6 @@
 //CLHEP
 #include "CLHEP/Random/RandGaussQ.h"
 #include "CLHEP/Random/RandFlat.h"
-#include "CLHEP/Random/RandExponential.h"
 #include "CLHEP/Random/RandPoisson.h"
 #include "CLHEP/Vector/LorentzVector.h"
 // root
@@ -59,6 +59,9 @@
 #include "TGraph.h"
 #include "TMarker.h"
 #include "TTree.h"
+// tbb
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 // C++
 #include <map>
 #include <algorithm>
@@ -122,11 +125,14 @@ namespace mu2e {
           fhicl::Atom<art::InputTag> mixedDigisTag { Name("MixedDigisTag"), Comment("Source of digis to overlay event onto"), ""};
           fhicl::Atom<bool> mixDigiMCs { Name("MixDigiMCs"), Comment("Propagate mixed StrawDigiMCs through module"), false};
           fhicl::Atom<bool> allowEmptySteps { Name("AllowEmptyStrawGasSteps"), Comment("Allow digitization to proceed even without any valid straw gas step collections"), false};
+          fhicl::Atom<bool> strawStreams { Name("PerStrawRandomStreams"), Comment("Draw the random numbers of each straw from its own counter-based stream, keyed by the event id, and digitize the straws concurrently"), false};
+          fhicl::Atom<unsigned> strawThreads { Name("StrawThreads"), Comment("Maximum number of threads digitizing the straws of an event with PerStrawRandomStreams, 0 for no limit"), 0};
         };
 
         typedef art::Ptr<StrawGasStep> SGSPtr;
         typedef art::Ptr<SimParticle> SPPtr;
         typedef map<StrawId,StrawClusterSequencePair> StrawClusterMap;  // clusts by straw
+        typedef map<StrawId,vector<SGSPtr>> StrawStepMap; // steps by straw
         // work with pairs of waveforms, one for each straw end
         typedef std::array<StrawWaveform,2> SWFP;
         typedef std::array<WFX,2> WFXP;
@@ -168,12 +174,26 @@ namespace mu2e {
         unsigned _maxnclu;
         StrawElectronics::Path _diagpath;
         bool _usestatus;
-        // Random number distributions
+        // Random number distributions drawing from one engine
+        struct RandomDists {
+          explicit RandomDists(CLHEP::HepRandomEngine& engine) : _gauss(engine), _flat(engine), _poisson(engine) {}
+          CLHEP::RandGaussQ _gauss;
+          CLHEP::RandFlat _flat;
+          CLHEP::RandPoisson _poisson;
+        };
+        // new digis of one straw and the straws it couples to
+        struct StrawDigiProducts {
+          StrawDigiCollection _digis;
+          StrawDigiADCWaveformCollection _digiadcs;
+          StrawDigiMCCollection _mcdigis;
+        };
+        SeedService::seed_t _seed;
         art::RandomNumberGenerator::base_engine_t& _engine;
-        CLHEP::RandGaussQ _randgauss;
-        CLHEP::RandFlat _randflat;
-        CLHEP::RandExponential _randexp;
-        CLHEP::RandPoisson _randP;
+        RandomDists _rand;
+        // per-straw random streams
+        bool _strawStreams;
+        unsigned _strawThreads;
+        static constexpr uint64_t _eventStream = uint64_t(1) << 16; // for draws not specific to a straw: past any straw id
         // A category for the error logger.
         const string _messageCategory;
         // Give some informationation messages only on the first event.
@@ -232,43 +252,58 @@ namespace mu2e {
         double _digitizationEndFromMarker;
 
         //  helper functions
+        void selectSteps(art::Event const& event, vector<SGSPtr>& sgsptrs);
         void fillClusterMap(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             art::Event const& event, StrawClusterMap & hmap);
+        void digitizeStrawStreams(StrawPhysics const& strawphys,
+            StrawElectronics const& strawele,
+            art::Event const& event,
+            StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
+        void digitizeStraw(StrawPhysics const& strawphys,
+            StrawElectronics const& strawele,
+            StrawClusterSequencePair const& hsp,
+            RandomDists& rand,
+            StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
         void addStep(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
             SGSPtr const& sgsptr,
+            RandomDists& rand,
+            vector<IonCluster>& clusters,
             StrawClusterSequencePair& shsp);
         void divideStep(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
             StrawGasStep const& step,
+            RandomDists& rand,
             vector<IonCluster>& clusters);
         void driftCluster(StrawPhysics const& strawphys, Straw const& straw,
-            IonCluster const& cluster, WireCharge& wireq);
+            IonCluster const& cluster, RandomDists& rand, WireCharge& wireq);
         void propagateCharge(StrawPhysics const& strawphys, Straw const& straw,
             WireCharge const& wireq, StrawEnd end, WireEndCharge& weq);
         double microbunchTime(StrawElectronics const& strawele, double globaltime) const;
         void addGhosts(StrawElectronics const& strawele, StrawCluster const& clust,StrawClusterSequence& shs);
         void addNoise(StrawClusterMap& hmap);
-        void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings);
+        void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, RandomDists& rand, WFXPList& xings);
         void createDigis(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             Straw const& straw,
             StrawClusterSequencePair const& hsp,
             XTalk const& xtalk,
+            RandomDists& rand,
             StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
         void fillDigis(StrawPhysics const& strawphys,
             StrawElectronics const& strawele,
             WFXPList const& xings,SWFP const& swfp , StrawId sid,
+            RandomDists& rand,
             StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
-        bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, StrawDigiCollection* digis,
+        bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, RandomDists& rand, StrawDigiCollection* digis,
             StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time);
         void findCrossTalkStraws(Straw const& straw,vector<XTalk>& xtalk);
-        void fillClusterNe(StrawPhysics const& strawphys,std::vector<unsigned>& me);
-        void fillClusterPositions(StrawGasStep const& step, Straw const& straw, std::vector<StrawCoordinates>& cpos);
-        void fillClusterMinion(StrawPhysics const& strawphys, StrawGasStep const& step, std::vector<unsigned>& me, std::vector<float>& cen);
+        void fillClusterNe(StrawPhysics const& strawphys,RandomDists& rand,std::vector<unsigned>& me);
+        void fillClusterPositions(StrawGasStep const& step, Straw const& straw, RandomDists& rand, std::vector<StrawCoordinates>& cpos);
+        void fillClusterMinion(StrawPhysics const& strawphys, StrawGasStep const& step, RandomDists& rand, std::vector<unsigned>& me, std::vector<float>& cen);
         bool readAll(StrawId const& sid) const;
         // diagnostic functions
         void waveformHist(StrawElectronics const& strawele,
@@ -310,11 +345,11 @@ namespace mu2e {
       _diagpath(static_cast<StrawElectronics::Path>(config().diagpath())),
       _usestatus(config().usestatus()),
       // Random number distributions
-      _engine(createEngine( art::ServiceHandle<SeedService>()->getSeed())),
-      _randgauss( _engine ),
-      _randflat( _engine ),
-      _randexp( _engine),
-      _randP( _engine),
+      _seed(art::ServiceHandle<SeedService>()->getSeed()),
+      _engine(createEngine(_seed)),
+      _rand( _engine ),
+      _strawStreams(config().strawStreams()),
+      _strawThreads(config().strawThreads()),
       _messageCategory("HITS"),
       _firstEvent(true),      // Control some information messages.
       _mixedDigisTag(config().mixedDigisTag()),
@@ -509,8 +544,16 @@ namespace mu2e {
       const ProtonBunchTimeMC& pbtmc(*pbtmcHandle);
       _pbtimemc = pbtmc.pbtime_;
       // calculate event window marker jitter for this microbunch for each panel
-      for (size_t i=0;i<StrawId::_nupanels;i++){
-        _ewMarkerROCdt.at(i) = _randgauss.fire(0,strawele.eventWindowMarkerROCJitter());
+      if(_strawStreams){
+        CounterRandomEngine engine(CounterRandomEngine::eventKey(event.id(),_seed),_eventStream);
+        CLHEP::RandGaussQ randgauss(engine);
+        for (size_t i=0;i<StrawId::_nupanels;i++){
+          _ewMarkerROCdt.at(i) = randgauss.fire(0,strawele.eventWindowMarkerROCJitter());
+        }
+      } else {
+        for (size_t i=0;i<StrawId::_nupanels;i++){
+          _ewMarkerROCdt.at(i) = _rand._gauss.fire(0,strawele.eventWindowMarkerROCJitter());
+        }
       }
       // make the microbunch buffer long enough to get the full waveform
       _mbbuffer = (strawele.nADCSamples() - strawele.nADCPreSamples())*strawele.adcPeriod();
@@ -519,34 +562,20 @@ namespace mu2e {
       unique_ptr<StrawDigiCollection> digis(new StrawDigiCollection);
       unique_ptr<StrawDigiADCWaveformCollection> digiadcs(new StrawDigiADCWaveformCollection);
       unique_ptr<StrawDigiMCCollection> mcdigis(new StrawDigiMCCollection);
-      // create the StrawCluster map
-      // this is a map from straw ids to a list of all clusters on that straw from this event
-      StrawClusterMap hmap;
-      // fill this from the event
-      fillClusterMap(strawphys,strawele,event,hmap);
-      // add noise clusts
-      if(_addNoise)addNoise(hmap);
-      // loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
-      for(auto ihsp=hmap.begin();ihsp!= hmap.end();++ihsp){
-        StrawClusterSequencePair const& hsp = ihsp->second;
-        Straw const& straw = _tracker->getStraw(hsp.strawId());
-        // create primary digis from this clust sequence
-        XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
-        createDigis(strawphys,strawele,straw,hsp,self,digis.get(),digiadcs.get(),mcdigis.get());
-        // if we're applying x-talk, look for nearby coupled straws
-        if(_addXtalk) {
-          // only apply if the charge is above a threshold
-          double totalCharge = 0;
-          for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
-            totalCharge += ih->charge();
-          }
-          if( totalCharge > _ctMinCharge){
-            vector<XTalk> xtalk;
-            findCrossTalkStraws(straw,xtalk);
-            for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
-              createDigis(strawphys,strawele,straw,hsp,*ixtalk,digis.get(),digiadcs.get(),mcdigis.get());
-            }
-          }
+      if(_strawStreams){
+        // each straw is simulated with its own random stream, so they can be processed in any order
+        digitizeStrawStreams(strawphys,strawele,event,digis.get(),digiadcs.get(),mcdigis.get());
+      } else {
+        // create the StrawCluster map
+        // this is a map from straw ids to a list of all clusters on that straw from this event
+        StrawClusterMap hmap;
+        // fill this from the event
+        fillClusterMap(strawphys,strawele,event,hmap);
+        // add noise clusts
+        if(_addNoise)addNoise(hmap);
+        // loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
+        for(auto ihsp=hmap.begin();ihsp!= hmap.end();++ihsp){
+          digitizeStraw(strawphys,strawele,ihsp->second,_rand,digis.get(),digiadcs.get(),mcdigis.get());
         }
       }
       // bundle up new digis in global collection
@@ -575,22 +604,111 @@ namespace mu2e {
         Straw const& straw,
         StrawClusterSequencePair const& hsp,
         XTalk const& xtalk,
+        RandomDists& rand,
         StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis) {
       // instantiate waveforms for both ends of this straw
-      SWFP waveforms  ={ StrawWaveform(straw,hsp.clustSequence(StrawEnd::cal),xtalk),
-        StrawWaveform(straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
+      SWFP waveforms  ={ StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::cal),xtalk),
+        StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
       // find the threshold crossing points for these waveforms
       WFXPList xings;
       // find the threshold crossings
-      findThresholdCrossings(strawele,waveforms,xings);
+      findThresholdCrossings(strawele,waveforms,rand,xings);
       // convert the crossing points into digis, and add them to the event data
-      fillDigis(strawphys,strawele,xings,waveforms,xtalk._dest,digis,digiadcs,mcdigis);
+      fillDigis(strawphys,strawele,xings,waveforms,xtalk._dest,rand,digis,digiadcs,mcdigis);
+    }
+
+    void StrawDigisFromStrawGasSteps::digitizeStraw(
+        StrawPhysics const& strawphys,
+        StrawElectronics const& strawele,
+        StrawClusterSequencePair const& hsp,
+        RandomDists& rand,
+        StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
+        StrawDigiMCCollection* mcdigis) {
+      Straw const& straw = _tracker->getStraw(hsp.strawId());
+      // create primary digis from this clust sequence
+      XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
+      createDigis(strawphys,strawele,straw,hsp,self,rand,digis,digiadcs,mcdigis);
+      // if we're applying x-talk, look for nearby coupled straws
+      if(_addXtalk) {
+        // only apply if the charge is above a threshold
+        double totalCharge = 0;
+        for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
+          totalCharge += ih->charge();
+        }
+        if( totalCharge > _ctMinCharge){
+          vector<XTalk> xtalk;
+          findCrossTalkStraws(straw,xtalk);
+          for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
+            createDigis(strawphys,strawele,straw,hsp,*ixtalk,rand,digis,digiadcs,mcdigis);
+          }
+        }
+      }
+    }
+
+    void StrawDigisFromStrawGasSteps::digitizeStrawStreams(
+        StrawPhysics const& strawphys,
+        StrawElectronics const& strawele,
+        art::Event const& event,
+        StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
+        StrawDigiMCCollection* mcdigis) {
+      // group the steps by straw, keeping their order
+      vector<SGSPtr> sgsptrs;
+      selectSteps(event,sgsptrs);
+      StrawStepMap smap;
+      for(auto const& sgsptr : sgsptrs) smap[sgsptr->strawId()].push_back(sgsptr);
+      vector<StrawStepMap::const_iterator> straws;
+      straws.reserve(smap.size());
+      for(auto istraw = smap.cbegin(); istraw != smap.cend(); ++istraw) straws.push_back(istraw);
+      // all the random numbers of a straw, including those of its cross-talk digis, come from a stream
+      // keyed by the event and straw id, so the result does not depend on the order the straws are processed in
+      uint64_t key = CounterRandomEngine::eventKey(event.id(),_seed);
+      vector<StrawDigiProducts> products(straws.size());
+      auto digitize = [&](size_t istraw) {
+        StrawId sid = straws[istraw]->first;
+        CounterRandomEngine engine(key,sid.asUint16());
+        RandomDists rand(engine);
+        // the diagnostic trees are filled from member data, in that case the straws are processed serially
+        vector<IonCluster> clusters;
+        vector<IonCluster>& scratch = _diag > 0 ? _clusters : clusters;
+        Straw const& straw = _tracker->getStraw(sid);
+        StrawClusterSequencePair hsp(sid);
+        for(auto const& sgsptr : straws[istraw]->second){
+          addStep(strawphys,strawele,straw,sgsptr,rand,scratch,hsp);
+        }
+        StrawDigiProducts& prod = products[istraw];
+        digitizeStraw(strawphys,strawele,hsp,rand,&prod._digis,&prod._digiadcs,&prod._mcdigis);
+      };
+      if(_diag > 0){
+        for(size_t istraw=0; istraw < straws.size(); ++istraw) digitize(istraw);
+      } else if(_strawThreads > 0){
+        tbb::task_arena arena(_strawThreads);
+        arena.execute([&]() { tbb::parallel_for(size_t(0),straws.size(),digitize); });
+      } else {
+        tbb::parallel_for(size_t(0),straws.size(),digitize);
+      }
+      // merge in straw order, as the serial loop over the cluster map does
+      for(auto const& prod : products){
+        digis->insert(digis->end(),prod._digis.begin(),prod._digis.end());
+        digiadcs->insert(digiadcs->end(),prod._digiadcs.begin(),prod._digiadcs.end());
+        mcdigis->insert(mcdigis->end(),prod._mcdigis.begin(),prod._mcdigis.end());
+      }
     }
 
     void StrawDigisFromStrawGasSteps::fillClusterMap(StrawPhysics const& strawphys,
         StrawElectronics const& strawele,
         art::Event const& event, StrawClusterMap & hmap){
+      vector<SGSPtr> sgsptrs;
+      selectSteps(event,sgsptrs);
+      for(auto const& sgsptr : sgsptrs){
+        StrawId const & sid = sgsptr->strawId();
+        Straw const& straw = _tracker->getStraw(sid);
+        // create a clust from this step, and add it to the clust map
+        addStep(strawphys,strawele,straw,sgsptr,_rand,_clusters,hmap[sid]);
+      }
+    }
+
+    void StrawDigisFromStrawGasSteps::selectSteps(art::Event const& event, vector<SGSPtr>& sgsptrs){
 // get status if needed
       std::shared_ptr<const TrackerStatus> trackerStatus;
       if(_usestatus) {
@@ -622,10 +740,7 @@ namespace mu2e {
           // lookup straw here, to avoid having to find the tracker for every step
           StrawId const & sid = sgs.strawId();
           if ( ((!_usestatus) || (!trackerStatus->noSignal(sid))) && sgs.ionizingEdep() > _minstepE){
-            Straw const& straw = _tracker->getStraw(sid);
-            auto sgsptr = SGSPtr(sgsch,isgs);
-            // create a clust from this step, and add it to the clust map
-            addStep(strawphys,strawele,straw,sgsptr,hmap[sid]);
+            sgsptrs.push_back(SGSPtr(sgsch,isgs));
           } else if(_debug > 0) {
             StrawStatus stat;
             if(_usestatus) stat = trackerStatus->strawStatus(sid);
@@ -639,6 +754,8 @@ namespace mu2e {
         StrawElectronics const& strawele,
         Straw const& straw,
         SGSPtr const& sgsptr,
+        RandomDists& rand,
+        vector<IonCluster>& clusters,
         StrawClusterSequencePair& shsp) {
       auto const& sgs = *sgsptr;
       StrawId sid = sgs.strawId();
@@ -648,13 +765,13 @@ namespace mu2e {
       if( (ctime > strawele.digitizationStartFromMarker() - strawele.electronicsTimeDelay() - _steptimebuf
             && ctime <  max(_mbtime,_digitizationEndFromMarker) - strawele.electronicsTimeDelay() + _steptimebuf) || readAll(sid)) {
         // Subdivide the StrawGasStep into ionization clusters
-        _clusters.clear();
-        divideStep(strawphys,strawele,straw,sgs,_clusters);
+        clusters.clear();
+        divideStep(strawphys,strawele,straw,sgs,rand,clusters);
         // check
         // drift these clusters to the wire, and record the charge at the wire
-        for(auto iclu = _clusters.begin(); iclu != _clusters.end(); ++iclu){
+        for(auto iclu = clusters.begin(); iclu != clusters.end(); ++iclu){
           WireCharge wireq;
-          driftCluster(strawphys,straw,*iclu,wireq);
+          driftCluster(strawphys,straw,*iclu,rand,wireq);
           // propagate this charge to each end of the wire
           for(size_t iend=0;iend<2;++iend){
             StrawEnd end(static_cast<StrawEnd::End>(iend));
@@ -681,12 +798,13 @@ namespace mu2e {
         StrawElectronics const& strawele,
         Straw const& straw,
         StrawGasStep const& sgs,
+        RandomDists& rand,
         vector<IonCluster>& clusters) {
       // single cluster
       if (sgs.stepType().shape() == StrawGasStep::StepType::point || sgs.stepLength() < strawphys.meanFreePath()){
         float cen = sgs.ionizingEdep();
         float fne = cen/strawphys.meanElectronEnergy();
-        unsigned ne = std::max( static_cast<unsigned>(_randP(fne)),(unsigned)1);
+        unsigned ne = std::max( static_cast<unsigned>(rand._poisson(fne)),(unsigned)1);
         auto spos = strawCoordinates(sgs.startPosition(),straw);
         if(_drift1e){
           for (size_t i=0;i<ne;i++){
@@ -701,7 +819,7 @@ namespace mu2e {
         // compute the number of clusters for this step from the mean free path
         double fnc = sgs.stepLength()/strawphys.meanFreePath();
         // use a truncated Poisson distribution; this keeps both the mean and variance physical
-        unsigned nc = std::max(static_cast<unsigned>(_randP.fire(fnc)),(unsigned)1);
+        unsigned nc = std::max(static_cast<unsigned>(rand._poisson.fire(fnc)),(unsigned)1);
         // if not minion, limit the number of steps geometrically
         bool minion = (sgs.stepType().ionization()==StrawGasStep::StepType::minion);
         if(!minion )nc = std::min(nc,_maxnclu);
@@ -710,17 +828,17 @@ namespace mu2e {
         if(nc>0){
           // generate random positions for the clusters
           std::vector<StrawCoordinates> cposv(nc);
-          fillClusterPositions(sgs,straw,cposv);
+          fillClusterPositions(sgs,straw,rand,cposv);
           // generate electron counts and energies for these clusters: minion model is more detailed
           std::vector<unsigned> ne(nc);
           std::vector<float> cen(nc);
           if(minion){
-            fillClusterMinion(strawphys,sgs,ne,cen);
+            fillClusterMinion(strawphys,sgs,rand,ne,cen);
           } else {
             // get Poisson distribution of # of electrons for the average energy
             double fne = sgs.ionizingEdep()/(nc*strawphys.meanElectronEnergy()); // average # of electrons/cluster for non-minion clusters
             for(unsigned ic=0;ic<nc;++ic){
-              ne[ic] = static_cast<unsigned>(std::max(_randP.fire(fne),(long)1));
+              ne[ic] = static_cast<unsigned>(std::max(rand._poisson.fire(fne),(long)1));
               cen[ic] = ne[ic]*strawphys.meanElectronEnergy(); // average energy per electron, works for large numbers of electrons
             }
           }
@@ -745,14 +863,14 @@ namespace mu2e {
 
     void StrawDigisFromStrawGasSteps::driftCluster(
         StrawPhysics const& strawphys,Straw const& straw,
-        IonCluster const& cluster, WireCharge& wireq ) {
+        IonCluster const& cluster, RandomDists& rand, WireCharge& wireq ) {
       // sample the gain for this cluster
-      double gain = strawphys.clusterGain(_randgauss, _randflat, cluster._ne);
+      double gain = strawphys.clusterGain(rand._gauss, rand._flat, cluster._ne);
       wireq._charge = cluster._charge*(gain);
       // compute drift time for this cluster
       double dt = strawphys.driftDistanceToTime(cluster._pos._wirePosition.Rho(),cluster._pos._wirePosition.Phi()); // this is now from the lorentz corrected r-component of the drift
       wireq._pos = cluster._pos;
-      wireq._time = _randgauss.fire(dt,strawphys.driftTimeSpread(cluster._pos._wirePosition.Rho()));
+      wireq._time = rand._gauss.fire(dt,strawphys.driftTimeSpread(cluster._pos._wirePosition.Rho()));
     }
 
     void StrawDigisFromStrawGasSteps::propagateCharge(
@@ -792,14 +910,14 @@ namespace mu2e {
       if(clust.time() > _mbtime - _mbbuffer) shs.insert(StrawCluster(clust,-_mbtime));
     }
 
-    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings){
+    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, RandomDists& rand, WFXPList& xings){
       //randomize the threshold to account for electronics noise; this includes parts that are coherent
       // for both ends (coming from the straw itself)
       // Keep track of crossings on each end to keep them in sequence
-      double strawnoise = _randgauss.fire(0,strawele.strawNoise());
+      double strawnoise = rand._gauss.fire(0,strawele.strawNoise());
       // add specifics for each end
-      double thresh[2] = {_randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
-        _randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
+      double thresh[2] = {rand._gauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
+        rand._gauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
       // Initialize search when the electronics becomes enabled:
       double tstart =strawele.digitizationStartFromMarker() - _flashbuffer;
       // for reading all hits, make sure we start looking for clusters at the minimum possible cluster time
@@ -822,14 +940,14 @@ namespace mu2e {
           if(std::min(wfx[0]._time,wfx[1]._time) > 0.0 )xings.push_back(wfx);
           // search for next crossing:
           // update threshold for straw noise
-          strawnoise = _randgauss.fire(0,strawele.strawNoise());
+          strawnoise = rand._gauss.fire(0,strawele.strawNoise());
           for(unsigned iend=0;iend<2;++iend){
             // insure a minimum time buffer between crossings
             wfx[iend]._time += strawele.deadTimeAnalog();
             // skip to the next clust
             ++(wfx[iend]._iclust);
             // update threshold for incoherent noise
-            thresh[iend] = _randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
+            thresh[iend] = rand._gauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
             // find next crossing
             crosses[iend] = swfp[iend].crossesThreshold(strawele,thresh[iend],wfx[iend]);
           }
@@ -847,6 +965,7 @@ namespace mu2e {
         StrawElectronics const& strawele,
         WFXPList const& xings, SWFP const& wf,
         StrawId sid,
+        RandomDists& rand,
         StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis ) {
       //
@@ -856,7 +975,7 @@ namespace mu2e {
       for(auto xpair : xings) {
         // create a digi from this pair.  This also performs a finial test
         // on whether the pair should make a digi
-        if(createDigi(strawele,xpair,wf,sid,digis,digiadcs,digitization_ready_time)){
+        if(createDigi(strawele,xpair,wf,sid,rand,digis,digiadcs,digitization_ready_time)){
           // fill associated MC truth matching. Only count the same step once
           StrawDigiMC::SGSPA sgspa;
           StrawDigiMC::PA cpos;
@@ -891,7 +1010,7 @@ namespace mu2e {
     }
 
     bool StrawDigisFromStrawGasSteps::createDigi(StrawElectronics const& strawele, WFXP const& xpair, SWFP const& waveform,
-        StrawId sid, StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
+        StrawId sid, RandomDists& rand, StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
       // initialize the float variables that we later digitize
       TDCTimes xtimes = {0.0,0.0};
       TrkTypes::TOTValues tot;
@@ -908,10 +1027,10 @@ namespace mu2e {
         WFX const& wfx = xpair[iend];
         // record the crossing time for this end, including clock jitter  These already include noise effects
         // add noise for TDC on each side
-        double tdc_jitter = _randgauss.fire(0.0,strawele.TDCResolution());
+        double tdc_jitter = rand._gauss.fire(0.0,strawele.TDCResolution());
         xtimes[iend] = wfx._time+dt+tdc_jitter;
         // randomize threshold using the incoherent noise
-        double threshold = _randgauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
+        double threshold = rand._gauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
         // find TOT
         tot[iend] = waveform[iend].digitizeTOT(strawele,threshold,wfx._time + dt);
         // sample ADC
@@ -926,7 +1045,7 @@ namespace mu2e {
       // add ends and add noise
       ADCVoltages wfsum; wfsum.reserve(adctimes.size());
       for(unsigned isamp=0;isamp<adctimes.size();++isamp){
-        wfsum.push_back(wf[0][isamp]+wf[1][isamp]+_randgauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
+        wfsum.push_back(wf[0][isamp]+wf[1][isamp]+rand._gauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
       }
       // digitize, and make final test.  This call includes the clock error WRT the proton pulse
       TrkTypes::TDCValues tdcs;
@@ -979,24 +1098,24 @@ namespace mu2e {
       // create random noise clusts and add them to the sequences of random straws.
     }
 
-    void StrawDigisFromStrawGasSteps::fillClusterPositions(StrawGasStep const& sgs, Straw const& straw, std::vector<StrawCoordinates>& cposv) {
+    void StrawDigisFromStrawGasSteps::fillClusterPositions(StrawGasStep const& sgs, Straw const& straw, RandomDists& rand, std::vector<StrawCoordinates>& cposv) {
       // generate a random position between the start and end points.
       XYZVectorF path = sgs.endPosition() - sgs.startPosition();
       for(auto& cpos : cposv) {
-        XYZVectorF pos = sgs.startPosition() + _randflat.fire(1.0)*path;
+        XYZVectorF pos = sgs.startPosition() + rand._flat.fire(1.0)*path;
         // randomize the position by width.  This needs to be 2-d to avoid problems at the origin
         if(_randrad){
           XYZVectorF sdir = XYZVectorF(straw.getDirection());
           XYZVectorF p1 = path.Cross(sdir).Unit();
           XYZVectorF p2 = path.Cross(p1).Unit();
-          pos += p1*_randgauss.fire()*sgs.width();
-          pos += p2*_randgauss.fire()*sgs.width();
+          pos += p1*rand._gauss.fire()*sgs.width();
+          pos += p2*rand._gauss.fire()*sgs.width();
         }
         cpos = strawCoordinates(pos,straw);
       }
     }
 
-    void StrawDigisFromStrawGasSteps::fillClusterMinion(StrawPhysics const& strawphys, StrawGasStep const& step, std::vector<unsigned>& ne, std::vector<float>& cen) {
+    void StrawDigisFromStrawGasSteps::fillClusterMinion(StrawPhysics const& strawphys, StrawGasStep const& step, RandomDists& rand, std::vector<unsigned>& ne, std::vector<float>& cen) {
       // Loop until we've assigned energy + electrons to every cluster
       unsigned mc(0);
       double esum(0.0);
@@ -1005,7 +1124,7 @@ namespace mu2e {
       while(mc < nc){
         std::vector<unsigned> me(nc);
         // fill an array of random# of electrons according to the measured distribution.
-        fillClusterNe(strawphys,me);
+        fillClusterNe(strawphys,rand,me);
         // loop through these as long as there's enough energy to have at least 1 electron in each cluster.  If not, re-throw the # of electrons/cluster for the remainder
         for(auto ie : me) {
           double emax = etot - esum - (nc -mc -1)*strawphys.ionizationEnergy((unsigned)1);
@@ -1023,12 +1142,12 @@ namespace mu2e {
       // distribute any residual energy randomly to these clusters.  This models delta rays
       unsigned ns;
       do{
-        unsigned me = strawphys.nePerIon(_randflat.fire());
+        unsigned me = strawphys.nePerIon(rand._flat.fire());
         double emax = etot - esum;
         double eele = strawphys.ionizationEnergy(me);
         if(eele < emax){
           // choose a random cluster to assign this energy to
-          unsigned mc = std::min(nc-1,static_cast<unsigned>(floor(_randflat.fire(nc))));
+          unsigned mc = std::min(nc-1,static_cast<unsigned>(floor(rand._flat.fire(nc))));
           ne[mc] += me;
           cen[mc] += eele;
           esum += eele;
@@ -1038,9 +1157,9 @@ namespace mu2e {
       } while(ns > 0);
     }
 
-    void StrawDigisFromStrawGasSteps::fillClusterNe(StrawPhysics const& strawphys,std::vector<unsigned>& me) {
+    void StrawDigisFromStrawGasSteps::fillClusterNe(StrawPhysics const& strawphys,RandomDists& rand,std::vector<unsigned>& me) {
       for(size_t ie=0;ie < me.size(); ++ie){
-        me[ie] = strawphys.nePerIon(_randflat.fire());
+        me[ie] = strawphys.nePerIon(rand._flat.fire());
       }
     }
 
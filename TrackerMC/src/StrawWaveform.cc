@@ -6,19 +6,44 @@
 // Original author David Brown, LBNL
 //
 #include "Offline/TrackerMC/inc/StrawWaveform.hh"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <boost/math/special_functions/binomial.hpp>
 
 using namespace std;
 namespace mu2e {
   using namespace TrkTypes;
   namespace TrackerMC {
-    StrawWaveform::StrawWaveform(Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
+    StrawWaveform::StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
       _cseq(hseq), _xtalk(xtalk), _straw(straw)
-    {}
+    {
+      StrawClusterList const& hlist = _cseq.clustList();
+      _cresp.reserve(hlist.size());
+      _tconst.reserve(hlist.size());
+      for(size_t iresp=0;iresp<nresp;++iresp){
+        _rconst[iresp].reserve(hlist.size());
+        _rsum[iresp].reserve(hlist.size()+1);
+        _rsum[iresp].push_back(0.0);
+      }
+      double tconst = -std::numeric_limits<double>::max();
+      for(size_t iclust=0;iclust<hlist.size();++iclust){
+        _cresp.push_back(strawele.clusterResponse(_straw,hlist[iclust].wireDistance()));
+        double tsat = hlist[iclust].time() + _cresp.back()._saturationTime;
+        tconst = std::max(tconst,tsat);
+        _tconst.push_back(tconst);
+        // sum in time order, as the direct sum over the clusts does
+        for(size_t iresp=0;iresp<nresp;++iresp){
+          double rconst = linearResponse(strawele,static_cast<Response>(iresp),iclust,tsat);
+          _rconst[iresp].push_back(rconst);
+          _rsum[iresp].push_back(_rsum[iresp].back() + rconst);
+        }
+      }
+    }
 
     StrawWaveform::StrawWaveform(StrawWaveform const& other) : _cseq(other._cseq),
-    _xtalk(other._xtalk), _straw(other._straw)
+    _xtalk(other._xtalk), _straw(other._straw), _cresp(other._cresp), _tconst(other._tconst),
+    _rconst(other._rconst), _rsum(other._rsum)
     {}
 
     bool StrawWaveform::crossesThreshold(StrawElectronics const& strawele,double threshold,WFX& wfx) const {
@@ -43,7 +68,7 @@ namespace mu2e {
             //// check if this clust could cross threshold
             //if(wfx._vstart + maxLinearResponse(wfx._iclust) > threshold){
             // check the actual response
-            double maxtime = wfx._iclust->time()+strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+            double maxtime = wfx._iclust->time()+maxResponseTime(strawele,wfx._iclust);
             double maxresp = sampleWaveform(strawele,StrawElectronics::thresh,maxtime);
             if(maxresp > threshold){
               // interpolate to find the precise crossing
@@ -64,7 +89,7 @@ namespace mu2e {
     void StrawWaveform::returnCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const {
       while(wfx._iclust != _cseq.clustList().end() && wfx._vstart > threshold) {
         // move forward in time at least as twice the time to the maxium for this clust
-        double time = wfx._iclust->time()+strawele.clusterLookbackTime() + 2*strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+        double time = wfx._iclust->time()+strawele.clusterLookbackTime() + 2*maxResponseTime(strawele,wfx._iclust);
         while(wfx._iclust != _cseq.clustList().end() &&
             wfx._iclust->time()-strawele.clusterLookbackTime() < time){
           ++(wfx._iclust);
@@ -95,7 +120,7 @@ namespace mu2e {
     bool StrawWaveform::fineCrossing(StrawElectronics const& strawele, double threshold,double maxresp, WFX& wfx) const {
       static double timestep(0.020); // interpolation minimum to use linear threshold crossing calculation
       double pretime = wfx._iclust->time()-strawele.clusterLookbackTime();
-      double posttime = pretime + strawele.clusterLookbackTime() + strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+      double posttime = pretime + strawele.clusterLookbackTime() + maxResponseTime(strawele,wfx._iclust);
       double presample = wfx._vstart;
       double postsample = maxresp;
       static const unsigned maxstep(10); // 10 steps max
@@ -141,22 +166,38 @@ namespace mu2e {
 
     double StrawWaveform::maxLinearResponse(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const {
       // ignore saturation effects
-      double linresp = strawele.maxLinearResponse(_straw.id(),StrawElectronics::thresh,iclust->wireDistance(),iclust->charge());
+      double linresp = strawele.maxLinearResponse(_straw.id(),StrawElectronics::thresh,_cresp[clustIndex(iclust)],iclust->charge());
       linresp *= (_xtalk._preamp + _xtalk._postamp);
       return linresp;
     }
 
-    double StrawWaveform::sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
-      // loop over all clusts and add their response at this time
+    double StrawWaveform::maxResponseTime(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const {
+      return strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,_cresp[clustIndex(iclust)]);
+    }
+
+    double StrawWaveform::linearResponse(StrawElectronics const& strawele,Response iresp,size_t iclust,double time) const {
+      StrawCluster const& clust = _cseq.clustList()[iclust];
+      StrawElectronics::Path ipath = iresp == adcresp ? StrawElectronics::adc : StrawElectronics::thresh;
+      return strawele.linearResponse(_straw,ipath,time-clust.time(),clust.charge(),_cresp[iclust],iresp == satresp);
+    }
+
+    double StrawWaveform::linearResponse(StrawElectronics const& strawele,Response iresp,double time) const {
       StrawClusterList const& hlist = _cseq.clustList();
-      double linresp(0.0);
-      auto iclust = hlist.begin();
-      while(iclust != hlist.end() && iclust->time()-strawele.clusterLookbackTime() < time){
-        // compute the linear straw electronics response to this charge.  This is pre-saturation
-        linresp += strawele.linearResponse(_straw,ipath,time-iclust->time(),iclust->charge(),iclust->wireDistance());
-        // move to next clust
-        ++iclust;
-      }
+      // clusts which arrived before this time
+      size_t nclust = std::partition_point(hlist.begin(),hlist.end(),
+          [&strawele,time](StrawCluster const& clust){ return clust.time()-strawele.clusterLookbackTime() < time; }) - hlist.begin();
+      // of those, the first ones whose response no longer changes
+      size_t nconst = std::partition_point(_tconst.begin(),_tconst.begin()+nclust,
+          [time](double tconst){ return tconst <= time; }) - _tconst.begin();
+      // add the response of the others at this time.  This is pre-saturation
+      double linresp = _rsum[iresp][nconst];
+      for(size_t iclust=nconst;iclust<nclust;++iclust)
+        linresp += linearResponse(strawele,iresp,iclust,time);
+      return linresp;
+    }
+
+    double StrawWaveform::sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
+      double linresp = linearResponse(strawele,ipath == StrawElectronics::adc ? adcresp : threshresp,time);
       double totresp = linresp * _xtalk._postamp;
       if(_xtalk._preamp>0.0)
         totresp += _xtalk._preamp*linresp;
@@ -198,18 +239,28 @@ namespace mu2e {
         for (size_t j=0;j<times.size();j++){
           volts.push_back(0);
         }
+        if (iclust == _cseq.clustList().end())
+          return;
 
         int num_steps = (int)ceil((times[times.size()-1]-iclust->time()-strawele.clusterLookbackTime())/strawele.saturationTimeStep());
 
+        // the window of clusts contributing to the current step slides forward with time
+        size_t nclust = clustIndex(iclust);
+        size_t nconst = nclust;
+        double rconst(0.0);
         for (int i=0;i<num_steps;i++){
           double time = iclust->time()-strawele.clusterLookbackTime() + i*strawele.saturationTimeStep();
-          // sum up the preamp response at this step
-          double response = 0;
-          auto jclust = iclust;
-          while(jclust != _cseq.clustList().end() && jclust->time()-strawele.clusterLookbackTime() < time){
-            response += strawele.linearResponse(_straw,StrawElectronics::thresh,time-jclust->time(),jclust->charge(),jclust->wireDistance(),true);
-            ++jclust;
+          while(nclust < _cseq.clustList().size() && _cseq.clustList()[nclust].time()-strawele.clusterLookbackTime() < time)
+            ++nclust;
+          // clusts whose response no longer changes are summed once
+          while(nconst < nclust && _cseq.clustList()[nconst].time() + _cresp[nconst]._saturationTime <= time){
+            rconst += _rconst[satresp][nconst];
+            ++nconst;
           }
+          // sum up the preamp response at this step
+          double response = rconst;
+          for(size_t jclust=nconst;jclust<nclust;++jclust)
+            response += linearResponse(strawele,satresp,jclust,time);
           // now saturate it
           double sat_response = strawele.saturatedResponse(response);
           // then calculate the impulse response at each of the adctimes and add it to that
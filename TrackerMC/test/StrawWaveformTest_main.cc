@@ -0,0 +1,581 @@
+//
+// Check that StrawWaveform and StrawElectronics digitize straws exactly as the code before
+// the per-cluster precomputation and the incremental sampling did.  The reference below is
+// that code: StrawElectronics::linearResponse, maxResponseTime and maxLinearResponse with the
+// linear search of the wire distance points and the reflection computed for every sample, the
+// StrawWaveform that sums all the clusters for every sample, and the StrawClusterSequence in
+// a std::list with a linear insertion.
+//
+// StrawElectronics is made from the StrawElectronics defaults of TrackerConditions/fcl/prolog.fcl,
+// as StrawElectronicsMaker does.  For made up straws, bursts of clusters as from the steps of a
+// track are digitized as StrawDigisFromStrawGasSteps does, by the self signal and by a
+// cross-talk signal, and the threshold crossings, TOT and ADC voltages are compared bit for
+// bit, as are samples of the waveforms at random times.  Some straws have enough charge to
+// take the saturated ADC path, and some bursts have clusters with equal times, which must be
+// kept in the same order.  It fails on any difference, or if these cases were not all met.
+//
+// arguments are
+// NSTRAW: optional, number of straws (default 200)
+// NCLUST: optional, largest number of clusters per straw (default 400)
+//
+// example:
+// StrawWaveformTest 1000 2000
+//
+#include "Offline/TrackerConditions/inc/StrawElectronics.hh"
+#include "Offline/TrackerGeom/inc/Straw.hh"
+#include "Offline/TrackerMC/inc/StrawClusterSequence.hh"
+#include "Offline/TrackerMC/inc/StrawWaveform.hh"
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+using namespace mu2e::TrackerMC;
+
+namespace {
+
+  using WireDistancePoint = StrawElectronics::WireDistancePoint;
+  using ReferenceList = std::list<StrawCluster>;
+
+  // StrawElectronics defaults of TrackerConditions/fcl/prolog.fcl
+  const int responseBins(10000);
+  const double sampleRate(10.0);
+  const std::vector<double> preampPoles{160., 6.}, preampZeros{0.2}, adcPoles{160., 6., 1.45}, adcZeros{0.2};
+  const std::vector<double> preampToAdc1Poles{160., 6.}, preampToAdc1Zeros{0.2}, preampToAdc2Poles{1.45}, preampToAdc2Zeros{};
+  const std::vector<double> wireDistances{0., 300., 600., 900., 1200.};
+  const std::vector<double> currentMeans{0, -0.1806, -0.3613, -0.5419, -0.7226};
+  const std::vector<double> currentNormalizations{1.0, 0.97931167, 0.91455972, 0.83082332, 0.7414788};
+  const std::vector<double> currentSigmas{2.24, 2.24, 2.24, 2.24, 2.24};
+  const std::vector<double> currentT0s{0.8, 1.26, 1.72, 2.17, 2.63};
+  const double reflectionTimeShift(5.08), reflectionVelocity(513.8), reflectionALength(2568.), reflectionFrac(0.58);
+  const double thresholddVdI(8.43e6), adcdVdI(1.528e6), threshold(12.0);
+  const double maxTime(1800.0);
+
+  // The response computed as StrawElectronics did before ClusterResponse, from the same wire
+  // distance points and gains.
+  class ReferenceElectronics {
+    public:
+      ReferenceElectronics(std::vector<WireDistancePoint> const& wpoints) : _wPoints(wpoints), _dVdI{thresholddVdI, adcdVdI} {}
+
+      void distanceBin(double distance, int& distIndex, double& distFrac) const {
+        distIndex = 0;
+        for (size_t i=1;i<_wPoints.size()-1;i++){
+          if (distance < _wPoints[i]._distance)
+            break;
+          distIndex = i;
+        }
+        distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+      }
+      double reflectionTime(Straw const& straw, double distance) const {
+        double straw_length = 2*straw.halfLength();
+        return reflectionTimeShift + (2*straw_length-2*distance)/reflectionVelocity;
+      }
+      double reflectionScale(Straw const& straw, double distance) const {
+        double straw_length = 2*straw.halfLength();
+        return reflectionFrac * exp(-(2*straw_length-2*distance)/reflectionALength);
+      }
+
+      double linearResponse(Straw const& straw, StrawElectronics::Path ipath, double time, double charge, double distance, bool forsaturation=false) const {
+        int index = time*sampleRate + responseBins/2.;
+        if ( index >= responseBins)
+          index = responseBins-1;
+        if (index < 0)
+          index = 0;
+
+        int index_refl = (time - reflectionTime(straw,distance))*sampleRate + responseBins/2.;
+        if (index_refl >= responseBins)
+          index_refl = responseBins-1;
+        if (index_refl < 0)
+          index_refl = 0;
+
+        double reflection_scale = reflectionScale(straw,distance);
+        int distIndex;
+        double distFrac;
+        distanceBin(distance,distIndex,distFrac);
+        double p0, p1;
+        if (ipath == StrawElectronics::thresh){
+          if (forsaturation){
+            p0 = _wPoints[distIndex]._preampToAdc1Response[index]      + _wPoints[distIndex]._preampToAdc1Response[index_refl]*reflection_scale;
+            p1 = _wPoints[distIndex + 1]._preampToAdc1Response[index]  + _wPoints[distIndex + 1]._preampToAdc1Response[index_refl]*reflection_scale;
+          }else{
+            p0 = _wPoints[distIndex]._preampResponse[index]      + _wPoints[distIndex]._preampResponse[index_refl]*reflection_scale;
+            p1 = _wPoints[distIndex + 1]._preampResponse[index]  + _wPoints[distIndex + 1]._preampResponse[index_refl]*reflection_scale;
+          }
+        }else{
+          p0 = _wPoints[distIndex]._adcResponse[index]      + _wPoints[distIndex]._adcResponse[index_refl]*reflection_scale;
+          p1 = _wPoints[distIndex + 1]._adcResponse[index]  + _wPoints[distIndex + 1]._adcResponse[index_refl]*reflection_scale;
+        }
+        return charge * ( p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath];
+      }
+
+      double maxResponseTime(StrawId sid, StrawElectronics::Path ipath, double distance) const {
+        int distIndex;
+        double distFrac;
+        distanceBin(distance,distIndex,distFrac);
+        double p0 = _wPoints[distIndex]._tmax[ipath][sid.getStraw()];
+        double p1 = _wPoints[distIndex + 1]._tmax[ipath][sid.getStraw()];
+        return p0 * distFrac + p1 * (1 - distFrac);
+      }
+
+      double maxLinearResponse(StrawId sid, StrawElectronics::Path ipath, double distance, double charge) const {
+        int distIndex;
+        double distFrac;
+        distanceBin(distance,distIndex,distFrac);
+        double p0 = _wPoints[distIndex]._linmax[ipath][sid.getStraw()];
+        double p1 = _wPoints[distIndex + 1]._linmax[ipath][sid.getStraw()];
+        return charge * (p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath];
+      }
+
+    private:
+      std::vector<WireDistancePoint> const& _wPoints;
+      double _dVdI[StrawElectronics::npaths];
+  };
+
+  // the insertion of StrawClusterSequence before the clusters were stored in a vector
+  void referenceInsert(ReferenceList& clist, StrawCluster const& clust) {
+    auto ibefore = clist.begin();
+    while(ibefore != clist.end() && ibefore->time() < clust.time())
+      ++ibefore;
+    clist.insert(ibefore,clust);
+  }
+
+  struct ReferenceCrossing {
+    double _time, _vstart, _vcross;
+    ReferenceList::const_iterator _iclust;
+  };
+
+  // StrawWaveform before the per-cluster precomputation and the incremental sampling
+  class ReferenceWaveform {
+    public:
+      ReferenceWaveform(ReferenceElectronics const& ref, Straw const& straw, ReferenceList const& clist, XTalk const& xtalk) :
+        _ref(ref), _clist(clist), _xtalk(xtalk), _straw(straw) {}
+
+      bool saturated(StrawElectronics const& strawele) const {
+        double max_possible_voltage = 0;
+        for (auto iclust = _clist.begin();iclust != _clist.end();++iclust)
+          max_possible_voltage += maxLinearResponse(iclust);
+        return max_possible_voltage > strawele.saturationVoltage();
+      }
+
+      bool crossesThreshold(StrawElectronics const& strawele,double threshold,ReferenceCrossing& wfx) const {
+        bool retval(false);
+        while(wfx._iclust != _clist.end() && wfx._iclust->time()-strawele.clusterLookbackTime()< wfx._time ){
+          ++(wfx._iclust);
+        }
+        if(wfx._iclust != _clist.end()){
+          wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
+          if(wfx._vstart > threshold)
+            returnCrossing(strawele,threshold, wfx);
+          if(roughCrossing(strawele,threshold,wfx)) {
+            while(wfx._iclust != _clist.end() ){
+              wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
+              double maxtime = wfx._iclust->time()+_ref.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+              double maxresp = sampleWaveform(strawele,StrawElectronics::thresh,maxtime);
+              if(maxresp > threshold){
+                fineCrossing(strawele,threshold,maxresp,wfx);
+                retval = true;
+                break;
+              }
+              ++(wfx._iclust);
+            }
+          }
+        }
+        return retval;
+      }
+
+      double sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
+        double linresp(0.0);
+        auto iclust = _clist.begin();
+        while(iclust != _clist.end() && iclust->time()-strawele.clusterLookbackTime() < time){
+          linresp += _ref.linearResponse(_straw,ipath,time-iclust->time(),iclust->charge(),iclust->wireDistance());
+          ++iclust;
+        }
+        double totresp = linresp * _xtalk._postamp;
+        if(_xtalk._preamp>0.0)
+          totresp += _xtalk._preamp*linresp;
+        return totresp;
+      }
+
+      void sampleADCWaveform(StrawElectronics const& strawele,TrkTypes::ADCTimes const& times,TrkTypes::ADCVoltages& volts) const {
+        volts.clear();
+        volts.reserve(times.size());
+        if (_xtalk._dest != _xtalk._source){
+          for (size_t j=0;j<times.size();j++)
+            volts.push_back(0);
+          return;
+        }
+        if (saturated(strawele)){
+          auto iclust = _clist.begin();
+          while (iclust != _clist.end()){
+            double time = iclust->time()-strawele.clusterLookbackTime();
+            if (time + strawele.truncationTime(StrawElectronics::thresh) > times[0])
+              break;
+            else
+              ++iclust;
+          }
+          for (size_t j=0;j<times.size();j++)
+            volts.push_back(0);
+          int num_steps = (int)ceil((times[times.size()-1]-iclust->time()-strawele.clusterLookbackTime())/strawele.saturationTimeStep());
+          for (int i=0;i<num_steps;i++){
+            double time = iclust->time()-strawele.clusterLookbackTime() + i*strawele.saturationTimeStep();
+            double response = 0;
+            auto jclust = iclust;
+            while(jclust != _clist.end() && jclust->time()-strawele.clusterLookbackTime() < time){
+              response += _ref.linearResponse(_straw,StrawElectronics::thresh,time-jclust->time(),jclust->charge(),jclust->wireDistance(),true);
+              ++jclust;
+            }
+            double sat_response = strawele.saturatedResponse(response);
+            for (size_t j=0;j<times.size();j++)
+              volts[j] += strawele.adcImpulseResponse(_straw.id(),times[j]-time,sat_response);
+          }
+        }else{
+          for(auto itime=times.begin();itime!=times.end();++itime)
+            volts.push_back(sampleWaveform(strawele,StrawElectronics::adc,*itime));
+        }
+      }
+
+      unsigned short digitizeTOT(StrawElectronics const& strawele, double threshold, double time) const {
+        for (size_t i=1;i<strawele.maxTOT();i++){
+          if (sampleWaveform(strawele,StrawElectronics::thresh,time + i*strawele.totLSB()) < threshold - strawele.triggerHysteresis())
+            return static_cast<unsigned short>(i);
+        }
+        return static_cast<unsigned short>(strawele.maxTOT());
+      }
+
+    private:
+      ReferenceElectronics const& _ref;
+      ReferenceList const& _clist;
+      XTalk _xtalk;
+      Straw const& _straw;
+
+      double maxLinearResponse(ReferenceList::const_iterator const& iclust) const {
+        double linresp = _ref.maxLinearResponse(_straw.id(),StrawElectronics::thresh,iclust->wireDistance(),iclust->charge());
+        linresp *= (_xtalk._preamp + _xtalk._postamp);
+        return linresp;
+      }
+
+      void returnCrossing(StrawElectronics const& strawele, double threshold, ReferenceCrossing& wfx) const {
+        while(wfx._iclust != _clist.end() && wfx._vstart > threshold) {
+          double time = wfx._iclust->time()+strawele.clusterLookbackTime() + 2*_ref.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+          while(wfx._iclust != _clist.end() && wfx._iclust->time()-strawele.clusterLookbackTime() < time){
+            ++(wfx._iclust);
+          }
+          if(wfx._iclust != _clist.end()){
+            wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
+            wfx._time =wfx._iclust->time()-strawele.clusterLookbackTime();
+          }
+        }
+      }
+
+      bool roughCrossing(StrawElectronics const& strawele, double threshold, ReferenceCrossing& wfx) const {
+        double resp = wfx._vstart;
+        while(wfx._iclust != _clist.end()){
+          resp += maxLinearResponse(wfx._iclust);
+          if(resp > threshold)break;
+          ++(wfx._iclust);
+        }
+        if(wfx._iclust != _clist.end() )
+          wfx._time = wfx._iclust->time()-strawele.clusterLookbackTime();
+        return wfx._iclust != _clist.end() && resp > threshold;
+      }
+
+      bool fineCrossing(StrawElectronics const& strawele, double threshold,double maxresp, ReferenceCrossing& wfx) const {
+        static double timestep(0.020);
+        double pretime = wfx._iclust->time()-strawele.clusterLookbackTime();
+        double posttime = pretime + strawele.clusterLookbackTime() + _ref.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+        double presample = wfx._vstart;
+        double postsample = maxresp;
+        static const unsigned maxstep(10);
+        unsigned nstep(0);
+        double deltat = posttime-pretime;
+        double dt = deltat;
+        double slope = deltat/(postsample-presample);
+        double time = pretime + slope*(threshold-presample);
+        while(fabs(dt) > timestep && nstep < maxstep) {
+          double sample = sampleWaveform(strawele,StrawElectronics::thresh,time);
+          if(sample > threshold){
+            posttime = time;
+            postsample = sample;
+          } else {
+            pretime = time;
+            presample = sample;
+          }
+          deltat = posttime-pretime;
+          slope = deltat/(postsample-presample);
+          double oldtime = time;
+          time = pretime + slope*(threshold-presample);
+          dt = time-oldtime;
+          ++nstep;
+        }
+        wfx._time = time;
+        wfx._vcross = threshold;
+        while(wfx._iclust != _clist.end() && wfx._iclust->time()-strawele.clusterLookbackTime() < wfx._time){
+          ++(wfx._iclust);
+        }
+        if(wfx._iclust != _clist.begin())--(wfx._iclust);
+        return dt < timestep;
+      }
+  };
+
+  // StrawElectronics as StrawElectronicsMaker makes it from the prolog defaults
+  std::shared_ptr<StrawElectronics> makeElectronics(std::vector<Straw> const& straws, std::vector<WireDistancePoint>& wPoints) {
+    auto ptr = std::make_shared<StrawElectronics>(false, 100.0, 400.0, 140.0, 1.25, 1.953125, 1024, 1, 5, 20.0, 2.0, 2,
+        0.01953125, (0x1u<<24)-1, 5.0, 15, 0.1, 0.0, 0.5, 450.0, 1705.0,
+        responseBins, sampleRate, 25,
+        preampPoles, preampZeros, adcPoles, adcZeros, preampToAdc1Poles, preampToAdc1Zeros, preampToAdc2Poles, preampToAdc2Zeros,
+        wireDistances, currentMeans, currentNormalizations, currentSigmas, currentT0s,
+        reflectionTimeShift, reflectionVelocity, reflectionALength, reflectionFrac, 2.0, 5.0);
+
+    std::array<double, StrawId::_nupanels> timeOffsetPanel;
+    std::array<double, StrawId::_nustraws> timeOffsetStraw;
+    timeOffsetPanel.fill(0);
+    timeOffsetStraw.fill(0);
+    ptr->setOffsets(timeOffsetPanel,timeOffsetStraw,timeOffsetStraw);
+    std::array<double, StrawId::_nustraws> dVdI;
+    dVdI.fill(thresholddVdI);
+    ptr->setdVdI(dVdI,StrawElectronics::thresh);
+    dVdI.fill(adcdVdI);
+    ptr->setdVdI(dVdI,StrawElectronics::adc);
+    ptr->setAnalogNoise({1.25, 0.9});
+    std::array<double, StrawId::_nustrawends> vthresh;
+    vthresh.fill(threshold);
+    ptr->setvthresh(vthresh);
+    std::array<uint16_t, StrawId::_nustraws> ADCped;
+    ADCped.fill((TrkTypes::ADCValue)((1024+1)/2. - threshold/1.953125 * 20));
+    ptr->setADCPed(ADCped);
+    ptr->setttrunc({(responseBins/2)/sampleRate, (responseBins/2)/sampleRate});
+
+    auto currentImpulse = std::vector<double>(responseBins,0);
+    currentImpulse[responseBins/2] = 1;
+    auto preampToAdc2Response = std::vector<double>(responseBins,0);
+    ptr->calculateResponse(preampToAdc2Poles,preampToAdc2Zeros,currentImpulse,preampToAdc2Response);
+    ptr->setCurrentImpulse(currentImpulse);
+
+    const double pC_per_uA_ns{1000};
+    auto integral_normalization = log(responseBins/2/sampleRate + currentT0s[0]) - log(currentT0s[0]);
+    wPoints.clear();
+    for (size_t ai=0;ai<wireDistances.size();ai++){
+      wPoints.emplace_back(wireDistances[ai],currentMeans[ai],currentNormalizations[ai],currentSigmas[ai],currentT0s[ai]);
+      auto& wpoint = wPoints[ai];
+      wpoint._currentPulse = std::vector<double>(responseBins,0);
+      double integral = 0;
+      for (int i=0;i<responseBins;i++){
+        double t_gaus = (i-responseBins/2)/sampleRate;
+        double val_gaus = 1/sqrt(TMath::TwoPi()*wpoint._sigma*wpoint._sigma)*exp(-((t_gaus-wpoint._mean)*(t_gaus-wpoint._mean))/(2*wpoint._sigma*wpoint._sigma));
+        for (int j=0;j<responseBins-i;j++){
+          double val = val_gaus / (j/sampleRate + wpoint._t0);
+          wpoint._currentPulse[i+j] += val;
+          integral += val;
+        }
+      }
+      for (int i=0;i<responseBins;i++){
+        wpoint._currentPulse[i] /= sampleRate * pC_per_uA_ns;
+        wpoint._currentPulse[i] /= integral_normalization;
+        wpoint._currentPulse[i] *= wpoint._normalization;
+      }
+      wpoint._preampResponse = std::vector<double>(responseBins,0);
+      wpoint._adcResponse = std::vector<double>(responseBins,0);
+      wpoint._preampToAdc1Response = std::vector<double>(responseBins,0);
+      ptr->calculateResponse(preampPoles,preampZeros,wpoint._currentPulse,wpoint._preampResponse);
+      ptr->calculateResponse(adcPoles,adcZeros,wpoint._currentPulse,wpoint._adcResponse);
+      ptr->calculateResponse(preampToAdc1Poles,preampToAdc1Zeros,wpoint._currentPulse,wpoint._preampToAdc1Response);
+      double preampToAdc1Max = *std::max_element(wpoint._preampToAdc1Response.begin(),wpoint._preampToAdc1Response.end());
+      double linmax_thresh = *std::max_element(wpoint._preampResponse.begin(),wpoint._preampResponse.end());
+      for (int i=0;i<responseBins;i++)
+        wpoint._preampToAdc1Response[i] *= linmax_thresh/preampToAdc1Max;
+    }
+
+    std::vector<double> preampToAdc2test(responseBins,0);
+    ptr->calculateResponse(preampToAdc2Poles,preampToAdc2Zeros,wPoints[0]._preampToAdc1Response,preampToAdc2test);
+    ptr->setwPoints(wPoints);
+    double preampToAdc2Max = *std::max_element(preampToAdc2test.begin(),preampToAdc2test.end());
+    double linmax_adc = *std::max_element(wPoints[0]._adcResponse.begin(),wPoints[0]._adcResponse.end());
+    for (int i=0;i<responseBins;i++)
+      preampToAdc2Response[i] *= linmax_adc/preampToAdc2Max;
+    ptr->setPreampToAdc2Response(preampToAdc2Response);
+
+    for (auto& wpoint : wPoints){
+      for (size_t ipath=0;ipath<StrawElectronics::npaths;ipath++){
+        for (size_t is=0;is<StrawId::_nstraws;is++){
+          double tmax = 0;
+          double linmax = -9e9;
+          for (int k=-5*sampleRate;k<20*sampleRate;k++){
+            double time = k/sampleRate;
+            double resp = ptr->linearResponse(straws[is],static_cast<StrawElectronics::Path>(ipath),time,1e-9,wpoint._distance,false)
+              /(ipath == StrawElectronics::thresh ? thresholddVdI : adcdVdI);
+            if (resp > linmax){
+              linmax = resp;
+              tmax = time;
+            }
+          }
+          wpoint._tmax[ipath][is] = tmax;
+          wpoint._linmax[ipath][is] = linmax*1e9;
+        }
+      }
+    }
+    ptr->setwPoints(wPoints);
+    return ptr;
+  }
+
+  struct Digi {
+    double time, vstart, vcross;
+    long iclust;
+    unsigned short tot;
+    TrkTypes::ADCVoltages volts;
+  };
+
+  bool same(Digi const& a, Digi const& b) {
+    return a.time == b.time && a.vstart == b.vstart && a.vcross == b.vcross && a.iclust == b.iclust
+      && a.tot == b.tot && a.volts == b.volts;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  int nStraw = argc > 1 ? std::stoi(argv[1]) : 200;
+  int nClust = argc > 2 ? std::stoi(argv[2]) : 400;
+
+  std::vector<Straw> straws;
+  for(unsigned is=0; is<StrawId::_nstraws; ++is)
+    straws.emplace_back(StrawId(0,0,is), CLHEP::Hep3Vector(0.,0.,0.), 300.+5.*is);
+  std::vector<WireDistancePoint> wPoints;
+  auto strawelePtr = makeElectronics(straws,wPoints);
+  StrawElectronics const& strawele = *strawelePtr;
+  ReferenceElectronics ref(wPoints);
+
+  int nBad(0);
+  // the distance dependent part of the response, including distances on the wire distance points and beyond them
+  std::mt19937 gen(24680);
+  std::uniform_real_distribution<double> flat(0.,1.);
+  std::vector<double> distances(wireDistances);
+  for(int i=0; i<10000; ++i) distances.push_back(-100. + 1400.*flat(gen));
+  for(auto distance : distances){
+    Straw const& straw = straws[gen()%straws.size()];
+    auto cresp = strawele.clusterResponse(straw,distance);
+    int distIndex;
+    double distFrac;
+    ref.distanceBin(distance,distIndex,distFrac);
+    if(cresp._distIndex != distIndex || cresp._distFrac != distFrac
+        || cresp._reflectionTime != ref.reflectionTime(straw,distance) || cresp._reflectionScale != ref.reflectionScale(straw,distance)){
+      std::cout<<"StrawWaveformTest: clusterResponse differs at wire distance "<<distance<<std::endl;
+      ++nBad;
+    }
+  }
+
+  long nDigi(0), nSamples(0), nSaturated(0), nUnsaturated(0), nEqualTimes(0);
+  double tNew(0), tRef(0);
+  for(int istraw=0; istraw<nStraw; ++istraw){
+    Straw const& straw = straws[istraw%straws.size()];
+    StrawClusterSequence seq(straw.id(),StrawEnd::cal);
+    ReferenceList clist;
+    // bursts of clusters as from the steps of a track, a few with equal times, a few with large charges
+    int ncl = 1 + int(flat(gen)*nClust);
+    for(int icl=0; icl<ncl; ){
+      double t0 = -50. + 1800.*flat(gen);
+      double wdist = 2*straw.halfLength()*flat(gen);
+      bool equaltimes = flat(gen) < 0.1;
+      int nburst = 1 + int(flat(gen)*40);
+      for(int ib=0; ib<nburst && icl<ncl; ++ib,++icl){
+        float time = equaltimes ? t0 : t0 + 30.*flat(gen);
+        float charge = 5.e-3*flat(gen)*(flat(gen) < 0.05 ? 10. : 1.);
+        StrawCluster clust(StrawCluster::primary,straw.id(),StrawEnd::cal,time,charge,wdist,StrawCoordinates(),0.f,0.f,art::Ptr<StrawGasStep>(),0.f);
+        seq.insert(clust);
+        referenceInsert(clist,clust);
+      }
+    }
+    auto const& clusts = seq.clustList();
+    if(clusts.size() != clist.size() || !std::equal(clusts.begin(),clusts.end(),clist.begin(),[](StrawCluster const& a, StrawCluster const& b){
+          return a.time() == b.time() && a.charge() == b.charge() && a.wireDistance() == b.wireDistance(); })){
+      std::cout<<"StrawWaveformTest: cluster order differs for straw "<<istraw<<std::endl;
+      ++nBad;
+      continue;
+    }
+    for(size_t icl=1; icl<clusts.size(); ++icl)
+      if(clusts[icl].time() == clusts[icl-1].time()) ++nEqualTimes;
+
+    // the self signal and a cross-talk signal
+    for(int ix=0; ix<2; ++ix){
+      XTalk xtalk = ix == 0 ? XTalk(straw.id()) : XTalk(straw.id(),straws[(istraw+1)%straws.size()].id(),0.1,0.02);
+      std::vector<Digi> newDigis, refDigis;
+
+      auto t0 = std::chrono::steady_clock::now();
+      StrawWaveform wf(strawele,straw,seq,xtalk);
+      WFX wfx(wf,0.0);
+      while(wf.crossesThreshold(strawele,threshold,wfx) && wfx._time < maxTime){
+        Digi digi{wfx._time,wfx._vstart,wfx._vcross,std::distance(clusts.begin(),wfx._iclust),
+          wf.digitizeTOT(strawele,threshold,wfx._time),{}};
+        TrkTypes::ADCTimes adctimes;
+        strawele.adcTimes(wfx._time,adctimes);
+        wf.sampleADCWaveform(strawele,adctimes,digi.volts);
+        newDigis.push_back(digi);
+        wfx._time += strawele.deadTimeAnalog();
+        ++wfx._iclust;
+      }
+      auto t1 = std::chrono::steady_clock::now();
+      ReferenceWaveform rwf(ref,straw,clist,xtalk);
+      ReferenceCrossing rwfx{0.0,0.0,0.0,clist.begin()};
+      while(rwf.crossesThreshold(strawele,threshold,rwfx) && rwfx._time < maxTime){
+        Digi digi{rwfx._time,rwfx._vstart,rwfx._vcross,std::distance(clist.cbegin(),rwfx._iclust),
+          rwf.digitizeTOT(strawele,threshold,rwfx._time),{}};
+        TrkTypes::ADCTimes adctimes;
+        strawele.adcTimes(rwfx._time,adctimes);
+        rwf.sampleADCWaveform(strawele,adctimes,digi.volts);
+        refDigis.push_back(digi);
+        rwfx._time += strawele.deadTimeAnalog();
+        ++rwfx._iclust;
+      }
+      auto t2 = std::chrono::steady_clock::now();
+      tNew += std::chrono::duration<double>(t1-t0).count();
+      tRef += std::chrono::duration<double>(t2-t1).count();
+
+      if(newDigis.size() != refDigis.size() || !std::equal(newDigis.begin(),newDigis.end(),refDigis.begin(),same)){
+        std::cout<<"StrawWaveformTest: digis differ for straw "<<istraw<<(ix == 0 ? "" : " cross-talk")
+          <<", "<<newDigis.size()<<" against "<<refDigis.size()<<" reference digis"<<std::endl;
+        ++nBad;
+      }
+      nDigi += newDigis.size();
+      if(ix == 0 && !newDigis.empty()){
+        if(rwf.saturated(strawele))
+          ++nSaturated;
+        else
+          ++nUnsaturated;
+      }
+
+      for(int isample=0; isample<20; ++isample){
+        double time = -60. + 1900.*flat(gen);
+        for(auto ipath : {StrawElectronics::thresh,StrawElectronics::adc}){
+          if(wf.sampleWaveform(strawele,ipath,time) != rwf.sampleWaveform(strawele,ipath,time)){
+            std::cout<<"StrawWaveformTest: waveform differs for straw "<<istraw<<" at time "<<time<<std::endl;
+            ++nBad;
+          }
+          ++nSamples;
+        }
+      }
+    }
+  }
+
+  std::cout<<"StrawWaveformTest: "<<nStraw<<" straws, "<<nDigi<<" digis, "<<nSamples<<" samples, "
+    <<nSaturated<<" straws with saturated and "<<nUnsaturated<<" with unsaturated digis, "<<nEqualTimes<<" clusters at the time of the previous one"<<std::endl;
+  std::cout<<"digitization time "<<tNew<<" s, reference "<<tRef<<" s"<<std::endl;
+  if(nBad > 0){
+    std::cout<<"StrawWaveformTest FAILED "<<nBad<<" differences"<<std::endl;
+    return 1;
+  }
+  if(nSaturated == 0 || nUnsaturated == 0 || nEqualTimes == 0){
+    std::cout<<"StrawWaveformTest FAILED: the straws do not cover the saturated, unsaturated and equal time cases"<<std::endl;
+    return 1;
+  }
+  std::cout<<"StrawWaveformTest passed"<<std::endl;
+  return 0;
+}
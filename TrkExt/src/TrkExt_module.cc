@@ -494,26 +494,34 @@ namespace mu2e {
       double & byx, double & byy, double & byz,
       double & bzx, double & bzy, double & bzz) {
 
-    Hep3Vector B0 = getBField(x);
-
     if (_bFieldGradientMode == 1) {
       double xx = x.x();
       double yy = x.y();
       double zz = x.z();
       double h = 5.;
-      Hep3Vector mx (xx-h,yy,zz);
-      Hep3Vector px (xx+h,yy,zz);
-      Hep3Vector my (xx,yy-h,zz);
-      Hep3Vector py (xx,yy+h,zz);
-      Hep3Vector mz (xx,yy,zz-h);
-      Hep3Vector pz (xx,yy,zz+h);
-
-      Hep3Vector Bmx = getBField(mx);
-      Hep3Vector Bpx = getBField(px);
-      Hep3Vector Bmy = getBField(my);
-      Hep3Vector Bpy = getBField(py);
-      Hep3Vector Bmz = getBField(mz);
-      Hep3Vector Bpz = getBField(pz);
+
+      // Look up the central point and its 6 neighbours in one call;
+      // the field manager works in Mu2e coordinates.
+      Hep3Vector points[7] = {
+        Hep3Vector(xx,yy,zz),
+        Hep3Vector(xx-h,yy,zz), Hep3Vector(xx+h,yy,zz),
+        Hep3Vector(xx,yy-h,zz), Hep3Vector(xx,yy+h,zz),
+        Hep3Vector(xx,yy,zz-h), Hep3Vector(xx,yy,zz+h) };
+      for (auto& p : points) p += _origin;
+      Hep3Vector fields[7];
+      bool status[7];
+      _bfMgr->getBFieldsWithStatus(7, points, fields, status);
+      if (fields[0].mag() >10) {
+        if (_verbosity>=0) cout << "TrkExt: Crazy bfield : (" << fields[0].x() << ", " << fields[0].y() << ", " << fields[0].z() << ") at (" << points[0].x() << ", " << points[0].y() << ", " << points[0].z() << ")" << endl;
+      }
+
+      Hep3Vector const& B0 = fields[0];
+      Hep3Vector const& Bmx = fields[1];
+      Hep3Vector const& Bpx = fields[2];
+      Hep3Vector const& Bmy = fields[3];
+      Hep3Vector const& Bpy = fields[4];
+      Hep3Vector const& Bmz = fields[5];
+      Hep3Vector const& Bpz = fields[6];
 
       bxx = (Bpx.x() - Bmx.x()) / (2.*h);
       bxy = (Bpy.x() - Bmy.x()) / (2.*h);
@@ -524,6 +532,7 @@ namespace mu2e {
       bzx = (Bpx.z() - Bmx.z()) / (2.*h);
       bzy = (Bpy.z() - Bmy.z()) / (2.*h);
       bzz = (Bpz.z() - Bmz.z()) / (2.*h);
+      return B0;
     }
     else {
       bxx = 0;
@@ -536,7 +545,7 @@ namespace mu2e {
       bzy = 0;
       bzz = 0;
     }
-    return B0;
+    return getBField(x);
   }
 
   /////////// Read VD //////////////
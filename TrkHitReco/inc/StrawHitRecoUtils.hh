@@ -24,8 +24,8 @@ namespace mu2e {
           bool filter,
           float ctE, float ctMinT, float ctMaxT, bool usecc, float clusterDt);
 
-      void flagCrossTalk(std::unique_ptr<StrawHitCollection> const& shCol,
-          std::unique_ptr<ComboHitCollection> const& chCol) const;
+      // flag straw and electronic cross-talk of all hits; to be called once, after all hits are created
+      void flagCrossTalk(ComboHitCollection& chCol) const;
 
       bool createComboHit(EventWindowMarker const& ewm, size_t isd, std::unique_ptr<ComboHitCollection> const& chCol,
           std::unique_ptr<StrawHitCollection> const& shCol,
@@ -36,6 +36,9 @@ namespace mu2e {
           TrackerStatus const& trackerStatus, StrawResponse const& srep, Tracker const& tt) const;
 
       double peakMinusPedWF(TrkTypes::ADCWaveform const& adcData, StrawResponse const& srep, ADCWFIter& maxiter) const;
+      // peak-pedestal of all waveforms, with nADCPreSamples pedestal samples, and optionally the index of the peak sample
+      void peakMinusPedWF(StrawDigiADCWaveformCollection const& adcwfs, size_t nADCPreSamples,
+          std::vector<double>& pmps, std::vector<size_t>* maxindices = nullptr) const;
 
     private:
       // algorith parameters
@@ -51,10 +54,6 @@ namespace mu2e {
       // Calo-cluster parameters
       bool _usecc;
       float _clusterDt;
-
-      std::vector<std::vector<size_t> > hits_by_panel;
-      std::vector<size_t> largeHits;
-      std::vector<size_t> largeHitPanels;
   };
 }
 #endif
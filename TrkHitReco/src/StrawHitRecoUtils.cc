@@ -7,6 +7,7 @@
 #include "Offline/DataProducts/inc/StrawEnd.hh"
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
 
+#include <algorithm>
 #include <numeric>
 
 
@@ -27,35 +28,48 @@ namespace mu2e {
     }
 
 
-  void StrawHitRecoUtils::flagCrossTalk(std::unique_ptr<StrawHitCollection> const& shCol, std::unique_ptr<ComboHitCollection> const& chCol) const {
-    std::vector<std::vector<size_t> > hits_by_panel(StrawId::_nupanels,std::vector<size_t>());
+  void StrawHitRecoUtils::flagCrossTalk(ComboHitCollection& chCol) const {
+    // identify large hits for cross-talk analysis
     std::vector<size_t> largeHits;
-    std::vector<size_t> largeHitPanels;
-
-    size_t numDigis = shCol->size();
-    largeHits.reserve(numDigis/10);
-    largeHitPanels.reserve(numDigis/10);
-//
-    //identify large hit for cross-talk analysis
-    for(size_t ish =0; ish < shCol->size(); ++ish){
-      auto& sh = (*shCol)[ish];
-      size_t upanel = sh.strawId().uniquePanel();
-      hits_by_panel[upanel].push_back(ish);
-      if (sh.energyDep() >= _ctE) {
-        largeHits.push_back(ish);
-        largeHitPanels.push_back(upanel);
-      }
+    largeHits.reserve(chCol.size()/10);
+    for(size_t ich = 0; ich < chCol.size(); ++ich){
+      if (chCol[ich].energyDep() >= _ctE) largeHits.push_back(ich);
+    }
+    if (largeHits.empty()) return;
+
+    // bucket the hits by panel (counting sort), and sort the hits of each panel with a large hit by time
+    std::vector<size_t> panelBegin(StrawId::_nupanels+1,0);
+    for(auto const& ch : chCol) ++panelBegin[ch.strawId().uniquePanel()+1];
+    std::partial_sum(panelBegin.begin(),panelBegin.end(),panelBegin.begin());
+    std::vector<size_t> hitsByPanel(chCol.size());
+    std::vector<size_t> next(panelBegin.begin(),panelBegin.end()-1);
+    for(size_t ich = 0; ich < chCol.size(); ++ich){
+      hitsByPanel[next[chCol[ich].strawId().uniquePanel()]++] = ich;
     }
-// loop over large hits and check for correlation with other hits in this panel
-    for (size_t ilarge=0; ilarge < largeHits.size();++ilarge) {
-      const StrawHit& sh = (*shCol)[largeHits[ilarge]];
-      for (size_t jsh : hits_by_panel[largeHitPanels[ilarge]]) {
-        if (jsh==largeHits[ilarge]) continue;
-        const StrawHit& sh2 = (*shCol)[jsh];
-        if (sh2.time()-sh.time() > _ctMinT && sh2.time()-sh.time() < _ctMaxT) {
-          if (sh.strawId().samePreamp(sh2.strawId())) (*chCol)[jsh]._flag.merge(StrawHitFlag::elecxtalk);
-          if (sh.strawId().nearestNeighbor(sh2.strawId())) (*chCol)[jsh]._flag.merge(StrawHitFlag::strawxtalk);
-        }
+    auto chtime = [&chCol](size_t ich) { return chCol[ich].endTime(StrawEnd::cal); };
+    std::vector<bool> sorted(StrawId::_nupanels,false);
+    for (size_t ilarge : largeHits) {
+      size_t upanel = chCol[ilarge].strawId().uniquePanel();
+      if (sorted[upanel]) continue;
+      sorted[upanel] = true;
+      std::sort(hitsByPanel.begin()+panelBegin[upanel],hitsByPanel.begin()+panelBegin[upanel+1],
+          [&chtime](size_t a, size_t b) { return chtime(a) < chtime(b); });
+    }
+
+    // loop over large hits and check for correlation with the hits in the time window in this panel
+    for (size_t ilarge : largeHits) {
+      StrawId sid = chCol[ilarge].strawId();
+      float time = chtime(ilarge);
+      size_t upanel = sid.uniquePanel();
+      auto first = std::partition_point(hitsByPanel.begin()+panelBegin[upanel],hitsByPanel.begin()+panelBegin[upanel+1],
+          [&](size_t jch) { return !(chtime(jch)-time > _ctMinT); });
+      for (auto jter = first; jter != hitsByPanel.begin()+panelBegin[upanel+1]; ++jter) {
+        size_t jch = *jter;
+        if (!(chtime(jch)-time < _ctMaxT)) break;
+        if (jch == ilarge) continue;
+        ComboHit& ch2 = chCol[jch];
+        if (sid.samePreamp(ch2.strawId())) ch2._flag.merge(StrawHitFlag::elecxtalk);
+        if (sid.nearestNeighbor(ch2.strawId())) ch2._flag.merge(StrawHitFlag::strawxtalk);
       }
     }
   }
@@ -73,6 +87,25 @@ namespace mu2e {
     return (peak-pedestal);
   }
 
+  void StrawHitRecoUtils::peakMinusPedWF(StrawDigiADCWaveformCollection const& adcwfs, size_t nADCPreSamples,
+      std::vector<double>& pmps, std::vector<size_t>* maxindices) const {
+    size_t npre = nADCPreSamples;
+    pmps.resize(adcwfs.size());
+    if (maxindices) maxindices->resize(adcwfs.size());
+    for (size_t iwf = 0; iwf < adcwfs.size(); ++iwf) {
+      TrkTypes::ADCValue const* adc = adcwfs[iwf].samples().data();
+      size_t nsamples = adcwfs[iwf].samples().size();
+      // branch-free reductions over the samples; same arithmetic as the single waveform version above
+      int pedsum(0);
+      for (size_t isamp = 0; isamp < npre; ++isamp) pedsum += adc[isamp];
+      auto pedestal = pedsum/static_cast<float>(npre);
+      TrkTypes::ADCValue peak = adc[npre];
+      for (size_t isamp = npre+1; isamp < nsamples; ++isamp) peak = std::max(peak,adc[isamp]);
+      pmps[iwf] = peak-pedestal;
+      if (maxindices) (*maxindices)[iwf] = std::find(adc+npre,adc+nsamples,peak)-adc;
+    }
+  }
+
   bool StrawHitRecoUtils::createComboHit(EventWindowMarker const& ewm, size_t isd, std::unique_ptr<ComboHitCollection> const& chCol,
       std::unique_ptr<StrawHitCollection> const& shCol, const CaloClusterCollection* caloClusters,
       double pbtOffset,
@@ -34,6 +34,8 @@
 #include "Offline/RecoDataProducts/inc/IntensityInfoTrackerHits.hh"
 #include "Offline/DataProducts/inc/EventWindowMarker.hh"
 
+#include "cetlib_except/exception.h"
+
 #include "TH1F.h"
 
 #include <memory>
@@ -95,6 +97,9 @@ namespace mu2e {
       std::unique_ptr<TrkHitReco::PeakFit> _pfit; // peak fitting algorithm
       // diagnostic
       TH1F* _maxiter;
+      // per-event buffers: peak-pedestal and index of the peak sample of each digi
+      std::vector<double> _pmps;
+      std::vector<size_t> _maxindices;
       // handles
       ProditionsHandle<StrawResponse> _strawResponse_h;
       ProditionsHandle<TrackerStatus> _trackerStatus_h;
@@ -186,25 +191,30 @@ namespace mu2e {
 
     TrackerStatus const& trackerStatus = _trackerStatus_h.get(event.id());
 
-    double pmp(0.0);
+    // compute peak-pedestal of all digis
+    if(!_useADCWF){
+      _pmps.resize(sdcol.size());
+      for (size_t isd=0;isd<sdcol.size();++isd) _pmps[isd] = sdcol[isd].PMP();
+    } else {
+      if(sdadcc->size() < sdcol.size())
+        throw cet::exception("RECO")<<"StrawHitReco: " << sdadcc->size() << " ADC waveforms for " << sdcol.size() << " digis" << std::endl;
+      _shrUtils.peakMinusPedWF(*sdadcc, srep.nADCPreSamples(), _pmps, _diagLevel > 0 ? &_maxindices : nullptr);
+      if(_diagLevel > 0){
+        for (size_t imax : _maxindices) _maxiter->Fill(imax);
+      }
+    }
+
+    // create the hits
     for (size_t isd=0;isd<sdcol.size();++isd) {
       const StrawDigi& digi = sdcol[isd];
-      // compute peak-pedestal
-      if(!_useADCWF){
-        pmp = digi.PMP();
-      } else {
-        auto const& adcwf = sdadcc->at(isd).samples();
-        ADCWFIter maxiter;
-        pmp = _shrUtils.peakMinusPedWF(adcwf,srep,maxiter);
-        if(_diagLevel > 0)_maxiter->Fill( std::distance(adcwf.begin(),maxiter));
-      }
       _shrUtils.createComboHit(ewm, isd, chCol, shCol, caloClusters, pbtOffset,
-          digi.strawId(), digi.TDC(), digi.TOT(), pmp,
+          digi.strawId(), digi.TDC(), digi.TOT(), _pmps[isd],
           trackerStatus,  srep, tt);
-      //flag straw and electronic cross-talk
-      if(_flagXT){
-        _shrUtils.flagCrossTalk(shCol, chCol);
-      }
+    }
+
+    //flag straw and electronic cross-talk, once all hits are known
+    if(_flagXT){
+      _shrUtils.flagCrossTalk(*chCol);
     }
     if(_writesh)event.put(std::move(shCol));
     intInfo->setNTrackerHits(chCol->size());
@@ -0,0 +1,195 @@
+//
+// Benchmark of the peak-pedestal and cross-talk stages of StrawHitReco on made up events,
+// from a conversion electron alone up to twice the nominal pile-up.  Each event has a few
+// clusters of neighboring straws (tracks, with large pulses and cross-talk candidates) on
+// top of pile-up hits spread over the tracker and in time.
+//
+// The cross-talk flags are set by StrawHitRecoUtils::flagCrossTalk, called once per event,
+// and by the function used before, called after each hit as the module did, and checked to
+// be identical.  The peak-pedestal of the batched version is checked against the single
+// waveform version.
+//
+// arguments are
+// NEVENT: optional, number of events per occupancy (default 20)
+//
+// example:
+// StrawHitRecoBench 50
+//
+#include "Offline/TrkHitReco/inc/StrawHitRecoUtils.hh"
+#include "Offline/DataProducts/inc/StrawEnd.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu2e;
+
+namespace {
+
+  // nominal cross-talk parameters of StrawHitReco
+  const float ctE(0.0045), ctMinT(-2.0), ctMaxT(30.0);
+  const size_t nADCPreSamples(6), nADCSamples(15);
+
+  struct Event {
+    StrawHitCollection             shCol;
+    ComboHitCollection             chCol;
+    StrawDigiADCWaveformCollection adcwfs;
+  };
+
+  void addHit(Event& event, std::mt19937& gen, StrawId sid, float time, float edep) {
+    std::uniform_int_distribution<int> ped(1900,2100), peak(0,600);
+    TrkTypes::TDCTimes times{time, time + 2.0f};
+    TrkTypes::TOTTimes tots{10.0, 10.0};
+    event.shCol.push_back(StrawHit(sid, times, tots, edep));
+    ComboHit ch;
+    ch._sid = sid;
+    ch._edep = edep;
+    ch._etime = times;
+    ch._time = time;
+    event.chCol.push_back(ch);
+    TrkTypes::ADCWaveform adc(nADCSamples);
+    int pedestal = ped(gen);
+    for (size_t isamp=0; isamp<nADCSamples; ++isamp) adc[isamp] = pedestal + (isamp < nADCPreSamples ? 0 : peak(gen));
+    event.adcwfs.emplace_back(adc);
+  }
+
+  Event makeEvent(std::mt19937& gen, size_t nPileup) {
+    std::uniform_int_distribution<int> plane(0,StrawId::_nplanes-1), panel(0,StrawId::_npanels-1), straw(0,StrawId::_nstraws-1);
+    std::uniform_real_distribution<float> time(400.0,1700.0), flat(0.0,1.0);
+    Event event;
+    // a conversion electron like track: neighboring straws with large pulses in many panels
+    float t0 = time(gen);
+    for (int ipanel=0; ipanel<60; ++ipanel) {
+      StrawId sid(plane(gen), panel(gen), std::min(straw(gen), StrawId::_nstraws-3));
+      for (int istraw=0; istraw<3; ++istraw) {
+        addHit(event, gen, StrawId(sid.plane(), sid.panel(), sid.straw()+istraw), t0 + 5.0f*flat(gen), istraw==1 ? 0.008 : 0.002);
+      }
+    }
+    // pile-up: mostly small pulses, some protons
+    for (size_t ihit=0; ihit<nPileup; ++ihit) {
+      addHit(event, gen, StrawId(plane(gen), panel(gen), straw(gen)), time(gen), flat(gen) < 0.1 ? 0.01 : 0.003*flat(gen));
+    }
+    // the module sees the digis ordered by straw
+    std::vector<size_t> order(event.chCol.size());
+    for (size_t i=0; i<order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&event](size_t a, size_t b) { return event.chCol[a]._sid < event.chCol[b]._sid; });
+    Event sorted;
+    for (size_t i : order) {
+      sorted.shCol.push_back(event.shCol[i]);
+      sorted.chCol.push_back(event.chCol[i]);
+      sorted.adcwfs.push_back(event.adcwfs[i]);
+    }
+    return sorted;
+  }
+
+  // the cross-talk flagging used before, called after each new hit
+  void flagCrossTalkOld(StrawHitCollection const& shCol, ComboHitCollection& chCol) {
+    std::vector<std::vector<size_t> > hits_by_panel(StrawId::_nupanels,std::vector<size_t>());
+    std::vector<size_t> largeHits;
+    std::vector<size_t> largeHitPanels;
+    for(size_t ish =0; ish < shCol.size(); ++ish){
+      auto& sh = shCol[ish];
+      size_t upanel = sh.strawId().uniquePanel();
+      hits_by_panel[upanel].push_back(ish);
+      if (sh.energyDep() >= ctE) {
+        largeHits.push_back(ish);
+        largeHitPanels.push_back(upanel);
+      }
+    }
+    for (size_t ilarge=0; ilarge < largeHits.size();++ilarge) {
+      const StrawHit& sh = shCol[largeHits[ilarge]];
+      for (size_t jsh : hits_by_panel[largeHitPanels[ilarge]]) {
+        if (jsh==largeHits[ilarge]) continue;
+        const StrawHit& sh2 = shCol[jsh];
+        if (sh2.time()-sh.time() > ctMinT && sh2.time()-sh.time() < ctMaxT) {
+          if (sh.strawId().samePreamp(sh2.strawId())) chCol[jsh]._flag.merge(StrawHitFlag::elecxtalk);
+          if (sh.strawId().nearestNeighbor(sh2.strawId())) chCol[jsh]._flag.merge(StrawHitFlag::strawxtalk);
+        }
+      }
+    }
+  }
+}
+
+
+int main(int argc, char** argv) {
+  int nEvent = argc > 1 ? std::stoi(argv[1]) : 20;
+
+  StrawHitRecoUtils shrUtils(TrkHitReco::FitType::peakminusped, 0, StrawIdMask::uniquestraw, false,
+      0.0, 2000.0, 0.0, 1.0, 0.0, 1000.0, false, ctE, ctMinT, ctMaxT, false, 0.0);
+
+  std::mt19937 gen(97531);
+  std::cout << "StrawHitRecoBench mean time per event in ms, " << nEvent << " events per occupancy" << std::endl;
+  std::cout << std::setw(10) << "hits" << std::setw(12) << "pmp single" << std::setw(12) << "pmp batch"
+    << std::setw(12) << "xt per hit" << std::setw(12) << "xt once" << std::setw(10) << "flagged" << std::endl;
+
+  int nBad(0);
+  // conversion electron only, 1/2, 1 and 2 times nominal pile-up
+  for (size_t nPileup : {0, 2500, 5000, 10000}) {
+    double tPmpSingle(0), tPmpBatch(0), tOld(0), tNew(0);
+    long nFlagged(0);
+    size_t nHits(0);
+    for (int iEvent=0; iEvent<nEvent; ++iEvent) {
+      Event event = makeEvent(gen, nPileup);
+      nHits = event.chCol.size();
+
+      // peak-pedestal
+      std::vector<double> pmpSingle(nHits), pmpBatch;
+      std::vector<size_t> maxSingle(nHits), maxBatch;
+      auto t0 = std::chrono::high_resolution_clock::now();
+      for (size_t i=0; i<nHits; ++i) {
+        auto const& adc = event.adcwfs[i].samples();
+        TrkTypes::ADCWaveform::const_iterator maxiter = adc.begin() + nADCPreSamples;
+        auto wfstart = adc.begin() + nADCPreSamples;
+        auto pedestal = std::accumulate(adc.begin(), wfstart, 0)/static_cast<float>(nADCPreSamples);
+        for (auto iter = wfstart+1; iter != adc.end(); ++iter) if (*iter > *maxiter) maxiter = iter;
+        pmpSingle[i] = *maxiter - pedestal;
+        maxSingle[i] = std::distance(adc.begin(), maxiter);
+      }
+      auto t1 = std::chrono::high_resolution_clock::now();
+      shrUtils.peakMinusPedWF(event.adcwfs, nADCPreSamples, pmpBatch, &maxBatch);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      if (pmpSingle != pmpBatch || maxSingle != maxBatch) ++nBad;
+
+      // cross-talk, called after each hit as before, and once
+      ComboHitCollection chOld, chNew(event.chCol);
+      StrawHitCollection shOld;
+      auto t3 = std::chrono::high_resolution_clock::now();
+      for (size_t i=0; i<nHits; ++i) {
+        shOld.push_back(event.shCol[i]);
+        chOld.push_back(event.chCol[i]);
+        flagCrossTalkOld(shOld, chOld);
+      }
+      auto t4 = std::chrono::high_resolution_clock::now();
+      shrUtils.flagCrossTalk(chNew);
+      auto t5 = std::chrono::high_resolution_clock::now();
+
+      for (size_t i=0; i<nHits; ++i) {
+        if (!(chOld[i].flag() == chNew[i].flag())) { ++nBad; break; }
+      }
+      for (auto const& ch : chNew) {
+        if (ch.flag().hasAnyProperty(StrawHitFlag::elecxtalk) || ch.flag().hasAnyProperty(StrawHitFlag::strawxtalk)) ++nFlagged;
+      }
+
+      tPmpSingle += std::chrono::duration<double>(t1-t0).count();
+      tPmpBatch  += std::chrono::duration<double>(t2-t1).count();
+      tOld       += std::chrono::duration<double>(t4-t3).count();
+      tNew       += std::chrono::duration<double>(t5-t4).count();
+    }
+    std::cout << std::setw(10) << nHits << std::fixed << std::setprecision(4)
+      << std::setw(12) << 1e3*tPmpSingle/nEvent << std::setw(12) << 1e3*tPmpBatch/nEvent
+      << std::setw(12) << 1e3*tOld/nEvent << std::setw(12) << 1e3*tNew/nEvent
+      << std::setw(10) << std::setprecision(1) << double(nFlagged)/nEvent << std::defaultfloat << std::endl;
+  }
+
+  if (nBad > 0) {
+    std::cout << "StrawHitRecoBench FAILED " << nBad << " events with different results" << std::endl;
+    return 1;
+  }
+  std::cout << "StrawHitRecoBench passed" << std::endl;
+  return 0;
+}
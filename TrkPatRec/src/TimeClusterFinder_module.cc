@@ -141,6 +141,7 @@ namespace mu2e {
       int                           _debug;
       TH1F                          _timespec;
       TimeCluMVA                    _pmva; // input variables to TMVA for cluster cleaning
+      std::vector<float>            _mvarows, _mvaout; // MVA input rows and results of all hits of a cluster
 
 
       void findClusters(TimeClusterCollection& tccol);
@@ -538,15 +539,18 @@ namespace mu2e {
   }
 
   void TimeClusterFinder::refineCluster(TimeCluster& tc) {
-    // mva filtering; remove worst hit iteratively
+    // mva filtering; remove worst hit iteratively.  The MVA is evaluated for all hits of the cluster in one call
+    const size_t nvars = _pmva._pars.size();
+    MVATools const& mva = tc.hasCaloCluster() ? _tcCaloMVA : _tcMVA;
     bool changed = true;
     while (changed && tc._nsh > 0) {
       changed = false;
-      auto iworst = tc._strawHitIdxs.end();
-      float worstmva(100.0);
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
-      for (auto ips=tc._strawHitIdxs.begin();ips != tc._strawHitIdxs.end();++ips) {
-        ComboHit const& ch = (*_chcol)[*ips];
+      const size_t nhits = tc._strawHitIdxs.size();
+      _mvarows.resize(nhits*nvars);
+      _mvaout.resize(nhits);
+      for (size_t ihit=0;ihit < nhits;++ihit) {
+        ComboHit const& ch = (*_chcol)[tc._strawHitIdxs[ihit]];
         float cht = _ttcalc.comboHitTime(ch,_pitch);
 
         _pmva._dt = fabs(cht - tc._t0._t0);
@@ -558,15 +562,16 @@ namespace mu2e {
         _pmva._plane = ch.strawId().plane();
         _pmva._werr = ch.wireRes();
         _pmva._wdist = fabs(ch.wireDist());
+        std::copy(_pmva._pars.begin(),_pmva._pars.end(),_mvarows.begin()+ihit*nvars);
+      }
+      mva.evalMVA(nhits,nvars,_mvarows.data(),_mvaout.data());
 
-        float mvaout(-1.0);
-        if (tc.hasCaloCluster())
-          mvaout = _tcCaloMVA.evalMVA(_pmva._pars);
-        else
-          mvaout = _tcMVA.evalMVA(_pmva._pars);
-        if (mvaout < worstmva) {
-          worstmva = mvaout;
-          iworst = ips;
+      auto iworst = tc._strawHitIdxs.end();
+      float worstmva(100.0);
+      for (size_t ihit=0;ihit < nhits;++ihit) {
+        if (_mvaout[ihit] < worstmva) {
+          worstmva = _mvaout[ihit];
+          iworst = tc._strawHitIdxs.begin()+ihit;
         }
       }
 